@@ -0,0 +1,165 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/json/json_value.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace xbwd {
+namespace bench {
+
+// Number of the operator new calls since the start, counted by main.cpp
+std::uint64_t
+allocations();
+
+// Keep the compiler from optimizing away a result
+template <class T>
+inline void
+keep(T const& v)
+{
+    asm volatile("" : : "r"(&v) : "memory");
+}
+
+// Read a recorded JSON message from the data directory
+Json::Value
+loadJson(std::filesystem::path const& file);
+
+/**
+ *  Run the benchmarks and print one line per benchmark.
+ *
+ *  The number of iterations is calibrated so a run takes at least minRunTime,
+ *  then the benchmark is run `repeats` times. The medians of the time and of
+ *  the allocations per operation are printed, they are stable from run to run
+ *  on a quiet machine.
+ */
+class Runner
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    static constexpr auto minRunTime = std::chrono::milliseconds(100);
+    static constexpr unsigned repeats = 5;
+
+private:
+    std::string const filter_;
+    std::filesystem::path const data_;
+
+public:
+    Runner(std::string filter, std::filesystem::path data)
+        : filter_(std::move(filter)), data_(std::move(data))
+    {
+    }
+
+    std::filesystem::path const&
+    data() const
+    {
+        return data_;
+    }
+
+    // Run only the benchmarks whose name contains the filter
+    bool
+    enabled(std::string_view name) const
+    {
+        return filter_.empty() || name.find(filter_) != std::string_view::npos;
+    }
+
+    // `f` performs one operation
+    template <class F>
+    void
+    run(std::string_view name, F&& f)
+    {
+        if (!enabled(name))
+            return;
+
+        auto measure = [&](std::uint64_t iters) {
+            auto const allocs = allocations();
+            auto const start = clock::now();
+            for (std::uint64_t i = 0; i < iters; ++i)
+                f();
+            auto const elapsed = clock::now() - start;
+            return std::make_pair(elapsed, allocations() - allocs);
+        };
+
+        // Warm up, and find the number of iterations
+        std::uint64_t iters = 1;
+        for (;;)
+        {
+            auto const elapsed = measure(iters).first;
+            if (elapsed >= minRunTime / 10)
+            {
+                auto const ns = std::chrono::duration_cast<
+                                    std::chrono::nanoseconds>(elapsed)
+                                    .count();
+                iters = std::max<std::uint64_t>(
+                    1,
+                    iters *
+                        std::chrono::nanoseconds(minRunTime).count() / ns);
+                break;
+            }
+            iters *= 10;
+        }
+
+        std::vector<double> nsPerOp, allocsPerOp;
+        for (unsigned r = 0; r < repeats; ++r)
+        {
+            auto const [elapsed, allocs] = measure(iters);
+            nsPerOp.push_back(
+                std::chrono::duration<double, std::nano>(elapsed).count() /
+                iters);
+            allocsPerOp.push_back(static_cast<double>(allocs) / iters);
+        }
+
+        fmt::print(
+            "{:<36} {:>12.1f} ns/op {:>9.1f} allocs/op {:>10} iters\n",
+            name,
+            median(nsPerOp),
+            median(allocsPerOp),
+            iters);
+    }
+
+private:
+    static double
+    median(std::vector<double>& v)
+    {
+        std::sort(v.begin(), v.end());
+        return v[v.size() / 2];
+    }
+};
+
+void
+benchParse(Runner& r);
+
+void
+benchSign(Runner& r);
+
+void
+benchDB(Runner& r);
+
+}  // namespace bench
+}  // namespace xbwd
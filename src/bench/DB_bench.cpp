@@ -0,0 +1,145 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <bench/Bench.h>
+
+#include <xbwd/app/DBInit.h>
+#include <xbwd/app/DBStatements.h>
+#include <xbwd/core/DatabaseCon.h>
+#include <xbwd/core/SociDB.h>
+
+#include <ripple/basics/Log.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/XChainAttestations.h>
+
+#include <filesystem>
+#include <string>
+
+#include <unistd.h>
+
+namespace xbwd {
+namespace bench {
+
+namespace {
+
+// Remove the temporary database directory on exit
+struct TempDir
+{
+    std::filesystem::path const path;
+
+    TempDir()
+        : path(
+              std::filesystem::temp_directory_path() /
+              ("xbwd_bench_" + std::to_string(::getpid())))
+    {
+        std::filesystem::create_directories(path);
+    }
+
+    ~TempDir()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+}  // namespace
+
+void
+benchDB(Runner& r)
+{
+    ripple::Logs logs(beast::severities::kFatal);
+    logs.silent(true);
+    auto const j = logs.journal("Bench");
+
+    for (bool const wal : {false, true})
+    {
+        TempDir const dir;
+        DatabaseSetup setup;
+        setup.wal = wal;
+        DatabaseCon db(
+            dir.path.string(),
+            db_init::xChainDBName(),
+            db_init::xChainDBPragma(),
+            db_init::xChainDBInit(),
+            j,
+            setup);
+        db.prepareStatements(db_stmt::prepareAll);
+
+        auto const ct = ChainType::locking;
+        ripple::AccountID const rewAcc(1), src(2), dst(3);
+        ripple::STXChainBridge const bridge;
+        auto const keys = ripple::generateKeyPair(
+            ripple::KeyType::ed25519,
+            *ripple::parseBase58<ripple::Seed>(
+                "snnksgXkSTgCBuHJmHeTekJyj4qG6"));
+        ripple::STAmount const amt(42);
+        auto const claim = ripple::Attestations::AttestationClaim{
+            bridge,
+            ripple::calcAccountID(keys.first),
+            keys.first,
+            keys.second,
+            src,
+            amt,
+            rewAcc,
+            true,
+            1,
+            dst};
+
+        // As Federator::onDBEvent for a commit, each insert has a new key
+        std::uint64_t claimID = 0;
+        auto insert = [&] {
+            auto session = db.checkoutDb();
+            auto& q = session.prepared<db_stmt::InsertClaim>(
+                db_stmt::InsertClaim::name(ct));
+            ++claimID;
+            ripple::uint256 const hash(claimID);
+            q.txnId = convert(hash, *session);
+            q.ledgerSeq = claimID;
+            q.claimID = claimID;
+            q.success = 1;
+            q.amt = convert(amt, *session);
+            q.bridge = convert(bridge, *session);
+            q.sendingAccount = convert(src, *session);
+            q.rewardAccount = convert(rewAcc, *session);
+            q.otherChainDst = convert(dst, *session);
+            q.signingAccount =
+                convert(claim.attestationSignerAccount, *session);
+            q.publicKey = convert(keys.first, *session);
+            q.signature = convert(claim.signature, *session);
+            q.st.execute(true);
+        };
+
+        // The DB loop commits the events in batches, the time is per batch
+        std::string const sfx = wal ? "/wal" : "";
+        for (unsigned const batch : {1u, 16u})
+        {
+            r.run(
+                "db/insert_claim_batch" + std::to_string(batch) + sfx, [&] {
+                    auto session = db.checkoutDb();
+                    soci::transaction tr(*session);
+                    for (unsigned i = 0; i < batch; ++i)
+                        insert();
+                    tr.commit();
+                });
+        }
+    }
+}
+
+}  // namespace bench
+}  // namespace xbwd
@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <bench/Bench.h>
+
+#include <xbwd/client/FlatJson.h>
+#include <xbwd/client/RpcResultParse.h>
+
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/TER.h>
+#include <ripple/protocol/jss.h>
+
+#include <stdexcept>
+
+namespace xbwd {
+namespace bench {
+
+namespace {
+
+// The steps of ChainListener::processMessage for a transaction, without the
+// event push. Return false if the message would be ignored.
+bool
+parseTransaction(Json::Value const& msg, Json::Value const& transaction)
+{
+    namespace rp = rpcResultParse;
+
+    if (!msg.isMember(ripple::jss::meta))
+        return false;
+    auto const& meta = msg[ripple::jss::meta];
+
+    auto const txnType = rp::parseXChainTxnType(transaction);
+    if (!txnType)
+        return false;
+    auto const bridge = rp::parseBridge(transaction);
+    auto const hash = rp::parseTxHash(transaction);
+    auto const seq = rp::parseTxSeq(transaction);
+    auto const lgrSeq = rp::parseLedgerSeq(msg);
+    auto const src = rp::parseSrcAccount(transaction);
+    auto const dst = rp::parseDstAccount(transaction, *txnType);
+    auto const deliveredAmt = rp::parseDeliveredAmt(transaction, meta);
+    auto const ter =
+        ripple::TER::fromInt(msg[ripple::jss::engine_result_code].asInt());
+    keep(bridge);
+    keep(dst);
+    keep(deliveredAmt);
+    keep(ter);
+    return hash && seq && src && lgrSeq;
+}
+
+}  // namespace
+
+void
+benchParse(Runner& r)
+{
+    auto const stream = loadJson(r.data() / "commit.json");
+    auto const accountTx = loadJson(r.data() / "account_tx.json");
+    auto const& transaction = stream[ripple::jss::transaction];
+    auto const& meta = stream[ripple::jss::meta];
+
+    std::string const streamStr = Json::to_string(stream);
+    std::string const accountTxStr = Json::to_string(accountTx);
+
+    if (!parseTransaction(stream, transaction))
+        throw std::runtime_error("commit.json is not an xchain commit");
+
+    // The websocket client parses every message before the listener gets it
+    r.run("json/read_stream", [&] {
+        Json::Value jv;
+        Json::Reader().parse(streamStr, jv);
+        keep(jv);
+    });
+
+    // As sent by rippled on the ledger stream
+    std::string const ledgerStr =
+        R"({"fee_base":10,"ledger_hash":"4B2B9B5E4D2E63A8C4B6E54E5D0DEC26)"
+        R"(7B3D4A0A1D7B8F5B6E0C2F8D1B3E5A7C","ledger_index":91826371,)"
+        R"("ledger_time":782821571,"reserve_base":1000000,)"
+        R"("reserve_inc":200000,"txn_count":42,"type":"ledgerClosed",)"
+        R"("validated_ledgers":"32570-91826371"})";
+
+    r.run("json/read_ledger_closed", [&] {
+        Json::Value jv;
+        Json::Reader().parse(ledgerStr, jv);
+        keep(jv);
+    });
+
+    r.run("json/read_ledger_closed_flat", [&] {
+        Json::Value jv;
+        keep(parseFlatJson(ledgerStr, jv));
+        keep(jv);
+    });
+
+    r.run("json/read_account_tx", [&] {
+        Json::Value jv;
+        Json::Reader().parse(accountTxStr, jv);
+        keep(jv);
+    });
+
+    r.run("listener/stream_tx", [&] {
+        bool const ok = parseTransaction(stream, transaction);
+        keep(ok);
+    });
+
+    // Per transaction of the account_tx response
+    auto const& txns =
+        accountTx[ripple::jss::result][ripple::jss::transactions];
+    r.run("listener/account_tx_page", [&] {
+        for (auto const& t : txns)
+        {
+            bool const ok = parseTransaction(t, t[ripple::jss::tx]);
+            keep(ok);
+        }
+    });
+
+    r.run("parse/xchain_txn_type", [&] {
+        keep(rpcResultParse::parseXChainTxnType(transaction));
+    });
+
+    r.run("parse/bridge", [&] {
+        keep(rpcResultParse::parseBridge(transaction));
+    });
+
+    r.run("parse/tx_hash", [&] {
+        keep(rpcResultParse::parseTxHash(transaction));
+    });
+
+    r.run("parse/src_account", [&] {
+        keep(rpcResultParse::parseSrcAccount(transaction));
+    });
+
+    r.run("parse/dst_account", [&] {
+        keep(rpcResultParse::parseDstAccount(
+            transaction, XChainTxnType::xChainCommit));
+    });
+
+    r.run("parse/ledger_seq", [&] {
+        keep(rpcResultParse::parseLedgerSeq(stream));
+    });
+
+    r.run("parse/delivered_amt", [&] {
+        keep(rpcResultParse::parseDeliveredAmt(transaction, meta));
+    });
+
+    r.run("parse/create_count", [&] {
+        keep(rpcResultParse::parseCreateCount(meta));
+    });
+
+    r.run("parse/reward_amt", [&] {
+        keep(rpcResultParse::parseRewardAmt(transaction));
+    });
+}
+
+}  // namespace bench
+}  // namespace xbwd
@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <bench/Bench.h>
+
+#include <xbwd/app/Config.h>
+#include <xbwd/client/RpcResultParse.h>
+#include <xbwd/federator/Federator.h>
+
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/XChainAttestations.h>
+#include <ripple/protocol/jss.h>
+
+#include <stdexcept>
+
+namespace xbwd {
+namespace bench {
+
+void
+benchSign(Runner& r)
+{
+    namespace rp = rpcResultParse;
+
+    // The attested transfer is the recorded commit
+    auto const stream = loadJson(r.data() / "commit.json");
+    auto const& transaction = stream[ripple::jss::transaction];
+    auto const bridge = rp::parseBridge(transaction);
+    auto const src = rp::parseSrcAccount(transaction);
+    auto const dst =
+        rp::parseDstAccount(transaction, XChainTxnType::xChainCommit);
+    auto const amt =
+        rp::parseDeliveredAmt(transaction, stream[ripple::jss::meta]);
+    if (!bridge || !src || !amt)
+        throw std::runtime_error("commit.json is not an xchain commit");
+
+    char const* const seed = "snnksgXkSTgCBuHJmHeTekJyj4qG6";
+    beast::Journal const j{beast::Journal::getNullSink()};
+
+    for (char const* keyType : {"secp256k1", "ed25519"})
+    {
+        Json::Value jv;
+        jv["SigningKeyType"] = keyType;
+        jv["SigningKeySeed"] = seed;
+        jv["SubmittingAccount"] = transaction[ripple::jss::Account];
+        config::TxnSubmit const txnSubmit(jv);
+        auto const& [pk, sk] = txnSubmit.keypair;
+        auto const signingAccount = ripple::calcAccountID(pk);
+        auto const rewardAccount = txnSubmit.submittingAccount;
+        std::string const sfx = std::string("/") + keyType;
+
+        // As Federator::makeAttestation for the events without a signature
+        auto makeClaim = [&] {
+            return ripple::Attestations::AttestationClaim{
+                *bridge,
+                signingAccount,
+                pk,
+                sk,
+                *src,
+                *amt,
+                rewardAccount,
+                true,
+                2,
+                dst};
+        };
+
+        r.run("attest/claim_sign" + sfx, [&] { keep(makeClaim()); });
+
+        ripple::Attestations::AttestationCreateAccount const create{
+            *bridge,
+            signingAccount,
+            pk,
+            sk,
+            *src,
+            *amt,
+            *amt,
+            rewardAccount,
+            true,
+            1,
+            *src};
+        r.run("attest/create_sign" + sfx, [&] {
+            keep(ripple::Attestations::AttestationCreateAccount{
+                *bridge,
+                signingAccount,
+                pk,
+                sk,
+                *src,
+                *amt,
+                *amt,
+                rewardAccount,
+                true,
+                1,
+                *src});
+        });
+
+        // The first submit builds the body, the resubmits reuse it
+        auto const claimAtt = makeClaim();
+        r.run("submission/claim_signed_txn" + sfx, [&] {
+            SubmissionClaim const claim(100, 10, 0, *bridge, claimAtt);
+            keep(claim.getSignedTxn(txnSubmit, ripple::XRPAmount{20}, j));
+        });
+        SubmissionClaim const claim(100, 10, 0, *bridge, claimAtt);
+        r.run("submission/claim_resigned_txn" + sfx, [&] {
+            keep(claim.getSignedTxn(txnSubmit, ripple::XRPAmount{20}, j));
+        });
+
+        r.run("submission/create_signed_txn" + sfx, [&] {
+            SubmissionCreateAccount const submCreate(
+                100, 10, 0, *bridge, create);
+            keep(
+                submCreate.getSignedTxn(txnSubmit, ripple::XRPAmount{20}, j));
+        });
+        SubmissionCreateAccount const submCreate(100, 10, 0, *bridge, create);
+        r.run("submission/create_resigned_txn" + sfx, [&] {
+            keep(
+                submCreate.getSignedTxn(txnSubmit, ripple::XRPAmount{20}, j));
+        });
+    }
+}
+
+}  // namespace bench
+}  // namespace xbwd
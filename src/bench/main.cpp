@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <bench/Bench.h>
+
+#include <ripple/json/json_reader.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+//------------------------------------------------------------------------------
+// Count the allocations of the whole program
+
+namespace {
+std::atomic_uint64_t gAllocations{0};
+
+void*
+allocate(std::size_t size)
+{
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+}  // namespace
+
+void*
+operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void*
+operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void
+operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+//------------------------------------------------------------------------------
+
+namespace xbwd {
+namespace bench {
+
+std::uint64_t
+allocations()
+{
+    return gAllocations.load(std::memory_order_relaxed);
+}
+
+Json::Value
+loadJson(std::filesystem::path const& file)
+{
+    std::ifstream f(file);
+    Json::Value jv;
+    if (!f || !Json::Reader().parse(f, jv))
+        throw std::runtime_error("can't read " + file.string());
+    return jv;
+}
+
+}  // namespace bench
+}  // namespace xbwd
+
+int
+main(int argc, char** argv)
+{
+    using namespace xbwd::bench;
+
+    std::string filter;
+    std::filesystem::path data = XBWD_BENCH_DATA;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view const arg = argv[i];
+        if (arg == "--data" && i + 1 < argc)
+            data = argv[++i];
+        else if (arg == "--help" || arg == "-h")
+        {
+            std::cerr << "xbridge_witness_bench [--data <dir>] [<filter>]\n";
+            return EXIT_SUCCESS;
+        }
+        else
+            filter = arg;
+    }
+
+    try
+    {
+        Runner r(filter, data);
+        benchParse(r);
+        benchSign(r);
+        benchDB(r);
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "benchmark failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
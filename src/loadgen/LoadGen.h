@@ -0,0 +1,324 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/app/Config.h>
+#include <xbwd/basics/ChainTypes.h>
+
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/STXChainBridge.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/websocket/stream.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xbwd {
+namespace loadgen {
+
+using clock = std::chrono::steady_clock;
+
+struct Options
+{
+    // Transactions added to every locking chain ledger
+    std::uint32_t commitsPerLedger = 10;
+    std::uint32_t createsPerLedger = 0;
+    std::chrono::milliseconds ledgerInterval{1000};
+    // Time the load is generated, counted from the witness sync
+    std::chrono::seconds duration{60};
+    // Ledgers closed after the load, for the last attestations
+    std::uint32_t drainLedgers = 10;
+    // Close the witness connections every interval, 0 - never
+    std::chrono::seconds disconnectInterval{0};
+    // Fraction of the attestation submits refused with telCAN_NOT_QUEUE_FULL
+    double submitErrorRate = 0;
+    std::chrono::seconds reportInterval{10};
+    // Witness process to sample the memory of, 0 - none
+    int witnessPid = 0;
+};
+
+/**
+ *  The attestations expected from the witness.
+ *
+ *  A transfer is pending from the close of the ledger with the commit until
+ *  the witness submits an accepted attestation for it. The mock chains run on
+ *  one thread, nothing is synchronized.
+ */
+class Tracker
+{
+public:
+    struct Stats
+    {
+        std::uint64_t commits = 0;
+        std::uint64_t creates = 0;
+        // First accepted attestation of a transfer
+        std::uint64_t attested = 0;
+        // Accepted attestations of already attested transfers
+        std::uint64_t resubmits = 0;
+        std::uint64_t submitErrors = 0;
+        // Attestations added to a ledger
+        std::uint64_t confirmed = 0;
+        std::uint64_t connects = 0;
+        std::uint64_t disconnects = 0;
+    };
+
+private:
+    std::unordered_map<std::uint64_t, clock::time_point> claims_;
+    std::unordered_map<std::uint64_t, clock::time_point> creates_;
+    // Commit ledger close to attestation, in microseconds
+    std::vector<std::uint32_t> latencyUs_;
+    Stats stats_;
+
+public:
+    void
+    committed(bool createAccount, std::uint64_t id, clock::time_point closed);
+
+    // Return false if the transfer was already attested
+    bool
+    attested(bool createAccount, std::uint64_t id, clock::time_point now);
+
+    std::size_t
+    pending() const;
+
+    Stats&
+    stats();
+
+    Stats const&
+    stats() const;
+
+    // Microseconds, 0 without samples. `p` in [0, 1]
+    std::uint32_t
+    latencyPercentile(double p);
+};
+
+/**
+ *  A rippled chain as the witness sees it through its websocket.
+ *
+ *  Built on the engines of the tests: the responses are generated from the
+ *  witness config, the transactions of the ledgers are kept for the
+ *  account_tx requests and the attestations submitted by the witness are
+ *  added to the next ledger.
+ */
+class MockChain
+{
+    struct Txn
+    {
+        std::uint32_t ledger;
+        Json::Value entry;
+    };
+
+    // Transactions of the ledgers older than that are trimmed
+    static constexpr std::uint32_t keepLedgers = 256;
+    static constexpr std::uint32_t firstLedger = 2;
+
+    ChainType const chainType_;
+    Options const& opts_;
+    Tracker& tracker_;
+    ripple::STXChainBridge const bridge_;
+    ripple::AccountID const door_;
+    ripple::AccountID const witnessSigner_;
+    ripple::AccountID const user_;
+    Json::Value const bridgeJson_;
+
+    std::uint32_t ledger_ = 10;
+    std::uint32_t userSeq_ = 1;
+    std::uint64_t claimID_ = 0;
+    std::uint64_t createCount_ = 0;
+    // The history of the door starts with the bridge creation
+    Json::Value createBridge_;
+    std::unordered_map<ripple::AccountID, std::deque<Txn>> txns_;
+    std::unordered_map<ripple::AccountID, std::uint32_t> sequences_;
+    std::unordered_map<ripple::AccountID, std::set<std::uint32_t>> tickets_;
+    // Accepted submits, for the next ledger
+    std::vector<Json::Value> submitted_;
+    bool synced_ = false;
+
+    std::mt19937 rng_;
+    std::bernoulli_distribution submitError_;
+
+public:
+    MockChain(
+        ChainType ct,
+        config::Config const& config,
+        Options const& opts,
+        Tracker& tracker);
+
+    ChainType
+    chainType() const
+    {
+        return chainType_;
+    }
+
+    // The witness polls the new transactions of the door, its initial sync is
+    // finished
+    bool
+    synced() const
+    {
+        return synced_;
+    }
+
+    // Return the response to a request of the witness
+    Json::Value
+    process(Json::Value const& request);
+
+    // Close a ledger, with the commits if `load`, and return the ledgerClosed
+    // stream message
+    Json::Value
+    closeLedger(bool load);
+
+private:
+    Json::Value
+    ledgerFields() const;
+
+    Json::Value
+    serverInfo() const;
+
+    Json::Value
+    accountInfo(Json::Value const& params);
+
+    Json::Value
+    ledgerEntry() const;
+
+    Json::Value
+    accountTx(Json::Value const& params);
+
+    Json::Value
+    accountObjects(Json::Value const& params) const;
+
+    Json::Value
+    submit(Json::Value const& params);
+
+    void
+    addCommit(std::uint32_t index, bool createAccount);
+
+    void
+    addTxn(
+        ripple::AccountID const& account,
+        Json::Value tx,
+        Json::Value meta,
+        std::uint32_t index);
+
+    void
+    trim();
+};
+
+//------------------------------------------------------------------------------
+
+// A websocket connection of the witness. The reads and the writes run on the
+// one thread of the io_context, the writes are queued.
+class Session : public std::enable_shared_from_this<Session>
+{
+    boost::beast::websocket::stream<boost::beast::tcp_stream> ws_;
+    boost::beast::flat_buffer buffer_;
+    std::deque<std::string> writes_;
+    MockChain& chain_;
+    Tracker& tracker_;
+    bool open_ = false;
+
+public:
+    Session(
+        boost::asio::ip::tcp::socket&& socket,
+        MockChain& chain,
+        Tracker& tracker);
+
+    void
+    run();
+
+    void
+    send(std::string msg);
+
+    void
+    close();
+
+    bool
+    isOpen() const
+    {
+        return open_;
+    }
+
+private:
+    void
+    onAccept(boost::beast::error_code ec);
+
+    void
+    doRead();
+
+    void
+    onRead(boost::beast::error_code ec, std::size_t bytes);
+
+    void
+    doWrite();
+
+    void
+    onWrite(boost::beast::error_code ec, std::size_t bytes);
+};
+
+// Accept the witness connections of a chain
+class Listener : public std::enable_shared_from_this<Listener>
+{
+    boost::asio::io_context& ioc_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    MockChain& chain_;
+    Tracker& tracker_;
+    std::vector<std::weak_ptr<Session>> sessions_;
+
+public:
+    Listener(
+        boost::asio::io_context& ioc,
+        boost::asio::ip::tcp::endpoint const& endpoint,
+        MockChain& chain,
+        Tracker& tracker);
+
+    void
+    run();
+
+    void
+    stop();
+
+    // Send a stream message to every connection
+    void
+    broadcast(std::string const& msg);
+
+    // Close every connection, the witness reconnects
+    void
+    disconnect();
+
+private:
+    void
+    doAccept();
+
+    void
+    onAccept(boost::beast::error_code ec, boost::asio::ip::tcp::socket socket);
+};
+
+}  // namespace loadgen
+}  // namespace xbwd
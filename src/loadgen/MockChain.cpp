@@ -0,0 +1,587 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <loadgen/LoadGen.h>
+
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/Seed.h>
+#include <ripple/protocol/TER.h>
+#include <ripple/protocol/digest.h>
+#include <ripple/protocol/jss.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace xbwd {
+namespace loadgen {
+
+namespace jss = ripple::jss;
+
+//------------------------------------------------------------------------------
+
+void
+Tracker::committed(
+    bool createAccount,
+    std::uint64_t id,
+    clock::time_point closed)
+{
+    auto& pending = createAccount ? creates_ : claims_;
+    pending.emplace(id, closed);
+    ++(createAccount ? stats_.creates : stats_.commits);
+}
+
+bool
+Tracker::attested(bool createAccount, std::uint64_t id, clock::time_point now)
+{
+    auto& pending = createAccount ? creates_ : claims_;
+    auto const it = pending.find(id);
+    if (it == pending.end())
+        return false;
+
+    latencyUs_.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - it->second)
+            .count());
+    pending.erase(it);
+    ++stats_.attested;
+    return true;
+}
+
+std::size_t
+Tracker::pending() const
+{
+    return claims_.size() + creates_.size();
+}
+
+Tracker::Stats&
+Tracker::stats()
+{
+    return stats_;
+}
+
+Tracker::Stats const&
+Tracker::stats() const
+{
+    return stats_;
+}
+
+std::uint32_t
+Tracker::latencyPercentile(double p)
+{
+    if (latencyUs_.empty())
+        return 0;
+    auto const n = static_cast<std::size_t>(p * (latencyUs_.size() - 1));
+    std::nth_element(
+        latencyUs_.begin(), latencyUs_.begin() + n, latencyUs_.end());
+    return latencyUs_[n];
+}
+
+//------------------------------------------------------------------------------
+
+namespace {
+
+ripple::AccountID
+witnessSigner(config::Config const& config)
+{
+    if (config.signingAccount)
+        return *config.signingAccount;
+    return ripple::calcAccountID(
+        ripple::derivePublicKey(config.keyType, config.signingKey));
+}
+
+// The sender and the destination of the transfers, the witness does not
+// check them
+ripple::AccountID
+userAccount()
+{
+    return ripple::calcAccountID(
+        ripple::generateKeyPair(
+            ripple::KeyType::secp256k1, ripple::generateSeed("xbwd loadgen"))
+            .first);
+}
+
+std::string
+makeHash(ChainType ct, std::uint32_t ledger, std::uint32_t index)
+{
+    return to_string(
+        ripple::sha512Half(static_cast<std::uint32_t>(ct), ledger, index));
+}
+
+Json::Value
+response(Json::Value const& request, Json::Value result)
+{
+    Json::Value jv;
+    jv[jss::id] = request[jss::id];
+    jv[jss::result] = std::move(result);
+    jv[jss::status] = jss::success;
+    jv[jss::type] = jss::response;
+    return jv;
+}
+
+Json::Value
+errorResponse(Json::Value const& request, std::string const& token)
+{
+    Json::Value jv;
+    jv[jss::id] = request[jss::id];
+    jv[jss::error] = token;
+    jv[jss::status] = jss::error;
+    jv[jss::type] = jss::response;
+    return jv;
+}
+
+ripple::AccountID
+accountParam(Json::Value const& params)
+{
+    auto const account =
+        ripple::parseBase58<ripple::AccountID>(params[jss::account].asString());
+    if (!account)
+        throw std::runtime_error("actMalformed");
+    return *account;
+}
+
+bool
+isAttestation(Json::Value const& tx)
+{
+    auto const type = tx[jss::TransactionType].asString();
+    return type == jss::XChainAddClaimAttestation.c_str() ||
+        type == jss::XChainAddAccountCreateAttestation.c_str();
+}
+
+}  // namespace
+
+MockChain::MockChain(
+    ChainType ct,
+    config::Config const& config,
+    Options const& opts,
+    Tracker& tracker)
+    : chainType_(ct)
+    , opts_(opts)
+    , tracker_(tracker)
+    , bridge_(config.bridge)
+    , door_(bridge_.door(ct))
+    , witnessSigner_(witnessSigner(config))
+    , user_(userAccount())
+    , bridgeJson_(bridge_.getJson(ripple::JsonOptions::none))
+    , rng_(static_cast<std::uint32_t>(ct) + 1)
+    , submitError_(opts.submitErrorRate)
+{
+    Json::Value tx;
+    tx[jss::Account] = ripple::toBase58(door_);
+    tx[jss::Fee] = "10";
+    tx[jss::Flags] = 0u;
+    tx[ripple::sfMinAccountCreateAmount.getJsonName()] = "10000000";
+    tx[jss::Sequence] = 1u;
+    tx[ripple::sfSignatureReward.getJsonName()] = "100";
+    tx[jss::SigningPubKey] = "";
+    tx[jss::TransactionType] = jss::XChainCreateBridge;
+    tx[ripple::sfXChainBridge.getJsonName()] = bridgeJson_;
+    tx[jss::hash] = makeHash(ct, firstLedger, 0);
+    tx[jss::ledger_index] = firstLedger;
+
+    Json::Value meta;
+    meta[ripple::sfAffectedNodes.getJsonName()] = Json::arrayValue;
+    meta[ripple::sfTransactionIndex.getJsonName()] = 0u;
+    meta[ripple::sfTransactionResult.getJsonName()] = "tesSUCCESS";
+
+    createBridge_[jss::meta] = std::move(meta);
+    createBridge_[jss::tx] = std::move(tx);
+    createBridge_[jss::validated] = true;
+}
+
+Json::Value
+MockChain::process(Json::Value const& request)
+{
+    auto const method = request[jss::method].asString();
+    try
+    {
+        if (method == "server_info")
+            return response(request, serverInfo());
+        if (method == "account_info")
+            return response(request, accountInfo(request));
+        if (method == "subscribe")
+            return response(request, ledgerFields());
+        if (method == "ledger_entry")
+            return response(request, ledgerEntry());
+        if (method == "account_tx")
+            return response(request, accountTx(request));
+        if (method == "account_objects")
+            return response(request, accountObjects(request));
+        if (method == "submit")
+            return response(request, submit(request));
+        if (method == "ledger_request")
+            return response(request, Json::Value(Json::objectValue));
+        if (method == "fee")
+        {
+            Json::Value result;
+            result[jss::drops][jss::base_fee] = "10";
+            result[jss::drops][jss::open_ledger_fee] = "10";
+            result[jss::ledger_current_index] = ledger_ + 1;
+            return response(request, result);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        return errorResponse(request, e.what());
+    }
+    return errorResponse(request, "unknownCmd");
+}
+
+Json::Value
+MockChain::closeLedger(bool load)
+{
+    ++ledger_;
+
+    std::uint32_t index = 0;
+    for (auto& tx : submitted_)
+    {
+        if (isAttestation(tx))
+            ++tracker_.stats().confirmed;
+        auto const account = ripple::parseBase58<ripple::AccountID>(
+            tx[jss::Account].asString());
+        Json::Value meta;
+        meta[ripple::sfAffectedNodes.getJsonName()] = Json::arrayValue;
+        addTxn(*account, std::move(tx), std::move(meta), index++);
+    }
+    submitted_.clear();
+
+    if (load)
+    {
+        for (std::uint32_t i = 0; i < opts_.commitsPerLedger; ++i)
+            addCommit(index++, false);
+        for (std::uint32_t i = 0; i < opts_.createsPerLedger; ++i)
+            addCommit(index++, true);
+    }
+    trim();
+
+    auto jv = ledgerFields();
+    jv[jss::txn_count] = index;
+    jv[jss::type] = jss::ledgerClosed;
+    return jv;
+}
+
+Json::Value
+MockChain::ledgerFields() const
+{
+    Json::Value jv;
+    jv[jss::fee_base] = 10;
+    jv[jss::fee_ref] = 10;
+    jv[jss::ledger_hash] = to_string(
+        ripple::sha512Half(static_cast<std::uint32_t>(chainType_), ledger_));
+    jv[jss::ledger_index] = ledger_;
+    jv[jss::ledger_time] = ledger_;
+    jv[jss::reserve_base] = 10000000;
+    jv[jss::reserve_inc] = 2000000;
+    jv[jss::validated_ledgers] = fmt::format("{}-{}", firstLedger, ledger_);
+    return jv;
+}
+
+Json::Value
+MockChain::serverInfo() const
+{
+    Json::Value result;
+    auto& info = result[jss::info];
+    info[jss::build_version] = "loadgen";
+    info[jss::complete_ledgers] = fmt::format("{}-{}", firstLedger, ledger_);
+    info[jss::server_state] = "full";
+    info[jss::validated_ledger][jss::seq] = ledger_;
+    return result;
+}
+
+Json::Value
+MockChain::accountInfo(Json::Value const& params)
+{
+    auto const account = accountParam(params);
+
+    Json::Value data;
+    data[jss::Account] = ripple::toBase58(account);
+    data[ripple::sfBalance.getJsonName()] = "100000000000";
+    data[jss::Flags] = 0u;
+    data[ripple::sfLedgerEntryType.getJsonName()] = jss::AccountRoot;
+    data[ripple::sfOwnerCount.getJsonName()] = 0u;
+    data[jss::Sequence] = sequences_.try_emplace(account, 1).first->second;
+    if (account == door_)
+    {
+        // The witness is the only signer of the door
+        Json::Value entry;
+        entry[ripple::sfSignerEntry.getJsonName()][jss::Account] =
+            ripple::toBase58(witnessSigner_);
+        entry[ripple::sfSignerEntry.getJsonName()]
+             [ripple::sfSignerWeight.getJsonName()] = 1u;
+
+        Json::Value list;
+        list[jss::Flags] = 0u;
+        list[ripple::sfLedgerEntryType.getJsonName()] = jss::SignerList;
+        list[ripple::sfSignerEntries.getJsonName()].append(entry);
+        list[ripple::sfSignerListID.getJsonName()] = 0u;
+        list[ripple::sfSignerQuorum.getJsonName()] = 1u;
+        data[jss::signer_lists].append(list);
+    }
+
+    Json::Value result;
+    result[jss::account_data] = std::move(data);
+    result[jss::ledger_current_index] = ledger_ + 1;
+    result[jss::validated] = true;
+    return result;
+}
+
+Json::Value
+MockChain::ledgerEntry() const
+{
+    Json::Value node;
+    node[jss::Account] = ripple::toBase58(door_);
+    node[jss::Flags] = 0u;
+    node[ripple::sfLedgerEntryType.getJsonName()] = jss::Bridge;
+    node[ripple::sfMinAccountCreateAmount.getJsonName()] = "10000000";
+    node[ripple::sfSignatureReward.getJsonName()] = "100";
+    node[ripple::sfXChainAccountClaimCount.getJsonName()] = "0";
+    node[ripple::sfXChainAccountCreateCount.getJsonName()] =
+        fmt::format("{:x}", createCount_);
+    node[ripple::sfXChainBridge.getJsonName()] = bridgeJson_;
+    node[ripple::sfXChainClaimID.getJsonName()] =
+        fmt::format("{:x}", claimID_);
+
+    Json::Value result;
+    result[jss::ledger_current_index] = ledger_ + 1;
+    result[jss::node] = std::move(node);
+    result[jss::validated] = false;
+    return result;
+}
+
+Json::Value
+MockChain::accountTx(Json::Value const& params)
+{
+    auto const account = accountParam(params);
+    auto bound = [&](Json::StaticString const& field, std::uint32_t dflt) {
+        auto const& v = params[field];
+        return v.isIntegral() && v.asInt() >= 0 ? v.asUInt() : dflt;
+    };
+    std::uint32_t const minLedger = bound(jss::ledger_index_min, firstLedger);
+    std::uint32_t const maxLedger = bound(jss::ledger_index_max, ledger_);
+    bool const forward = params[jss::forward].asBool();
+    std::uint32_t const limit = params[jss::limit].isIntegral()
+        ? std::clamp(params[jss::limit].asUInt(), 1u, 1000u)
+        : 200u;
+    // Stable while the bounds don't change, an offset is enough
+    std::uint32_t const offset =
+        params[jss::marker].isIntegral() ? params[jss::marker].asUInt() : 0;
+
+    // The history is read backward, the new transactions forward
+    if (account == door_ && forward)
+        synced_ = true;
+
+    std::vector<Json::Value const*> matched;
+    if (account == door_ && minLedger <= firstLedger &&
+        firstLedger <= maxLedger)
+        matched.push_back(&createBridge_);
+    for (auto const& t : txns_[account])
+        if (t.ledger >= minLedger && t.ledger <= maxLedger)
+            matched.push_back(&t.entry);
+    if (!forward)
+        std::reverse(matched.begin(), matched.end());
+
+    Json::Value result;
+    result[jss::account] = ripple::toBase58(account);
+    result[jss::ledger_index_min] = minLedger;
+    result[jss::ledger_index_max] = maxLedger;
+    result[jss::limit] = limit;
+    auto& txns = result[jss::transactions] = Json::arrayValue;
+    std::size_t const end = std::min<std::size_t>(
+        matched.size(), static_cast<std::size_t>(offset) + limit);
+    for (std::size_t i = offset; i < end; ++i)
+        txns.append(*matched[i]);
+    if (end < matched.size())
+        result[jss::marker] = static_cast<std::uint32_t>(end);
+    result[jss::validated] = true;
+    return result;
+}
+
+Json::Value
+MockChain::accountObjects(Json::Value const& params) const
+{
+    auto const account = accountParam(params);
+
+    Json::Value result;
+    result[jss::account] = ripple::toBase58(account);
+    auto& objects = result[jss::account_objects] = Json::arrayValue;
+    if (auto const it = tickets_.find(account); it != tickets_.end())
+    {
+        for (auto const t : it->second)
+        {
+            Json::Value o;
+            o[jss::Account] = ripple::toBase58(account);
+            o[ripple::sfLedgerEntryType.getJsonName()] = jss::Ticket;
+            o[ripple::sfTicketSequence.getJsonName()] = t;
+            objects.append(o);
+        }
+    }
+    result[jss::ledger_current_index] = ledger_ + 1;
+    result[jss::validated] = true;
+    return result;
+}
+
+Json::Value
+MockChain::submit(Json::Value const& params)
+{
+    auto const blob = ripple::strUnHex(params[jss::tx_blob].asString());
+    if (!blob)
+        throw std::runtime_error("invalidTransaction");
+    ripple::SerialIter sit(ripple::makeSlice(*blob));
+    ripple::STTx const tx(sit);
+
+    auto txJson = tx.getJson(ripple::JsonOptions::none);
+    txJson[jss::hash] = to_string(tx.getTransactionID());
+
+    Json::Value result;
+    result[jss::tx_blob] = params[jss::tx_blob];
+    result[jss::tx_json] = txJson;
+
+    auto const type = tx.getTxnType();
+    bool const claim = type == ripple::ttXCHAIN_ADD_CLAIM_ATTESTATION;
+    bool const create = type == ripple::ttXCHAIN_ADD_ACCOUNT_CREATE_ATTESTATION;
+    if ((claim || create) && submitError_(rng_))
+    {
+        // Nothing is applied, the witness resubmits after the TTL
+        ++tracker_.stats().submitErrors;
+        result[jss::engine_result] =
+            ripple::transToken(ripple::telCAN_NOT_QUEUE_FULL);
+        result[jss::engine_result_code] =
+            ripple::TERtoInt(ripple::telCAN_NOT_QUEUE_FULL);
+        return result;
+    }
+
+    // Any sequence is accepted, the mock does not check the order
+    auto const account = tx.getAccountID(ripple::sfAccount);
+    auto const seq = tx.getFieldU32(ripple::sfSequence);
+    auto& next = sequences_.try_emplace(account, 1).first->second;
+    if (seq)
+        next = std::max(next, seq + 1);
+    else if (tx.isFieldPresent(ripple::sfTicketSequence))
+        tickets_[account].erase(tx.getFieldU32(ripple::sfTicketSequence));
+
+    if (type == ripple::ttTICKET_CREATE)
+    {
+        auto const count = tx.getFieldU32(ripple::sfTicketCount);
+        for (std::uint32_t i = 1; i <= count; ++i)
+            tickets_[account].insert(seq + i);
+        next = std::max(next, seq + count + 1);
+    }
+
+    if (claim || create)
+    {
+        auto const id = claim
+            ? tx.getFieldU64(ripple::sfXChainClaimID)
+            : tx.getFieldU64(ripple::sfXChainAccountCreateCount);
+        if (!tracker_.attested(create, id, clock::now()))
+            ++tracker_.stats().resubmits;
+    }
+
+    submitted_.push_back(std::move(txJson));
+    result[jss::accepted] = true;
+    result[jss::applied] = true;
+    result[jss::engine_result] = "tesSUCCESS";
+    result[jss::engine_result_code] = 0;
+    return result;
+}
+
+void
+MockChain::addCommit(std::uint32_t index, bool createAccount)
+{
+    auto const user = ripple::toBase58(user_);
+
+    Json::Value tx;
+    tx[jss::Account] = user;
+    tx[jss::Fee] = "10";
+    tx[jss::Flags] = 0u;
+    tx[jss::Sequence] = userSeq_++;
+    tx[jss::SigningPubKey] = "";
+    tx[ripple::sfXChainBridge.getJsonName()] = bridgeJson_;
+
+    Json::Value meta;
+    auto& nodes = meta[ripple::sfAffectedNodes.getJsonName()] =
+        Json::arrayValue;
+
+    std::uint64_t id = 0;
+    if (createAccount)
+    {
+        id = ++createCount_;
+        tx[jss::TransactionType] = jss::XChainAccountCreateCommit;
+        tx[jss::Amount] = "20000000";
+        tx[ripple::sfDestination.getJsonName()] = user;
+        tx[ripple::sfSignatureReward.getJsonName()] = "100";
+
+        // The create count is read from the bridge
+        Json::Value node;
+        node[ripple::sfLedgerEntryType.getJsonName()] = jss::Bridge;
+        node[ripple::sfFinalFields.getJsonName()]
+            [ripple::sfXChainAccountCreateCount.getJsonName()] =
+                fmt::format("{:x}", id);
+        Json::Value modified;
+        modified[ripple::sfModifiedNode.getJsonName()] = std::move(node);
+        nodes.append(modified);
+    }
+    else
+    {
+        id = ++claimID_;
+        tx[jss::TransactionType] = jss::XChainCommit;
+        tx[jss::Amount] = "1000000";
+        tx[ripple::sfOtherChainDestination.getJsonName()] = user;
+        tx[ripple::sfXChainClaimID.getJsonName()] = fmt::format("{:x}", id);
+    }
+    meta[jss::delivered_amount] = tx[jss::Amount];
+
+    addTxn(door_, std::move(tx), std::move(meta), index);
+    tracker_.committed(createAccount, id, clock::now());
+}
+
+void
+MockChain::addTxn(
+    ripple::AccountID const& account,
+    Json::Value tx,
+    Json::Value meta,
+    std::uint32_t index)
+{
+    if (!tx.isMember(jss::hash))
+        tx[jss::hash] = makeHash(chainType_, ledger_, index);
+    tx[jss::ledger_index] = ledger_;
+    meta[ripple::sfTransactionIndex.getJsonName()] = index;
+    meta[ripple::sfTransactionResult.getJsonName()] = "tesSUCCESS";
+
+    Json::Value entry;
+    entry[jss::meta] = std::move(meta);
+    entry[jss::tx] = std::move(tx);
+    entry[jss::validated] = true;
+    txns_[account].push_back({ledger_, std::move(entry)});
+}
+
+void
+MockChain::trim()
+{
+    if (ledger_ <= keepLedgers)
+        return;
+    auto const oldest = ledger_ - keepLedgers;
+    for (auto& [_, txns] : txns_)
+        while (!txns.empty() && txns.front().ledger < oldest)
+            txns.pop_front();
+}
+
+}  // namespace loadgen
+}  // namespace xbwd
@@ -0,0 +1,225 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <loadgen/LoadGen.h>
+
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+
+#include <boost/asio/buffer.hpp>
+#include <boost/beast/core/bind_handler.hpp>
+#include <boost/beast/core/buffers_to_string.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <iostream>
+
+namespace xbwd {
+namespace loadgen {
+
+namespace websocket = boost::beast::websocket;
+using tcp = boost::asio::ip::tcp;
+
+namespace {
+
+void
+logError(ChainType ct, boost::beast::error_code ec, char const* what)
+{
+    std::cerr << to_string(ct) << " " << what << ": " << ec.message()
+              << std::endl;
+}
+
+}  // namespace
+
+Session::Session(tcp::socket&& socket, MockChain& chain, Tracker& tracker)
+    : ws_(std::move(socket)), chain_(chain), tracker_(tracker)
+{
+}
+
+void
+Session::run()
+{
+    ws_.set_option(websocket::stream_base::timeout::suggested(
+        boost::beast::role_type::server));
+    ws_.async_accept(boost::beast::bind_front_handler(
+        &Session::onAccept, shared_from_this()));
+}
+
+void
+Session::send(std::string msg)
+{
+    if (!open_)
+        return;
+    writes_.push_back(std::move(msg));
+    if (writes_.size() == 1)
+        doWrite();
+}
+
+void
+Session::close()
+{
+    if (!open_)
+        return;
+    open_ = false;
+    ++tracker_.stats().disconnects;
+    ws_.async_close(
+        websocket::close_code::going_away,
+        [self = shared_from_this()](boost::beast::error_code) {});
+}
+
+void
+Session::onAccept(boost::beast::error_code ec)
+{
+    if (ec)
+        return logError(chain_.chainType(), ec, "accept");
+    open_ = true;
+    ++tracker_.stats().connects;
+    doRead();
+}
+
+void
+Session::doRead()
+{
+    ws_.async_read(
+        buffer_,
+        boost::beast::bind_front_handler(&Session::onRead, shared_from_this()));
+}
+
+void
+Session::onRead(boost::beast::error_code ec, std::size_t)
+{
+    if (ec)
+    {
+        if (open_ && ec != websocket::error::closed)
+            logError(chain_.chainType(), ec, "read");
+        open_ = false;
+        return;
+    }
+
+    Json::Value request;
+    Json::Reader().parse(
+        boost::beast::buffers_to_string(buffer_.data()), request);
+    buffer_.consume(buffer_.size());
+    send(to_string(chain_.process(request)));
+    doRead();
+}
+
+void
+Session::doWrite()
+{
+    ws_.text(true);
+    ws_.async_write(
+        boost::asio::buffer(writes_.front()),
+        boost::beast::bind_front_handler(
+            &Session::onWrite, shared_from_this()));
+}
+
+void
+Session::onWrite(boost::beast::error_code ec, std::size_t)
+{
+    if (ec)
+    {
+        if (open_)
+            logError(chain_.chainType(), ec, "write");
+        open_ = false;
+        writes_.clear();
+        return;
+    }
+
+    writes_.pop_front();
+    if (open_ && !writes_.empty())
+        doWrite();
+}
+
+//------------------------------------------------------------------------------
+
+Listener::Listener(
+    boost::asio::io_context& ioc,
+    tcp::endpoint const& endpoint,
+    MockChain& chain,
+    Tracker& tracker)
+    : ioc_(ioc), acceptor_(ioc), chain_(chain), tracker_(tracker)
+{
+    acceptor_.open(endpoint.protocol());
+    acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor_.bind(endpoint);
+    acceptor_.listen(boost::asio::socket_base::max_listen_connections);
+}
+
+void
+Listener::run()
+{
+    doAccept();
+}
+
+void
+Listener::stop()
+{
+    boost::system::error_code ec;
+    acceptor_.close(ec);
+    for (auto const& w : sessions_)
+        if (auto s = w.lock())
+            s->close();
+    sessions_.clear();
+}
+
+void
+Listener::broadcast(std::string const& msg)
+{
+    for (auto const& w : sessions_)
+        if (auto s = w.lock())
+            s->send(msg);
+}
+
+void
+Listener::disconnect()
+{
+    for (auto const& w : sessions_)
+        if (auto s = w.lock())
+            s->close();
+}
+
+void
+Listener::doAccept()
+{
+    acceptor_.async_accept(
+        ioc_,
+        boost::beast::bind_front_handler(
+            &Listener::onAccept, shared_from_this()));
+}
+
+void
+Listener::onAccept(boost::beast::error_code ec, tcp::socket socket)
+{
+    if (ec == boost::asio::error::operation_aborted)
+        return;
+    if (ec)
+        logError(chain_.chainType(), ec, "listen");
+    else
+    {
+        std::erase_if(sessions_, [](auto const& w) { return w.expired(); });
+        auto session =
+            std::make_shared<Session>(std::move(socket), chain_, tracker_);
+        sessions_.push_back(session);
+        session->run();
+    }
+    doAccept();
+}
+
+}  // namespace loadgen
+}  // namespace xbwd
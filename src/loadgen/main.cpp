@@ -0,0 +1,393 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <loadgen/LoadGen.h>
+
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace xbwd {
+namespace loadgen {
+
+namespace {
+
+char const* const usage =
+    "xbridge_witness_loadgen --conf <witness config> [options]\n"
+    "  --commits <n>            commits per locking chain ledger (10)\n"
+    "  --creates <n>            account creates per ledger (0)\n"
+    "  --ledger-ms <ms>         ledger interval (1000)\n"
+    "  --duration <s>           load time after the witness sync (60)\n"
+    "  --drain <n>              ledgers closed after the load (10)\n"
+    "  --disconnect-every <s>   close the witness connections (0 - never)\n"
+    "  --submit-error-rate <f>  attestations refused, in [0, 1] (0)\n"
+    "  --report <s>             interim report interval (10)\n"
+    "  --pid <pid>              witness process to sample the memory of\n";
+
+// Kilobytes of a /proc/<pid>/status field, nullopt if not readable
+std::optional<std::uint64_t>
+procStatus(int pid, std::string_view field)
+{
+    if (!pid)
+        return {};
+    std::ifstream f("/proc/" + std::to_string(pid) + "/status");
+    std::string line;
+    while (std::getline(f, line))
+    {
+        if (line.starts_with(field) && line.size() > field.size() &&
+            line[field.size()] == ':')
+        {
+            std::istringstream is(line.substr(field.size() + 1));
+            std::uint64_t kb = 0;
+            if (is >> kb)
+                return kb;
+        }
+    }
+    return {};
+}
+
+std::string
+memory(int pid, std::string_view field)
+{
+    auto const kb = procStatus(pid, field);
+    if (!kb)
+        return "n/a";
+    return std::to_string(*kb / 1024) + "MB";
+}
+
+Options
+parseArgs(int argc, char** argv, std::string& conf)
+{
+    Options opts;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view const arg = argv[i];
+        if (arg == "--help" || arg == "-h")
+        {
+            std::cerr << usage;
+            std::exit(EXIT_SUCCESS);
+        }
+        if (i + 1 >= argc)
+            throw std::runtime_error(
+                "missing value for " + std::string(arg));
+        std::string const value = argv[++i];
+
+        if (arg == "--conf")
+            conf = value;
+        else if (arg == "--commits")
+            opts.commitsPerLedger = std::stoul(value);
+        else if (arg == "--creates")
+            opts.createsPerLedger = std::stoul(value);
+        else if (arg == "--ledger-ms")
+            opts.ledgerInterval = std::chrono::milliseconds(std::stoul(value));
+        else if (arg == "--duration")
+            opts.duration = std::chrono::seconds(std::stoul(value));
+        else if (arg == "--drain")
+            opts.drainLedgers = std::stoul(value);
+        else if (arg == "--disconnect-every")
+            opts.disconnectInterval = std::chrono::seconds(std::stoul(value));
+        else if (arg == "--submit-error-rate")
+            opts.submitErrorRate = std::stod(value);
+        else if (arg == "--report")
+            opts.reportInterval = std::chrono::seconds(std::stoul(value));
+        else if (arg == "--pid")
+            opts.witnessPid = std::stoi(value);
+        else
+            throw std::runtime_error("unknown option " + std::string(arg));
+    }
+
+    if (conf.empty())
+        throw std::runtime_error("--conf is required");
+    if (opts.ledgerInterval.count() <= 0)
+        throw std::runtime_error("--ledger-ms must be positive");
+    if (opts.submitErrorRate < 0 || opts.submitErrorRate > 1)
+        throw std::runtime_error("--submit-error-rate must be in [0, 1]");
+    return opts;
+}
+
+config::Config
+loadConfig(std::string const& file)
+{
+    std::ifstream f(file);
+    Json::Value jv;
+    if (!f || !Json::Reader().parse(f, jv))
+        throw std::runtime_error("can't read " + file);
+    return config::Config(jv);
+}
+
+double
+seconds(clock::duration d)
+{
+    return std::chrono::duration<double>(d).count();
+}
+
+// Drive the ledgers of both chains and report
+class Driver
+{
+    enum class Phase { waitSync, load, drain, done };
+
+    boost::asio::io_context& ioc_;
+    Options const& opts_;
+    Tracker& tracker_;
+    MockChain& locking_;
+    MockChain& issuing_;
+    std::shared_ptr<Listener> lockingListener_;
+    std::shared_ptr<Listener> issuingListener_;
+
+    boost::asio::steady_timer ledgerTimer_;
+    boost::asio::steady_timer disconnectTimer_;
+    boost::asio::steady_timer reportTimer_;
+
+    Phase phase_ = Phase::waitSync;
+    clock::time_point const start_ = clock::now();
+    clock::time_point loadStart_;
+    clock::time_point loadEnd_;
+    std::uint32_t drained_ = 0;
+    std::uint64_t ledgers_ = 0;
+
+public:
+    Driver(
+        boost::asio::io_context& ioc,
+        Options const& opts,
+        Tracker& tracker,
+        MockChain& locking,
+        MockChain& issuing,
+        std::shared_ptr<Listener> lockingListener,
+        std::shared_ptr<Listener> issuingListener)
+        : ioc_(ioc)
+        , opts_(opts)
+        , tracker_(tracker)
+        , locking_(locking)
+        , issuing_(issuing)
+        , lockingListener_(std::move(lockingListener))
+        , issuingListener_(std::move(issuingListener))
+        , ledgerTimer_(ioc)
+        , disconnectTimer_(ioc)
+        , reportTimer_(ioc)
+    {
+    }
+
+    void
+    run()
+    {
+        schedule(ledgerTimer_, opts_.ledgerInterval, [this] { onLedger(); });
+        if (opts_.disconnectInterval.count())
+            schedule(disconnectTimer_, opts_.disconnectInterval, [this] {
+                onDisconnect();
+            });
+        if (opts_.reportInterval.count())
+            schedule(reportTimer_, opts_.reportInterval, [this] {
+                onReport();
+            });
+    }
+
+    void
+    stop()
+    {
+        if (phase_ != Phase::done && phase_ != Phase::waitSync)
+            loadEnd_ = std::min(loadEnd_, clock::now());
+        phase_ = Phase::done;
+        ledgerTimer_.cancel();
+        disconnectTimer_.cancel();
+        reportTimer_.cancel();
+        lockingListener_->stop();
+        issuingListener_->stop();
+    }
+
+    void
+    summary()
+    {
+        auto const& s = tracker_.stats();
+        double const loadTime = loadStart_ == clock::time_point{}
+            ? 0
+            : seconds(loadEnd_ - loadStart_);
+        auto ms = [&](double p) {
+            return tracker_.latencyPercentile(p) / 1000.0;
+        };
+
+        std::cout << std::fixed << std::setprecision(1) << "\nsummary\n"
+                  << "  ledgers          " << ledgers_ << "\n"
+                  << "  commits          " << s.commits << "\n"
+                  << "  creates          " << s.creates << "\n"
+                  << "  attested         " << s.attested << "\n"
+                  << "  not attested     " << tracker_.pending() << "\n"
+                  << "  sustained att/s  "
+                  << (loadTime > 0 ? s.attested / loadTime : 0.0) << "\n"
+                  << "  latency ms       p50 " << ms(0.5) << " p90 " << ms(0.9)
+                  << " p99 " << ms(0.99) << " max " << ms(1.0) << "\n"
+                  << "  submit errors    " << s.submitErrors << "\n"
+                  << "  resubmits        " << s.resubmits << "\n"
+                  << "  confirmed        " << s.confirmed << "\n"
+                  << "  disconnects      " << s.disconnects << "\n"
+                  << "  connects         " << s.connects << "\n"
+                  << "  peak RSS         " << memory(opts_.witnessPid, "VmHWM")
+                  << std::endl;
+    }
+
+private:
+    template <class F>
+    void
+    schedule(boost::asio::steady_timer& t, clock::duration d, F f)
+    {
+        t.expires_after(d);
+        t.async_wait([this, &t, d, f](boost::system::error_code ec) {
+            if (ec || phase_ == Phase::done)
+                return;
+            f();
+            if (phase_ != Phase::done)
+                schedule(t, d, f);
+        });
+    }
+
+    void
+    onLedger()
+    {
+        auto const now = clock::now();
+        if (phase_ == Phase::waitSync && locking_.synced() &&
+            issuing_.synced())
+        {
+            phase_ = Phase::load;
+            loadStart_ = now;
+            loadEnd_ = now + opts_.duration;
+            std::cout << "witness synced after " << std::setprecision(1)
+                      << std::fixed << seconds(now - start_)
+                      << "s, load started" << std::endl;
+        }
+        if (phase_ == Phase::load && now >= loadEnd_)
+        {
+            phase_ = Phase::drain;
+            std::cout << "load finished, draining" << std::endl;
+        }
+
+        bool const load = phase_ == Phase::load;
+        lockingListener_->broadcast(to_string(locking_.closeLedger(load)));
+        issuingListener_->broadcast(to_string(issuing_.closeLedger(false)));
+        ++ledgers_;
+
+        if (phase_ == Phase::drain &&
+            (++drained_ > opts_.drainLedgers || !tracker_.pending()))
+        {
+            stop();
+            ioc_.stop();
+        }
+    }
+
+    void
+    onDisconnect()
+    {
+        lockingListener_->disconnect();
+        issuingListener_->disconnect();
+    }
+
+    void
+    onReport()
+    {
+        auto const& s = tracker_.stats();
+        auto const elapsed = seconds(clock::now() - start_);
+        double const loadTime = phase_ == Phase::waitSync
+            ? 0
+            : seconds(std::min(clock::now(), loadEnd_) - loadStart_);
+        std::cout << std::fixed << std::setprecision(1) << "[" << elapsed
+                  << "s] ledgers " << ledgers_ << " commits "
+                  << s.commits + s.creates << " attested " << s.attested
+                  << " att/s " << (loadTime > 0 ? s.attested / loadTime : 0.0)
+                  << " pending " << tracker_.pending() << " errors "
+                  << s.submitErrors << " resubmits " << s.resubmits
+                  << " reconnects " << s.disconnects << " RSS "
+                  << memory(opts_.witnessPid, "VmRSS") << std::endl;
+    }
+};
+
+}  // namespace
+
+}  // namespace loadgen
+}  // namespace xbwd
+
+int
+main(int argc, char** argv)
+{
+    using namespace xbwd::loadgen;
+
+    try
+    {
+        std::string conf;
+        auto const opts = parseArgs(argc, argv, conf);
+        auto const config = loadConfig(conf);
+
+        Tracker tracker;
+        MockChain locking(xbwd::ChainType::locking, config, opts, tracker);
+        MockChain issuing(xbwd::ChainType::issuing, config, opts, tracker);
+
+        boost::asio::io_context ioc;
+        auto listen = [&](MockChain& chain,
+                          xbwd::config::ChainConfig const& cc) {
+            boost::asio::ip::tcp::endpoint const ep(
+                boost::asio::ip::make_address(cc.addrChainIp.host),
+                cc.addrChainIp.port);
+            auto l = std::make_shared<Listener>(ioc, ep, chain, tracker);
+            l->run();
+            std::cout << to_string(chain.chainType()) << " chain on " << ep
+                      << std::endl;
+            return l;
+        };
+        auto lockingListener = listen(locking, config.lockingChainConfig);
+        auto issuingListener = listen(issuing, config.issuingChainConfig);
+
+        Driver driver(
+            ioc,
+            opts,
+            tracker,
+            locking,
+            issuing,
+            lockingListener,
+            issuingListener);
+        driver.run();
+
+        boost::asio::signal_set signals(ioc, SIGINT, SIGTERM);
+        signals.async_wait([&](boost::system::error_code ec, int) {
+            if (ec)
+                return;
+            driver.stop();
+            ioc.stop();
+        });
+
+        ioc.run();
+        driver.summary();
+    }
+    catch (std::exception const& e)
+    {
+        std::cerr << "loadgen failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
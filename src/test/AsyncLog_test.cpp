@@ -0,0 +1,215 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/AsyncLog.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xbwd {
+namespace tests {
+
+namespace {
+
+// Collects the lines written. The first write may be held, to keep the log
+// thread busy while the ring of the test fills up.
+class CaptureSink : public beast::Journal::Sink
+{
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::vector<std::string> lines_;
+    bool hold_ = false;
+    bool holding_ = false;
+
+public:
+    CaptureSink() : Sink(beast::severities::kTrace, false)
+    {
+    }
+
+    void
+    write(beast::severities::Severity, std::string const& text) override
+    {
+        std::unique_lock l{m_};
+        lines_.push_back(text);
+        if (hold_)
+        {
+            holding_ = true;
+            cv_.notify_all();
+            cv_.wait(l, [this] { return !hold_; });
+        }
+    }
+
+    void
+    writeAlways(beast::severities::Severity level, std::string const& text)
+        override
+    {
+        write(level, text);
+    }
+
+    void
+    hold()
+    {
+        std::lock_guard l{m_};
+        hold_ = true;
+    }
+
+    // Wait for the log thread to be held in write()
+    void
+    waitHeld()
+    {
+        std::unique_lock l{m_};
+        cv_.wait(l, [this] { return holding_; });
+    }
+
+    void
+    release()
+    {
+        {
+            std::lock_guard l{m_};
+            hold_ = false;
+        }
+        cv_.notify_all();
+    }
+
+    std::vector<std::string>
+    take()
+    {
+        std::lock_guard l{m_};
+        return std::move(lines_);
+    }
+};
+
+}  // namespace
+
+class AsyncLog_test : public beast::unit_test::suite
+{
+    void
+    testOrder()
+    {
+        testcase("Order");
+
+        CaptureSink sink;
+        beast::Journal j{sink};
+        {
+            AsyncLog log(16, j);
+            BEAST_EXPECT(AsyncLog::active() == &log);
+            for (std::int64_t i = 0; i < 3; ++i)
+                log.push(
+                    j.info(),
+                    "msg",
+                    {{"i", i, false}, {"s", std::string("x"), true}});
+        }
+        BEAST_EXPECT(!AsyncLog::active());
+
+        // The messages of a thread are written in order, formatted as the
+        // synchronous JLOGV
+        auto const lines = sink.take();
+        if (BEAST_EXPECT(lines.size() == 3))
+        {
+            BEAST_EXPECT(lines[0] == R"(msg {"i": 0, "s": "x"})");
+            BEAST_EXPECT(lines[1] == R"(msg {"i": 1, "s": "x"})");
+            BEAST_EXPECT(lines[2] == R"(msg {"i": 2, "s": "x"})");
+        }
+    }
+
+    void
+    testDropped()
+    {
+        testcase("Dropped");
+
+        CaptureSink sink;
+        beast::Journal j{sink};
+        {
+            AsyncLog log(2, j);
+            sink.hold();
+            log.push(j.info(), "first", {});
+            sink.waitHeld();
+
+            // The ring holds 2, the log thread is busy with the first
+            for (int i = 0; i < 5; ++i)
+                log.push(j.info(), "next", {});
+            BEAST_EXPECT(log.dropped() == 3);
+            sink.release();
+        }
+
+        auto const lines = sink.take();
+        auto const count = [&lines](char const* text) {
+            return std::count_if(
+                lines.begin(), lines.end(), [text](auto const& line) {
+                    return line.find(text) != std::string::npos;
+                });
+        };
+        // The 3 written and the report of the dropped
+        BEAST_EXPECT(lines.size() == 4);
+        BEAST_EXPECT(!lines.empty() && lines[0].find("first") == 0);
+        BEAST_EXPECT(count("next") == 2);
+        BEAST_EXPECT(count("dropped 3 messages") == 1);
+    }
+
+    void
+    testStop()
+    {
+        testcase("Stop");
+
+        CaptureSink sink;
+        beast::Journal j{sink};
+        {
+            AsyncLog log(64, j);
+            // The ring of a thread gone is written out
+            std::thread t([&] {
+                for (int i = 0; i < 10; ++i)
+                    log.push(j.info(), "thread", {});
+            });
+            t.join();
+            // Pushed right before the stop
+            for (int i = 0; i < 10; ++i)
+                log.push(j.info(), "main", {});
+        }
+        auto const lines = sink.take();
+        BEAST_EXPECT(lines.size() == 20);
+
+        // A new instance has new rings for the same threads
+        {
+            AsyncLog log(64, j);
+            log.push(j.info(), "again", {});
+        }
+        auto const again = sink.take();
+        BEAST_EXPECT(again.size() == 1 && again[0].find("again") == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrder();
+        testDropped();
+        testStop();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AsyncLog, basics, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/federator/AttestCoalescer.h>
+
+#include <ripple/beast/unit_test.h>
+
+namespace xbwd {
+namespace tests {
+
+class AttestCoalescer_test : public beast::unit_test::suite
+{
+private:
+    void
+    testNoDelay()
+    {
+        testcase("No delay");
+
+        // One attestation per transaction, always submitted
+        AttestCoalescer single(1, 0, 0);
+        BEAST_EXPECT(single.target() == 1);
+        BEAST_EXPECT(single.onAdd(1, 10, false));
+        BEAST_EXPECT(single.flushes(AttestCoalescer::fr_size) == 1);
+
+        AttestCoalescer c(8, 0, 0);
+        BEAST_EXPECT(c.target() == 8);
+        BEAST_EXPECT(!c.onAdd(1, 10, false));
+        BEAST_EXPECT(c.onAdd(2, 10, true));
+        BEAST_EXPECT(c.flushes(AttestCoalescer::fr_boundary) == 1);
+
+        // Every new ledger submits a non empty batch
+        BEAST_EXPECT(!c.onLedger(0, 11));
+        BEAST_EXPECT(c.onLedger(1, 11));
+
+        for (std::size_t n = 1; n < 8; ++n)
+            BEAST_EXPECT(!c.onAdd(n, 12, false));
+        BEAST_EXPECT(c.onAdd(8, 12, false));
+        BEAST_EXPECT(c.flushes(AttestCoalescer::fr_size) == 1);
+        BEAST_EXPECT(c.flushes(AttestCoalescer::fr_boundary) == 2);
+        BEAST_EXPECT(c.attestations() == 11);
+    }
+
+    void
+    testDelay()
+    {
+        testcase("Delay");
+
+        AttestCoalescer c(8, 4, 3);
+        BEAST_EXPECT(c.target() == 4);
+        BEAST_EXPECT(c.maxDelay() == 3);
+
+        // The ledger boundaries don't submit, the target does
+        BEAST_EXPECT(!c.onAdd(1, 10, true));
+        BEAST_EXPECT(!c.onLedger(1, 11));
+        BEAST_EXPECT(!c.onAdd(2, 11, true));
+        BEAST_EXPECT(!c.onAdd(3, 12, true));
+        BEAST_EXPECT(c.onAdd(4, 12, false));
+        BEAST_EXPECT(c.flushes(AttestCoalescer::fr_size) == 1);
+
+        // The deadline runs from the oldest attestation of the batch
+        BEAST_EXPECT(!c.onAdd(1, 20, true));
+        BEAST_EXPECT(!c.onLedger(1, 21));
+        BEAST_EXPECT(!c.onAdd(2, 22, false));
+        BEAST_EXPECT(c.onLedger(2, 23));
+        BEAST_EXPECT(c.flushes(AttestCoalescer::fr_deadline) == 1);
+
+        // An attestation added past the deadline submits too
+        BEAST_EXPECT(!c.onAdd(1, 30, false));
+        BEAST_EXPECT(c.onAdd(2, 33, false));
+        BEAST_EXPECT(c.flushes(AttestCoalescer::fr_deadline) == 2);
+        BEAST_EXPECT(c.flushes(AttestCoalescer::fr_boundary) == 0);
+
+        // The target is within the cap
+        AttestCoalescer capped(8, 100, 3);
+        BEAST_EXPECT(capped.target() == 8);
+    }
+
+    void
+    testSizes()
+    {
+        testcase("Sizes");
+
+        AttestCoalescer c(64, 0, 0);
+        BEAST_EXPECT(c.onLedger(1, 1));
+        BEAST_EXPECT(c.onLedger(1, 2));
+        BEAST_EXPECT(c.onLedger(3, 3));
+        BEAST_EXPECT(c.onLedger(AttestCoalescer::SizeBuckets, 4));
+        BEAST_EXPECT(c.onLedger(40, 5));
+        BEAST_EXPECT(c.batches(1) == 2);
+        BEAST_EXPECT(c.batches(2) == 0);
+        BEAST_EXPECT(c.batches(3) == 1);
+        BEAST_EXPECT(c.batches(AttestCoalescer::SizeBuckets) == 2);
+        BEAST_EXPECT(c.batches(40) == 2);
+        BEAST_EXPECT(c.attestations() == 45 + AttestCoalescer::SizeBuckets);
+    }
+
+public:
+    void
+    run() override
+    {
+        testNoDelay();
+        testDelay();
+        testSizes();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AttestCoalescer, federator, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/federator/AttestTracer.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <chrono>
+#include <vector>
+
+namespace xbwd {
+namespace tests {
+
+class AttestTracer_test : public beast::unit_test::suite
+{
+    using Key = AttestTracer::Key;
+
+private:
+    void
+    testStages()
+    {
+        testcase("Stages");
+
+        using namespace std::chrono_literals;
+
+        AttestTracer tracer(16, 4);
+        auto const t0 = AttestTracer::clock::now();
+        Key const claim{ChainType::issuing, false, 7};
+        Key const create{ChainType::issuing, true, 7};
+
+        tracer.start(claim, t0, t0 + 1ms);
+        tracer.start(create, t0, t0 + 1ms);
+        BEAST_EXPECT(tracer.active() == 2);
+
+        tracer.record(AttestTracer::st_dbCommitted, {claim}, t0 + 3ms);
+        tracer.record(AttestTracer::st_signed, {claim, create}, t0 + 2ms);
+        tracer.record(AttestTracer::st_submitted, {claim, create}, t0 + 4ms);
+        // Resubmitted
+        tracer.record(AttestTracer::st_signed, {claim}, t0 + 10ms);
+        tracer.record(AttestTracer::st_submitted, {claim}, t0 + 11ms);
+        BEAST_EXPECT(tracer.recent(10).empty());
+
+        // Unknown key is ignored
+        Key const other{ChainType::locking, false, 7};
+        tracer.record(AttestTracer::st_confirmed, {other, claim}, t0 + 20ms);
+        BEAST_EXPECT(tracer.active() == 1);
+
+        auto const traces = tracer.recent(10);
+        BEAST_EXPECT(traces.size() == 1);
+        if (traces.size() == 1)
+        {
+            auto const& t = traces.front();
+            BEAST_EXPECT(t.key == claim);
+            BEAST_EXPECT(t.submits == 2);
+            BEAST_EXPECT(*t.stages[AttestTracer::st_signed] == t0 + 10ms);
+            BEAST_EXPECT(*t.stages[AttestTracer::st_confirmed] == t0 + 20ms);
+        }
+
+        auto const total = tracer.total().snapshot();
+        BEAST_EXPECT(total.count == 1 && total.sum == 20'000);
+        auto const confirm =
+            tracer.latency(AttestTracer::st_confirmed).snapshot();
+        BEAST_EXPECT(confirm.count == 1 && confirm.sum == 9'000);
+        auto const db =
+            tracer.latency(AttestTracer::st_dbCommitted).snapshot();
+        BEAST_EXPECT(db.count == 1 && db.sum == 2'000);
+    }
+
+    void
+    testLimits()
+    {
+        testcase("Limits");
+
+        AttestTracer tracer(3, 2);
+        auto const now = AttestTracer::clock::now();
+        std::vector<Key> keys;
+        for (std::uint64_t i = 0; i < 5; ++i)
+        {
+            keys.push_back({ChainType::locking, false, i});
+            tracer.start(keys.back(), now, now);
+        }
+        // The oldest ones are dropped
+        BEAST_EXPECT(tracer.active() == 3);
+
+        tracer.record(AttestTracer::st_confirmed, keys);
+        BEAST_EXPECT(tracer.active() == 0);
+        BEAST_EXPECT(tracer.total().snapshot().count == 3);
+
+        auto const traces = tracer.recent(10);
+        BEAST_EXPECT(traces.size() == 2);
+        if (traces.size() == 2)
+        {
+            BEAST_EXPECT(traces[0].key.id == 4);
+            BEAST_EXPECT(traces[1].key.id == 3);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testStages();
+        testLimits();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AttestTracer, federator, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
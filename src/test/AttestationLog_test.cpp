@@ -0,0 +1,286 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/app/AttestationLog.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace xbwd {
+namespace tests {
+
+namespace {
+
+std::string const logDir = "test_attestation_log";
+
+AttestationRow
+makeRow(std::uint64_t id, std::uint32_t ledgerSeq, std::uint8_t txn)
+{
+    AttestationRow r;
+    r.txnHash = ripple::uint256(txn);
+    r.ledgerSeq = ledgerSeq;
+    r.id = id;
+    r.success = true;
+    r.amt = "amt" + std::to_string(id);
+    r.bridge = "bridge";
+    r.sendingAccount = "sender";
+    r.rewardAccount = "reward";
+    r.signingAccount = "signer";
+    r.publicKey = "pk";
+    r.signature = "sig" + std::to_string(id);
+    return r;
+}
+
+AttestationQuery
+makeQuery(AttestationRow const& r)
+{
+    return AttestationQuery{
+        r.id, r.amt, r.rewardAmt, r.bridge, r.sendingAccount, {}};
+}
+
+}  // namespace
+
+class AttestationLog_test : public beast::unit_test::suite
+{
+    beast::Journal j_{beast::Journal::getNullSink()};
+
+    std::unique_ptr<AttestationLog>
+    open(std::uint64_t segmentSize = 64 << 10)
+    {
+        return std::make_unique<AttestationLog>(
+            logDir, AttestationLog::Setup{segmentSize, 50}, j_);
+    }
+
+    void
+    testFind()
+    {
+        testcase("Find");
+        std::filesystem::remove_all(logDir);
+        auto db = open();
+
+        auto const r1 = makeRow(1, 10, 1);
+        auto r2 = makeRow(2, 20, 2);
+        r2.otherChainDst = "dst";
+        db->insert(ChainType::locking, false, r1);
+        db->insert(ChainType::locking, false, r2);
+
+        // Nothing is read before the commit of the batch
+        BEAST_EXPECT(!db->find(ChainType::locking, false, makeQuery(r1)));
+        db->commit();
+
+        auto found = db->find(ChainType::locking, false, makeQuery(r1));
+        BEAST_EXPECT(found && found->signature == r1.signature);
+        // Per table
+        BEAST_EXPECT(!db->find(ChainType::issuing, false, makeQuery(r1)));
+        BEAST_EXPECT(!db->find(ChainType::locking, true, makeQuery(r1)));
+
+        auto q = makeQuery(r1);
+        q.amt = "other";
+        BEAST_EXPECT(!db->find(ChainType::locking, false, q));
+
+        // Any destination, unless one is asked
+        q = makeQuery(r2);
+        found = db->find(ChainType::locking, false, q);
+        BEAST_EXPECT(found && found->otherChainDst == "dst");
+        q.otherChainDst = "other";
+        BEAST_EXPECT(!db->find(ChainType::locking, false, q));
+
+        // The failed transactions are not attested
+        auto r3 = makeRow(3, 30, 3);
+        r3.success = false;
+        db->insert(ChainType::locking, false, r3);
+        db->commit();
+        BEAST_EXPECT(!db->find(ChainType::locking, false, makeQuery(r3)));
+    }
+
+    void
+    testErase()
+    {
+        testcase("Erase and prune");
+        std::filesystem::remove_all(logDir);
+        auto db = open();
+
+        for (std::uint64_t id = 1; id <= 5; ++id)
+            db->insert(ChainType::issuing, true, makeRow(id, id * 10, id));
+        db->commit();
+
+        db->erase(ChainType::issuing, true, 2, 3);
+        db->commit();
+        BEAST_EXPECT(
+            !db->find(ChainType::issuing, true, makeQuery(makeRow(2, 20, 2))));
+        BEAST_EXPECT(
+            db->find(ChainType::issuing, true, makeQuery(makeRow(4, 40, 4))));
+
+        // A row inserted again after its erase is live
+        db->insert(ChainType::issuing, true, makeRow(2, 20, 2));
+        db->commit();
+        BEAST_EXPECT(
+            db->find(ChainType::issuing, true, makeQuery(makeRow(2, 20, 2))));
+
+        // The rows of the batch are pruned too
+        db->insert(ChainType::issuing, true, makeRow(6, 5, 6));
+        std::vector<std::uint64_t> erased;
+        auto const rows = db->prune(
+            ChainType::issuing, true, 41, [&](std::uint64_t id) {
+                erased.push_back(id);
+            });
+        db->commit();
+        std::sort(erased.begin(), erased.end());
+        BEAST_EXPECT(rows == 4);
+        BEAST_EXPECT((erased == std::vector<std::uint64_t>{1, 2, 4, 6}));
+        BEAST_EXPECT(
+            !db->find(ChainType::issuing, true, makeQuery(makeRow(4, 40, 4))));
+        BEAST_EXPECT(
+            db->find(ChainType::issuing, true, makeQuery(makeRow(5, 50, 5))));
+
+        BEAST_EXPECT(!db->prune(
+            ChainType::issuing, true, 41, [](std::uint64_t) {}));
+    }
+
+    void
+    testReopen()
+    {
+        testcase("Reopen");
+        std::filesystem::remove_all(logDir);
+        {
+            auto db = open();
+            for (std::uint64_t id = 1; id <= 3; ++id)
+                db->insert(ChainType::locking, false, makeRow(id, id, id));
+            db->commit();
+            db->erase(ChainType::locking, false, 2, 2);
+            db->commit();
+            // Not committed, lost
+            db->insert(ChainType::locking, false, makeRow(4, 4, 4));
+        }
+
+        auto db = open();
+        BEAST_EXPECT(
+            db->find(ChainType::locking, false, makeQuery(makeRow(1, 1, 1))));
+        BEAST_EXPECT(
+            !db->find(ChainType::locking, false, makeQuery(makeRow(2, 2, 2))));
+        BEAST_EXPECT(
+            db->find(ChainType::locking, false, makeQuery(makeRow(3, 3, 3))));
+        BEAST_EXPECT(
+            !db->find(ChainType::locking, false, makeQuery(makeRow(4, 4, 4))));
+
+        // The same transaction written again is one row
+        db->insert(ChainType::locking, false, makeRow(3, 3, 3));
+        db->commit();
+        BEAST_EXPECT(db->getInfo()["rows"].asUInt() == 2);
+    }
+
+    void
+    testCompact()
+    {
+        testcase("Compact");
+        std::filesystem::remove_all(logDir);
+        {
+            // A few rows per segment
+            auto db = open(1024);
+            for (std::uint64_t id = 1; id <= 40; ++id)
+            {
+                db->insert(ChainType::locking, false, makeRow(id, id, id));
+                db->commit();
+            }
+            auto const before = db->segments();
+            BEAST_EXPECT(before > 4);
+
+            db->erase(ChainType::locking, false, 1, 36);
+            db->commit();
+            BEAST_EXPECT(db->compact() > 0);
+            BEAST_EXPECT(db->segments() < before);
+            for (std::uint64_t id = 37; id <= 40; ++id)
+                BEAST_EXPECT(db->find(
+                    ChainType::locking, false, makeQuery(makeRow(id, id, id))));
+        }
+
+        // The erased rows stay erased once their tombstones are moved
+        auto db = open(1024);
+        BEAST_EXPECT(db->getInfo()["rows"].asUInt() == 4);
+        BEAST_EXPECT(!db->find(
+            ChainType::locking, false, makeQuery(makeRow(36, 36, 36))));
+        BEAST_EXPECT(db->find(
+            ChainType::locking, false, makeQuery(makeRow(40, 40, 40))));
+    }
+
+    void
+    testRead()
+    {
+        testcase("Page and scan");
+        std::filesystem::remove_all(logDir);
+        auto db = open();
+
+        // IDs and ledgers in reverse
+        std::uint64_t constexpr rows = 2500;
+        for (std::uint64_t id = 1; id <= rows; ++id)
+            db->insert(
+                ChainType::issuing, false, makeRow(id, rows - id, id % 256));
+        db->commit();
+
+        std::vector<std::uint64_t> ids;
+        std::size_t chunks = 0;
+        db->scan(
+            ChainType::issuing, false, [&](std::vector<AttestationRow>&& c) {
+                ++chunks;
+                for (auto const& r : c)
+                    ids.push_back(r.id);
+            });
+        BEAST_EXPECT(chunks == 3);
+        BEAST_EXPECT(ids.size() == rows);
+        BEAST_EXPECT(std::is_sorted(ids.begin(), ids.end()));
+
+        std::optional<AttestationMarker> marker;
+        std::size_t read = 0;
+        std::uint64_t lastId = rows + 1;
+        for (;;)
+        {
+            auto const page = db->page(ChainType::issuing, false, marker, 1000);
+            if (page.empty())
+                break;
+            for (auto const& r : page)
+            {
+                BEAST_EXPECT(r.id < lastId);
+                lastId = r.id;
+            }
+            read += page.size();
+            marker.emplace(page.back().ledgerSeq, page.back().txnHash);
+        }
+        BEAST_EXPECT(read == rows);
+    }
+
+public:
+    void
+    run() override
+    {
+        testFind();
+        testErase();
+        testReopen();
+        testCompact();
+        testRead();
+        std::filesystem::remove_all(logDir);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(AttestationLog, app, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
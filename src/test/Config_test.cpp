@@ -21,6 +21,7 @@
 
 #include <ripple/beast/unit_test.h>
 #include <ripple/json/json_reader.h>
+#include <ripple/json/json_writer.h>
 
 #include <fmt/format.h>
 
@@ -136,6 +137,232 @@ private:
         BEAST_EXPECT(!config);
     }
 
+    void
+    testOptionalData()
+    {
+        testcase("Check optional data");
+
+        Json::Value jv;
+        if (!BEAST_EXPECT(Json::Reader().parse(witness_good, jv)))
+            return;
+
+        {
+            config::Config const config(jv);
+            BEAST_EXPECT(config.signingThreads == 0);
+            BEAST_EXPECT(!config.database.wal);
+            BEAST_EXPECT(config.database.synchronous.empty());
+            BEAST_EXPECT(config.database.readers == 0);
+            BEAST_EXPECT(config.database.checkpointPages == 1000);
+            BEAST_EXPECT(config.database.vacuumPages == 0);
+            BEAST_EXPECT(config.database.retainLedgers == 0);
+            BEAST_EXPECT(config.database.engine == "sqlite");
+            BEAST_EXPECT(config.database.logSegmentMB == 64);
+            BEAST_EXPECT(!config.adaptiveWindow);
+            BEAST_EXPECT(config.minAttToSend == 8);
+            BEAST_EXPECT(!config.binaryAccountTx);
+            BEAST_EXPECT(config.backfillRanges == 0);
+            BEAST_EXPECT(!config.subscribeAccounts);
+            BEAST_EXPECT(config.lockingChainConfig.txnSubmit->maxFee == 0);
+            BEAST_EXPECT(config.issuingChainConfig.txnSubmit->tickets == 0);
+            BEAST_EXPECT(config.lockingChainConfig.addrFallbackIps.empty());
+            BEAST_EXPECT(!config.lockingChainConfig.hedgeRequests);
+            BEAST_EXPECT(config.ioThreads == 0);
+            BEAST_EXPECT(config.cpuAffinity.empty());
+            BEAST_EXPECT(config.lockingChainConfig.ioThreads == 0);
+            BEAST_EXPECT(config.lockingChainConfig.cpuAffinity.empty());
+            BEAST_EXPECT(config.rpcBatchLimit == 100);
+            BEAST_EXPECT(config.attestationCacheSize == 4096);
+            BEAST_EXPECT(config.wsQueueLimit == 100);
+            BEAST_EXPECT(config.logAsyncQueue == 0);
+            BEAST_EXPECT(config.batchMaxDelay == 0);
+            BEAST_EXPECT(config.batchTarget == 0);
+        }
+
+        jv["SigningThreads"] = 4;
+        jv["Database"]["WAL"] = true;
+        jv["Database"]["Synchronous"] = "NORMAL";
+        jv["Database"]["Readers"] = 2;
+        jv["Database"]["CheckpointPages"] = 500;
+        jv["Database"]["VacuumPages"] = 64;
+        jv["Database"]["RetainLedgers"] = 100000;
+        jv["Database"]["Engine"] = "log";
+        jv["Database"]["LogSegmentMB"] = 16;
+        jv["AdaptiveWindow"] = true;
+        jv["MinAttToSend"] = 4;
+        jv["BinaryAccountTx"] = true;
+        jv["BackfillRanges"] = 8;
+        jv["SubscribeAccounts"] = true;
+        jv["LockingChain"]["TxnSubmit"]["MaxFee"] = 1000;
+        jv["IssuingChain"]["TxnSubmit"]["Tickets"] = 50;
+        jv["LockingChain"]["FallbackEndpoints"][0u]["Host"] = "127.0.0.2";
+        jv["LockingChain"]["FallbackEndpoints"][0u]["Port"] = 6007;
+        jv["LockingChain"]["HedgeRequests"] = true;
+        jv["IOThreads"] = 4;
+        jv["CPUAffinity"][0u] = 0;
+        jv["CPUAffinity"][1u] = 1;
+        jv["LockingChain"]["IOThreads"] = 2;
+        jv["LockingChain"]["CPUAffinity"][0u] = 2;
+        jv["RPCBatchLimit"] = 5000;
+        jv["AttestationCacheSize"] = 0;
+        jv["WSQueueLimit"] = 16;
+        jv["LogAsyncQueue"] = 8192;
+        {
+            config::Config const config(jv);
+            BEAST_EXPECT(config.signingThreads == 4);
+            BEAST_EXPECT(config.database.wal);
+            BEAST_EXPECT(config.database.synchronous == "NORMAL");
+            BEAST_EXPECT(config.database.readers == 2);
+            BEAST_EXPECT(config.database.checkpointPages == 500);
+            BEAST_EXPECT(config.database.vacuumPages == 64);
+            BEAST_EXPECT(config.database.retainLedgers == 100000);
+            BEAST_EXPECT(config.database.engine == "log");
+            BEAST_EXPECT(config.database.logSegmentMB == 16);
+            BEAST_EXPECT(config.adaptiveWindow);
+            BEAST_EXPECT(config.minAttToSend == 4);
+            BEAST_EXPECT(config.binaryAccountTx);
+            BEAST_EXPECT(config.backfillRanges == 8);
+            BEAST_EXPECT(config.subscribeAccounts);
+            BEAST_EXPECT(config.lockingChainConfig.txnSubmit->maxFee == 1000);
+            BEAST_EXPECT(config.issuingChainConfig.txnSubmit->maxFee == 0);
+            BEAST_EXPECT(config.issuingChainConfig.txnSubmit->tickets == 50);
+            auto const& fallback = config.lockingChainConfig.addrFallbackIps;
+            if (BEAST_EXPECT(fallback.size() == 1))
+            {
+                BEAST_EXPECT(fallback[0].host == "127.0.0.2");
+                BEAST_EXPECT(fallback[0].port == 6007);
+            }
+            BEAST_EXPECT(config.lockingChainConfig.hedgeRequests);
+            BEAST_EXPECT(!config.issuingChainConfig.hedgeRequests);
+            BEAST_EXPECT(config.ioThreads == 4);
+            BEAST_EXPECT(
+                config.cpuAffinity == std::vector<std::uint32_t>({0, 1}));
+            BEAST_EXPECT(config.lockingChainConfig.ioThreads == 2);
+            BEAST_EXPECT(
+                config.lockingChainConfig.cpuAffinity ==
+                std::vector<std::uint32_t>({2}));
+            BEAST_EXPECT(config.issuingChainConfig.ioThreads == 0);
+            BEAST_EXPECT(config.rpcBatchLimit == 5000);
+            BEAST_EXPECT(config.attestationCacheSize == 0);
+            BEAST_EXPECT(config.wsQueueLimit == 16);
+            BEAST_EXPECT(config.logAsyncQueue == 8192);
+        }
+
+        jv["WSQueueLimit"] = 0;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["WSQueueLimit"] = 16;
+
+        jv["IssuingChain"]["CPUAffinity"][0u] = 3;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["IssuingChain"].removeMember("CPUAffinity");
+
+        jv["CPUAffinity"][2u] = "cpu";
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv.removeMember("CPUAffinity");
+
+        jv["IssuingChain"]["HedgeRequests"] = true;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["IssuingChain"].removeMember("HedgeRequests");
+
+        jv["LockingChain"]["FallbackEndpoints"][1u] = "127.0.0.3";
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["LockingChain"].removeMember("FallbackEndpoints");
+
+        jv["IssuingChain"]["TxnSubmit"]["Tickets"] = 251;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["IssuingChain"]["TxnSubmit"]["Tickets"] = 50;
+
+        jv["MinAttToSend"] = 1000;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["MinAttToSend"] = 4;
+
+        jv["Database"]["CheckpointPages"] = 0;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["Database"]["CheckpointPages"] = 500;
+
+        jv["Database"]["Engine"] = "rocksdb";
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["Database"]["Engine"] = "log";
+
+        // Only with batches
+        jv["BatchMaxDelay"] = 4;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv.removeMember("BatchMaxDelay");
+        jv["BatchTarget"] = 8;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv.removeMember("BatchTarget");
+    }
+
+    void
+    testBridges()
+    {
+        testcase("Bridges");
+
+        Json::Value jv;
+        if (!BEAST_EXPECT(Json::Reader().parse(witness_good, jv)))
+            return;
+
+        auto& entry = jv["Bridges"][0u];
+        entry["Name"] = "xrp_usd";
+        entry["XChainBridge"] = jv["XChainBridge"];
+        entry["XChainBridge"]["IssuingChainDoor"] =
+            "rnscFKLtPLn9MnUZh8EHi2KEnJR6qcZXWg";
+        entry["LockingChain"]["RewardAccount"] =
+            "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+        entry["TxLimit"] = 50;
+        {
+            config::Config const config(jv);
+            BEAST_EXPECT(config.name.empty());
+            if (!BEAST_EXPECT(config.bridges.size() == 1))
+                return;
+            auto const& b = config.bridges[0];
+            BEAST_EXPECT(b.name == "xrp_usd");
+            BEAST_EXPECT(b.bridges.empty());
+            BEAST_EXPECT(!(b.bridge == config.bridge));
+            BEAST_EXPECT(b.txLimit == 50);
+            BEAST_EXPECT(config.txLimit == 500);
+            // The other fields are the top level ones
+            BEAST_EXPECT(
+                b.lockingChainConfig.rewardAccount !=
+                config.lockingChainConfig.rewardAccount);
+            BEAST_EXPECT(
+                b.lockingChainConfig.addrChainIp.port ==
+                config.lockingChainConfig.addrChainIp.port);
+            BEAST_EXPECT(b.lockingChainConfig.txnSubmit);
+            BEAST_EXPECT(
+                b.issuingChainConfig.rewardAccount ==
+                config.issuingChainConfig.rewardAccount);
+            BEAST_EXPECT(b.dataDir == config.dataDir);
+        }
+
+        auto bad = [&](auto&& change) {
+            Json::Value j = jv;
+            change(j["Bridges"][0u]);
+            return !loadConfig(Json::FastWriter().write(j));
+        };
+        BEAST_EXPECT(bad([](Json::Value& e) { e.removeMember("Name"); }));
+        BEAST_EXPECT(bad([](Json::Value& e) { e["Name"] = "xrp-usd"; }));
+        BEAST_EXPECT(bad([](Json::Value& e) { e["Name"] = ""; }));
+        BEAST_EXPECT(bad([&](Json::Value& e) {
+            e["XChainBridge"] = jv["XChainBridge"];
+        }));
+        BEAST_EXPECT(bad([](Json::Value& e) { e["DBDir"] = "/tmp"; }));
+        BEAST_EXPECT(bad([](Json::Value& e) {
+            e["IssuingChain"]["Endpoint"]["Port"] = 6009;
+        }));
+
+        // Names and bridges are unique
+        jv["Bridges"][1u] = entry;
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["Bridges"][1u]["Name"] = "other";
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+        jv["Bridges"][1u]["XChainBridge"]["LockingChainDoor"] =
+            "rnscFKLtPLn9MnUZh8EHi2KEnJR6qcZXWg";
+        BEAST_EXPECT(loadConfig(Json::FastWriter().write(jv)));
+
+        jv["Bridges"] = "xrp_usd";
+        BEAST_EXPECT(!loadConfig(Json::FastWriter().write(jv)));
+    }
+
 public:
     void
     run() override
@@ -144,6 +371,8 @@ public:
         testBad1ConfigFile();
         testConfigData();
         testBadData();
+        testOptionalData();
+        testBridges();
     }
 };
 
@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <xbwd/app/DBInit.h>
+#include <xbwd/app/DBStatements.h>
 #include <xbwd/core/DatabaseCon.h>
 #include <xbwd/core/SociDB.h>
 
@@ -28,7 +29,10 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <filesystem>
+#include <thread>
+#include <vector>
 
 namespace xbwd {
 namespace tests {
@@ -53,10 +57,12 @@ private:
     {
         std::error_code ec;
         std::filesystem::remove(db_init::xChainDBName(), ec);
+        std::filesystem::remove(db_init::xChainDBName() + "-wal", ec);
+        std::filesystem::remove(db_init::xChainDBName() + "-shm", ec);
     }
 
     std::unique_ptr<DatabaseCon>
-    createDB()
+    createDB(DatabaseSetup const& setup = {})
     {
         Json::Value jv;
 
@@ -67,7 +73,8 @@ private:
                 db_init::xChainDBName(),
                 db_init::xChainDBPragma(),
                 db_init::xChainDBInit(),
-                j_);
+                j_,
+                setup);
         }
         catch (std::exception&)
         {
@@ -117,19 +124,19 @@ private:
             throw std::runtime_error("Can't create db");
 
         ripple::uint256 const hash;
-        auto const hashHex = ripple::strHex(hash.begin(), hash.end());
         unsigned const seq = 0;
 
         auto initSyncTable = [&]() {
             for (auto const ct : {ChainType::locking, ChainType::issuing})
             {
                 auto session = db->checkoutDb();
+                soci::blob hashBlob = convert(hash, *session);
                 auto const sql = fmt::format(
                     "INSERT INTO {} (ChainType, TransID, LedgerSeq) VALUES "
                     "(:ct, :txnId, :lgrSeq);",
                     db_init::xChainSyncTable);
                 *session << sql, soci::use(static_cast<std::uint32_t>(ct)),
-                    soci::use(hashHex), soci::use(seq);
+                    soci::use(hashBlob), soci::use(seq);
             }
         };
 
@@ -159,11 +166,7 @@ private:
                 }
                 auto const ct = static_cast<ChainType>(chainType);
 
-                ripple::uint256 locHash;
-                if (!locHash.parseHex(transID))
-                {
-                    throw std::runtime_error("cannot parse transation hash");
-                }
+                auto const locHash = convert<ripple::uint256>(transID);
 
                 if (!BEAST_EXPECT(seq == ledgerSeq))
                     return false;
@@ -208,7 +211,6 @@ private:
             ripple::STAmount amt;
             std::uint64_t const claimID = 0;
             ripple::uint256 const hash;
-            auto const hashHex = ripple::strHex(hash.begin(), hash.end());
             unsigned const seq = 0;
 
             {
@@ -245,7 +247,8 @@ private:
                     ":signingAccount, :pk, :sig); ",
                     tblName);
 
-                *session << sql, soci::use(hashHex), soci::use(seq),
+                soci::blob hashBlob = convert(hash, *session);
+                *session << sql, soci::use(hashBlob), soci::use(seq),
                     soci::use(claimID), soci::use(success), soci::use(amtBlob),
                     soci::use(bridgeBlob), soci::use(sendingAccountBlob),
                     soci::use(rewardAccountBlob), soci::use(otherChainDstBlob),
@@ -365,7 +368,6 @@ private:
             ripple::STAmount amt, rewAmt;
             std::uint64_t const createCnt = 0;
             ripple::uint256 const hash;
-            auto const hashHex = ripple::strHex(hash.begin(), hash.end());
             unsigned const seq = 0;
 
             {
@@ -408,7 +410,8 @@ private:
                     ":signingAccount, :pk, :sig);",
                     tblName);
 
-                *session << sql, soci::use(hashHex), soci::use(seq),
+                soci::blob hashBlob = convert(hash, *session);
+                *session << sql, soci::use(hashBlob), soci::use(seq),
                     soci::use(createCnt), soci::use(success),
                     soci::use(amtBlob), soci::use(rewardAmtBlob),
                     soci::use(bridgeBlob), soci::use(sendingAccountBlob),
@@ -507,6 +510,481 @@ private:
         deleteDB();
     }
 
+    void
+    testPreparedStatements(DatabaseSetup const& setup = {})
+    {
+        testcase(
+            setup.wal ? "Prepared statements, WAL" : "Prepared statements");
+
+        auto db = createDB(setup);
+        if (!db)
+            throw std::runtime_error("Can't create db");
+        db->prepareStatements(db_stmt::prepareAll);
+
+        BEAST_EXPECT(db->readers() == (setup.wal ? setup.readers : 0));
+        {
+            auto session = db->checkoutReadDb();
+            std::string mode;
+            *session << "PRAGMA journal_mode;", soci::into(mode);
+            BEAST_EXPECT((mode == "wal") == setup.wal);
+        }
+
+        auto const ct = ChainType::locking;
+        ripple::AccountID const rewAcc;
+        ripple::AccountID const dst, src;
+        ripple::AccountID const signAcc;
+        ripple::STXChainBridge const bridge;
+        auto const keys = ripple::generateKeyPair(
+            ripple::KeyType::ed25519,
+            *ripple::parseBase58<ripple::Seed>(
+                "snnksgXkSTgCBuHJmHeTekJyj4qG6"));
+        ripple::STAmount const amt(42);
+
+        // The same statement is executed several times, with new blobs bound
+        // each time
+        for (std::uint64_t claimID : {1, 2, 3, 4, 5})
+        {
+            auto const claim = ripple::Attestations::AttestationClaim{
+                bridge,
+                signAcc,
+                keys.first,
+                keys.second,
+                src,
+                amt,
+                rewAcc,
+                true,
+                claimID,
+                dst};
+
+            auto session = db->checkoutDb();
+            auto& q = session.prepared<db_stmt::InsertClaim>(
+                db_stmt::InsertClaim::name(ct));
+            ripple::uint256 const hash(claimID);
+            q.txnId = convert(hash, *session);
+            q.ledgerSeq = claimID * 10;
+            q.claimID = claimID;
+            q.success = 1;
+            q.amt = convert(amt, *session);
+            q.bridge = convert(bridge, *session);
+            q.sendingAccount = convert(src, *session);
+            q.rewardAccount = convert(rewAcc, *session);
+            q.otherChainDst = convert(dst, *session);
+            q.signingAccount =
+                convert(claim.attestationSignerAccount, *session);
+            q.publicKey = convert(keys.first, *session);
+            q.signature = convert(claim.signature, *session);
+            q.st.execute(true);
+        }
+
+        auto select = [&](std::uint64_t claimID, bool withDst) {
+            auto session = db->checkoutReadDb();
+            auto& q = session.prepared<db_stmt::SelectClaim>(
+                db_stmt::SelectClaim::name(ct, withDst));
+            q.claimID = claimID;
+            q.amt = convert(amt, *session);
+            q.bridge = convert(bridge, *session);
+            q.sendingAccount = convert(src, *session);
+            if (withDst)
+                q.otherChainDst = convert(dst, *session);
+            if (!q.execute(*session))
+                return false;
+            if (!withDst &&
+                !BEAST_EXPECT(q.otherChainDstInd == soci::i_ok &&
+                              convert<ripple::AccountID>(q.otherChainDst) ==
+                                  dst))
+                return false;
+            return BEAST_EXPECT(
+                q.sigInd == soci::i_ok &&
+                convert<ripple::PublicKey>(q.publicKey) == keys.first &&
+                convert<ripple::AccountID>(q.rewardAccount) == rewAcc);
+        };
+
+        BEAST_EXPECT(select(2, true));
+        BEAST_EXPECT(select(2, false));
+        BEAST_EXPECT(!select(6, true));
+        BEAST_EXPECT(!select(6, false));
+
+        {
+            auto session = db->checkoutDb();
+            auto& q = session.prepared<db_stmt::DeleteIDRange>(
+                db_stmt::DeleteIDRange::name(ct, false));
+            q.first = 2;
+            q.last = 3;
+            q.st.execute(true);
+        }
+        BEAST_EXPECT(!select(2, true));
+        BEAST_EXPECT(!select(3, false));
+        BEAST_EXPECT(select(1, true));
+        BEAST_EXPECT(select(4, false));
+
+        {
+            auto session = db->checkoutDb();
+            auto& sel = session.prepared<db_stmt::SelectPrunedIDs>(
+                db_stmt::SelectPrunedIDs::name(ct, false));
+            sel.ledgerSeq = 50;
+            std::vector<std::uint64_t> ids;
+            if (sel.st.execute(true))
+            {
+                do
+                    ids.push_back(sel.id);
+                while (sel.st.fetch());
+            }
+            std::sort(ids.begin(), ids.end());
+            BEAST_EXPECT(ids == std::vector<std::uint64_t>({1, 4}));
+
+            auto& q = session.prepared<db_stmt::PruneClaims>(
+                db_stmt::PruneClaims::name(ct, false));
+            q.ledgerSeq = 50;
+            q.st.execute(true);
+        }
+        BEAST_EXPECT(!select(1, true));
+        BEAST_EXPECT(!select(4, true));
+        BEAST_EXPECT(select(5, true));
+
+        db.reset();
+        deleteDB();
+    }
+
+    void
+    testBridgeStatements()
+    {
+        testcase("Prepared statements of a named bridge");
+
+        std::string const name("Side");
+        auto db = createDB();
+        if (!db)
+            throw std::runtime_error("Can't create db");
+        {
+            auto session = db->checkoutDb();
+            for (auto const& sql : db_init::xChainDBInit(name))
+                *session << sql;
+        }
+        db->prepareStatements([&name](soci::session& s) {
+            return db_stmt::prepareBridges(s, {std::string(), name});
+        });
+
+        auto const ct = ChainType::issuing;
+        ripple::AccountID const rewAcc;
+        ripple::AccountID const dst, src;
+        ripple::AccountID const signAcc;
+        ripple::STXChainBridge const bridge;
+        auto const keys = ripple::generateKeyPair(
+            ripple::KeyType::ed25519,
+            *ripple::parseBase58<ripple::Seed>(
+                "snnksgXkSTgCBuHJmHeTekJyj4qG6"));
+        ripple::STAmount const amt(42);
+        ripple::STAmount const rewardAmt(1);
+        ripple::uint256 const hash(7);
+        auto const sig =
+            ripple::sign(keys.first, keys.second, ripple::makeSlice(name));
+
+        {
+            auto session = db->checkoutDb();
+            auto& q = session.prepared<db_stmt::InsertClaim>(
+                db_stmt::InsertClaim::name(ct, name));
+            q.txnId = convert(hash, *session);
+            q.ledgerSeq = 10;
+            q.claimID = 7;
+            q.success = 1;
+            q.amt = convert(amt, *session);
+            q.bridge = convert(bridge, *session);
+            q.sendingAccount = convert(src, *session);
+            q.rewardAccount = convert(rewAcc, *session);
+            q.otherChainDst = convert(dst, *session);
+            q.signingAccount = convert(signAcc, *session);
+            q.publicKey = convert(keys.first, *session);
+            q.signature = convert(sig, *session);
+            q.st.execute(true);
+        }
+        {
+            auto session = db->checkoutDb();
+            auto& q = session.prepared<db_stmt::InsertCreateAccount>(
+                db_stmt::InsertCreateAccount::name(ct, name));
+            q.txnId = convert(hash, *session);
+            q.ledgerSeq = 10;
+            q.createCount = 3;
+            q.success = 1;
+            q.amt = convert(amt, *session);
+            q.rewardAmt = convert(rewardAmt, *session);
+            q.bridge = convert(bridge, *session);
+            q.sendingAccount = convert(src, *session);
+            q.rewardAccount = convert(rewAcc, *session);
+            q.otherChainDst = convert(dst, *session);
+            q.signingAccount = convert(signAcc, *session);
+            q.publicKey = convert(keys.first, *session);
+            q.signature = convert(sig, *session);
+            q.st.execute(true);
+        }
+
+        // The rows hold the serialized bridge, not the name of the bridge
+        for (auto const& table :
+             {db_init::xChainTableName(ct, name),
+              db_init::xChainCreateAccountTableName(ct, name)})
+        {
+            auto session = db->checkoutDb();
+            soci::blob bridgeBlob(*session);
+            *session << fmt::format("SELECT Bridge FROM {};", table),
+                soci::into(bridgeBlob);
+            BEAST_EXPECT(convert<ripple::STXChainBridge>(bridgeBlob) == bridge);
+        }
+
+        auto selectClaim = [&](std::string const& b) {
+            auto session = db->checkoutReadDb();
+            auto& q = session.prepared<db_stmt::SelectClaim>(
+                db_stmt::SelectClaim::name(ct, true, b));
+            q.claimID = 7;
+            q.amt = convert(amt, *session);
+            q.bridge = convert(bridge, *session);
+            q.sendingAccount = convert(src, *session);
+            q.otherChainDst = convert(dst, *session);
+            return q.execute(*session) &&
+                convert<ripple::PublicKey>(q.publicKey) == keys.first;
+        };
+        auto selectCreate = [&](std::string const& b) {
+            auto session = db->checkoutReadDb();
+            auto& q = session.prepared<db_stmt::SelectCreateAccount>(
+                db_stmt::SelectCreateAccount::name(ct, b));
+            q.createCount = 3;
+            q.amt = convert(amt, *session);
+            q.rewardAmt = convert(rewardAmt, *session);
+            q.bridge = convert(bridge, *session);
+            q.sendingAccount = convert(src, *session);
+            q.otherChainDst = convert(dst, *session);
+            return q.execute(*session) &&
+                convert<ripple::PublicKey>(q.publicKey) == keys.first;
+        };
+
+        // Found in the tables of the named bridge only
+        BEAST_EXPECT(selectClaim(name));
+        BEAST_EXPECT(selectCreate(name));
+        BEAST_EXPECT(!selectClaim({}));
+        BEAST_EXPECT(!selectCreate({}));
+
+        db.reset();
+        deleteDB();
+    }
+
+    void
+    testPinnedReadDb()
+    {
+        testcase("Pinned read session");
+
+        auto db = createDB(DatabaseSetup{true, "NORMAL", 2, 1});
+        if (!db)
+            throw std::runtime_error("Can't create db");
+        db->prepareStatements(db_stmt::prepareAll);
+
+        {
+            // Another idle reader
+            auto first = db->checkoutReadDb();
+            auto second = db->checkoutReadDb();
+            BEAST_EXPECT(first.get() != second.get());
+        }
+
+        {
+            DatabaseCon::PinnedReadDb const pin(*db);
+            auto first = db->checkoutReadDb();
+            auto second = db->checkoutReadDb();
+            BEAST_EXPECT(first.get() == second.get());
+
+            // Other threads still take a reader from the pool
+            soci::session* other = nullptr;
+            std::thread([&] { other = db->checkoutReadDb().get(); }).join();
+            BEAST_EXPECT(other && other != first.get());
+        }
+
+        db.reset();
+        deleteDB();
+    }
+
+    void
+    testVacuum()
+    {
+        testcase("Incremental vacuum");
+
+        auto autoVacuum = [](DatabaseCon& db) {
+            int mode = -1;
+            auto session = db.checkoutDb();
+            *session << "PRAGMA auto_vacuum;", soci::into(mode);
+            return mode;
+        };
+
+        // An existing database is vacuumed into the incremental mode
+        auto db = createDB();
+        if (!db)
+            throw std::runtime_error("Can't create db");
+        BEAST_EXPECT(autoVacuum(*db) == 0);
+        db.reset();
+
+        DatabaseSetup setup;
+        setup.vacuumPages = 8;
+        db = createDB(setup);
+        if (!db)
+            throw std::runtime_error("Can't create db");
+        BEAST_EXPECT(autoVacuum(*db) == 2);
+        db->incrementalVacuum();
+        db.reset();
+
+        // And a new one starts in it
+        deleteDB();
+        db = createDB(setup);
+        if (!db)
+            throw std::runtime_error("Can't create db");
+        BEAST_EXPECT(autoVacuum(*db) == 2);
+
+        db.reset();
+        deleteDB();
+    }
+
+    void
+    testCheckpoint()
+    {
+        testcase("Checkpoint");
+
+        auto db = createDB();
+        if (!db)
+            throw std::runtime_error("Can't create db");
+        db->prepareStatements(db_stmt::prepareAll);
+
+        auto const ct = ChainType::issuing;
+        {
+            auto session = db->checkoutDb();
+            *session << fmt::format(
+                            "INSERT INTO {} (ChainType, DoorLedgerSeq, "
+                            "SubmitLedgerSeq) VALUES (:ct, 0, 0);",
+                            db_init::xChainCheckpointTable),
+                soci::use(static_cast<std::uint32_t>(ct));
+
+            auto update = [&](std::uint32_t door, std::uint32_t submit) {
+                auto& q = session.prepared<db_stmt::UpdateCheckpoint>(
+                    db_stmt::UpdateCheckpoint::name());
+                q.doorLedgerSeq = door;
+                q.submitLedgerSeq = submit;
+                q.chainType = static_cast<std::uint32_t>(ct);
+                q.st.execute(true);
+            };
+            auto checkpoint = [&] {
+                std::uint32_t door = 0, submit = 0;
+                *session << fmt::format(
+                                "SELECT DoorLedgerSeq, SubmitLedgerSeq FROM {} "
+                                "WHERE ChainType = :ct;",
+                                db_init::xChainCheckpointTable),
+                    soci::into(door), soci::into(submit),
+                    soci::use(static_cast<std::uint32_t>(ct));
+                return std::make_pair(door, submit);
+            };
+
+            // The ledgers never go back, a 0 keeps the saved one
+            update(10, 12);
+            BEAST_EXPECT(checkpoint() == std::make_pair(10u, 12u));
+            update(15, 0);
+            BEAST_EXPECT(checkpoint() == std::make_pair(15u, 12u));
+            update(11, 20);
+            BEAST_EXPECT(checkpoint() == std::make_pair(15u, 20u));
+
+            auto insert = [&](std::uint64_t d, std::uint32_t ledger) {
+                auto& q = session.prepared<db_stmt::InsertAttested>(
+                    db_stmt::InsertAttested::name(ct));
+                ripple::uint256 const digest(d);
+                q.digest = convert(digest, *session);
+                q.ledgerSeq = ledger;
+                q.st.execute(true);
+            };
+            auto count = [&] {
+                int cnt = 0;
+                *session << fmt::format(
+                                "SELECT COUNT(*) FROM {};",
+                                db_init::xChainAttestedTableName(ct)),
+                    soci::into(cnt);
+                return cnt;
+            };
+
+            insert(1, 100);
+            insert(2, 200);
+            insert(3, 300);
+            // Known digest
+            insert(2, 250);
+            BEAST_EXPECT(count() == 3);
+
+            auto& q = session.prepared<db_stmt::PruneAttested>(
+                db_stmt::PruneAttested::name(ct));
+            q.ledgerSeq = 200;
+            q.st.execute(true);
+            BEAST_EXPECT(count() == 2);
+        }
+
+        db.reset();
+        deleteDB();
+    }
+
+    void
+    testMigrate()
+    {
+        testcase("Migrate");
+
+        auto db = createDB();
+        if (!db)
+            throw std::runtime_error("Can't create db");
+
+        auto const ct = ChainType::locking;
+        ripple::uint256 const hash(42);
+        auto const hashHex = ripple::strHex(hash.begin(), hash.end());
+        {
+            auto session = db->checkoutDb();
+
+            // Version 0 stored the hashes as hex strings
+            *session << fmt::format(
+                            "INSERT INTO {} (TransID, LedgerSeq, ClaimID) "
+                            "VALUES (:txnId, 1, 2);",
+                            db_init::xChainTableName(ct)),
+                soci::use(hashHex);
+            *session << fmt::format(
+                            "INSERT INTO {} (ChainType, TransID, LedgerSeq) "
+                            "VALUES (:ct, :txnId, 1);",
+                            db_init::xChainSyncTable),
+                soci::use(static_cast<std::uint32_t>(ct)), soci::use(hashHex);
+
+            db_init::xChainDBMigrate(*session, j_);
+
+            int version = 0;
+            *session << "PRAGMA user_version;", soci::into(version);
+            BEAST_EXPECT(version == db_init::xChainDBVersion);
+
+            auto readHash = [&](std::string const& table) {
+                std::string type;
+                std::string transID;
+                *session << fmt::format(
+                                "SELECT typeof(TransID), TransID FROM {};",
+                                table),
+                    soci::into(type), soci::into(transID);
+                return type == "blob" &&
+                    convert<ripple::uint256>(transID) == hash;
+            };
+            BEAST_EXPECT(readHash(db_init::xChainTableName(ct)));
+            BEAST_EXPECT(readHash(db_init::xChainSyncTable));
+
+            // Nothing to do the second time
+            db_init::xChainDBMigrate(*session, j_);
+            BEAST_EXPECT(readHash(db_init::xChainTableName(ct)));
+
+            // Newer database
+            *session << "PRAGMA user_version = 1000;";
+            bool thrown = false;
+            try
+            {
+                db_init::xChainDBMigrate(*session, j_);
+            }
+            catch (std::exception const&)
+            {
+                thrown = true;
+            }
+            BEAST_EXPECT(thrown);
+        }
+
+        db.reset();
+        deleteDB();
+    }
+
 public:
     void
     run() override
@@ -517,6 +995,13 @@ public:
         testInitDB();
         testSubmitTable();
         testCreateTable();
+        testPreparedStatements();
+        testPreparedStatements(DatabaseSetup{true, "NORMAL", 2, 1});
+        testBridgeStatements();
+        testPinnedReadDb();
+        testVacuum();
+        testCheckpoint();
+        testMigrate();
         deleteDB();
     }
 };
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <xbwd/federator/FeeStrategy.h>
+
+#include <ripple/beast/unit_test.h>
+
+namespace xbwd {
+namespace tests {
+
+class FeeStrategy_test : public beast::unit_test::suite
+{
+private:
+    void
+    testBase()
+    {
+        testcase("Base fee");
+
+        FeeLimits const limits{10, 0};
+
+        // Idle chain
+        BEAST_EXPECT(computeFee({10, 0, 1000}, 0, limits) == 20);
+        BEAST_EXPECT(computeFee({10, 10, 1000}, 0, limits) == 20);
+
+        // Loaded server
+        BEAST_EXPECT(computeFee({10, 0, 2500}, 0, limits) == 35);
+        // Unexpected load factor below normal
+        BEAST_EXPECT(computeFee({10, 0, 500}, 0, limits) == 20);
+
+        // Open ledger escalation
+        BEAST_EXPECT(computeFee({10, 300, 1000}, 0, limits) == 310);
+        BEAST_EXPECT(computeFee({10, 300, 50000}, 0, limits) == 510);
+    }
+
+    void
+    testEscalation()
+    {
+        testcase("Escalation");
+
+        FeeState const state{10, 0, 1000};
+
+        BEAST_EXPECT(computeFee(state, 1, {10, 0}) == 40);
+        BEAST_EXPECT(computeFee(state, 5, {10, 0}) == 640);
+
+        // Capped
+        BEAST_EXPECT(computeFee(state, 5, {10, 100}) == 100);
+        BEAST_EXPECT(computeFee(state, 0, {10, 100}) == 20);
+
+        // The cap does not go below the ledger fee
+        BEAST_EXPECT(computeFee({50, 0, 1000}, 3, {10, 20}) == 50);
+    }
+
+public:
+    void
+    run() override
+    {
+        testBase();
+        testEscalation();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FeeStrategy, federator, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
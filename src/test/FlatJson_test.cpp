@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/client/FlatJson.h>
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/protocol/jss.h>
+
+#include <string>
+
+namespace xbwd {
+namespace tests {
+
+class FlatJson_test : public beast::unit_test::suite
+{
+private:
+    // Parsed flat, with the value of Json::Reader
+    void
+    expectSame(std::string const& doc)
+    {
+        Json::Value flat, full;
+        BEAST_EXPECT(parseFlatJson(doc, flat));
+        BEAST_EXPECT(Json::Reader().parse(doc, full));
+        BEAST_EXPECT(flat == full);
+        BEAST_EXPECT(flat.type() == full.type());
+        for (auto it = full.begin(); it != full.end(); ++it)
+            BEAST_EXPECT(flat[it.memberName()].type() == it->type());
+    }
+
+    void
+    testFlat()
+    {
+        testcase("Flat objects");
+
+        std::string const ledgerClosed =
+            R"({"fee_base":10,"ledger_hash":"4B2B9B5E4D2E63A8C4B6E54E5D0DEC2)"
+            R"(67B3D4A0A1D7B8F5B6E0C2F8D1B3E5A7C","ledger_index":91826371,)"
+            R"("ledger_time":782821571,"reserve_base":1000000,)"
+            R"("reserve_inc":200000,"txn_count":42,"type":"ledgerClosed",)"
+            R"("validated_ledgers":"32570-91826371"})";
+        expectSame(ledgerClosed);
+
+        Json::Value jv;
+        if (BEAST_EXPECT(parseFlatJson(ledgerClosed, jv)))
+        {
+            BEAST_EXPECT(jv[ripple::jss::type] == "ledgerClosed");
+            BEAST_EXPECT(jv[ripple::jss::ledger_index].asUInt() == 91826371);
+            BEAST_EXPECT(jv[ripple::jss::fee_base].isIntegral());
+        }
+
+        expectSame("{}");
+        expectSame(" { \"a\" : 1 ,\n\t\"b\":\"x\" } ");
+        expectSame(R"({"t":true,"f":false,"n":null,"neg":-5})");
+        // Int while it fits, UInt above
+        expectSame(R"({"int":2147483647,"uint":4294967295})");
+        expectSame(R"({"min":-2147483648})");
+        // The last duplicate wins
+        expectSame(R"({"a":1,"a":2})");
+    }
+
+    void
+    testRejected()
+    {
+        testcase("Left to the full parse");
+
+        Json::Value jv;
+        // Responses, nested members
+        BEAST_EXPECT(!parseFlatJson(
+            R"({"id":1,"result":{"ledger_index":5},"status":"success"})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":[1,2]})", jv));
+        // Escapes, non-integers, out of range
+        BEAST_EXPECT(!parseFlatJson(R"({"a":"q\"uote"})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a\n":1})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":1.5})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":1e3})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":4294967296})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":-2147483649})", jv));
+        // Malformed
+        BEAST_EXPECT(!parseFlatJson("", jv));
+        BEAST_EXPECT(!parseFlatJson("[]", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":1)", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":1,})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a" 1})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":tru})", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":1} x)", jv));
+        BEAST_EXPECT(!parseFlatJson(R"({"a":"open})", jv));
+    }
+
+public:
+    void
+    run() override
+    {
+        testFlat();
+        testRejected();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(FlatJson, client, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
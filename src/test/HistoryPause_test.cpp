@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/federator/HistoryPause.h>
+
+#include <ripple/beast/unit_test.h>
+
+namespace xbwd {
+namespace tests {
+
+class HistoryPause_test : public beast::unit_test::suite
+{
+    static constexpr HistoryMarks marks{100, 10, 50, 5};
+
+    void
+    testPause()
+    {
+        testcase("Pause");
+
+        BEAST_EXPECT(!marks.paused(false, {}));
+        BEAST_EXPECT(!marks.paused(false, {99, 99, 49}));
+
+        // Any load at its high mark
+        BEAST_EXPECT(marks.paused(false, {100, 0, 0}));
+        BEAST_EXPECT(marks.paused(false, {0, 100, 0}));
+        BEAST_EXPECT(marks.paused(false, {0, 0, 50}));
+    }
+
+    void
+    testResume()
+    {
+        testcase("Resume");
+
+        // Between the marks the state is kept
+        HistoryLoad const between{50, 50, 20};
+        BEAST_EXPECT(!marks.paused(false, between));
+        BEAST_EXPECT(marks.paused(true, between));
+
+        // Any load over its low mark keeps it paused
+        BEAST_EXPECT(marks.paused(true, {11, 0, 0}));
+        BEAST_EXPECT(marks.paused(true, {0, 11, 0}));
+        BEAST_EXPECT(marks.paused(true, {0, 0, 6}));
+
+        // All at their low marks
+        BEAST_EXPECT(!marks.paused(true, {10, 10, 5}));
+        BEAST_EXPECT(!marks.paused(true, {}));
+    }
+
+public:
+    void
+    run() override
+    {
+        testPause();
+        testResume();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(HistoryPause, federator, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
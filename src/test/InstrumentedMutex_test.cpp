@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/InstrumentedMutex.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <chrono>
+#include <thread>
+
+namespace xbwd {
+namespace tests {
+
+class InstrumentedMutex_test : public beast::unit_test::suite
+{
+    void
+    testCounts()
+    {
+        testcase("Counts");
+
+        InstrumentedMutex<> m{"test_counts"};
+        for (int i = 0; i < 3; ++i)
+            std::lock_guard l{m};
+        {
+            std::unique_lock l{m, std::try_to_lock};
+            BEAST_EXPECT(l.owns_lock());
+        }
+        auto const& s = m.stats();
+        BEAST_EXPECT(s.acquisitions_.value() == 4);
+        BEAST_EXPECT(s.contended_.value() == 0);
+        BEAST_EXPECT(s.hold_.snapshot().count == 4);
+        BEAST_EXPECT(s.wait_.snapshot().count == 0);
+
+        // The same name, the same stats
+        InstrumentedMutex<> other{"test_counts"};
+        std::lock_guard l{other};
+        BEAST_EXPECT(&other.stats() == &s);
+        BEAST_EXPECT(s.acquisitions_.value() == 5);
+    }
+
+    void
+    testContention()
+    {
+        testcase("Contention");
+
+        using namespace std::chrono_literals;
+        InstrumentedMutex<> m{"test_contention"};
+        std::unique_lock held{m};
+        std::thread t([&] {
+            // Taken by the test thread
+            BEAST_EXPECT(!m.try_lock());
+            std::lock_guard l{m};
+        });
+        std::this_thread::sleep_for(20ms);
+        held.unlock();
+        t.join();
+
+        auto const& s = m.stats();
+        BEAST_EXPECT(s.acquisitions_.value() == 2);
+        BEAST_EXPECT(s.contended_.value() == 1);
+        auto const wait = s.wait_.snapshot();
+        BEAST_EXPECT(wait.count == 1 && wait.sum >= 10'000);
+        BEAST_EXPECT(s.hold_.snapshot().sum >= 10'000);
+    }
+
+    void
+    testRecursive()
+    {
+        testcase("Recursive");
+
+        InstrumentedMutex<std::recursive_mutex> m{"test_recursive"};
+        {
+            std::lock_guard outer{m};
+            std::lock_guard inner{m};
+        }
+        auto const& s = m.stats();
+        BEAST_EXPECT(s.acquisitions_.value() == 2);
+        // Held once
+        BEAST_EXPECT(s.hold_.snapshot().count == 1);
+    }
+
+    void
+    testMetrics()
+    {
+        testcase("Metrics");
+
+        InstrumentedMutex<> m{"test_metrics"};
+        std::lock_guard l{m};
+
+        metrics::Writer w;
+        writeLockMetrics(w);
+        auto const& out = w.str();
+        BEAST_EXPECT(
+            out.find("xbwd_lock_acquisitions_total{lock=\"test_metrics\"} 1") !=
+            std::string::npos);
+        BEAST_EXPECT(
+            out.find("xbwd_lock_contended_total{lock=\"test_metrics\"} 0") !=
+            std::string::npos);
+        BEAST_EXPECT(
+            out.find("xbwd_lock_wait_seconds_count{lock=\"test_metrics\"}") !=
+            std::string::npos);
+        // One HELP line per metric
+        BEAST_EXPECT(
+            out.find("# HELP xbwd_lock_hold_seconds") ==
+            out.rfind("# HELP xbwd_lock_hold_seconds"));
+    }
+
+public:
+    void
+    run() override
+    {
+        testCounts();
+        testContention();
+        testRecursive();
+        testMetrics();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(InstrumentedMutex, basics, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
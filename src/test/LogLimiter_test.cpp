@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <xbwd/basics/LogLimiter.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <chrono>
+
+namespace xbwd {
+namespace tests {
+
+class LogLimiter_test : public beast::unit_test::suite
+{
+    using clock_type = LogLimiter::clock_type;
+
+    void
+    testSample()
+    {
+        testcase("Sample");
+
+        LogLimiter limiter;
+        auto const now = clock_type::now();
+        // Not limited
+        BEAST_EXPECT(limiter.check(10, now) == 0);
+
+        limiter.set(10, LogLimit{0, 1, 3});
+        BEAST_EXPECT(limiter.check(10, now) == 0);
+        BEAST_EXPECT(!limiter.check(10, now));
+        BEAST_EXPECT(!limiter.check(10, now));
+        // With the number suppressed
+        BEAST_EXPECT(limiter.check(10, now) == 2);
+        BEAST_EXPECT(!limiter.check(10, now));
+        // Other sites are not limited
+        BEAST_EXPECT(limiter.check(11, now) == 0);
+
+        auto const jv = limiter.getJson();
+        if (BEAST_EXPECT(jv.size() == 1))
+        {
+            BEAST_EXPECT(jv[0u]["jlog_id"].asUInt() == 10);
+            BEAST_EXPECT(jv[0u]["logged"].asUInt() == 2);
+            BEAST_EXPECT(jv[0u]["suppressed"].asUInt() == 3);
+        }
+
+        BEAST_EXPECT(limiter.clear(10));
+        BEAST_EXPECT(!limiter.clear(10));
+        BEAST_EXPECT(limiter.check(10, now) == 0);
+        BEAST_EXPECT(limiter.getJson().size() == 0);
+    }
+
+    void
+    testRate()
+    {
+        testcase("Rate");
+
+        using namespace std::chrono_literals;
+        LogLimiter limiter;
+        limiter.set(20, LogLimit{2, 3, 1});
+        auto const now = clock_type::now();
+
+        // The burst, then 2 per second
+        for (int i = 0; i < 3; ++i)
+            BEAST_EXPECT(limiter.check(20, now) == 0);
+        BEAST_EXPECT(!limiter.check(20, now));
+        BEAST_EXPECT(!limiter.check(20, now + 250ms));
+        BEAST_EXPECT(limiter.check(20, now + 500ms) == 2);
+        BEAST_EXPECT(!limiter.check(20, now + 750ms));
+        BEAST_EXPECT(limiter.check(20, now + 1s) == 1);
+        // Refilled up to the burst only
+        auto const later = now + 1h;
+        for (int i = 0; i < 3; ++i)
+            BEAST_EXPECT(limiter.check(20, later) == 0);
+        BEAST_EXPECT(!limiter.check(20, later));
+
+        // A new limit starts over
+        limiter.set(20, LogLimit{1, 1, 1});
+        BEAST_EXPECT(limiter.check(20, clock_type::now()) == 0);
+    }
+
+    void
+    testFlush()
+    {
+        testcase("Flush");
+
+        using namespace std::chrono_literals;
+        LogLimiter limiter;
+        auto const now = clock_type::now();
+        limiter.set(30, LogLimit{0, 1, 10});
+        limiter.set(31, LogLimit{0, 1, 10});
+        BEAST_EXPECT(limiter.check(30, now) == 0);
+        BEAST_EXPECT(limiter.check(31, now) == 0);
+        for (int i = 0; i < 3; ++i)
+            BEAST_EXPECT(!limiter.check(30, now));
+
+        // Not before the site was quiet for the interval
+        BEAST_EXPECT(limiter.flush(now + 1s).empty());
+
+        // The sites without messages suppressed are not flushed
+        auto const later = now + LogLimiter::flushInterval;
+        auto const flushed = limiter.flush(later);
+        if (BEAST_EXPECT(flushed.size() == 1))
+        {
+            BEAST_EXPECT(flushed[0].first == 30);
+            BEAST_EXPECT(flushed[0].second == 3);
+        }
+        BEAST_EXPECT(limiter.flush(later + 1h).empty());
+
+        // Counted once: the next message logged has the ones after the flush
+        for (int i = 0; i < 6; ++i)
+            BEAST_EXPECT(!limiter.check(30, later));
+        BEAST_EXPECT(limiter.check(30, later) == 6);
+        BEAST_EXPECT(limiter.flush(later + 1h).empty());
+        BEAST_EXPECT(limiter.getJson()[0u]["suppressed"].asUInt() == 9);
+    }
+
+public:
+    void
+    run() override
+    {
+        testSample();
+        testRate();
+        testFlush();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LogLimiter, basics, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
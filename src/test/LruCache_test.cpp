@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <xbwd/basics/LruCache.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <string>
+
+namespace xbwd {
+namespace tests {
+
+class LruCache_test : public beast::unit_test::suite
+{
+private:
+    void
+    testEviction()
+    {
+        testcase("Least recently used evicted");
+
+        // One shard, so the eviction order is global
+        LruCache<int, std::string> cache(3, 1);
+        cache.put(1, "one");
+        cache.put(2, "two");
+        cache.put(3, "three");
+        BEAST_EXPECT(cache.size() == 3);
+
+        // 1 is used again, 2 is the oldest
+        BEAST_EXPECT(cache.get(1) == std::string("one"));
+        cache.put(4, "four");
+        BEAST_EXPECT(cache.size() == 3);
+        BEAST_EXPECT(!cache.get(2));
+        BEAST_EXPECT(cache.get(3) == std::string("three"));
+        BEAST_EXPECT(cache.get(4) == std::string("four"));
+
+        // Replaced in place
+        cache.put(4, "FOUR");
+        BEAST_EXPECT(cache.size() == 3);
+        BEAST_EXPECT(cache.get(4) == std::string("FOUR"));
+
+        BEAST_EXPECT(cache.hits() == 4);
+        BEAST_EXPECT(cache.misses() == 1);
+    }
+
+    void
+    testErase()
+    {
+        testcase("Erase and generation");
+
+        LruCache<int, int> cache(64);
+        cache.put(1, 10);
+        auto const gen = cache.generation(1);
+        cache.erase(1);
+        BEAST_EXPECT(!cache.get(1));
+
+        // Read before the erase, not cached
+        cache.put(1, 10, gen);
+        BEAST_EXPECT(!cache.get(1));
+        cache.put(1, 11, cache.generation(1));
+        BEAST_EXPECT(cache.get(1) == 11);
+
+        // Unknown key
+        cache.erase(2);
+        BEAST_EXPECT(cache.size() == 1);
+    }
+
+    void
+    testDisabled()
+    {
+        testcase("Disabled");
+
+        LruCache<int, int> cache(0);
+        cache.put(1, 10);
+        BEAST_EXPECT(!cache.get(1));
+        BEAST_EXPECT(cache.size() == 0);
+        BEAST_EXPECT(cache.hits() == 0 && cache.misses() == 0);
+    }
+
+    void
+    testShards()
+    {
+        testcase("Shards");
+
+        // Split between the shards, never more than the capacity rounded up
+        LruCache<int, int> cache(64, 16);
+        for (int i = 0; i < 1000; ++i)
+            cache.put(i, i);
+        BEAST_EXPECT(cache.size() <= 64);
+        BEAST_EXPECT(cache.get(999) == 999);
+    }
+
+public:
+    void
+    run() override
+    {
+        testEviction();
+        testErase();
+        testDisabled();
+        testShards();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(LruCache, basics, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
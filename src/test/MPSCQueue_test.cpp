@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/MPSCQueue.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace xbwd {
+namespace tests {
+
+class MPSCQueue_test : public beast::unit_test::suite
+{
+private:
+    void
+    testSingleThread()
+    {
+        testcase("Single thread");
+
+        MPSCQueue<std::string> q(3);
+        BEAST_EXPECT(q.capacity() == 4);
+        BEAST_EXPECT(q.size() == 0);
+
+        std::string s;
+        BEAST_EXPECT(!q.tryPop(s));
+
+        for (int i = 0; i < 4; ++i)
+            BEAST_EXPECT(q.push(std::to_string(i)));
+        BEAST_EXPECT(q.size() == 4);
+
+        BEAST_EXPECT(q.tryPop(s) && s == "0");
+        std::vector<std::string> out;
+        BEAST_EXPECT(q.popAll(out) == 3);
+        BEAST_EXPECT(out == std::vector<std::string>({"1", "2", "3"}));
+        BEAST_EXPECT(q.size() == 0);
+
+        // Wraps around
+        for (int i = 0; i < 10; ++i)
+        {
+            BEAST_EXPECT(q.push(std::to_string(i)));
+            BEAST_EXPECT(q.tryPop(s) && s == std::to_string(i));
+        }
+
+        auto const st = q.stats();
+        BEAST_EXPECT(st.pushed == 14);
+        BEAST_EXPECT(st.size == 0);
+        BEAST_EXPECT(st.fullWaits == 0);
+    }
+
+    void
+    testProducers()
+    {
+        testcase("Producers");
+
+        // Small queue, so the producers have to wait for the consumer
+        MPSCQueue<std::pair<int, int>> q(8);
+        int const producers = 4;
+        int const perProducer = 10000;
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p)
+            threads.emplace_back([&q, p] {
+                for (int i = 0; i < perProducer; ++i)
+                    q.push(std::make_pair(p, i));
+            });
+
+        // Each producer items come in order, nothing is lost
+        std::vector<int> last(producers, -1);
+        std::vector<std::pair<int, int>> out;
+        bool ordered = true;
+        int total = 0;
+        while (total < producers * perProducer && q.waitPopAll(out))
+        {
+            for (auto const& [p, i] : out)
+            {
+                ordered = ordered && (i == last[p] + 1);
+                last[p] = i;
+            }
+            total += out.size();
+            out.clear();
+        }
+        for (auto& t : threads)
+            t.join();
+
+        BEAST_EXPECT(ordered);
+        BEAST_EXPECT(total == producers * perProducer);
+        BEAST_EXPECT(q.size() == 0);
+        BEAST_EXPECT(q.stats().pushed == producers * perProducer);
+    }
+
+    void
+    testClose()
+    {
+        testcase("Close");
+
+        using namespace std::chrono_literals;
+
+        // The waiting consumer is released
+        {
+            MPSCQueue<int> q(4);
+            std::vector<int> out;
+            bool ret = true;
+            std::thread t([&] { ret = q.waitPopAll(out); });
+            std::this_thread::sleep_for(10ms);
+            q.close();
+            t.join();
+            BEAST_EXPECT(!ret && out.empty());
+        }
+
+        // Items are popped before close is reported, a producer waiting on a
+        // full queue is released
+        {
+            MPSCQueue<int> q(2);
+            BEAST_EXPECT(q.push(1));
+            BEAST_EXPECT(q.push(2));
+            bool pushed = true;
+            std::thread t([&] { pushed = q.push(3); });
+            std::this_thread::sleep_for(10ms);
+            q.close();
+            t.join();
+            BEAST_EXPECT(!pushed);
+
+            std::vector<int> out;
+            BEAST_EXPECT(q.waitPopAll(out));
+            BEAST_EXPECT(out == std::vector<int>({1, 2}));
+            BEAST_EXPECT(!q.waitPopAll(out));
+        }
+    }
+
+    void
+    testWakeup()
+    {
+        testcase("Wakeup");
+
+        Wakeup w;
+
+        // A notification sent after the token was taken is not lost
+        auto const t = w.token();
+        w.notify();
+        w.wait(t);
+
+        // The waiter checks its condition between the token and the wait
+        using namespace std::chrono_literals;
+        std::atomic_bool flag{false};
+        bool seen = false;
+        std::thread th([&] {
+            for (;;)
+            {
+                auto const token = w.token();
+                if (flag)
+                    break;
+                w.wait(token);
+            }
+            seen = true;
+        });
+        std::this_thread::sleep_for(10ms);
+        flag = true;
+        w.notify();
+        th.join();
+        BEAST_EXPECT(seen);
+    }
+
+    void
+    testNotify()
+    {
+        testcase("Notify");
+
+        using namespace std::chrono_literals;
+
+        // The consumer is released by the state of `ready`, without items
+        MPSCQueue<int> q(4);
+        std::atomic_bool flag{false};
+        std::vector<int> out;
+        bool ret = false;
+        std::thread t([&] {
+            ret = q.waitPopAll(out, [&] { return flag.exchange(false); });
+        });
+        std::this_thread::sleep_for(10ms);
+        flag = true;
+        q.notify();
+        t.join();
+        BEAST_EXPECT(ret && out.empty());
+
+        // Or by the items
+        BEAST_EXPECT(q.push(1));
+        BEAST_EXPECT(q.waitPopAll(out, [] { return false; }));
+        BEAST_EXPECT(out == std::vector<int>({1}));
+
+        out.clear();
+        q.close();
+        BEAST_EXPECT(!q.waitPopAll(out, [] { return false; }));
+    }
+
+public:
+    void
+    run() override
+    {
+        testSingleThread();
+        testProducers();
+        testClose();
+        testWakeup();
+        testNotify();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(MPSCQueue, basics, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/Metrics.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xbwd {
+namespace tests {
+
+class Metrics_test : public beast::unit_test::suite
+{
+private:
+    void
+    testCounter()
+    {
+        testcase("Counter");
+
+        metrics::Counter c;
+        BEAST_EXPECT(c.value() == 0);
+        c.inc();
+        c.inc(2);
+        BEAST_EXPECT(c.value() == 3);
+
+        int const threads = 8;
+        int const perThread = 10000;
+        std::vector<std::thread> ts;
+        for (int t = 0; t < threads; ++t)
+            ts.emplace_back([&c] {
+                for (int i = 0; i < perThread; ++i)
+                    c.inc();
+            });
+        for (auto& t : ts)
+            t.join();
+        BEAST_EXPECT(c.value() == 3 + threads * perThread);
+    }
+
+    void
+    testHistogram()
+    {
+        testcase("Histogram");
+
+        using namespace std::chrono_literals;
+
+        metrics::Histogram h;
+        h.observe(50);
+        h.observe(100);
+        h.observe(101);
+        h.observe(2ms);
+        h.observe(20s);
+
+        auto const s = h.snapshot();
+        BEAST_EXPECT(s.count == 5);
+        BEAST_EXPECT(s.sum == 50 + 100 + 101 + 2000 + 20'000'000);
+        BEAST_EXPECT(s.buckets[0] == 2);
+        BEAST_EXPECT(s.buckets[1] == 1);
+        BEAST_EXPECT(s.buckets[4] == 1);
+        BEAST_EXPECT(s.buckets.back() == 1);
+    }
+
+    void
+    testWriter()
+    {
+        testcase("Writer");
+
+        metrics::Counter c;
+        c.inc(7);
+        metrics::Histogram h;
+        h.observe(300);
+        h.observe(1'500'000);
+
+        metrics::Writer w;
+        w.counter("xbwd_events_total", "Events.", {{"chain", "locking"}}, 5);
+        w.counter(
+            "xbwd_events_total", "Events.", {{"chain", "issuing"}}, c.value());
+        w.gauge("xbwd_queue_size", "Queue size.", {}, 2);
+        w.histogram("xbwd_latency_seconds", "Latency.", {{"db", "txn"}}, h);
+
+        auto const& out = w.str();
+        BEAST_EXPECT(
+            out.find("# HELP xbwd_events_total Events.\n"
+                     "# TYPE xbwd_events_total counter\n"
+                     "xbwd_events_total{chain=\"locking\"} 5\n"
+                     "xbwd_events_total{chain=\"issuing\"} 7\n") == 0);
+        BEAST_EXPECT(
+            out.find("# TYPE xbwd_queue_size gauge\n"
+                     "xbwd_queue_size 2\n") != std::string::npos);
+        BEAST_EXPECT(
+            out.find("xbwd_latency_seconds_bucket{db=\"txn\",le=\"0.00025\"} "
+                     "0\n"
+                     "xbwd_latency_seconds_bucket{db=\"txn\",le=\"0.0005\"} "
+                     "1\n") != std::string::npos);
+        BEAST_EXPECT(
+            out.find("xbwd_latency_seconds_bucket{db=\"txn\",le=\"+Inf\"} "
+                     "2\n"
+                     "xbwd_latency_seconds_sum{db=\"txn\"} 1.5003\n"
+                     "xbwd_latency_seconds_count{db=\"txn\"} 2\n") !=
+            std::string::npos);
+        // One header per metric
+        auto const type = out.find("# TYPE xbwd_events_total");
+        BEAST_EXPECT(
+            out.find("# TYPE xbwd_events_total", type + 1) ==
+            std::string::npos);
+
+        // The common labels come first, until replaced
+        metrics::Writer b;
+        b.commonLabels({{"bridge", "b1"}});
+        b.gauge("xbwd_queue_size", "Queue size.", {{"chain", "locking"}}, 1);
+        b.gauge("xbwd_queue_size", "Queue size.", {}, 2);
+        b.commonLabels({});
+        b.gauge("xbwd_queue_size", "Queue size.", {}, 3);
+        BEAST_EXPECT(
+            b.str() ==
+            "# HELP xbwd_queue_size Queue size.\n"
+            "# TYPE xbwd_queue_size gauge\n"
+            "xbwd_queue_size{bridge=\"b1\",chain=\"locking\"} 1\n"
+            "xbwd_queue_size{bridge=\"b1\"} 2\n"
+            "xbwd_queue_size 3\n");
+    }
+
+public:
+    void
+    run() override
+    {
+        testCounter();
+        testHistogram();
+        testWriter();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Metrics, basics, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
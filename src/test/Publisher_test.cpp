@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <xbwd/rpc/Publisher.h>
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/server/Port.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace xbwd {
+namespace tests {
+
+namespace {
+
+// Collects the messages, as the websocket peer writing them would
+class TestSession : public ripple::WSSession
+{
+    ripple::Port port_;
+    ripple::http_request_type request_;
+    boost::asio::ip::tcp::endpoint endpoint_;
+
+public:
+    std::vector<std::string> sent;
+
+    void
+    run() override
+    {
+    }
+
+    ripple::Port const&
+    port() const override
+    {
+        return port_;
+    }
+
+    ripple::http_request_type const&
+    request() const override
+    {
+        return request_;
+    }
+
+    boost::asio::ip::tcp::endpoint const&
+    remote_endpoint() const override
+    {
+        return endpoint_;
+    }
+
+    void
+    send(std::shared_ptr<ripple::WSMsg> w) override
+    {
+        // In small chunks, to check the message is split right
+        std::string s;
+        for (;;)
+        {
+            auto const [last, buffers] = w->prepare(3, [] {});
+            for (auto const& b : buffers)
+                s.append(static_cast<char const*>(b.data()), b.size());
+            if (last)
+                break;
+        }
+        sent.push_back(std::move(s));
+    }
+
+    void
+    close() override
+    {
+    }
+
+    void
+    close(boost::beast::websocket::close_reason const&) override
+    {
+    }
+
+    void
+    complete() override
+    {
+    }
+};
+
+}  // namespace
+
+class Publisher_test : public beast::unit_test::suite
+{
+    void
+    testSubscribe()
+    {
+        testcase("Subscribe");
+
+        rpc::Publisher publisher;
+        auto const s1 = std::make_shared<TestSession>();
+        auto const s2 = std::make_shared<TestSession>();
+        BEAST_EXPECT(publisher.empty());
+
+        Json::Value jv(Json::objectValue);
+        jv["type"] = "attestation";
+        jv["claim_id"] = 7;
+        // Nobody listens
+        publisher.publish(jv);
+
+        BEAST_EXPECT(publisher.subscribe(s1));
+        BEAST_EXPECT(!publisher.subscribe(s1));
+        BEAST_EXPECT(publisher.subscribe(s2));
+        BEAST_EXPECT(publisher.size() == 2);
+        BEAST_EXPECT(!publisher.empty());
+
+        publisher.publish(jv);
+        BEAST_EXPECT(s1->sent.size() == 1);
+        BEAST_EXPECT(s2->sent.size() == 1);
+        if (BEAST_EXPECT(!s1->sent.empty()))
+        {
+            Json::Value received;
+            BEAST_EXPECT(Json::Reader().parse(s1->sent[0], received));
+            BEAST_EXPECT(received == jv);
+            BEAST_EXPECT(s2->sent == s1->sent);
+        }
+
+        BEAST_EXPECT(publisher.unsubscribe(*s1));
+        BEAST_EXPECT(!publisher.unsubscribe(*s1));
+        publisher.publish(jv);
+        BEAST_EXPECT(s1->sent.size() == 1);
+        BEAST_EXPECT(s2->sent.size() == 2);
+    }
+
+    void
+    testClosed()
+    {
+        testcase("Closed sessions");
+
+        rpc::Publisher publisher;
+        auto s1 = std::make_shared<TestSession>();
+        auto const s2 = std::make_shared<TestSession>();
+        publisher.subscribe(s1);
+        publisher.subscribe(s2);
+
+        // Dropped on the next message
+        s1.reset();
+        BEAST_EXPECT(publisher.size() == 2);
+        publisher.publish(Json::Value("x"));
+        BEAST_EXPECT(publisher.size() == 1);
+        BEAST_EXPECT(s2->sent.size() == 1);
+
+        publisher.unsubscribe(*s2);
+        BEAST_EXPECT(publisher.empty());
+    }
+
+public:
+    void
+    run() override
+    {
+        testSubscribe();
+        testClosed();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Publisher, rpc, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
@@ -19,8 +19,13 @@
 
 #include <xbwd/client/RpcResultParse.h>
 
+#include <ripple/basics/strHex.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/json/json_reader.h>
+#include <ripple/protocol/SField.h>
+#include <ripple/protocol/STParsedJSON.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/jss.h>
 
 #include <fmt/format.h>
 
@@ -313,6 +318,14 @@ private:
         BEAST_EXPECT(seq && seq == 3);
         seq = parseTxSeq(jvEmpty);
         BEAST_EXPECT(!seq);
+        {
+            // Sent with a ticket
+            Json::Value txTicket = txCommitAtt;
+            txTicket[ripple::jss::Sequence] = 0;
+            txTicket[ripple::sfTicketSequence.getJsonName()] = 42;
+            seq = parseTxSeq(txTicket);
+            BEAST_EXPECT(seq && seq == 42);
+        }
 
         auto ledgSeq = parseLedgerSeq(txCreate);
         BEAST_EXPECT(ledgSeq && ledgSeq == 7);
@@ -357,6 +370,73 @@ private:
         BEAST_EXPECT(!deliveryAmt);
     }
 
+    void
+    testParseBinary()
+    {
+        testcase("Test binary parser");
+        using namespace rpcResultParse;
+
+        auto toBlob = [](ripple::STObject const& obj) {
+            ripple::Serializer s;
+            obj.add(s);
+            return Json::Value(ripple::strHex(s.slice()));
+        };
+
+        for (char const* const str :
+             {TxAccCreate,
+              TxCommit,
+              TxAccCreateAtt,
+              TxAccClaimAtt,
+              TxCreateBridge})
+        {
+            Json::Value jv;
+            Json::Reader().parse(str, jv);
+            auto const& jvTx = jv["transaction"];
+            auto const& jvMeta = jv["meta"];
+
+            // The blobs have only the serialized fields
+            Json::Value fields = jvTx;
+            for (char const* f : {"date", "hash", "inLedger", "ledger_index"})
+                fields.removeMember(f);
+            ripple::STParsedJSONObject const parsedTx("tx", fields);
+            ripple::STParsedJSONObject const parsedMeta("meta", jvMeta);
+            if (!BEAST_EXPECT(parsedTx.object && parsedMeta.object))
+                continue;
+
+            auto const tx = parseTxBlob(toBlob(*parsedTx.object));
+            auto const meta = parseMetaBlob(toBlob(*parsedMeta.object));
+            if (!BEAST_EXPECT(tx && meta))
+                continue;
+
+            auto const txType = parseXChainTxnType(*tx);
+            if (!BEAST_EXPECT(txType && txType == parseXChainTxnType(jvTx)))
+                continue;
+            BEAST_EXPECT(parseSrcAccount(*tx) == parseSrcAccount(jvTx));
+            BEAST_EXPECT(
+                parseDstAccount(*tx, *txType) ==
+                parseDstAccount(jvTx, *txType));
+            BEAST_EXPECT(
+                parseOtherSrcAccount(*tx, *txType) ==
+                parseOtherSrcAccount(jvTx, *txType));
+            BEAST_EXPECT(
+                parseOtherDstAccount(*tx, *txType) ==
+                parseOtherDstAccount(jvTx, *txType));
+            BEAST_EXPECT(parseBridge(*tx) == parseBridge(jvTx));
+            BEAST_EXPECT(parseTxHash(*tx) == parseTxHash(jvTx));
+            BEAST_EXPECT(parseTxSeq(*tx) == parseTxSeq(jvTx));
+            BEAST_EXPECT(parseRewardAmt(*tx) == parseRewardAmt(jvTx));
+            BEAST_EXPECT(
+                parseDeliveredAmt(*tx, *meta) ==
+                parseDeliveredAmt(jvTx, jvMeta));
+            BEAST_EXPECT(parseCreateCount(*meta) == parseCreateCount(jvMeta));
+        }
+
+        BEAST_EXPECT(!parseTxBlob(Json::Value()));
+        BEAST_EXPECT(!parseTxBlob(Json::Value("not hex")));
+        BEAST_EXPECT(!parseTxBlob(Json::Value("1200")));
+        BEAST_EXPECT(!parseMetaBlob(Json::Value("")));
+    }
+
 public:
     void
     run() override
@@ -364,6 +444,7 @@ public:
         testToString();
         testMatchStr();
         testParse();
+        testParseBinary();
     }
 };
 
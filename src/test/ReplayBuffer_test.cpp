@@ -0,0 +1,237 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/federator/ReplayBuffer.h>
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Issue.h>
+#include <ripple/protocol/digest.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <vector>
+
+namespace xbwd {
+namespace tests {
+
+namespace {
+
+std::string const replayFile = "test_replay_buffer";
+
+ripple::STXChainBridge
+makeBridge(std::uint64_t door)
+{
+    return ripple::STXChainBridge(
+        ripple::AccountID(door),
+        ripple::xrpIssue(),
+        ripple::AccountID(door + 1),
+        ripple::xrpIssue());
+}
+
+event::XChainCommitDetected
+makeCommit(ripple::STXChainBridge const& bridge, std::int32_t rpcOrder)
+{
+    event::XChainCommitDetected e;
+    e.chainType_ = ChainType::locking;
+    e.src_ = ripple::AccountID(7);
+    e.bridge_ = bridge;
+    e.claimID_ = 100 + rpcOrder;
+    e.ledgerSeq_ = 1000 + rpcOrder;
+    e.txnHash_ = ripple::uint256(500 + rpcOrder);
+    e.status_ = ripple::tesSUCCESS;
+    e.rpcOrder_ = rpcOrder;
+    e.ledgerBoundary_ = false;
+    return e;
+}
+
+}  // namespace
+
+class ReplayBuffer_test : public beast::unit_test::suite
+{
+    // The rpc orders of the events, in the replay order
+    std::vector<std::int32_t>
+    replayed(ReplayBuffer const& b)
+    {
+        std::vector<std::int32_t> r;
+        b.forEach([&](FederatorEvent&& e) {
+            if (auto const c = std::get_if<event::XChainCommitDetected>(&e))
+                r.push_back(*c->rpcOrder_);
+        });
+        return r;
+    }
+
+    void
+    testOrder()
+    {
+        testcase("Order");
+
+        auto const bridge = makeBridge(1);
+        std::int32_t constexpr history = 50;
+        std::int32_t constexpr recent = 30;
+        std::vector<std::int32_t> expected;
+        for (std::int32_t i = -history; i < 0; ++i)
+            expected.push_back(i);
+        for (std::int32_t i = 1; i <= recent; ++i)
+            expected.push_back(i);
+
+        // All in memory, all in the file, and both
+        for (std::size_t const memoryBytes : {1 << 20, 0, 1 << 10})
+        {
+            ReplayBuffer b(bridge, replayFile, memoryBytes);
+            // The history from the newest, the new events mixed in
+            for (std::int32_t i = 1; i <= history; ++i)
+            {
+                b.pushFront(makeCommit(bridge, -i));
+                if (i <= recent)
+                    b.pushBack(makeCommit(bridge, i));
+            }
+            BEAST_EXPECT(b.size() == expected.size());
+            BEAST_EXPECT(
+                memoryBytes ? b.memoryBytes() > 0 : b.memoryBytes() == 0);
+            BEAST_EXPECT(
+                memoryBytes >= (1 << 20) ? b.fileBytes() == 0
+                                         : b.fileBytes() > 0);
+            BEAST_EXPECT(replayed(b) == expected);
+
+            b.clear();
+            BEAST_EXPECT(b.empty() && b.fileBytes() == 0);
+            BEAST_EXPECT(replayed(b).empty());
+        }
+
+        // The spill file is unlinked once opened
+        BEAST_EXPECT(!boost::filesystem::exists(replayFile + ".0"));
+        BEAST_EXPECT(!boost::filesystem::exists(replayFile + ".1"));
+    }
+
+    void
+    testFields()
+    {
+        testcase("Fields");
+
+        auto const bridge = makeBridge(1);
+        ReplayBuffer b(bridge, replayFile, 0);
+
+        // Every optional field, another bridge
+        auto commit = makeCommit(makeBridge(10), 3);
+        commit.chainType_ = ChainType::issuing;
+        commit.deliveredAmt_ = ripple::STAmount(std::uint64_t(12345));
+        commit.otherChainDst_ = ripple::AccountID(8);
+        commit.status_ = ripple::tecNO_DST;
+        commit.ledgerBoundary_ = true;
+        commit.signature_ = ripple::Buffer("sig", 3);
+        b.pushBack(commit);
+
+        event::XChainAccountCreateCommitDetected create;
+        create.chainType_ = ChainType::locking;
+        create.src_ = ripple::AccountID(9);
+        create.bridge_ = bridge;
+        create.rewardAmt_ = ripple::STAmount(std::uint64_t(10));
+        create.createCount_ = 42;
+        create.otherChainDst_ = ripple::AccountID(11);
+        create.ledgerSeq_ = 77;
+        create.txnHash_ = ripple::uint256(78);
+        create.status_ = ripple::tesSUCCESS;
+        create.ledgerBoundary_ = false;
+        b.pushBack(create);
+
+        std::vector<FederatorEvent> events;
+        b.forEach([&](FederatorEvent&& e) { events.push_back(std::move(e)); });
+        if (!BEAST_EXPECT(events.size() == 2))
+            return;
+
+        auto const c = std::get_if<event::XChainCommitDetected>(&events[0]);
+        if (BEAST_EXPECT(c))
+        {
+            BEAST_EXPECT(c->chainType_ == ChainType::issuing);
+            BEAST_EXPECT(c->src_ == commit.src_);
+            BEAST_EXPECT(c->bridge_ == commit.bridge_);
+            BEAST_EXPECT(c->deliveredAmt_ == commit.deliveredAmt_);
+            BEAST_EXPECT(c->claimID_ == commit.claimID_);
+            BEAST_EXPECT(c->otherChainDst_ == commit.otherChainDst_);
+            BEAST_EXPECT(c->ledgerSeq_ == commit.ledgerSeq_);
+            BEAST_EXPECT(c->txnHash_ == commit.txnHash_);
+            BEAST_EXPECT(c->status_ == ripple::tecNO_DST);
+            BEAST_EXPECT(c->rpcOrder_ == commit.rpcOrder_);
+            BEAST_EXPECT(c->ledgerBoundary_);
+            BEAST_EXPECT(c->signature_ == commit.signature_);
+        }
+
+        auto const a =
+            std::get_if<event::XChainAccountCreateCommitDetected>(&events[1]);
+        if (BEAST_EXPECT(a))
+        {
+            BEAST_EXPECT(a->bridge_ == bridge);
+            BEAST_EXPECT(!a->deliveredAmt_);
+            BEAST_EXPECT(a->rewardAmt_ == create.rewardAmt_);
+            BEAST_EXPECT(a->createCount_ == 42);
+            BEAST_EXPECT(a->otherChainDst_ == create.otherChainDst_);
+            BEAST_EXPECT(a->status_ == ripple::tesSUCCESS);
+            BEAST_EXPECT(!a->rpcOrder_ && !a->signature_);
+        }
+
+        // Only the commit events are replayed
+        try
+        {
+            b.pushBack(event::EndOfHistory{ChainType::locking});
+            fail();
+        }
+        catch (std::logic_error const&)
+        {
+            pass();
+        }
+        BEAST_EXPECT(b.size() == 2);
+    }
+
+    void
+    testFingerprints()
+    {
+        testcase("Fingerprints");
+
+        FingerprintSet s;
+        for (std::uint64_t i = 100; i > 0; --i)
+            s.insert(ripple::sha512Half(i));
+        s.insert(ripple::sha512Half(std::uint64_t(1)));
+        BEAST_EXPECT(s.size() == 100);
+        BEAST_EXPECT(s.contains(ripple::sha512Half(std::uint64_t(50))));
+        BEAST_EXPECT(!s.contains(ripple::sha512Half(std::uint64_t(101))));
+
+        // Found again after more inserts
+        s.insert(ripple::sha512Half(std::uint64_t(101)));
+        BEAST_EXPECT(s.contains(ripple::sha512Half(std::uint64_t(101))));
+        BEAST_EXPECT(s.contains(ripple::sha512Half(std::uint64_t(1))));
+
+        s.clear();
+        BEAST_EXPECT(s.size() == 0);
+        BEAST_EXPECT(!s.contains(ripple::sha512Half(std::uint64_t(1))));
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrder();
+        testFields();
+        testFingerprints();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ReplayBuffer, federator, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
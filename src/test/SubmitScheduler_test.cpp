@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/federator/SubmitScheduler.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <memory>
+
+namespace xbwd {
+namespace tests {
+
+class SubmitScheduler_test : public beast::unit_test::suite
+{
+    using Scheduler = SubmitScheduler<std::unique_ptr<int>>;
+    using clock = Scheduler::clock;
+
+    enum { urgent, create, claim, classes };
+
+    static std::vector<int>
+    values(std::vector<std::unique_ptr<int>> const& v)
+    {
+        std::vector<int> r;
+        for (auto const& p : v)
+            r.push_back(*p);
+        return r;
+    }
+
+    void
+    testOrder()
+    {
+        testcase("Order");
+
+        Scheduler s(classes);
+        BEAST_EXPECT(s.empty());
+
+        // Claims in the arrival order
+        for (int i = 0; i < 3; ++i)
+            s.push(claim, {}, std::make_unique<int>(100 + i));
+        // Creates by key, whatever the arrival
+        s.push(create, {12, 0}, std::make_unique<int>(12));
+        s.push(create, {10, 0}, std::make_unique<int>(10));
+        s.push(create, {11, 0}, std::make_unique<int>(11));
+        s.push(urgent, {}, std::make_unique<int>(1));
+        BEAST_EXPECT(s.size() == 7);
+
+        std::vector<int> all;
+        s.forEach([&](std::unique_ptr<int> const& p) { all.push_back(*p); });
+        BEAST_EXPECT((all == std::vector<int>{1, 10, 11, 12, 100, 101, 102}));
+
+        BEAST_EXPECT((values(s.pop(3)) == std::vector<int>{1, 10, 11}));
+        // A claim flood doesn't pass the creates
+        for (int i = 0; i < 100; ++i)
+            s.push(claim, {}, std::make_unique<int>(200 + i));
+        s.push(create, {13, 0}, std::make_unique<int>(13));
+        BEAST_EXPECT((values(s.pop(3)) == std::vector<int>{12, 13, 100}));
+        BEAST_EXPECT(s.size() == 102);
+        BEAST_EXPECT(s.pop(1000).size() == 102);
+        BEAST_EXPECT(s.empty());
+        BEAST_EXPECT(s.pop(1).empty());
+    }
+
+    void
+    testStats()
+    {
+        testcase("Stats");
+
+        Scheduler s(classes);
+        auto const t0 = clock::now();
+        s.push(claim, {}, std::make_unique<int>(1), t0);
+        s.push(
+            claim, {}, std::make_unique<int>(2), t0 + std::chrono::seconds(1));
+        s.push(create, {}, std::make_unique<int>(3), t0);
+
+        auto st = s.stats(claim, t0 + std::chrono::seconds(3));
+        BEAST_EXPECT(st.depth == 2);
+        BEAST_EXPECT(st.pushed == 2);
+        BEAST_EXPECT(st.popped == 0);
+        BEAST_EXPECT(st.oldestWaitUs == 3'000'000);
+
+        s.pop(2, t0 + std::chrono::seconds(2));
+        st = s.stats(claim, t0 + std::chrono::seconds(2));
+        BEAST_EXPECT(st.depth == 1);
+        BEAST_EXPECT(st.popped == 1);
+        BEAST_EXPECT(st.lastWaitUs == 2'000'000);
+        BEAST_EXPECT(st.maxWaitUs == 2'000'000);
+        BEAST_EXPECT(st.oldestWaitUs == 1'000'000);
+
+        st = s.stats(create, t0 + std::chrono::seconds(2));
+        BEAST_EXPECT(st.depth == 0);
+        BEAST_EXPECT(st.popped == 1);
+        BEAST_EXPECT(st.avgWaitUs == 2'000'000);
+        BEAST_EXPECT(st.oldestWaitUs == 0);
+        BEAST_EXPECT(s.stats(urgent).pushed == 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrder();
+        testStats();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SubmitScheduler, federator, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#include <xbwd/federator/SubmitWindow.h>
+
+#include <ripple/beast/unit_test.h>
+
+namespace xbwd {
+namespace tests {
+
+class SubmitWindow_test : public beast::unit_test::suite
+{
+private:
+    void
+    testFixed()
+    {
+        testcase("Fixed");
+
+        SubmitWindow none(0, 0);
+        BEAST_EXPECT(!none.adaptive());
+        BEAST_EXPECT(none.size() == 0);
+        none.onLanded();
+        BEAST_EXPECT(!none.onCongestion(1));
+        BEAST_EXPECT(none.size() == 0);
+
+        SubmitWindow fixed(200, 200);
+        BEAST_EXPECT(!fixed.adaptive());
+        fixed.onLanded();
+        BEAST_EXPECT(!fixed.onCongestion(1));
+        BEAST_EXPECT(fixed.size() == 200);
+        BEAST_EXPECT(fixed.landed() == 1);
+        BEAST_EXPECT(fixed.decreases() == 0);
+    }
+
+    void
+    testAdaptive()
+    {
+        testcase("Adaptive");
+
+        SubmitWindow w(4, 64);
+        BEAST_EXPECT(w.adaptive());
+        BEAST_EXPECT(w.size() == 4);
+
+        // Grows by one per landed transaction up to the max
+        for (int i = 0; i < 100; ++i)
+            w.onLanded();
+        BEAST_EXPECT(w.size() == 64);
+
+        // Halved once per ledger
+        BEAST_EXPECT(w.onCongestion(10));
+        BEAST_EXPECT(w.size() == 32);
+        BEAST_EXPECT(!w.onCongestion(10));
+        BEAST_EXPECT(w.size() == 32);
+
+        // Above the threshold grows by about one per window
+        for (int i = 0; i < 31; ++i)
+            w.onLanded();
+        BEAST_EXPECT(w.size() == 32);
+        for (int i = 0; i < 2; ++i)
+            w.onLanded();
+        BEAST_EXPECT(w.size() == 33);
+
+        // Never below the min
+        for (std::uint32_t l = 11; l < 20; ++l)
+            w.onCongestion(l);
+        BEAST_EXPECT(w.size() == 4);
+        BEAST_EXPECT(w.decreases() == 10);
+    }
+
+public:
+    void
+    run() override
+    {
+        testFixed();
+        testAdaptive();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SubmitWindow, federator, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
@@ -0,0 +1,141 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/TimerWheel.h>
+
+#include <ripple/beast/unit_test.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace xbwd {
+namespace tests {
+
+class TimerWheel_test : public beast::unit_test::suite
+{
+private:
+    using clock = TimerWheel<int>::clock;
+
+    static std::vector<int>
+    sorted(std::vector<int> v)
+    {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    void
+    testDue()
+    {
+        testcase("Due timers");
+
+        using namespace std::chrono_literals;
+        auto const t0 = clock::now();
+        TimerWheel<int> wheel(1s, 8, t0);
+
+        wheel.add(1, t0 + 1s);
+        wheel.add(2, t0 + 3s);
+        // Not before its deadline
+        wheel.add(3, t0 + 2500ms);
+        BEAST_EXPECT(wheel.size() == 3);
+
+        BEAST_EXPECT(wheel.advance(t0 + 500ms).empty());
+        BEAST_EXPECT(wheel.advance(t0 + 1s) == std::vector<int>{1});
+        BEAST_EXPECT(wheel.advance(t0 + 2s).empty());
+        BEAST_EXPECT(
+            sorted(wheel.advance(t0 + 3s)) == (std::vector<int>{2, 3}));
+        BEAST_EXPECT(wheel.size() == 0);
+
+        // The time going back changes nothing
+        wheel.add(4, t0 + 4s);
+        BEAST_EXPECT(wheel.advance(t0 + 1s).empty());
+        BEAST_EXPECT(wheel.advance(t0 + 4s) == std::vector<int>{4});
+    }
+
+    void
+    testTurns()
+    {
+        testcase("Several turns");
+
+        using namespace std::chrono_literals;
+        auto const t0 = clock::now();
+        TimerWheel<int> wheel(1s, 8, t0);
+
+        // Same slot as the tick 7, three turns later
+        wheel.add(1, t0 + 23s);
+        BEAST_EXPECT(wheel.advance(t0 + 10s).empty());
+        BEAST_EXPECT(wheel.advance(t0 + 22s).empty());
+        BEAST_EXPECT(wheel.advance(t0 + 23s) == std::vector<int>{1});
+
+        // Advanced by more than a turn at once
+        wheel.add(2, t0 + 25s);
+        wheel.add(3, t0 + 40s);
+        wheel.add(4, t0 + 200s);
+        BEAST_EXPECT(
+            sorted(wheel.advance(t0 + 100s)) == (std::vector<int>{2, 3}));
+        BEAST_EXPECT(wheel.size() == 1);
+
+        // A deadline already passed is due on the next tick
+        wheel.add(5, t0);
+        BEAST_EXPECT(wheel.advance(t0 + 100s).empty());
+        BEAST_EXPECT(wheel.advance(t0 + 101s) == std::vector<int>{5});
+        BEAST_EXPECT(wheel.advance(t0 + 200s) == std::vector<int>{4});
+        BEAST_EXPECT(wheel.size() == 0);
+    }
+
+    void
+    testInvalid()
+    {
+        testcase("Invalid wheel");
+
+        using namespace std::chrono_literals;
+        try
+        {
+            TimerWheel<int> wheel(0s, 8);
+            fail();
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+        try
+        {
+            TimerWheel<int> wheel(1s, 0);
+            fail();
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testDue();
+        testTurns();
+        testInvalid();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(TimerWheel, basics, xbwd);
+
+}  // namespace tests
+}  // namespace xbwd
@@ -455,12 +455,78 @@ private:
         BEAST_EXPECT(c.repl_ == params);
     }
 
+    void
+    testBufferPool()
+    {
+        testcase("Test Websocket receive buffers");
+
+        Connection c;
+        c.startServer(LHOST, LPORT);
+        c.startIOThreads();
+
+        WebsocketClient::Traffic traffic;
+        std::shared_ptr<WebsocketClient> wsClient =
+            std::make_shared<WebsocketClient>(
+                [self = &c](Json::Value const& msg) { self->onMessage(msg); },
+                [self = &c]() { self->onConnect(); },
+                c.ios_,
+                beast::IP::Endpoint{
+                    boost::asio::ip::make_address(LHOST), LPORT},
+                std::unordered_map<std::string, std::string>{},
+                j_,
+                &traffic);
+        wsClient->connect();
+
+        wait_for(60s, [&c]() {
+            return c.connected_ == true;
+        } DBG_ARGS("onConnect()"));
+        BEAST_EXPECT(c.connected_ == true);
+
+        // One at a time, the buffer of a reply is back in the pool before
+        // the next one
+        std::uint32_t const msgs = 20;
+        for (std::uint32_t i = 0; i < msgs; ++i)
+        {
+            {
+                std::unique_lock l{gMcv};
+                c.repl_ = Json::Value();
+            }
+            Json::Value params;
+            params[ripple::jss::account] = "rnscFKLtPLn9MnUZh8EHi2KEnJR6qcZXWg";
+            auto const id = wsClient->send(
+                "account_info", params, "locking", [](std::uint32_t) {});
+            wait_for(1s, [&c, id]() {
+                return c.repl_[ripple::jss::id] == id;
+            } DBG_ARGS("onMessage()"));
+        }
+
+        wait_for(1s, [&traffic]() {
+            return traffic.readMsgs_.value() == msgs;
+        } DBG_ARGS("readMsgs"));
+        BEAST_EXPECT(traffic.readMsgs_.value() == msgs);
+        BEAST_EXPECT(
+            traffic.bufferHits_.value() + traffic.bufferMisses_.value() ==
+            msgs);
+        BEAST_EXPECT(traffic.bufferHits_.value() > 0);
+        BEAST_EXPECT(traffic.maxQueueSize_ >= 1);
+        BEAST_EXPECT(traffic.readPauses_.value() == 0);
+
+        wait_for(1s, [&traffic]() {
+            return traffic.writeMsgs_.value() == msgs;
+        } DBG_ARGS("writeMsgs"));
+        BEAST_EXPECT(traffic.writeMsgs_.value() == msgs);
+        BEAST_EXPECT(traffic.writeQueueSize_ == 0);
+
+        wsClient.reset();
+    }
+
 public:
     void
     run() override
     {
         testWS();
         testReconnect();
+        testBufferPool();
     }
 };
 
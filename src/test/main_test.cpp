@@ -89,6 +89,7 @@ extern const char accInfoIss1[];
 extern const char accTxIss1[];
 extern const char accTxIss2[];
 extern const char submIss[];
+extern const char feeResp[];
 
 std::mutex gMCons;
 
@@ -179,6 +180,8 @@ public:
         else if (method == "ledger_entry")
             s = fmt::format(
                 fmt::runtime(prepForFmt(ledgerEntryLoc)), "id"_a = id);
+        else if (method == "fee")
+            s = fmt::format(fmt::runtime(prepForFmt(feeResp)), "id"_a = id);
         else if (method == "account_tx")
         {
             if (!accTxCtr)
@@ -294,6 +297,8 @@ public:
         else if (method == "ledger_entry")
             s = fmt::format(
                 fmt::runtime(prepForFmt(ledgerEntryIss)), "id"_a = id);
+        else if (method == "fee")
+            s = fmt::format(fmt::runtime(prepForFmt(feeResp)), "id"_a = id);
         else if (method == "account_tx")
         {
             if (!accTxCtr)
@@ -2396,6 +2401,35 @@ const char submIss[] = R"str(
 }
 )str";
 
+const char feeResp[] = R"str(
+{
+   "id" : `id`,
+   "jsonrpc" : "2.0",
+   "result" : {
+      "current_ledger_size" : "0",
+      "current_queue_size" : "0",
+      "drops" : {
+         "base_fee" : "10",
+         "median_fee" : "5000",
+         "minimum_fee" : "10",
+         "open_ledger_fee" : "10"
+      },
+      "expected_ledger_size" : "32",
+      "ledger_current_index" : 8,
+      "levels" : {
+         "median_level" : "128000",
+         "minimum_level" : "256",
+         "open_ledger_level" : "256",
+         "reference_level" : "256"
+      },
+      "max_queue_size" : "640"
+   },
+   "ripplerpc" : "2.0",
+   "status" : "success",
+   "type" : "response"
+}
+)str";
+
 }  // namespace all
 }  // namespace tests
 }  // namespace xbwd
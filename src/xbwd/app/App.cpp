@@ -2,6 +2,7 @@
 
 #include <xbwd/app/BuildInfo.h>
 #include <xbwd/app/DBInit.h>
+#include <xbwd/app/DBStatements.h>
 #include <xbwd/basics/StructuredLog.h>
 #include <xbwd/federator/Federator.h>
 #include <xbwd/rpc/RPCCall.h>
@@ -16,24 +17,64 @@
 #include <fmt/format.h>
 
 #include <filesystem>
+#include <iostream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace xbwd {
 
-BasicApp::BasicApp(std::size_t numberOfThreads)
+namespace {
+
+void
+setThreadAffinity(std::thread& t, std::uint32_t cpu)
 {
-    work_.emplace(io_service_);
-    threads_.reserve(numberOfThreads);
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (auto const err =
+            pthread_setaffinity_np(t.native_handle(), sizeof(set), &set))
+        std::cerr << "Can't pin the io thread to cpu " << cpu << ", error "
+                  << err << std::endl;
+#else
+    std::cerr << "CPUAffinity is not supported on this platform" << std::endl;
+#endif
+}
+
+}  // namespace
 
-    while (numberOfThreads--)
+void
+runIOThreads(
+    boost::asio::io_service& ios,
+    std::vector<std::thread>& threads,
+    std::string const& name,
+    std::size_t numberOfThreads,
+    std::vector<std::uint32_t> const& cpus)
+{
+    threads.reserve(numberOfThreads);
+
+    for (std::size_t i = 0; i < numberOfThreads; ++i)
     {
-        threads_.emplace_back([this, numberOfThreads]() {
-            beast::setCurrentThreadName(
-                "io svc #" + std::to_string(numberOfThreads));
-            this->io_service_.run();
+        auto& t = threads.emplace_back([&ios, name, i]() {
+            beast::setCurrentThreadName(name + " #" + std::to_string(i));
+            ios.run();
         });
+        if (!cpus.empty())
+            setThreadAffinity(t, cpus[i % cpus.size()]);
     }
 }
 
+BasicApp::BasicApp(
+    std::size_t numberOfThreads,
+    std::vector<std::uint32_t> const& cpus)
+{
+    work_.emplace(io_service_);
+    runIOThreads(io_service_, threads_, "io svc", numberOfThreads, cpus);
+}
+
 BasicApp::~BasicApp()
 {
     work_.reset();
@@ -43,10 +84,33 @@ BasicApp::~BasicApp()
             t.join();
 }
 
+ChainIOService::ChainIOService(ChainType ct, config::ChainConfig const& config)
+{
+    work_.emplace(io_service_);
+    runIOThreads(
+        io_service_,
+        threads_,
+        "io " + to_string(ct),
+        config.ioThreads,
+        config.cpuAffinity);
+}
+
+ChainIOService::~ChainIOService()
+{
+    work_.reset();
+    io_service_.stop();
+    for (auto& t : threads_)
+        if (t.joinable())
+            t.join();
+}
+
 App::App(
     std::unique_ptr<config::Config> config,
     beast::severities::Severity logLevel)
-    : BasicApp(std::thread::hardware_concurrency())
+    : BasicApp(
+          config->ioThreads ? config->ioThreads
+                            : std::thread::hardware_concurrency(),
+          config->cpuAffinity)
     , logs_(logLevel)
     , j_([&, this]() {
         if (!config->logFile.empty())
@@ -59,13 +123,25 @@ App::App(
         logs_.silent(config->logSilent);
         return logs_.journal("App");
     }())
+    , asyncLog_(
+          config->logAsyncQueue ? std::make_unique<AsyncLog>(
+                                      config->logAsyncQueue,
+                                      logs_.journal("AsyncLog"))
+                                : nullptr)
     , xChainTxnDB_(
           config->dataDir,
           db_init::xChainDBName(),
           db_init::xChainDBPragma(),
           db_init::xChainDBInit(),
-          j_)
+          j_,
+          DatabaseSetup{
+              config->database.wal,
+              config->database.synchronous,
+              config->database.readers,
+              config->database.checkpointPages,
+              config->database.vacuumPages})
     , signals_(io_service_)
+    , logLimitTimer_(io_service_)
     , config_(std::move(config))
 {
     // TODO initialize the public and secret keys
@@ -79,10 +155,72 @@ App::App(
         get_io_service(), config_->issuingChainConfig.addrChainIp);
     config_->lockingChainConfig.chainIp = xbwd::rpc_call::addrToEndpoint(
         get_io_service(), config_->lockingChainConfig.addrChainIp);
+    for (auto* cc :
+         {&config_->lockingChainConfig, &config_->issuingChainConfig})
+        for (auto const& ae : cc->addrFallbackIps)
+            cc->fallbackIps.push_back(
+                xbwd::rpc_call::addrToEndpoint(get_io_service(), ae));
+    // The bridges share the endpoints of the top level config
+    for (auto& b : config_->bridges)
+    {
+        b.rpcEndpoint = config_->rpcEndpoint;
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
+        {
+            auto const& from = ct == ChainType::locking
+                ? config_->lockingChainConfig
+                : config_->issuingChainConfig;
+            auto& to = ct == ChainType::locking ? b.lockingChainConfig
+                                                : b.issuingChainConfig;
+            to.chainIp = from.chainIp;
+            to.fallbackIps = from.fallbackIps;
+        }
+    }
 
     try
     {
-        federator_ = make_Federator(*this, get_io_service(), *config_, logs_);
+        {
+            auto session = xChainTxnDB_.checkoutDb();
+            db_init::xChainDBMigrate(*session, j_);
+            for (auto const& b : config_->bridges)
+                for (auto const& sql : db_init::xChainDBInit(b.name))
+                    *session << sql;
+        }
+        std::vector<std::string> names{std::string()};
+        for (auto const& b : config_->bridges)
+            names.push_back(b.name);
+        xChainTxnDB_.prepareStatements([names](soci::session& s) {
+            return db_stmt::prepareBridges(s, names);
+        });
+        attestationStores_[{}] = makeAttestationStore(
+            *config_, xChainTxnDB_, logs_.journal("AttestationStore"));
+        for (auto const& b : config_->bridges)
+            attestationStores_[b.name] = makeAttestationStore(
+                b, xChainTxnDB_, logs_.journal("AttestationStore"));
+
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
+        {
+            auto const& cc = ct == ChainType::locking
+                ? config_->lockingChainConfig
+                : config_->issuingChainConfig;
+            if (cc.ioThreads)
+                chainIOServices_[ct] =
+                    std::make_unique<ChainIOService>(ct, cc);
+
+            std::vector<beast::IP::Endpoint> eps{cc.chainIp};
+            eps.insert(eps.end(), cc.fallbackIps.begin(), cc.fallbackIps.end());
+            chainConnections_[ct] = std::make_shared<ChainConnection>(
+                ct, get_io_service(ct), eps, logs_.journal("ChainConnection"));
+        }
+
+        federators_.push_back(
+            make_Federator(*this, get_io_service(), *config_, logs_));
+        for (auto const& b : config_->bridges)
+            federators_.push_back(
+                make_Federator(*this, get_io_service(), b, logs_));
+
+        // All the listeners are subscribed
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
+            chainConnections_[ct]->connect();
 
         serverHandler_ = std::make_unique<rpc::ServerHandler>(
             *this, get_io_service(), logs_.journal("ServerHandler"));
@@ -131,6 +269,9 @@ App::setup()
             p.port = endpoint.port();
             // TODO - encode protocol in config
             p.protocol.insert("http");
+            // The subscriptions, see rpc::Publisher
+            p.protocol.insert("ws");
+            p.ws_queue_limit = config_->wsQueueLimit;
             r.push_back(p);
             return r;
         }();
@@ -147,25 +288,49 @@ App::setup()
 void
 App::start()
 {
-    if (federator_)
-        federator_->start();
+    for (auto& f : federators_)
+        f->start();
     // TODO: unlockMainLoop should go away
-    federator_->unlockMainLoop();
+    for (auto& f : federators_)
+        f->unlockMainLoop();
 
     logRotation_ = std::thread(&App::logRotation, this);
+    scheduleLogLimitFlush();
 }
 
 void
 App::stop()
 {
-    if (federator_)
-        federator_->stop();
+    logLimitTimer_.cancel();
+    for (auto& f : federators_)
+        f->stop();
+    for (auto& conn : chainConnections_)
+        if (conn)
+            conn->shutdown();
     if (serverHandler_)
         serverHandler_->stop();
     if (logRotation_.joinable())
         logRotation_.join();
 }
 
+void
+App::scheduleLogLimitFlush()
+{
+    logLimitTimer_.expires_after(LogLimiter::flushInterval);
+    logLimitTimer_.async_wait([this](boost::system::error_code const& ec) {
+        if (ec == boost::asio::error::operation_aborted)
+            return;
+        // Not through JLOGV, the summary is not limited
+        for (auto const& [jlogId, suppressed] :
+             LogLimiter::instance().flush(LogLimiter::clock_type::now()))
+            JLOG(j_.info()) << fmt::format(
+                R"(Log messages suppressed {{"jlogId": {}, "suppressed": {}}})",
+                jlogId,
+                suppressed);
+        scheduleLogLimitFlush();
+    });
+}
+
 void
 App::run()
 {
@@ -183,6 +348,12 @@ App::getXChainTxnDB()
     return xChainTxnDB_;
 }
 
+AttestationStore&
+App::attestationStore(std::string const& bridge)
+{
+    return *attestationStores_.at(bridge);
+}
+
 void
 App::signalStop()
 {
@@ -196,10 +367,45 @@ App::config()
     return *config_;
 }
 
+boost::asio::io_service&
+App::get_io_service(ChainType ct)
+{
+    if (auto& ios = chainIOServices_[ct])
+        return ios->get_io_service();
+    return get_io_service();
+}
+
+std::shared_ptr<ChainConnection>
+App::chainConnection(ChainType ct)
+{
+    return chainConnections_[ct];
+}
+
 Federator&
 App::federator()
 {
-    return *federator_;
+    return *federators_.front();
+}
+
+Federator*
+App::federator(ripple::STXChainBridge const& bridge)
+{
+    for (auto& f : federators_)
+        if (f->bridge() == bridge)
+            return f.get();
+    return nullptr;
+}
+
+std::vector<std::unique_ptr<Federator>> const&
+App::federators() const
+{
+    return federators_;
+}
+
+rpc::Publisher&
+App::publisher()
+{
+    return publisher_;
 }
 
 void
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <xbwd/app/AttestationStore.h>
 #include <xbwd/app/Config.h>
+#include <xbwd/basics/AsyncLog.h>
+#include <xbwd/basics/ChainTypes.h>
+#include <xbwd/client/ChainConnection.h>
 #include <xbwd/core/DatabaseCon.h>
 #include <xbwd/federator/Federator.h>
+#include <xbwd/rpc/Publisher.h>
 #include <xbwd/rpc/ServerHandler.h>
 
 #include <ripple/beast/utility/Journal.h>
@@ -14,9 +19,13 @@
 
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <condition_variable>
+#include <map>
+#include <memory>
 #include <optional>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -29,6 +38,15 @@ namespace xbwd {
 
 class Federator;
 
+// Threads named "<name> #<n>", pinned to the cpus in turn if any
+void
+runIOThreads(
+    boost::asio::io_service& ios,
+    std::vector<std::thread>& threads,
+    std::string const& name,
+    std::size_t numberOfThreads,
+    std::vector<std::uint32_t> const& cpus);
+
 class BasicApp
 {
 protected:
@@ -37,7 +55,9 @@ protected:
     boost::asio::io_service io_service_;
 
 public:
-    BasicApp(std::size_t numberOfThreads);
+    BasicApp(
+        std::size_t numberOfThreads,
+        std::vector<std::uint32_t> const& cpus = {});
     ~BasicApp();
 
     boost::asio::io_service&
@@ -47,18 +67,57 @@ public:
     }
 };
 
+// io_service of one chain, the traffic of a chain doesn't wait behind the
+// other one
+class ChainIOService
+{
+    std::optional<boost::asio::io_service::work> work_;
+    std::vector<std::thread> threads_;
+    boost::asio::io_service io_service_;
+
+public:
+    ChainIOService(ChainType ct, config::ChainConfig const& config);
+    ~ChainIOService();
+
+    boost::asio::io_service&
+    get_io_service()
+    {
+        return io_service_;
+    }
+};
+
 class App : public BasicApp
 {
     ripple::Logs logs_;
     beast::Journal j_;
+    // Destroyed after the threads logging, before the logs
+    std::unique_ptr<AsyncLog> asyncLog_;
     std::thread logRotation_;
 
     // Database for cross chain transactions
     DatabaseCon xChainTxnDB_;
+    // The claim and create account rows, in the database or in a log. One
+    // store per bridge, by name.
+    std::map<std::string, std::unique_ptr<AttestationStore>>
+        attestationStores_;
 
     boost::asio::signal_set signals_;
 
-    std::unique_ptr<Federator> federator_;
+    // Logs the messages of the LogLimiter sites gone quiet
+    boost::asio::steady_timer logLimitTimer_;
+
+    // Empty for the chains using the app io_service. Declared before the
+    // federator, they outlive the listeners.
+    ChainArray<std::unique_ptr<ChainIOService>> chainIOServices_;
+
+    // Shared by the listeners of all the bridges. Outlive the federators.
+    ChainArray<std::shared_ptr<ChainConnection>> chainConnections_;
+
+    // Outlives the federator publishing to it
+    rpc::Publisher publisher_;
+
+    // The top level bridge first, then the ones of "Bridges"
+    std::vector<std::unique_ptr<Federator>> federators_;
     std::unique_ptr<rpc::ServerHandler> serverHandler_;
 
     std::condition_variable stoppingCondition_;
@@ -89,15 +148,43 @@ public:
     DatabaseCon&
     getXChainTxnDB();
 
+    // The store of the bridge, by its config name
+    AttestationStore&
+    attestationStore(std::string const& bridge = {});
+
     config::Config&
     config();
 
+    // The chain listener io_service
+    boost::asio::io_service&
+    get_io_service(ChainType ct);
+
+    using BasicApp::get_io_service;
+
+    std::shared_ptr<ChainConnection>
+    chainConnection(ChainType ct);
+
+    // The federator of the top level bridge
     Federator&
     federator();
 
+    // nullptr if the bridge is not served
+    Federator*
+    federator(ripple::STXChainBridge const& bridge);
+
+    std::vector<std::unique_ptr<Federator>> const&
+    federators() const;
+
+    // The websocket subscribers of the attestations stream
+    rpc::Publisher&
+    publisher();
+
 protected:
     void
     logRotation();
+
+    void
+    scheduleLogLimitFlush();
 };
 
 }  // namespace xbwd
@@ -0,0 +1,902 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/app/AttestationLog.h>
+
+#include <xbwd/basics/StructuredLog.h>
+
+#include <boost/crc.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace xbwd {
+
+namespace {
+
+// A record is its body size and checksum, then the body: the type, the
+// table, the sequence number and the payload of the type
+enum RecordType : std::uint8_t { rtPut = 1, rtErase = 2, rtPrune = 3 };
+
+std::size_t constexpr HeaderSize = 8;
+
+// The scan chunks
+std::size_t constexpr ScanChunk = 1024;
+
+auto constexpr CompactInterval = std::chrono::seconds(10);
+
+std::uint8_t
+tableIndex(ChainType ct, bool isCreateAccount)
+{
+    return (ct == ChainType::locking ? 0 : 2) + (isCreateAccount ? 1 : 0);
+}
+
+std::uint32_t
+checksum(char const* data, std::size_t size)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(data, size);
+    return crc.checksum();
+}
+
+[[noreturn]] void
+throwErrno(std::string const& what, std::string const& path)
+{
+    throw std::runtime_error(fmt::format(
+        "attestation log: {} {}: {}", what, path, std::strerror(errno)));
+}
+
+void
+syncFd(int fd, std::string const& path)
+{
+#if defined(__APPLE__)
+    if (::fsync(fd) != 0)
+#else
+    if (::fdatasync(fd) != 0)
+#endif
+        throwErrno("sync", path);
+}
+
+class Encoder
+{
+    std::string& s_;
+
+public:
+    explicit Encoder(std::string& s) : s_(s)
+    {
+    }
+
+    template <class T>
+    void
+    put(T v)
+    {
+        s_.append(reinterpret_cast<char const*>(&v), sizeof(v));
+    }
+
+    void
+    bytes(std::string const& v)
+    {
+        put(static_cast<std::uint32_t>(v.size()));
+        s_.append(v);
+    }
+};
+
+class Decoder
+{
+    char const* p_;
+    char const* const end_;
+
+public:
+    Decoder(char const* p, std::size_t size) : p_(p), end_(p + size)
+    {
+    }
+
+    template <class T>
+    T
+    get()
+    {
+        T v;
+        if (end_ - p_ < static_cast<std::ptrdiff_t>(sizeof(v)))
+            throw std::runtime_error("attestation log: short record");
+        std::memcpy(&v, p_, sizeof(v));
+        p_ += sizeof(v);
+        return v;
+    }
+
+    std::string
+    bytes()
+    {
+        auto const size = get<std::uint32_t>();
+        if (end_ - p_ < static_cast<std::ptrdiff_t>(size))
+            throw std::runtime_error("attestation log: short record");
+        std::string r(p_, size);
+        p_ += size;
+        return r;
+    }
+
+    ripple::uint256
+    hash()
+    {
+        ripple::uint256 r;
+        if (end_ - p_ < static_cast<std::ptrdiff_t>(r.size()))
+            throw std::runtime_error("attestation log: short record");
+        std::memcpy(r.data(), p_, r.size());
+        p_ += r.size();
+        return r;
+    }
+};
+
+// The body of the record at `offset`, empty at the end of the records or at
+// a torn write
+std::pair<char const*, std::uint32_t>
+recordAt(char const* base, std::uint64_t capacity, std::uint64_t offset)
+{
+    if (offset + HeaderSize > capacity)
+        return {nullptr, 0};
+    std::uint32_t size = 0;
+    std::uint32_t crc = 0;
+    std::memcpy(&size, base + offset, sizeof(size));
+    std::memcpy(&crc, base + offset + sizeof(size), sizeof(crc));
+    if (!size || offset + HeaderSize + size > capacity)
+        return {nullptr, 0};
+    char const* body = base + offset + HeaderSize;
+    if (checksum(body, size) != crc)
+        return {nullptr, 0};
+    return {body, size};
+}
+
+}  // namespace
+
+struct AttestationLog::Segment
+{
+    std::uint32_t const number;
+    std::string const path;
+    int fd = -1;
+    char* base = nullptr;
+    std::uint64_t capacity = 0;
+    // Bytes of the records, of the live rows, and of the tombstones
+    std::uint64_t used = 0;
+    std::uint64_t liveBytes = 0;
+    std::uint64_t tombBytes = 0;
+    // Delete the file with the segment, once compacted
+    bool remove = false;
+
+    Segment(std::uint32_t n, std::string p, std::uint64_t newCapacity)
+        : number(n), path(std::move(p))
+    {
+        int const flags = newCapacity ? O_RDWR | O_CREAT | O_EXCL : O_RDWR;
+        fd = ::open(path.c_str(), flags, 0644);
+        if (fd < 0)
+            throwErrno("open", path);
+
+        if (newCapacity)
+        {
+            if (::ftruncate(fd, newCapacity) != 0)
+                throwErrno("resize", path);
+            capacity = newCapacity;
+        }
+        else
+        {
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+                throwErrno("stat", path);
+            capacity = st.st_size;
+        }
+
+        if (capacity)
+        {
+            void* p = ::mmap(nullptr, capacity, PROT_READ, MAP_SHARED, fd, 0);
+            if (p == MAP_FAILED)
+                throwErrno("map", path);
+            base = static_cast<char*>(p);
+        }
+    }
+
+    ~Segment()
+    {
+        if (base)
+            ::munmap(base, capacity);
+        if (fd >= 0)
+            ::close(fd);
+        if (remove)
+            ::unlink(path.c_str());
+    }
+
+    Segment(Segment const&) = delete;
+    Segment&
+    operator=(Segment const&) = delete;
+};
+
+AttestationLog::AttestationLog(
+    boost::filesystem::path const& dir,
+    Setup const& setup,
+    beast::Journal j)
+    : dir_(dir), setup_(setup), j_(j)
+{
+    open();
+    compactThread_ = std::thread([this] { compactLoop(); });
+}
+
+AttestationLog::~AttestationLog()
+{
+    {
+        std::lock_guard l{compactMutex_};
+        stop_ = true;
+    }
+    compactCv_.notify_all();
+    if (compactThread_.joinable())
+        compactThread_.join();
+}
+
+void
+AttestationLog::open()
+{
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(dir_, ec);
+    if (ec)
+        throw std::runtime_error(
+            "attestation log: can't create " + dir_.string() + ": " +
+            ec.message());
+
+    std::vector<std::uint32_t> numbers;
+    for (auto const& de : boost::filesystem::directory_iterator(dir_))
+    {
+        auto const& p = de.path();
+        if (p.extension() != ".seg")
+            continue;
+        try
+        {
+            numbers.push_back(std::stoul(p.stem().string()));
+        }
+        catch (std::exception const&)
+        {
+            JLOGV(
+                j_.warn(),
+                "attestation log: skip file",
+                jv("path", p.string()));
+        }
+    }
+    std::sort(numbers.begin(), numbers.end());
+
+    std::lock_guard wl{writeMutex_};
+    std::unique_lock l{mutex_};
+    std::size_t records = 0;
+    for (auto const n : numbers)
+    {
+        auto seg = std::make_unique<Segment>(
+            n, (dir_ / fmt::format("{:08}.seg", n)).string(), 0);
+        auto& s = *seg;
+        segments_.emplace(n, std::move(seg));
+
+        std::uint64_t offset = 0;
+        for (;;)
+        {
+            auto const [body, size] = recordAt(s.base, s.capacity, offset);
+            if (!body)
+                break;
+
+            Decoder d(body, size);
+            Op op;
+            op.type = d.get<std::uint8_t>();
+            op.table = d.get<std::uint8_t>();
+            op.seq = d.get<std::uint64_t>();
+            op.size = HeaderSize + size;
+            if (op.table >= tables_.size())
+                throw std::runtime_error(
+                    "attestation log: bad table in " + s.path);
+            if (op.type == rtPut)
+            {
+                op.ledgerSeq = d.get<std::uint32_t>();
+                op.id = d.get<std::uint64_t>();
+                op.success = d.get<std::uint8_t>() != 0;
+                op.txnHash = d.hash();
+            }
+            else if (op.type == rtErase)
+            {
+                op.id = d.get<std::uint64_t>();
+                op.last = d.get<std::uint64_t>();
+            }
+            else if (op.type == rtPrune)
+                op.ledgerSeq = d.get<std::uint32_t>();
+            else
+                throw std::runtime_error(
+                    "attestation log: bad record in " + s.path);
+
+            apply(op, n, offset);
+            nextSeq_ = std::max(nextSeq_, op.seq + 1);
+            offset += op.size;
+            ++records;
+        }
+        s.used = offset;
+        nextSegment_ = n + 1;
+    }
+
+    std::size_t rows = 0;
+    for (auto const& t : tables_)
+        rows += t.byLedger.size();
+    JLOGV(
+        j_.info(),
+        "attestation log opened",
+        jv("path", dir_.string()),
+        jv("segments", segments_.size()),
+        jv("records", records),
+        jv("rows", rows));
+}
+
+void
+AttestationLog::append(Op op, std::string const& payload)
+{
+    std::string body;
+    body.reserve(10 + payload.size());
+    Encoder e(body);
+    e.put(op.type);
+    e.put(op.table);
+    e.put(op.seq);
+    body.append(payload);
+
+    op.offset = batch_.size();
+    op.size = HeaderSize + body.size();
+    Encoder h(batch_);
+    h.put(static_cast<std::uint32_t>(body.size()));
+    h.put(checksum(body.data(), body.size()));
+    batch_.append(body);
+    batchOps_.push_back(op);
+}
+
+void
+AttestationLog::insert(
+    ChainType ct,
+    bool isCreateAccount,
+    AttestationRow const& row)
+{
+    Op op;
+    op.type = rtPut;
+    op.table = tableIndex(ct, isCreateAccount);
+    op.seq = nextSeq_++;
+    op.ledgerSeq = row.ledgerSeq;
+    op.id = row.id;
+    op.success = row.success;
+    op.txnHash = row.txnHash;
+
+    // The fixed fields first, the index is rebuilt from them
+    std::string payload;
+    Encoder e(payload);
+    e.put(row.ledgerSeq);
+    e.put(row.id);
+    e.put(static_cast<std::uint8_t>(row.success));
+    payload.append(
+        reinterpret_cast<char const*>(row.txnHash.data()), row.txnHash.size());
+    for (auto const* f :
+         {&row.amt,
+          &row.rewardAmt,
+          &row.bridge,
+          &row.sendingAccount,
+          &row.rewardAccount,
+          &row.otherChainDst,
+          &row.signingAccount,
+          &row.publicKey,
+          &row.signature})
+        e.bytes(*f);
+    append(op, payload);
+}
+
+void
+AttestationLog::erase(
+    ChainType ct,
+    bool isCreateAccount,
+    std::uint64_t first,
+    std::uint64_t last)
+{
+    Op op;
+    op.type = rtErase;
+    op.table = tableIndex(ct, isCreateAccount);
+    op.seq = nextSeq_++;
+    op.id = first;
+    op.last = last;
+
+    std::string payload;
+    Encoder e(payload);
+    e.put(first);
+    e.put(last);
+    append(op, payload);
+}
+
+std::size_t
+AttestationLog::prune(
+    ChainType ct,
+    bool isCreateAccount,
+    std::uint32_t ledger,
+    std::function<void(std::uint64_t)> const& onErased)
+{
+    auto const tableIdx = tableIndex(ct, isCreateAccount);
+    std::size_t rows = 0;
+    {
+        std::shared_lock l{mutex_};
+        auto const& t = tables_[tableIdx];
+        for (auto it = t.byLedger.begin();
+             it != t.byLedger.end() && it->first.first < ledger;
+             ++it)
+        {
+            onErased(it->second);
+            ++rows;
+        }
+    }
+    // And the rows of the batch
+    for (auto const& op : batchOps_)
+    {
+        if (op.type == rtPut && op.table == tableIdx && op.ledgerSeq < ledger)
+        {
+            onErased(op.id);
+            ++rows;
+        }
+    }
+    if (!rows)
+        return 0;
+
+    Op op;
+    op.type = rtPrune;
+    op.table = tableIdx;
+    op.seq = nextSeq_++;
+    op.ledgerSeq = ledger;
+
+    std::string payload;
+    Encoder e(payload);
+    e.put(ledger);
+    append(op, payload);
+    return rows;
+}
+
+void
+AttestationLog::commit()
+{
+    if (batch_.empty())
+        return;
+
+    std::lock_guard wl{writeMutex_};
+    auto const [segment, offset] = write(batch_);
+    {
+        std::unique_lock l{mutex_};
+        for (auto const& op : batchOps_)
+            apply(op, segment, offset + op.offset);
+    }
+    batch_.clear();
+    batchOps_.clear();
+}
+
+std::pair<std::uint32_t, std::uint64_t>
+AttestationLog::write(std::string const& records)
+{
+    Segment* s = nullptr;
+    {
+        std::shared_lock l{mutex_};
+        if (active_)
+            s = segments_.at(active_).get();
+    }
+
+    if (!s || s->used + records.size() > s->capacity)
+    {
+        auto const n = nextSegment_++;
+        auto seg = std::make_unique<Segment>(
+            n,
+            (dir_ / fmt::format("{:08}.seg", n)).string(),
+            std::max<std::uint64_t>(setup_.segmentSize, records.size()));
+
+        // The new file name is durable before its records are
+        int const dirFd = ::open(dir_.string().c_str(), O_RDONLY);
+        if (dirFd < 0)
+            throwErrno("open", dir_.string());
+        ::fsync(dirFd);
+        ::close(dirFd);
+
+        s = seg.get();
+        {
+            std::unique_lock l{mutex_};
+            segments_.emplace(n, std::move(seg));
+        }
+        if (active_)
+            compactCv_.notify_one();
+        active_ = n;
+    }
+
+    auto const offset = s->used;
+    std::size_t done = 0;
+    while (done < records.size())
+    {
+        auto const w = ::pwrite(
+            s->fd,
+            records.data() + done,
+            records.size() - done,
+            offset + done);
+        if (w < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throwErrno("write", s->path);
+        }
+        done += w;
+    }
+    syncFd(s->fd, s->path);
+    ++syncs_;
+
+    std::unique_lock l{mutex_};
+    s->used += records.size();
+    return {s->number, offset};
+}
+
+void
+AttestationLog::apply(Op const& op, std::uint32_t segment, std::uint64_t offset)
+{
+    auto& t = tables_[op.table];
+    auto& seg = *segments_.at(segment);
+
+    if (op.type == rtPut)
+    {
+        auto& v = t.byId[op.id];
+        for (std::size_t i = 0; i < v.size(); ++i)
+        {
+            if (v[i].txnHash != op.txnHash)
+                continue;
+            // The same transaction written again, the later one wins
+            if (v[i].seq > op.seq)
+                return;
+            eraseEntry(t, op.id, i);
+            break;
+        }
+        v.push_back(Entry{
+            op.seq,
+            segment,
+            op.size,
+            offset,
+            op.ledgerSeq,
+            op.success,
+            op.txnHash});
+        t.byLedger[{op.ledgerSeq, op.txnHash}] = op.id;
+        seg.liveBytes += op.size;
+        return;
+    }
+
+    seg.tombBytes += op.size;
+    if (op.type == rtErase)
+    {
+        for (auto it = t.byId.lower_bound(op.id);
+             it != t.byId.end() && it->first <= op.last;)
+        {
+            auto& v = it->second;
+            for (std::size_t i = v.size(); i-- > 0;)
+                if (v[i].seq < op.seq)
+                    eraseEntry(t, it->first, i);
+            it = v.empty() ? t.byId.erase(it) : std::next(it);
+        }
+        return;
+    }
+
+    // rtPrune
+    for (auto it = t.byLedger.begin();
+         it != t.byLedger.end() && it->first.first < op.ledgerSeq;)
+    {
+        auto const [key, id] = *it++;
+        auto found = t.byId.find(id);
+        if (found == t.byId.end())
+            continue;
+        auto& v = found->second;
+        for (std::size_t i = v.size(); i-- > 0;)
+            if (v[i].txnHash == key.second && v[i].seq < op.seq)
+                eraseEntry(t, id, i);
+        if (v.empty())
+            t.byId.erase(found);
+    }
+}
+
+void
+AttestationLog::eraseEntry(Table& t, std::uint64_t id, std::size_t i)
+{
+    auto& v = t.byId[id];
+    auto const& e = v[i];
+    if (auto it = segments_.find(e.segment); it != segments_.end())
+        it->second->liveBytes -= e.size;
+    if (auto it = t.byLedger.find({e.ledgerSeq, e.txnHash});
+        it != t.byLedger.end() && it->second == id)
+        t.byLedger.erase(it);
+    v.erase(v.begin() + i);
+}
+
+AttestationRow
+AttestationLog::read(Entry const& e) const
+{
+    auto const& s = *segments_.at(e.segment);
+    auto const [body, size] = recordAt(s.base, s.capacity, e.offset);
+    if (!body)
+        throw std::runtime_error("attestation log: bad record in " + s.path);
+
+    Decoder d(body, size);
+    d.get<std::uint8_t>();
+    d.get<std::uint8_t>();
+    d.get<std::uint64_t>();
+
+    AttestationRow r;
+    r.ledgerSeq = d.get<std::uint32_t>();
+    r.id = d.get<std::uint64_t>();
+    r.success = d.get<std::uint8_t>() != 0;
+    r.txnHash = d.hash();
+    for (auto* f :
+         {&r.amt,
+          &r.rewardAmt,
+          &r.bridge,
+          &r.sendingAccount,
+          &r.rewardAccount,
+          &r.otherChainDst,
+          &r.signingAccount,
+          &r.publicKey,
+          &r.signature})
+        *f = d.bytes();
+    return r;
+}
+
+std::optional<AttestationRow>
+AttestationLog::find(
+    ChainType ct,
+    bool isCreateAccount,
+    AttestationQuery const& q)
+{
+    std::shared_lock l{mutex_};
+    auto const& t = tables_[tableIndex(ct, isCreateAccount)];
+    auto const it = t.byId.find(q.id);
+    if (it == t.byId.end())
+        return std::nullopt;
+
+    for (auto const& e : it->second)
+    {
+        if (!e.success)
+            continue;
+        auto row = read(e);
+        if (row.amt != q.amt || row.bridge != q.bridge ||
+            row.sendingAccount != q.sendingAccount)
+            continue;
+        if (isCreateAccount && row.rewardAmt != q.rewardAmt)
+            continue;
+        if ((isCreateAccount || !q.otherChainDst.empty()) &&
+            row.otherChainDst != q.otherChainDst)
+            continue;
+        return row;
+    }
+    return std::nullopt;
+}
+
+void
+AttestationLog::scan(
+    ChainType ct,
+    bool isCreateAccount,
+    std::function<void(std::vector<AttestationRow>&&)> const& onChunk)
+{
+    auto const& t = tables_[tableIndex(ct, isCreateAccount)];
+    std::optional<std::uint64_t> next = 0;
+    while (next)
+    {
+        std::vector<AttestationRow> rows;
+        {
+            // Not held over the callback, the batches go on
+            std::shared_lock l{mutex_};
+            auto it = t.byId.lower_bound(*next);
+            for (; it != t.byId.end() && rows.size() < ScanChunk; ++it)
+                for (auto const& e : it->second)
+                    rows.push_back(read(e));
+            if (it == t.byId.end())
+                next.reset();
+            else
+                next = it->first;
+        }
+        if (!rows.empty())
+            onChunk(std::move(rows));
+    }
+}
+
+std::vector<AttestationRow>
+AttestationLog::page(
+    ChainType ct,
+    bool isCreateAccount,
+    std::optional<AttestationMarker> const& after,
+    std::uint32_t limit)
+{
+    std::shared_lock l{mutex_};
+    auto const& t = tables_[tableIndex(ct, isCreateAccount)];
+    std::vector<AttestationRow> r;
+    auto it = after ? t.byLedger.upper_bound(*after) : t.byLedger.begin();
+    for (; it != t.byLedger.end() && r.size() < limit; ++it)
+    {
+        auto const found = t.byId.find(it->second);
+        if (found == t.byId.end())
+            continue;
+        for (auto const& e : found->second)
+            if (e.txnHash == it->first.second)
+                r.push_back(read(e));
+    }
+    return r;
+}
+
+Json::Value
+AttestationLog::getInfo() const
+{
+    std::shared_lock l{mutex_};
+    std::uint64_t used = 0, live = 0;
+    for (auto const& [n, s] : segments_)
+    {
+        used += s->used;
+        live += s->liveBytes;
+    }
+    std::size_t rows = 0;
+    for (auto const& t : tables_)
+        rows += t.byLedger.size();
+
+    Json::Value r{Json::objectValue};
+    r["engine"] = "log";
+    r["segments"] = static_cast<Json::UInt>(segments_.size());
+    r["bytes"] = std::to_string(used);
+    r["live_bytes"] = std::to_string(live);
+    r["rows"] = static_cast<Json::UInt>(rows);
+    r["compactions"] = std::to_string(compactions_.load());
+    r["syncs"] = std::to_string(syncs_.load());
+    return r;
+}
+
+std::size_t
+AttestationLog::segments() const
+{
+    std::shared_lock l{mutex_};
+    return segments_.size();
+}
+
+std::size_t
+AttestationLog::compact()
+{
+    std::lock_guard wl{writeMutex_};
+    std::vector<std::uint32_t> eligible;
+    {
+        std::shared_lock l{mutex_};
+        for (auto const& [n, s] : segments_)
+        {
+            if (n == active_)
+                continue;
+            // The tombstones are copied, unless no older segment is left
+            auto const kept = s->liveBytes +
+                (n == segments_.begin()->first ? 0 : s->tombBytes);
+            if (kept * 100 < s->used * setup_.compactPercent || !s->used)
+                eligible.push_back(n);
+        }
+    }
+
+    std::size_t r = 0;
+    for (auto const n : eligible)
+        if (compactSegment(n))
+            ++r;
+    return r;
+}
+
+bool
+AttestationLog::compactSegment(std::uint32_t number)
+{
+    std::string records;
+    std::vector<std::pair<Entry*, std::uint64_t>> moved;
+    std::uint64_t tombBytes = 0;
+    {
+        // The index only changes under the write mutex, the entries stay
+        // where they are until moved below
+        std::shared_lock l{mutex_};
+        auto const it = segments_.find(number);
+        if (it == segments_.end())
+            return false;
+        auto const& s = *it->second;
+
+        for (auto& t : tables_)
+        {
+            for (auto& [id, v] : t.byId)
+            {
+                for (auto& e : v)
+                {
+                    if (e.segment != number)
+                        continue;
+                    moved.emplace_back(&e, records.size());
+                    records.append(s.base + e.offset, e.size);
+                }
+            }
+        }
+
+        if (it != segments_.begin())
+        {
+            std::uint64_t offset = 0;
+            for (;;)
+            {
+                auto const [body, size] = recordAt(s.base, s.capacity, offset);
+                if (!body)
+                    break;
+                if (static_cast<std::uint8_t>(body[0]) != rtPut)
+                {
+                    records.append(s.base + offset, HeaderSize + size);
+                    tombBytes += HeaderSize + size;
+                }
+                offset += HeaderSize + size;
+            }
+        }
+    }
+
+    std::pair<std::uint32_t, std::uint64_t> where{0, 0};
+    if (!records.empty())
+        where = write(records);
+
+    std::unique_lock l{mutex_};
+    if (!records.empty())
+    {
+        auto& dst = *segments_.at(where.first);
+        for (auto& [e, offset] : moved)
+        {
+            e->segment = where.first;
+            e->offset = where.second + offset;
+            dst.liveBytes += e->size;
+        }
+        dst.tombBytes += tombBytes;
+    }
+    auto node = segments_.extract(number);
+    node.mapped()->remove = true;
+    ++compactions_;
+
+    JLOGV(
+        j_.debug(),
+        "attestation log compacted",
+        jv("segment", number),
+        jv("rows", moved.size()),
+        jv("bytes", records.size()));
+    return true;
+}
+
+void
+AttestationLog::compactLoop()
+{
+    std::unique_lock l{compactMutex_};
+    while (!stop_)
+    {
+        compactCv_.wait_for(l, CompactInterval);
+        if (stop_)
+            break;
+        l.unlock();
+        try
+        {
+            compact();
+        }
+        catch (std::exception const& e)
+        {
+            JLOGV(
+                j_.error(),
+                "attestation log compaction failed",
+                jv("what", e.what()));
+        }
+        l.lock();
+    }
+}
+
+}  // namespace xbwd
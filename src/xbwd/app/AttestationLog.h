@@ -0,0 +1,230 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/app/AttestationStore.h>
+#include <xbwd/basics/ThreadSaftyAnalysis.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xbwd {
+
+/**
+ *  Append-only store of the claim and create account rows.
+ *
+ *  The inserts, and the erases and prunes as tombstones, are appended to
+ *  segment files, memory mapped for the reads. An index of the live rows is
+ *  kept in memory and rebuilt from the segments when opened. The records of
+ *  a DB batch are written at once with one sync to disk, in commit().
+ *
+ *  Every record has a sequence number. A tombstone only erases the rows
+ *  with a lower one, the records keep theirs when moved, so the order of the
+ *  segments doesn't matter once compacted: a background thread copies the
+ *  live rows of the sealed segments with too few of them to the active one,
+ *  and deletes the files.
+ */
+class AttestationLog : public AttestationStore
+{
+public:
+    struct Setup
+    {
+        // Size of a segment file, a bigger DB batch gets a segment of its
+        // own size
+        std::uint64_t segmentSize = 64 << 20;
+
+        // Compact a sealed segment once its live rows take less than this
+        // percentage of it
+        std::uint32_t compactPercent = 50;
+    };
+
+private:
+    struct Segment;
+
+    // Where a live row is
+    struct Entry
+    {
+        std::uint64_t seq = 0;
+        std::uint32_t segment = 0;
+        std::uint32_t size = 0;
+        std::uint64_t offset = 0;
+        std::uint32_t ledgerSeq = 0;
+        bool success = false;
+        ripple::uint256 txnHash;
+    };
+
+    // Index of the rows of a table
+    struct Table
+    {
+        std::map<std::uint64_t, std::vector<Entry>> byId;
+        std::map<AttestationMarker, std::uint64_t> byLedger;
+    };
+
+    // A decoded record, queued until the write of the batch
+    struct Op
+    {
+        std::uint8_t type = 0;
+        std::uint8_t table = 0;
+        std::uint64_t seq = 0;
+        // Of the put rows, from the start of the batch
+        std::uint64_t offset = 0;
+        std::uint32_t size = 0;
+        std::uint32_t ledgerSeq = 0;
+        bool success = false;
+        ripple::uint256 txnHash;
+        std::uint64_t id = 0;
+        std::uint64_t last = 0;
+    };
+
+    boost::filesystem::path const dir_;
+    Setup const setup_;
+    beast::Journal j_;
+
+    // Held by the writes to the segments: the batches and the compactions
+    std::mutex writeMutex_;
+    // Guards the index and the segments map
+    mutable std::shared_mutex mutex_;
+
+    std::array<Table, 4> GUARDED_BY(mutex_) tables_;
+    std::map<std::uint32_t, std::unique_ptr<Segment>> GUARDED_BY(mutex_)
+        segments_;
+
+    // Appended to, 0 - none yet
+    std::uint32_t GUARDED_BY(writeMutex_) active_ = 0;
+    std::uint32_t GUARDED_BY(writeMutex_) nextSegment_ = 1;
+
+    // Records of the current DB batch and their sequence numbers, DB thread
+    // only
+    std::uint64_t nextSeq_ = 1;
+    std::string batch_;
+    std::vector<Op> batchOps_;
+
+    std::atomic_uint64_t compactions_{0};
+    std::atomic_uint64_t syncs_{0};
+
+    std::mutex compactMutex_;
+    std::condition_variable compactCv_;
+    bool GUARDED_BY(compactMutex_) stop_ = false;
+    std::thread compactThread_;
+
+public:
+    AttestationLog(
+        boost::filesystem::path const& dir,
+        Setup const& setup,
+        beast::Journal j);
+    ~AttestationLog();
+
+    AttestationLog(AttestationLog const&) = delete;
+    AttestationLog&
+    operator=(AttestationLog const&) = delete;
+
+    void
+    insert(ChainType ct, bool isCreateAccount, AttestationRow const& row)
+        override;
+
+    void
+    erase(
+        ChainType ct,
+        bool isCreateAccount,
+        std::uint64_t first,
+        std::uint64_t last) override;
+
+    std::size_t
+    prune(
+        ChainType ct,
+        bool isCreateAccount,
+        std::uint32_t ledger,
+        std::function<void(std::uint64_t)> const& onErased) override;
+
+    void
+    commit() override;
+
+    std::optional<AttestationRow>
+    find(ChainType ct, bool isCreateAccount, AttestationQuery const& q)
+        override;
+
+    void
+    scan(
+        ChainType ct,
+        bool isCreateAccount,
+        std::function<void(std::vector<AttestationRow>&&)> const& onChunk)
+        override;
+
+    std::vector<AttestationRow>
+    page(
+        ChainType ct,
+        bool isCreateAccount,
+        std::optional<AttestationMarker> const& after,
+        std::uint32_t limit) override;
+
+    Json::Value
+    getInfo() const override;
+
+    // Compact the eligible sealed segments now, instead of waiting for the
+    // background thread. Return the number of segments compacted.
+    std::size_t
+    compact();
+
+    // Number of segment files
+    std::size_t
+    segments() const;
+
+private:
+    void
+    open();
+
+    void
+    append(Op op, std::string const& body);
+
+    // Copy the records to the active segment, with one sync. Return the
+    // segment and the offset they were written at.
+    std::pair<std::uint32_t, std::uint64_t>
+    write(std::string const& records) REQUIRES(writeMutex_);
+
+    // Apply a record to the index, written at the offset of the segment
+    void
+    apply(Op const& op, std::uint32_t segment, std::uint64_t offset)
+        REQUIRES(mutex_);
+
+    void
+    eraseEntry(Table& table, std::uint64_t id, std::size_t i)
+        REQUIRES(mutex_);
+
+    AttestationRow
+    read(Entry const& e) const REQUIRES_SHARED(mutex_);
+
+    bool
+    compactSegment(std::uint32_t number) REQUIRES(writeMutex_);
+
+    void
+    compactLoop();
+};
+
+}  // namespace xbwd
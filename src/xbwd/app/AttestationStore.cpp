@@ -0,0 +1,442 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/app/AttestationStore.h>
+
+#include <xbwd/app/AttestationLog.h>
+#include <xbwd/app/Config.h>
+#include <xbwd/app/DBInit.h>
+#include <xbwd/app/DBStatements.h>
+#include <xbwd/core/DatabaseCon.h>
+#include <xbwd/core/SociDB.h>
+
+#include <ripple/protocol/Serializer.h>
+
+#include <fmt/core.h>
+
+#include <stdexcept>
+#include <string_view>
+
+namespace xbwd {
+
+namespace {
+
+// The tables are read by chunks, with vector binds
+std::size_t constexpr ReadDBChunk = 1024;
+
+struct DBAttestRows
+{
+    std::vector<std::string> transID;
+    std::vector<long long> ledgerSeq;
+    std::vector<long long> id;
+    std::vector<int> success;
+    std::vector<std::string> amt;
+    std::vector<std::string> rewardAmt;
+    std::vector<std::string> bridge;
+    std::vector<std::string> sendingAccount;
+    std::vector<std::string> rewardAccount;
+    std::vector<std::string> otherChainDst;
+    std::vector<soci::indicator> otherChainDstInd;
+    std::vector<std::string> signingAccount;
+    std::vector<std::string> publicKey;
+    std::vector<std::string> signature;
+
+    std::size_t
+    size() const
+    {
+        return transID.size();
+    }
+
+    void
+    resize(std::size_t n)
+    {
+        transID.resize(n);
+        ledgerSeq.resize(n);
+        id.resize(n);
+        success.resize(n);
+        amt.resize(n);
+        rewardAmt.resize(n);
+        bridge.resize(n);
+        sendingAccount.resize(n);
+        rewardAccount.resize(n);
+        otherChainDst.resize(n);
+        otherChainDstInd.resize(n);
+        signingAccount.resize(n);
+        publicKey.resize(n);
+        signature.resize(n);
+    }
+
+    std::vector<AttestationRow>
+    toRows()
+    {
+        std::vector<AttestationRow> r(size());
+        for (std::size_t i = 0; i < r.size(); ++i)
+        {
+            auto& row = r[i];
+            row.txnHash = convert<ripple::uint256>(transID[i]);
+            row.ledgerSeq = static_cast<std::uint32_t>(ledgerSeq[i]);
+            row.id = static_cast<std::uint64_t>(id[i]);
+            row.success = success[i] != 0;
+            row.amt = std::move(amt[i]);
+            row.rewardAmt = std::move(rewardAmt[i]);
+            row.bridge = std::move(bridge[i]);
+            row.sendingAccount = std::move(sendingAccount[i]);
+            row.rewardAccount = std::move(rewardAccount[i]);
+            if (otherChainDstInd[i] == soci::i_ok)
+                row.otherChainDst = std::move(otherChainDst[i]);
+            row.signingAccount = std::move(signingAccount[i]);
+            row.publicKey = std::move(publicKey[i]);
+            row.signature = std::move(signature[i]);
+        }
+        return r;
+    }
+};
+
+std::string
+tableName(ChainType ct, bool isCreateAccount, std::string const& bridge)
+{
+    return isCreateAccount ? db_init::xChainCreateAccountTableName(ct, bridge)
+                           : db_init::xChainTableName(ct, bridge);
+}
+
+// All the columns, in the order of the DBAttestRows binds
+std::string
+selectRowsSql(
+    ChainType ct,
+    bool isCreateAccount,
+    std::string const& bridge,
+    std::string_view where,
+    std::string_view order)
+{
+    return fmt::format(
+        R"sql(SELECT TransID, LedgerSeq, {id}, Success, DeliveredAmt, {reward}
+                     Bridge, SendingAccount, RewardAccount, OtherChainDst,
+                     SigningAccount, PublicKey, Signature
+              FROM {table_name} {where} ORDER BY {order};
+        )sql",
+        fmt::arg("id", isCreateAccount ? "CreateCount" : "ClaimID"),
+        fmt::arg("reward", isCreateAccount ? "RewardAmt," : ""),
+        fmt::arg("table_name", tableName(ct, isCreateAccount, bridge)),
+        fmt::arg("where", where),
+        fmt::arg("order", order));
+}
+
+void
+bindRows(soci::statement& st, DBAttestRows& rows, bool isCreateAccount)
+{
+    st.exchange(soci::into(rows.transID));
+    st.exchange(soci::into(rows.ledgerSeq));
+    st.exchange(soci::into(rows.id));
+    st.exchange(soci::into(rows.success));
+    st.exchange(soci::into(rows.amt));
+    if (isCreateAccount)
+        st.exchange(soci::into(rows.rewardAmt));
+    st.exchange(soci::into(rows.bridge));
+    st.exchange(soci::into(rows.sendingAccount));
+    st.exchange(soci::into(rows.rewardAccount));
+    st.exchange(soci::into(rows.otherChainDst, rows.otherChainDstInd));
+    st.exchange(soci::into(rows.signingAccount));
+    st.exchange(soci::into(rows.publicKey));
+    st.exchange(soci::into(rows.signature));
+}
+
+template <class T>
+std::string
+serializeST(T const& v)
+{
+    ripple::Serializer s;
+    v.add(s);
+    return std::string(reinterpret_cast<char const*>(s.data()), s.size());
+}
+
+}  // namespace
+
+std::string
+serialize(ripple::STAmount const& v)
+{
+    return serializeST(v);
+}
+
+std::string
+serialize(ripple::STXChainBridge const& v)
+{
+    return serializeST(v);
+}
+
+std::string
+serialize(ripple::AccountID const& v)
+{
+    return std::string(reinterpret_cast<char const*>(v.data()), v.size());
+}
+
+std::string
+serialize(ripple::PublicKey const& v)
+{
+    return std::string(reinterpret_cast<char const*>(v.data()), v.size());
+}
+
+std::string
+serialize(ripple::Buffer const& v)
+{
+    return std::string(reinterpret_cast<char const*>(v.data()), v.size());
+}
+
+SqliteAttestationStore::SqliteAttestationStore(
+    DatabaseCon& db,
+    std::string const& bridge)
+    : db_(db), bridge_(bridge)
+{
+}
+
+void
+SqliteAttestationStore::insert(
+    ChainType ct,
+    bool isCreateAccount,
+    AttestationRow const& row)
+{
+    auto session = db_.checkoutDb();
+    auto bindCommon = [&](auto& q) {
+        q.txnId = convert(row.txnHash, *session);
+        q.ledgerSeq = row.ledgerSeq;
+        q.success = row.success ? 1 : 0;
+        q.amt = convert(row.amt, *session);
+        q.bridge = convert(row.bridge, *session);
+        q.sendingAccount = convert(row.sendingAccount, *session);
+        q.rewardAccount = convert(row.rewardAccount, *session);
+        q.otherChainDst = convert(row.otherChainDst, *session);
+        q.signingAccount = convert(row.signingAccount, *session);
+        q.publicKey = convert(row.publicKey, *session);
+        q.signature = convert(row.signature, *session);
+    };
+
+    if (isCreateAccount)
+    {
+        auto& q = session.prepared<db_stmt::InsertCreateAccount>(
+            db_stmt::InsertCreateAccount::name(ct, bridge_));
+        bindCommon(q);
+        q.createCount = row.id;
+        q.rewardAmt = convert(row.rewardAmt, *session);
+        q.st.execute(true);
+        return;
+    }
+
+    auto& q = session.prepared<db_stmt::InsertClaim>(
+        db_stmt::InsertClaim::name(ct, bridge_));
+    bindCommon(q);
+    q.claimID = row.id;
+    q.st.execute(true);
+}
+
+void
+SqliteAttestationStore::erase(
+    ChainType ct,
+    bool isCreateAccount,
+    std::uint64_t first,
+    std::uint64_t last)
+{
+    auto session = db_.checkoutDb();
+    auto& q = session.prepared<db_stmt::DeleteIDRange>(
+        db_stmt::DeleteIDRange::name(ct, isCreateAccount, bridge_));
+    q.first = first;
+    q.last = last;
+    q.st.execute(true);
+}
+
+std::size_t
+SqliteAttestationStore::prune(
+    ChainType ct,
+    bool isCreateAccount,
+    std::uint32_t ledger,
+    std::function<void(std::uint64_t)> const& onErased)
+{
+    auto session = db_.checkoutDb();
+    auto& sel = session.prepared<db_stmt::SelectPrunedIDs>(
+        db_stmt::SelectPrunedIDs::name(ct, isCreateAccount, bridge_));
+    sel.ledgerSeq = ledger;
+    std::size_t rows = 0;
+    if (sel.st.execute(true))
+    {
+        do
+        {
+            onErased(sel.id);
+            ++rows;
+        } while (sel.st.fetch());
+    }
+    if (!rows)
+        return 0;
+
+    auto& q = session.prepared<db_stmt::PruneClaims>(
+        db_stmt::PruneClaims::name(ct, isCreateAccount, bridge_));
+    q.ledgerSeq = ledger;
+    q.st.execute(true);
+    db_.incrementalVacuum();
+    return rows;
+}
+
+std::optional<AttestationRow>
+SqliteAttestationStore::find(
+    ChainType ct,
+    bool isCreateAccount,
+    AttestationQuery const& query)
+{
+    auto session = db_.checkoutReadDb();
+    AttestationRow r;
+    r.id = query.id;
+    r.success = true;
+    r.amt = query.amt;
+    r.bridge = query.bridge;
+    r.sendingAccount = query.sendingAccount;
+    r.otherChainDst = query.otherChainDst;
+
+    if (isCreateAccount)
+    {
+        auto& q = session.prepared<db_stmt::SelectCreateAccount>(
+            db_stmt::SelectCreateAccount::name(ct, bridge_));
+        q.createCount = query.id;
+        q.amt = convert(query.amt, *session);
+        q.rewardAmt = convert(query.rewardAmt, *session);
+        q.bridge = convert(query.bridge, *session);
+        q.sendingAccount = convert(query.sendingAccount, *session);
+        q.otherChainDst = convert(query.otherChainDst, *session);
+        if (!q.execute(*session))
+            return std::nullopt;
+
+        r.rewardAmt = query.rewardAmt;
+        r.signingAccount = convert<std::string>(q.signingAccount);
+        r.signature = convert<std::string>(q.signature);
+        r.publicKey = convert<std::string>(q.publicKey);
+        r.rewardAccount = convert<std::string>(q.rewardAccount);
+        return r;
+    }
+
+    bool const withDst = !query.otherChainDst.empty();
+    auto& q = session.prepared<db_stmt::SelectClaim>(
+        db_stmt::SelectClaim::name(ct, withDst, bridge_));
+    q.claimID = query.id;
+    q.amt = convert(query.amt, *session);
+    q.bridge = convert(query.bridge, *session);
+    q.sendingAccount = convert(query.sendingAccount, *session);
+    if (withDst)
+        q.otherChainDst = convert(query.otherChainDst, *session);
+    if (!q.execute(*session))
+        return std::nullopt;
+
+    if (!withDst && q.otherChainDstInd == soci::i_ok)
+        r.otherChainDst = convert<std::string>(q.otherChainDst);
+    r.signingAccount = convert<std::string>(q.signingAccount);
+    if (q.sigInd == soci::i_ok)
+        r.signature = convert<std::string>(q.signature);
+    r.publicKey = convert<std::string>(q.publicKey);
+    r.rewardAccount = convert<std::string>(q.rewardAccount);
+    return r;
+}
+
+void
+SqliteAttestationStore::scan(
+    ChainType ct,
+    bool isCreateAccount,
+    std::function<void(std::vector<AttestationRow>&&)> const& onChunk)
+{
+    auto session = db_.checkoutDb();
+
+    DBAttestRows rows;
+    rows.resize(ReadDBChunk);
+
+    soci::statement st(*session);
+    bindRows(st, rows, isCreateAccount);
+    st.alloc();
+    st.prepare(selectRowsSql(
+        ct,
+        isCreateAccount,
+        bridge_,
+        "",
+        isCreateAccount ? "CreateCount" : "ClaimID"));
+    st.define_and_bind();
+    st.execute(false);
+
+    while (st.fetch())
+    {
+        onChunk(rows.toRows());
+        rows.resize(ReadDBChunk);
+    }
+}
+
+std::vector<AttestationRow>
+SqliteAttestationStore::page(
+    ChainType ct,
+    bool isCreateAccount,
+    std::optional<AttestationMarker> const& after,
+    std::uint32_t limit)
+{
+    auto session = db_.checkoutReadDb();
+
+    DBAttestRows rows;
+    rows.resize(limit);
+
+    std::uint32_t markerSeq = after ? after->first : 0;
+    soci::blob markerTxnId =
+        after ? convert(after->second, *session) : soci::blob(*session);
+
+    soci::statement st(*session);
+    bindRows(st, rows, isCreateAccount);
+    if (after)
+    {
+        st.exchange(soci::use(markerSeq));
+        st.exchange(soci::use(markerTxnId));
+    }
+    st.alloc();
+    st.prepare(selectRowsSql(
+        ct,
+        isCreateAccount,
+        bridge_,
+        after ? "WHERE (LedgerSeq, TransID) > (:ledgerSeq, :transID)" : "",
+        fmt::format("LedgerSeq, TransID LIMIT {}", limit)));
+    st.define_and_bind();
+    if (!st.execute(true))
+        return {};
+    return rows.toRows();
+}
+
+Json::Value
+SqliteAttestationStore::getInfo() const
+{
+    Json::Value r{Json::objectValue};
+    r["engine"] = "sqlite";
+    return r;
+}
+
+std::unique_ptr<AttestationStore>
+makeAttestationStore(
+    config::Config const& config,
+    DatabaseCon& db,
+    beast::Journal j)
+{
+    auto const& dc = config.database;
+    if (dc.engine == "log")
+        return std::make_unique<AttestationLog>(
+            config.dataDir /
+                (config.name.empty() ? std::string("attestations")
+                                     : "attestations_" + config.name),
+            AttestationLog::Setup{
+                std::uint64_t(dc.logSegmentMB) << 20, dc.logCompactPercent},
+            j);
+    return std::make_unique<SqliteAttestationStore>(db, config.name);
+}
+
+}  // namespace xbwd
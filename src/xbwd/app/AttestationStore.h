@@ -0,0 +1,226 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/ChainTypes.h>
+
+#include <ripple/basics/Buffer.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/PublicKey.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STXChainBridge.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xbwd {
+
+class DatabaseCon;
+
+namespace config {
+struct Config;
+}
+
+/**
+ *  A row of the claim or of the create account table of a chain. The fields
+ *  are serialized as in the sqlite blob columns, an empty field is a NULL
+ *  column.
+ */
+struct AttestationRow
+{
+    ripple::uint256 txnHash;
+    std::uint32_t ledgerSeq = 0;
+    // ClaimID or CreateCount
+    std::uint64_t id = 0;
+    bool success = false;
+    std::string amt;
+    // Create accounts only
+    std::string rewardAmt;
+    std::string bridge;
+    std::string sendingAccount;
+    std::string rewardAccount;
+    std::string otherChainDst;
+    std::string signingAccount;
+    std::string publicKey;
+    std::string signature;
+};
+
+// The fields of the witness RPCs, matched against the successful rows
+struct AttestationQuery
+{
+    std::uint64_t id = 0;
+    std::string amt;
+    // Create accounts only
+    std::string rewardAmt;
+    std::string bridge;
+    std::string sendingAccount;
+    // Empty - any destination
+    std::string otherChainDst;
+};
+
+// Position of the select_all pages
+using AttestationMarker = std::pair<std::uint32_t, ripple::uint256>;
+
+std::string
+serialize(ripple::STAmount const& v);
+std::string
+serialize(ripple::STXChainBridge const& v);
+std::string
+serialize(ripple::AccountID const& v);
+std::string
+serialize(ripple::PublicKey const& v);
+std::string
+serialize(ripple::Buffer const& v);
+
+/**
+ *  Storage of the claim and create account tables. `isCreateAccount` selects
+ *  the table of the chain.
+ *
+ *  Writes are only made by the DB thread, within a DB batch, and are durable
+ *  once commit() returns. Reads may be made by any thread.
+ */
+class AttestationStore
+{
+public:
+    virtual ~AttestationStore() = default;
+
+    virtual void
+    insert(ChainType ct, bool isCreateAccount, AttestationRow const& row) = 0;
+
+    // Delete the rows with the IDs in [first, last]
+    virtual void
+    erase(
+        ChainType ct,
+        bool isCreateAccount,
+        std::uint64_t first,
+        std::uint64_t last) = 0;
+
+    // Delete the rows older than the ledger, `onErased` is called with the ID
+    // of each of them. Return the number of rows deleted.
+    virtual std::size_t
+    prune(
+        ChainType ct,
+        bool isCreateAccount,
+        std::uint32_t ledger,
+        std::function<void(std::uint64_t)> const& onErased) = 0;
+
+    // Make the writes of the DB batch durable. Called before the sqlite
+    // transaction of the batch commits.
+    virtual void
+    commit() = 0;
+
+    // A successful row matching the query
+    virtual std::optional<AttestationRow>
+    find(ChainType ct, bool isCreateAccount, AttestationQuery const& q) = 0;
+
+    // All the rows ordered by ID, handed by chunks
+    virtual void
+    scan(
+        ChainType ct,
+        bool isCreateAccount,
+        std::function<void(std::vector<AttestationRow>&&)> const& onChunk) = 0;
+
+    // Up to `limit` rows ordered by (ledgerSeq, txnHash), after the marker
+    virtual std::vector<AttestationRow>
+    page(
+        ChainType ct,
+        bool isCreateAccount,
+        std::optional<AttestationMarker> const& after,
+        std::uint32_t limit) = 0;
+
+    // Engine statistics for server_info
+    virtual Json::Value
+    getInfo() const = 0;
+};
+
+// The tables of the xchain database, of the bridge named `bridge`
+class SqliteAttestationStore : public AttestationStore
+{
+    DatabaseCon& db_;
+    std::string const bridge_;
+
+public:
+    explicit SqliteAttestationStore(
+        DatabaseCon& db,
+        std::string const& bridge = {});
+
+    void
+    insert(ChainType ct, bool isCreateAccount, AttestationRow const& row)
+        override;
+
+    void
+    erase(
+        ChainType ct,
+        bool isCreateAccount,
+        std::uint64_t first,
+        std::uint64_t last) override;
+
+    std::size_t
+    prune(
+        ChainType ct,
+        bool isCreateAccount,
+        std::uint32_t ledger,
+        std::function<void(std::uint64_t)> const& onErased) override;
+
+    // The rows are committed with the sync tables, by the DB batch
+    // transaction
+    void
+    commit() override
+    {
+    }
+
+    std::optional<AttestationRow>
+    find(ChainType ct, bool isCreateAccount, AttestationQuery const& q)
+        override;
+
+    void
+    scan(
+        ChainType ct,
+        bool isCreateAccount,
+        std::function<void(std::vector<AttestationRow>&&)> const& onChunk)
+        override;
+
+    std::vector<AttestationRow>
+    page(
+        ChainType ct,
+        bool isCreateAccount,
+        std::optional<AttestationMarker> const& after,
+        std::uint32_t limit) override;
+
+    Json::Value
+    getInfo() const override;
+};
+
+// The store of Database.Engine, for the bridge of the config
+std::unique_ptr<AttestationStore>
+makeAttestationStore(
+    config::Config const& config,
+    DatabaseCon& db,
+    beast::Journal j);
+
+}  // namespace xbwd
@@ -6,10 +6,17 @@
 #include <ripple/protocol/AccountID.h>
 #include <ripple/protocol/KeyType.h>
 
+#include <algorithm>
+#include <limits>
+#include <set>
+
 namespace xbwd {
 namespace config {
 
 namespace {
+// Ledgers an attestation may wait for its batch, about four minutes
+constexpr std::uint32_t BatchMaxDelayLimit = 64;
+
 ripple::KeyType
 keyTypeFromJson(Json::Value const& jv, char const* key)
 {
@@ -28,6 +35,96 @@ keyTypeFromJson(Json::Value const& jv, char const* key)
     throw std::runtime_error(
         "Unknown key type: "s + s + " while constructing a key type from json");
 }
+
+std::vector<std::uint32_t>
+cpusFromJson(Json::Value const& jv, char const* key)
+{
+    std::vector<std::uint32_t> cpus;
+    if (!jv.isMember(key))
+        return cpus;
+
+    auto const& v = jv[key];
+    if (!v.isArray())
+        throw std::runtime_error(std::string(key) + " is not an array");
+    for (auto const& cpu : v)
+    {
+        if (!cpu.isIntegral() || cpu.asInt() < 0)
+            throw std::runtime_error(std::string(key) + " wrong format");
+        cpus.push_back(cpu.asUInt());
+    }
+    return cpus;
+}
+
+// The fields a "Bridges" entry can't set, they are of the whole process or of
+// the chain connections shared by the bridges
+char const* const sharedFields[] = {
+    "RPCEndpoint",
+    "DBDir",
+    "Admin",
+    "LogFile",
+    "LogLevel",
+    "LogSilent",
+    "LogSizeToRotateMb",
+    "LogFilesToKeep",
+    "LogAsyncQueue",
+    "Database",
+    "IOThreads",
+    "CPUAffinity",
+    "RPCBatchLimit",
+    "WSQueueLimit"};
+char const* const sharedChainFields[] = {
+    "Endpoint",
+    "FallbackEndpoints",
+    "HedgeRequests",
+    "IOThreads",
+    "CPUAffinity"};
+
+bool
+isBridgeName(std::string const& name)
+{
+    return !name.empty() && name.size() <= 32 &&
+        std::all_of(name.begin(), name.end(), [](char c) {
+               return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                   (c >= '0' && c <= '9') || c == '_';
+           });
+}
+
+// The top level config with the fields of the entry, the chain objects are
+// merged field by field
+Json::Value
+bridgeJson(Json::Value const& top, Json::Value const& entry)
+{
+    using namespace std::literals;
+    Json::Value r = top;
+    r.removeMember("Bridges");
+    for (auto const& key : entry.getMemberNames())
+    {
+        if (key == "Name")
+            continue;
+        for (auto const* f : sharedFields)
+            if (key == f)
+                throw std::runtime_error(
+                    "Bridges: "s + f + " is set by the top level config");
+        if (key != "LockingChain" && key != "IssuingChain")
+        {
+            r[key] = entry[key];
+            continue;
+        }
+        auto const& chain = entry[key];
+        if (!chain.isObject())
+            throw std::runtime_error("Bridges: " + key + " wrong format");
+        for (auto const& field : chain.getMemberNames())
+        {
+            for (auto const* f : sharedChainFields)
+                if (field == f)
+                    throw std::runtime_error(
+                        "Bridges: "s + f + " of " + key +
+                        " is set by the top level config");
+            r[key][field] = chain[field];
+        }
+    }
+    return r;
+}
 }  // namespace
 
 std::optional<AdminConfig>
@@ -103,6 +200,15 @@ TxnSubmit::TxnSubmit(Json::Value const& jv)
         else
             throw std::runtime_error("WitnessSubmit config wrong format");
     }
+    if (jv.isMember("MaxFee"))
+        maxFee = jv["MaxFee"].asUInt();
+    if (jv.isMember("Tickets"))
+    {
+        tickets = jv["Tickets"].asUInt();
+        // An account can't own more
+        if (tickets > 250)
+            throw std::runtime_error("TxnSubmit: Tickets is more than 250");
+    }
 }
 
 ChainConfig::ChainConfig(Json::Value const& jv)
@@ -120,6 +226,62 @@ ChainConfig::ChainConfig(Json::Value const& jv)
     }
     if (jv.isMember("IgnoreSignerList"))
         ignoreSignerList = jv["IgnoreSignerList"].asBool();
+    if (jv.isMember("FallbackEndpoints"))
+    {
+        auto const& eps = jv["FallbackEndpoints"];
+        if (!eps.isArray())
+            throw std::runtime_error("FallbackEndpoints is not an array");
+        for (auto const& ep : eps)
+        {
+            if (!ep.isObject() || !ep.isMember("Host") || !ep.isMember("Port"))
+                throw std::runtime_error("FallbackEndpoints wrong format");
+            addrFallbackIps.push_back(
+                {ep["Host"].asString(),
+                 static_cast<std::uint16_t>(ep["Port"].asUInt())});
+        }
+    }
+    if (jv.isMember("HedgeRequests"))
+        hedgeRequests = jv["HedgeRequests"].asBool();
+    if (hedgeRequests && addrFallbackIps.empty())
+        throw std::runtime_error("HedgeRequests requires FallbackEndpoints");
+    if (jv.isMember("IOThreads"))
+        ioThreads = jv["IOThreads"].asUInt();
+    cpuAffinity = cpusFromJson(jv, "CPUAffinity");
+    if (!cpuAffinity.empty() && !ioThreads)
+        throw std::runtime_error("CPUAffinity requires IOThreads");
+}
+
+DatabaseConfig::DatabaseConfig(Json::Value const& jv)
+    : wal(jv.isMember("WAL") ? jv["WAL"].asBool() : false)
+    , synchronous(
+          jv.isMember("Synchronous") ? jv["Synchronous"].asString()
+                                     : std::string())
+    , readers(jv.isMember("Readers") ? jv["Readers"].asUInt() : 0)
+    , checkpointPages(
+          jv.isMember("CheckpointPages") ? jv["CheckpointPages"].asUInt()
+                                         : 1000)
+    , vacuumPages(
+          jv.isMember("VacuumPages") ? jv["VacuumPages"].asUInt() : 0)
+    , retainLedgers(
+          jv.isMember("RetainLedgers") ? jv["RetainLedgers"].asUInt() : 0)
+    , engine(
+          jv.isMember("Engine") ? jv["Engine"].asString()
+                                : std::string("sqlite"))
+    , logSegmentMB(
+          jv.isMember("LogSegmentMB") ? jv["LogSegmentMB"].asUInt() : 64)
+    , logCompactPercent(
+          jv.isMember("LogCompactPercent") ? jv["LogCompactPercent"].asUInt()
+                                           : 50)
+{
+    if (!checkpointPages)
+        throw std::runtime_error("Database config: CheckpointPages is 0");
+    if (engine != "sqlite" && engine != "log")
+        throw std::runtime_error("Database config: unknown Engine " + engine);
+    if (!logSegmentMB)
+        throw std::runtime_error("Database config: LogSegmentMB is 0");
+    if (logCompactPercent > 100)
+        throw std::runtime_error(
+            "Database config: LogCompactPercent is over 100");
 }
 
 Config::Config(Json::Value const& jv)
@@ -138,7 +300,19 @@ Config::Config(Json::Value const& jv)
     , adminConfig{jv.isMember("Admin") ? AdminConfig::make(jv["Admin"]) : std::nullopt}
     , maxAttToSend(
           jv.isMember("MaxAttToSend") ? jv["MaxAttToSend"].asUInt() : 200)
+    , adaptiveWindow(
+          jv.isMember("AdaptiveWindow") ? jv["AdaptiveWindow"].asBool() : false)
+    , minAttToSend(
+          jv.isMember("MinAttToSend") ? jv["MinAttToSend"].asUInt() : 8)
     , txLimit(jv.isMember("TxLimit") ? jv["TxLimit"].asUInt() : 500)
+    , binaryAccountTx(
+          jv.isMember("BinaryAccountTx") ? jv["BinaryAccountTx"].asBool()
+                                         : false)
+    , backfillRanges(
+          jv.isMember("BackfillRanges") ? jv["BackfillRanges"].asUInt() : 0)
+    , subscribeAccounts(
+          jv.isMember("SubscribeAccounts") ? jv["SubscribeAccounts"].asBool()
+                                           : false)
     , logFile(jv.isMember("LogFile") ? jv["LogFile"].asString() : std::string())
     , logLevel(
           jv.isMember("LogLevel") ? jv["LogLevel"].asString() : std::string())
@@ -148,16 +322,81 @@ Config::Config(Json::Value const& jv)
                                            : 0)
     , logFilesToKeep(
           jv.isMember("LogFilesToKeep") ? jv["LogFilesToKeep"].asUInt() : 0)
+    , logAsyncQueue(
+          jv.isMember("LogAsyncQueue") ? jv["LogAsyncQueue"].asUInt() : 0)
     , useBatch(jv.isMember("UseBatch") ? jv["UseBatch"].asBool() : false)
+    , batchMaxDelay(
+          jv.isMember("BatchMaxDelay") ? jv["BatchMaxDelay"].asUInt() : 0)
+    , batchTarget(jv.isMember("BatchTarget") ? jv["BatchTarget"].asUInt() : 0)
+    , signingThreads(
+          jv.isMember("SigningThreads") ? jv["SigningThreads"].asUInt() : 0)
+    , database(
+          jv.isMember("Database") ? DatabaseConfig(jv["Database"])
+                                  : DatabaseConfig())
+    , ioThreads(jv.isMember("IOThreads") ? jv["IOThreads"].asUInt() : 0)
+    , cpuAffinity(cpusFromJson(jv, "CPUAffinity"))
+    , rpcBatchLimit(
+          jv.isMember("RPCBatchLimit") ? jv["RPCBatchLimit"].asUInt() : 100)
+    , attestationCacheSize(
+          jv.isMember("AttestationCacheSize")
+              ? jv["AttestationCacheSize"].asUInt()
+              : 4096)
+    , wsQueueLimit(
+          jv.isMember("WSQueueLimit")
+              ? static_cast<std::uint16_t>(jv["WSQueueLimit"].asUInt())
+              : 100)
 {
+    if (jv.isMember("WSQueueLimit") &&
+        (!jv["WSQueueLimit"].asUInt() ||
+         jv["WSQueueLimit"].asUInt() >
+             std::numeric_limits<std::uint16_t>::max()))
+        throw std::runtime_error("WSQueueLimit must be within 1 and 65535");
     if (jv.isMember("SigningAccount"))
         signingAccount = rpc::fromJson<ripple::AccountID>(jv, "SigningAccount");
+    if (adaptiveWindow &&
+        (!maxAttToSend || !minAttToSend || minAttToSend > maxAttToSend))
+        throw std::runtime_error(
+            "AdaptiveWindow requires 0 < MinAttToSend <= MaxAttToSend");
+    if ((batchMaxDelay || batchTarget) && !useBatch)
+        throw std::runtime_error("BatchMaxDelay and BatchTarget need UseBatch");
+    if (batchMaxDelay > BatchMaxDelayLimit)
+        throw std::runtime_error("BatchMaxDelay is over 64 ledgers");
+    if (binaryAccountTx && useBatch)
+        throw std::runtime_error(
+            "BinaryAccountTx doesn't support Batch Attestations");
 #ifndef USE_BATCH_ATTESTATION
     if (useBatch)
         throw std::runtime_error(
             "Please compile with USE_BATCH_ATTESTATION to use Batch "
             "Attestations");
 #endif
+
+    if (jv.isMember("Bridges"))
+    {
+        auto const& entries = jv["Bridges"];
+        if (!entries.isArray())
+            throw std::runtime_error("Bridges is not an array");
+        std::set<std::string> names;
+        for (auto const& entry : entries)
+        {
+            if (!entry.isObject() || !entry["Name"].isString())
+                throw std::runtime_error("Bridges: Name is missing");
+            auto const n = entry["Name"].asString();
+            if (!isBridgeName(n))
+                throw std::runtime_error("Bridges: invalid Name " + n);
+            if (!names.insert(n).second)
+                throw std::runtime_error("Bridges: duplicate Name " + n);
+
+            auto& b = bridges.emplace_back(bridgeJson(jv, entry));
+            b.name = n;
+            if (b.bridge == bridge ||
+                std::count_if(
+                    bridges.begin(), bridges.end(), [&](Config const& c) {
+                        return c.bridge == b.bridge;
+                    }) > 1)
+                throw std::runtime_error("Bridges: duplicate bridge " + n);
+        }
+    }
 }
 
 }  // namespace config
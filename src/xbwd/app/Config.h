@@ -15,7 +15,9 @@
 #include <boost/asio/ip/network_v6.hpp>
 #include <boost/filesystem.hpp>
 
+#include <set>
 #include <string>
+#include <vector>
 
 namespace xbwd {
 namespace config {
@@ -47,6 +49,11 @@ struct TxnSubmit
     std::pair<ripple::PublicKey, ripple::SecretKey> keypair;
     ripple::AccountID submittingAccount;
     bool shouldSubmit{true};
+    // Fee cap in drops for the escalated fees, 0 - no cap
+    std::uint32_t maxFee = 0;
+    // Tickets kept by the submitting account, the attestations are submitted
+    // with tickets instead of sequences. 0 - use sequences
+    std::uint32_t tickets = 0;
 
     explicit TxnSubmit(Json::Value const& jv);
 };
@@ -55,13 +62,46 @@ struct ChainConfig
 {
     rpc::AddrEndpoint addrChainIp;
     beast::IP::Endpoint chainIp;
+    // Other nodes of the chain. The stream moves to the healthiest node.
+    std::vector<rpc::AddrEndpoint> addrFallbackIps;
+    std::vector<beast::IP::Endpoint> fallbackIps;
+    // Send submit, account_info and tx to the best other node as well, the
+    // first reply is used
+    bool hedgeRequests = false;
     ripple::AccountID rewardAccount;
     std::optional<TxnSubmit> txnSubmit;
     bool ignoreSignerList = false;
     std::optional<ripple::uint256> lastAttestedCommitTx;
+    // Threads of the chain own io_service, 0 - the listener runs on the app
+    // io_service
+    std::uint32_t ioThreads = 0;
+    // The io threads are pinned to these CPUs in turn
+    std::vector<std::uint32_t> cpuAffinity;
     explicit ChainConfig(Json::Value const& jv);
 };
 
+struct DatabaseConfig
+{
+    bool wal = false;
+    std::string synchronous;
+    std::uint32_t readers = 0;
+    std::uint32_t checkpointPages = 1000;
+    // Free pages returned to the file system at each pruning, 0 - no auto
+    // vacuum
+    std::uint32_t vacuumPages = 0;
+    // Ledgers the claim and create account rows are kept for, counted from
+    // the last processed ledger of their chain. 0 - keep them.
+    std::uint32_t retainLedgers = 0;
+    // Storage of the claim and create account rows: "sqlite", the tables of
+    // the database, or "log", see AttestationLog
+    std::string engine = "sqlite";
+    std::uint32_t logSegmentMB = 64;
+    std::uint32_t logCompactPercent = 50;
+
+    DatabaseConfig() = default;
+    explicit DatabaseConfig(Json::Value const& jv);
+};
+
 struct Config
 {
 public:
@@ -80,17 +120,72 @@ public:
     // 0 - no "window"
     std::uint32_t maxAttToSend = 0;
 
+    // Adapt the window to the submit results, between minAttToSend and
+    // maxAttToSend
+    bool adaptiveWindow = false;
+    std::uint32_t minAttToSend = 8;
+
     std::uint32_t txLimit = 500;
 
+    // Request the account_tx transactions and metadata as binary blobs
+    bool binaryAccountTx = false;
+
+    // Split the history into that many ledger ranges, requested concurrently
+    // 0, 1 - one account_tx request at a time
+    std::uint32_t backfillRanges = 0;
+
+    // Once the history is done, subscribe to the door and submit accounts
+    // instead of requesting account_tx on every ledger
+    bool subscribeAccounts = false;
+
     std::string logFile;
     std::string logLevel;
     bool logSilent;
 
     unsigned logSizeToRotateMb = 0;  // 0 means "no rotation"
     unsigned logFilesToKeep = 0;
+    // Messages queued by each thread for the log thread, 0 - each thread
+    // writes its messages
+    unsigned logAsyncQueue = 0;
 
     bool useBatch;
 
+    // With batches, an in-progress batch waits up to batchMaxDelay ledgers of
+    // the submitting chain to reach batchTarget attestations
+    // 0 delay - submitted at every ledger boundary, 0 target - the batch cap
+    std::uint32_t batchMaxDelay = 0;
+    std::uint32_t batchTarget = 0;
+
+    // Threads signing the attestations and the submitted transactions
+    // 0 - sign on the event and submit threads
+    std::uint32_t signingThreads = 0;
+
+    DatabaseConfig database;
+
+    // Threads of the app io_service, 0 - one per hardware thread
+    std::uint32_t ioThreads = 0;
+    // The app io threads are pinned to these CPUs in turn
+    std::vector<std::uint32_t> cpuAffinity;
+
+    // Most requests in a JSON-RPC batch, 0 - no batches
+    std::uint32_t rpcBatchLimit = 100;
+
+    // Attestations kept in memory for the witness RPCs, 0 - no cache
+    std::uint32_t attestationCacheSize = 4096;
+
+    // Messages queued to a websocket subscriber before it is dropped
+    std::uint16_t wsQueueLimit = 100;
+
+    // Name of an entry of "Bridges", empty for the top level bridge. The
+    // database tables of a named bridge end with "_<name>".
+    std::string name;
+
+    // The other bridges of the process, each a Federator sharing the chain
+    // connections, the io threads and the database of the top level one. An
+    // entry is the top level config with the fields of the entry, the fields
+    // used by the whole process can't be set there.
+    std::vector<Config> bridges;
+
     explicit Config(Json::Value const& jv);
 };
 
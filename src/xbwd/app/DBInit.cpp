@@ -1,10 +1,65 @@
 #include <xbwd/app/DBInit.h>
 
+#include <xbwd/basics/StructuredLog.h>
+#include <xbwd/core/SociDB.h>
+
+#include <ripple/basics/base_uint.h>
+
 #include <fmt/core.h>
 
+#include <stdexcept>
+#include <utility>
+
 namespace xbwd {
 namespace db_init {
 
+namespace {
+
+// Replace the hex text values of a column with 32 bytes blobs. SQLite does not
+// convert a blob stored in a column with a text affinity, so the tables of the
+// older databases keep their declared types.
+void
+hexToBlob(soci::session& s, std::string const& table, std::string const& column)
+{
+    std::vector<std::pair<long long, std::string>> rows;
+    {
+        long long rowid = 0;
+        std::string hex;
+        soci::statement st =
+            (s.prepare << fmt::format(
+                 "SELECT rowid, {1} FROM {0} WHERE typeof({1}) = 'text';",
+                 table,
+                 column),
+             soci::into(rowid),
+             soci::into(hex));
+        st.execute();
+        while (st.fetch())
+            rows.emplace_back(rowid, hex);
+    }
+
+    auto const sql = fmt::format(
+        "UPDATE {} SET {} = :value WHERE rowid = :rowid;", table, column);
+    for (auto const& [rowid, hex] : rows)
+    {
+        ripple::uint256 h;
+        if (!h.parseHex(hex))
+            throw std::runtime_error(
+                fmt::format("cannot parse {}.{}: {}", table, column, hex));
+        soci::blob value = convert(h, s);
+        s << sql, soci::use(value), soci::use(rowid);
+    }
+}
+
+std::string
+bridgeTable(std::string_view table, std::string const& bridge)
+{
+    if (bridge.empty())
+        return std::string(table);
+    return fmt::format("{}_{}", table, bridge);
+}
+
+}  // namespace
+
 std::string const&
 xChainDBName()
 {
@@ -13,28 +68,43 @@ xChainDBName()
 }
 
 // Use the source that produce the event to get the table name
-std::string const&
-xChainTableName(ChainType src)
+std::string
+xChainTableName(ChainType src, std::string const& bridge)
 {
-    if (src == ChainType::locking)
-    {
-        static std::string const r{"XChainTxnLockingToIssuing"};
-        return r;
-    }
-    static std::string const r{"XChainTxnIssuingToLocking"};
-    return r;
+    return bridgeTable(
+        src == ChainType::locking ? "XChainTxnLockingToIssuing"
+                                  : "XChainTxnIssuingToLocking",
+        bridge);
 }
 
-std::string const&
-xChainCreateAccountTableName(ChainType src)
+std::string
+xChainCreateAccountTableName(ChainType src, std::string const& bridge)
 {
-    if (src == ChainType::locking)
-    {
-        static std::string const r{"XChainTxnCreateAccountLocking"};
-        return r;
-    }
-    static std::string const r{"XChainTxnCreateAccountIssuing"};
-    return r;
+    return bridgeTable(
+        src == ChainType::locking ? "XChainTxnCreateAccountLocking"
+                                  : "XChainTxnCreateAccountIssuing",
+        bridge);
+}
+
+std::string
+xChainAttestedTableName(ChainType chain, std::string const& bridge)
+{
+    return bridgeTable(
+        chain == ChainType::locking ? "XChainAttestedLocking"
+                                    : "XChainAttestedIssuing",
+        bridge);
+}
+
+std::string
+xChainSyncTableName(std::string const& bridge)
+{
+    return bridgeTable(xChainSyncTable, bridge);
+}
+
+std::string
+xChainCheckpointTableName(std::string const& bridge)
+{
+    return bridgeTable(xChainCheckpointTable, bridge);
 }
 
 std::vector<std::string> const&
@@ -49,85 +119,161 @@ xChainDBPragma()
     return result;
 };
 
+std::vector<std::string>
+xChainDBInit(std::string const& bridge)
+{
+    std::vector<std::string> r;
+    r.push_back("BEGIN TRANSACTION;");
+
+    // DeliveredAmt is encoded as a serialized STAmount
+    //              this is raw data - no encoded.
+    // Success is a bool (but soci complains about using bools)
+
+    auto constexpr tblFmtStr = R"sql(
+        CREATE TABLE IF NOT EXISTS {table_name} (
+            TransID           BLOB PRIMARY KEY,
+            LedgerSeq         BIGINT UNSIGNED,
+            ClaimID           BIGINT UNSIGNED,
+            Success           UNSIGNED,
+            DeliveredAmt      BLOB,
+            Bridge            BLOB,
+            SendingAccount    BLOB,
+            RewardAccount     BLOB,
+            OtherChainDst     BLOB,
+            SigningAccount    BLOB,
+            PublicKey         BLOB,
+            Signature         BLOB);
+    )sql";
+    auto constexpr idxFmtStr = R"sql(
+        CREATE INDEX IF NOT EXISTS {table_name}ClaimIDIdx ON {table_name}(ClaimID);",
+    )sql";
+    // The select_all pages and the pruning by ledger
+    auto constexpr seqIdxFmtStr = R"sql(
+        CREATE INDEX IF NOT EXISTS {table_name}LedgerSeqIdx ON {table_name}(LedgerSeq, TransID);
+    )sql";
+
+    auto constexpr createAccTblFmtStr = R"sql(
+        CREATE TABLE IF NOT EXISTS {table_name} (
+            TransID           BLOB PRIMARY KEY,
+            LedgerSeq         BIGINT UNSIGNED,
+            CreateCount       BIGINT UNSIGNED,
+            Success           UNSIGNED,
+            DeliveredAmt      BLOB,
+            RewardAmt         BLOB,
+            Bridge            BLOB,
+            SendingAccount    BLOB,
+            RewardAccount     BLOB,
+            OtherChainDst     BLOB,
+            SigningAccount    BLOB,
+            PublicKey         BLOB,
+            Signature         BLOB);
+    )sql";
+    auto constexpr createAccIdxFmtStr = R"sql(
+        CREATE INDEX IF NOT EXISTS {table_name}CreateCountIdx ON {table_name}(CreateCount);",
+    )sql";
+
+    auto constexpr syncTblFmtStr = R"sql(
+        CREATE TABLE IF NOT EXISTS {table_name} (
+            ChainType         UNSIGNED PRIMARY KEY,
+            TransID           BLOB,
+            LedgerSeq         BIGINT UNSIGNED);
+    )sql";
+
+    auto constexpr checkpointTblFmtStr = R"sql(
+        CREATE TABLE IF NOT EXISTS {table_name} (
+            ChainType         UNSIGNED PRIMARY KEY,
+            DoorLedgerSeq     BIGINT UNSIGNED,
+            SubmitLedgerSeq   BIGINT UNSIGNED);
+    )sql";
+
+    // LedgerSeq is the ledger of the chain the attestation landed on
+    auto constexpr attestedTblFmtStr = R"sql(
+        CREATE TABLE IF NOT EXISTS {table_name} (
+            Digest            BLOB PRIMARY KEY,
+            LedgerSeq         BIGINT UNSIGNED);
+    )sql";
+    auto constexpr attestedIdxFmtStr = R"sql(
+        CREATE INDEX IF NOT EXISTS {table_name}LedgerSeqIdx ON {table_name}(LedgerSeq);
+    )sql";
+
+    for (auto cd : {ChainType::locking, ChainType::issuing})
+    {
+        auto const claims = xChainTableName(cd, bridge);
+        r.push_back(fmt::format(tblFmtStr, fmt::arg("table_name", claims)));
+        r.push_back(fmt::format(idxFmtStr, fmt::arg("table_name", claims)));
+        r.push_back(fmt::format(seqIdxFmtStr, fmt::arg("table_name", claims)));
+
+        auto const creates = xChainCreateAccountTableName(cd, bridge);
+        r.push_back(fmt::format(
+            createAccTblFmtStr, fmt::arg("table_name", creates)));
+        r.push_back(fmt::format(
+            createAccIdxFmtStr, fmt::arg("table_name", creates)));
+        r.push_back(
+            fmt::format(seqIdxFmtStr, fmt::arg("table_name", creates)));
+
+        auto const attested = xChainAttestedTableName(cd, bridge);
+        r.push_back(fmt::format(
+            attestedTblFmtStr, fmt::arg("table_name", attested)));
+        r.push_back(fmt::format(
+            attestedIdxFmtStr, fmt::arg("table_name", attested)));
+    }
+
+    r.push_back(fmt::format(
+        syncTblFmtStr, fmt::arg("table_name", xChainSyncTableName(bridge))));
+    r.push_back(fmt::format(
+        checkpointTblFmtStr,
+        fmt::arg("table_name", xChainCheckpointTableName(bridge))));
+
+    r.push_back("END TRANSACTION;");
+    return r;
+}
+
 std::vector<std::string> const&
 xChainDBInit()
 {
-    static std::vector<std::string> result = [] {
-        std::vector<std::string> r;
-        r.push_back("BEGIN TRANSACTION;");
-
-        // DeliveredAmt is encoded as a serialized STAmount
-        //              this is raw data - no encoded.
-        // Success is a bool (but soci complains about using bools)
-
-        auto constexpr tblFmtStr = R"sql(
-            CREATE TABLE IF NOT EXISTS {table_name} (
-                TransID           CHARACTER(64) PRIMARY KEY,
-                LedgerSeq         BIGINT UNSIGNED,
-                ClaimID           BIGINT UNSIGNED,
-                Success           UNSIGNED,
-                DeliveredAmt      BLOB,
-                Bridge            BLOB,
-                SendingAccount    BLOB,
-                RewardAccount     BLOB,
-                OtherChainDst     BLOB,
-                SigningAccount    BLOB,
-                PublicKey         BLOB,
-                Signature         BLOB);
-        )sql";
-        auto constexpr idxFmtStr = R"sql(
-            CREATE INDEX IF NOT EXISTS {table_name}ClaimIDIdx ON {table_name}(ClaimID);",
-        )sql";
-
-        auto constexpr createAccTblFmtStr = R"sql(
-            CREATE TABLE IF NOT EXISTS {table_name} (
-                TransID           CHARACTER(64) PRIMARY KEY,
-                LedgerSeq         BIGINT UNSIGNED,
-                CreateCount       BIGINT UNSIGNED,
-                Success           UNSIGNED,
-                DeliveredAmt      BLOB,
-                RewardAmt         BLOB,
-                Bridge            BLOB,
-                SendingAccount    BLOB,
-                RewardAccount     BLOB,
-                OtherChainDst     BLOB,
-                SigningAccount    BLOB,
-                PublicKey         BLOB,
-                Signature         BLOB);
-        )sql";
-        auto constexpr createAccIdxFmtStr = R"sql(
-            CREATE INDEX IF NOT EXISTS {table_name}CreateCountIdx ON {table_name}(CreateCount);",
-        )sql";
-
-        auto constexpr syncTblFmtStr = R"sql(
-            CREATE TABLE IF NOT EXISTS {table_name} (
-                ChainType         UNSIGNED PRIMARY KEY,
-                TransID           CHARACTER(64),
-                LedgerSeq         BIGINT UNSIGNED);
-        )sql";
-
-        for (auto cd : {ChainType::locking, ChainType::issuing})
+    static std::vector<std::string> const result = xChainDBInit({});
+    return result;
+}
+
+void
+xChainDBMigrate(soci::session& s, beast::Journal j)
+{
+    int version = 0;
+    s << "PRAGMA user_version;", soci::into(version);
+    if (version == xChainDBVersion)
+        return;
+    if (version > xChainDBVersion)
+    {
+        JLOGV(
+            j.fatal(),
+            "database version is not supported",
+            jv("version", version),
+            jv("supported", xChainDBVersion));
+        throw std::runtime_error("database version is not supported");
+    }
+
+    soci::transaction tr(s);
+
+    // 1: transaction hashes and attestation digests are 32 bytes blobs
+    if (version < 1)
+    {
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
         {
-            r.push_back(fmt::format(
-                tblFmtStr, fmt::arg("table_name", xChainTableName(cd))));
-            r.push_back(fmt::format(
-                idxFmtStr, fmt::arg("table_name", xChainTableName(cd))));
-
-            r.push_back(fmt::format(
-                createAccTblFmtStr,
-                fmt::arg("table_name", xChainCreateAccountTableName(cd))));
-            r.push_back(fmt::format(
-                createAccIdxFmtStr,
-                fmt::arg("table_name", xChainCreateAccountTableName(cd))));
+            hexToBlob(s, xChainTableName(ct), "TransID");
+            hexToBlob(s, xChainCreateAccountTableName(ct), "TransID");
+            hexToBlob(s, xChainAttestedTableName(ct), "Digest");
         }
+        hexToBlob(s, xChainSyncTable, "TransID");
+    }
 
-        r.push_back(fmt::format(
-            syncTblFmtStr, fmt::arg("table_name", xChainSyncTable)));
+    s << fmt::format("PRAGMA user_version = {};", xChainDBVersion);
+    tr.commit();
 
-        r.push_back("END TRANSACTION;");
-        return r;
-    }();
-    return result;
+    JLOGV(
+        j.info(),
+        "database migrated",
+        jv("from", version),
+        jv("to", xChainDBVersion));
 }
 
 }  // namespace db_init
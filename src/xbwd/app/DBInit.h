@@ -2,25 +2,45 @@
 
 #include <xbwd/basics/ChainTypes.h>
 
+#include <ripple/beast/utility/Journal.h>
+
 #include <array>
 #include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
 
+namespace soci {
+class session;
+}
+
 namespace xbwd {
 namespace db_init {
 
+// The tables of the bridge of the top level config have these names, the
+// names of the tables of the other bridges end with "_<Name>" of their config
 std::string const xChainSyncTable("XChainSync");
+// Processed ledgers of the door and of the submit accounts, per chain
+std::string const xChainCheckpointTable("XChainCheckpoint");
 
 std::string const&
 xChainDBName();
 
-std::string const&
-xChainTableName(ChainType chain);
+std::string
+xChainTableName(ChainType chain, std::string const& bridge = {});
 
-std::string const&
-xChainCreateAccountTableName(ChainType chain);
+std::string
+xChainCreateAccountTableName(ChainType chain, std::string const& bridge = {});
+
+// Digests of the attestations that landed on the chain
+std::string
+xChainAttestedTableName(ChainType chain, std::string const& bridge = {});
+
+std::string
+xChainSyncTableName(std::string const& bridge = {});
+
+std::string
+xChainCheckpointTableName(std::string const& bridge = {});
 
 std::vector<std::string> const&
 xChainDBPragma();
@@ -28,5 +48,18 @@ xChainDBPragma();
 std::vector<std::string> const&
 xChainDBInit();
 
+// The same for the tables of a bridge of the "Bridges" config, created at the
+// current version
+std::vector<std::string>
+xChainDBInit(std::string const& bridge);
+
+// Schema version, kept in PRAGMA user_version
+int constexpr xChainDBVersion = 1;
+
+// Upgrade the tables created by xChainDBInit() of an older version. Throw if
+// the database is newer than this version.
+void
+xChainDBMigrate(soci::session& s, beast::Journal j);
+
 }  // namespace db_init
 }  // namespace xbwd
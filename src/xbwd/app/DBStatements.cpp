@@ -0,0 +1,520 @@
+#include <xbwd/app/DBStatements.h>
+
+#include <xbwd/app/DBInit.h>
+
+#include <fmt/core.h>
+
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace xbwd {
+namespace db_stmt {
+
+namespace {
+
+ChainArray<std::string>
+chainNames(std::string_view prefix)
+{
+    return ChainArray<std::string>{
+        fmt::format("{}_{}", prefix, to_string(ChainType::locking)),
+        fmt::format("{}_{}", prefix, to_string(ChainType::issuing))};
+}
+
+std::string
+withBridge(std::string const& name, std::string const& bridge)
+{
+    if (bridge.empty())
+        return name;
+    return fmt::format("{}:{}", name, bridge);
+}
+
+std::string
+insertClaimSql(ChainType ct, std::string const& bridge)
+{
+    return fmt::format(
+        R"sql(INSERT INTO {table_name}
+              (TransID, LedgerSeq, ClaimID, Success, DeliveredAmt, Bridge,
+               SendingAccount, RewardAccount, OtherChainDst, SigningAccount, PublicKey, Signature)
+              VALUES
+              (:txnId, :lgrSeq, :claimID, :success, :amt, :bridge,
+               :sendingAccount, :rewardAccount, :otherChainDst, :signingAccount, :pk, :sig);
+        )sql",
+        fmt::arg("table_name", db_init::xChainTableName(ct, bridge)));
+}
+
+std::string
+insertCreateAccountSql(ChainType ct, std::string const& bridge)
+{
+    return fmt::format(
+        R"sql(INSERT INTO {table_name}
+              (TransID, LedgerSeq, CreateCount, Success, DeliveredAmt, RewardAmt, Bridge,
+               SendingAccount, RewardAccount, otherChainDst, SigningAccount, PublicKey, Signature)
+              VALUES
+              (:txnId, :lgrSeq, :createCount, :success, :amt, :rewardAmt, :bridge,
+               :sendingAccount, :rewardAccount, :otherChainDst, :signingAccount, :pk, :sig);
+        )sql",
+        fmt::arg(
+            "table_name", db_init::xChainCreateAccountTableName(ct, bridge)));
+}
+
+// The table and the ID column of the claims or of the create accounts
+std::pair<std::string, char const*>
+idTable(ChainType ct, bool isCreateAccount, std::string const& bridge)
+{
+    if (isCreateAccount)
+        return {
+            db_init::xChainCreateAccountTableName(ct, bridge), "CreateCount"};
+    return {db_init::xChainTableName(ct, bridge), "ClaimID"};
+}
+
+std::string
+deleteRangeSql(ChainType ct, bool isCreateAccount, std::string const& bridge)
+{
+    auto const [table, column] = idTable(ct, isCreateAccount, bridge);
+    return fmt::format(
+        "DELETE FROM {} WHERE {} BETWEEN :first AND :last;", table, column);
+}
+
+std::string
+selectPrunedSql(ChainType ct, bool isCreateAccount, std::string const& bridge)
+{
+    auto const [table, column] = idTable(ct, isCreateAccount, bridge);
+    return fmt::format(
+        "SELECT {} FROM {} WHERE LedgerSeq < :lgrSeq;", column, table);
+}
+
+std::string
+selectCreateAccountSql(ChainType ct, std::string const& bridge)
+{
+    return fmt::format(
+        R"sql(SELECT SigningAccount, Signature, PublicKey, RewardAccount FROM {table_name}
+              WHERE CreateCount = :createCount and
+                    Success = 1 and
+                    DeliveredAmt = :amt and
+                    RewardAmt = :rewardAmt and
+                    Bridge = :bridge and
+                    SendingAccount = :sendingAccount and
+                    OtherChainDst = :otherChainDst;
+        )sql",
+        fmt::arg(
+            "table_name", db_init::xChainCreateAccountTableName(ct, bridge)));
+}
+
+soci::statement
+prepareSelectClaim(
+    SelectClaim& q,
+    soci::session& s,
+    ChainType ct,
+    bool withDst,
+    std::string const& bridge)
+{
+    auto const tblName = db_init::xChainTableName(ct, bridge);
+    if (withDst)
+    {
+        auto const sql = fmt::format(
+            R"sql(SELECT SigningAccount, Signature, PublicKey, RewardAccount FROM {table_name}
+                  WHERE ClaimID = :claimID and
+                        Success = 1 and
+                        DeliveredAmt = :amt and
+                        Bridge = :bridge and
+                        SendingAccount = :sendingAccount and
+                        OtherChainDst = :otherChainDst;
+            )sql",
+            fmt::arg("table_name", tblName));
+
+        return (
+            s.prepare << sql,
+            soci::into(q.signingAccount),
+            soci::into(q.signature, q.sigInd),
+            soci::into(q.publicKey),
+            soci::into(q.rewardAccount),
+            soci::use(q.claimID),
+            soci::use(q.amt),
+            soci::use(q.bridge),
+            soci::use(q.sendingAccount),
+            soci::use(q.otherChainDst));
+    }
+
+    auto const sql = fmt::format(
+        R"sql(SELECT SigningAccount, Signature, PublicKey, RewardAccount, OtherChainDst FROM {table_name}
+              WHERE ClaimID = :claimID and
+                    Success = 1 and
+                    DeliveredAmt = :amt and
+                    Bridge = :bridge and
+                    SendingAccount = :sendingAccount;
+        )sql",
+        fmt::arg("table_name", tblName));
+
+    return (
+        s.prepare << sql,
+        soci::into(q.signingAccount),
+        soci::into(q.signature, q.sigInd),
+        soci::into(q.publicKey),
+        soci::into(q.rewardAccount),
+        soci::into(q.otherChainDst, q.otherChainDstInd),
+        soci::use(q.claimID),
+        soci::use(q.amt),
+        soci::use(q.bridge),
+        soci::use(q.sendingAccount));
+}
+
+}  // namespace
+
+InsertClaim::InsertClaim(
+    soci::session& s,
+    ChainType ct,
+    std::string const& bridgeName)
+    : txnId(s)
+    , amt(s)
+    , bridge(s)
+    , sendingAccount(s)
+    , rewardAccount(s)
+    , otherChainDst(s)
+    , signingAccount(s)
+    , publicKey(s)
+    , signature(s)
+    , st((s.prepare << insertClaimSql(ct, bridgeName),
+          soci::use(txnId),
+          soci::use(ledgerSeq),
+          soci::use(claimID),
+          soci::use(success),
+          soci::use(amt),
+          soci::use(bridge),
+          soci::use(sendingAccount),
+          soci::use(rewardAccount),
+          soci::use(otherChainDst),
+          soci::use(signingAccount),
+          soci::use(publicKey),
+          soci::use(signature)))
+{
+}
+
+std::string
+InsertClaim::name(ChainType ct, std::string const& bridge)
+{
+    static auto const r = chainNames("insert_claim");
+    return withBridge(r[ct], bridge);
+}
+
+InsertCreateAccount::InsertCreateAccount(
+    soci::session& s,
+    ChainType ct,
+    std::string const& bridgeName)
+    : txnId(s)
+    , amt(s)
+    , rewardAmt(s)
+    , bridge(s)
+    , sendingAccount(s)
+    , rewardAccount(s)
+    , otherChainDst(s)
+    , signingAccount(s)
+    , publicKey(s)
+    , signature(s)
+    , st((s.prepare << insertCreateAccountSql(ct, bridgeName),
+          soci::use(txnId),
+          soci::use(ledgerSeq),
+          soci::use(createCount),
+          soci::use(success),
+          soci::use(amt),
+          soci::use(rewardAmt),
+          soci::use(bridge),
+          soci::use(sendingAccount),
+          soci::use(rewardAccount),
+          soci::use(otherChainDst),
+          soci::use(signingAccount),
+          soci::use(publicKey),
+          soci::use(signature)))
+{
+}
+
+std::string
+InsertCreateAccount::name(ChainType ct, std::string const& bridge)
+{
+    static auto const r = chainNames("insert_create_account");
+    return withBridge(r[ct], bridge);
+}
+
+UpdateSyncTx::UpdateSyncTx(soci::session& s, std::string const& bridge)
+    : txnId(s)
+    , st((s.prepare << fmt::format(
+                           "UPDATE {} SET TransID = :tx_hash WHERE ChainType "
+                           "= :chain_type;",
+                           db_init::xChainSyncTableName(bridge)),
+          soci::use(txnId),
+          soci::use(chainType)))
+{
+}
+
+std::string
+UpdateSyncTx::name(std::string const& bridge)
+{
+    return withBridge("update_sync_tx", bridge);
+}
+
+UpdateSyncLedger::UpdateSyncLedger(soci::session& s, std::string const& bridge)
+    : st((s.prepare << fmt::format(
+                           "UPDATE {} SET LedgerSeq = :ledger_sqn WHERE "
+                           "ChainType = :chain_type;",
+                           db_init::xChainSyncTableName(bridge)),
+          soci::use(ledgerSeq),
+          soci::use(chainType)))
+{
+}
+
+std::string
+UpdateSyncLedger::name(std::string const& bridge)
+{
+    return withBridge("update_sync_ledger", bridge);
+}
+
+UpdateCheckpoint::UpdateCheckpoint(soci::session& s, std::string const& bridge)
+    : st((s.prepare << fmt::format(
+                           "UPDATE {} SET DoorLedgerSeq = MAX(DoorLedgerSeq, "
+                           ":door_sqn), SubmitLedgerSeq = MAX(SubmitLedgerSeq, "
+                           ":submit_sqn) WHERE ChainType = :chain_type;",
+                           db_init::xChainCheckpointTableName(bridge)),
+          soci::use(doorLedgerSeq),
+          soci::use(submitLedgerSeq),
+          soci::use(chainType)))
+{
+}
+
+std::string
+UpdateCheckpoint::name(std::string const& bridge)
+{
+    return withBridge("update_checkpoint", bridge);
+}
+
+InsertAttested::InsertAttested(
+    soci::session& s,
+    ChainType ct,
+    std::string const& bridge)
+    : digest(s)
+    , st((s.prepare << fmt::format(
+                           "INSERT OR IGNORE INTO {} (Digest, LedgerSeq) "
+                           "VALUES (:digest, :lgrSeq);",
+                           db_init::xChainAttestedTableName(ct, bridge)),
+          soci::use(digest),
+          soci::use(ledgerSeq)))
+{
+}
+
+std::string
+InsertAttested::name(ChainType ct, std::string const& bridge)
+{
+    static auto const r = chainNames("insert_attested");
+    return withBridge(r[ct], bridge);
+}
+
+PruneAttested::PruneAttested(
+    soci::session& s,
+    ChainType ct,
+    std::string const& bridge)
+    : st((s.prepare << fmt::format(
+                           "DELETE FROM {} WHERE LedgerSeq < :lgrSeq;",
+                           db_init::xChainAttestedTableName(ct, bridge)),
+          soci::use(ledgerSeq)))
+{
+}
+
+std::string
+PruneAttested::name(ChainType ct, std::string const& bridge)
+{
+    static auto const r = chainNames("prune_attested");
+    return withBridge(r[ct], bridge);
+}
+
+DeleteIDRange::DeleteIDRange(
+    soci::session& s,
+    ChainType ct,
+    bool isCreateAccount,
+    std::string const& bridge)
+    : st((s.prepare << deleteRangeSql(ct, isCreateAccount, bridge),
+          soci::use(first),
+          soci::use(last)))
+{
+}
+
+std::string
+DeleteIDRange::name(
+    ChainType ct,
+    bool isCreateAccount,
+    std::string const& bridge)
+{
+    static auto const claim = chainNames("delete_claims");
+    static auto const create = chainNames("delete_create_accounts");
+    return withBridge(isCreateAccount ? create[ct] : claim[ct], bridge);
+}
+
+SelectPrunedIDs::SelectPrunedIDs(
+    soci::session& s,
+    ChainType ct,
+    bool isCreateAccount,
+    std::string const& bridge)
+    : st((s.prepare << selectPrunedSql(ct, isCreateAccount, bridge),
+          soci::into(id),
+          soci::use(ledgerSeq)))
+{
+}
+
+std::string
+SelectPrunedIDs::name(
+    ChainType ct,
+    bool isCreateAccount,
+    std::string const& bridge)
+{
+    static auto const claim = chainNames("select_pruned_claims");
+    static auto const create = chainNames("select_pruned_create_accounts");
+    return withBridge(isCreateAccount ? create[ct] : claim[ct], bridge);
+}
+
+PruneClaims::PruneClaims(
+    soci::session& s,
+    ChainType ct,
+    bool isCreateAccount,
+    std::string const& bridge)
+    : st((s.prepare << fmt::format(
+                           "DELETE FROM {} WHERE LedgerSeq < :lgrSeq;",
+                           idTable(ct, isCreateAccount, bridge).first),
+          soci::use(ledgerSeq)))
+{
+}
+
+std::string
+PruneClaims::name(ChainType ct, bool isCreateAccount, std::string const& bridge)
+{
+    static auto const claim = chainNames("prune_claims");
+    static auto const create = chainNames("prune_create_accounts");
+    return withBridge(isCreateAccount ? create[ct] : claim[ct], bridge);
+}
+
+SelectClaim::SelectClaim(
+    soci::session& s,
+    ChainType ct,
+    bool withDst,
+    std::string const& bridgeName)
+    : amt(s)
+    , bridge(s)
+    , sendingAccount(s)
+    , otherChainDst(s)
+    , signingAccount(s)
+    , signature(s)
+    , publicKey(s)
+    , rewardAccount(s)
+    , st(prepareSelectClaim(*this, s, ct, withDst, bridgeName))
+{
+}
+
+bool
+SelectClaim::execute(soci::session& s)
+{
+    signingAccount = soci::blob(s);
+    signature = soci::blob(s);
+    publicKey = soci::blob(s);
+    rewardAccount = soci::blob(s);
+    sigInd = soci::i_null;
+    otherChainDstInd = soci::i_null;
+    return st.execute(true);
+}
+
+std::string
+SelectClaim::name(ChainType ct, bool withDst, std::string const& bridge)
+{
+    static auto const all = chainNames("select_claim");
+    static auto const dst = chainNames("select_claim_dst");
+    return withBridge(withDst ? dst[ct] : all[ct], bridge);
+}
+
+SelectCreateAccount::SelectCreateAccount(
+    soci::session& s,
+    ChainType ct,
+    std::string const& bridgeName)
+    : amt(s)
+    , rewardAmt(s)
+    , bridge(s)
+    , sendingAccount(s)
+    , otherChainDst(s)
+    , signingAccount(s)
+    , signature(s)
+    , publicKey(s)
+    , rewardAccount(s)
+    , st((s.prepare << selectCreateAccountSql(ct, bridgeName),
+          soci::into(signingAccount),
+          soci::into(signature),
+          soci::into(publicKey),
+          soci::into(rewardAccount),
+          soci::use(createCount),
+          soci::use(amt),
+          soci::use(rewardAmt),
+          soci::use(bridge),
+          soci::use(sendingAccount),
+          soci::use(otherChainDst)))
+{
+}
+
+bool
+SelectCreateAccount::execute(soci::session& s)
+{
+    signingAccount = soci::blob(s);
+    signature = soci::blob(s);
+    publicKey = soci::blob(s);
+    rewardAccount = soci::blob(s);
+    return st.execute(true);
+}
+
+std::string
+SelectCreateAccount::name(ChainType ct, std::string const& bridge)
+{
+    static auto const r = chainNames("select_create_account");
+    return withBridge(r[ct], bridge);
+}
+
+PreparedStatements
+prepareAll(soci::session& s)
+{
+    return prepareBridges(s, {std::string()});
+}
+
+PreparedStatements
+prepareBridges(soci::session& s, std::vector<std::string> const& bridges)
+{
+    PreparedStatements r;
+    for (auto const& b : bridges)
+    {
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
+        {
+            r[InsertClaim::name(ct, b)] =
+                std::make_unique<InsertClaim>(s, ct, b);
+            r[InsertCreateAccount::name(ct, b)] =
+                std::make_unique<InsertCreateAccount>(s, ct, b);
+            for (bool const isCreate : {false, true})
+            {
+                r[DeleteIDRange::name(ct, isCreate, b)] =
+                    std::make_unique<DeleteIDRange>(s, ct, isCreate, b);
+                r[SelectPrunedIDs::name(ct, isCreate, b)] =
+                    std::make_unique<SelectPrunedIDs>(s, ct, isCreate, b);
+                r[PruneClaims::name(ct, isCreate, b)] =
+                    std::make_unique<PruneClaims>(s, ct, isCreate, b);
+            }
+            for (bool const withDst : {false, true})
+                r[SelectClaim::name(ct, withDst, b)] =
+                    std::make_unique<SelectClaim>(s, ct, withDst, b);
+            r[SelectCreateAccount::name(ct, b)] =
+                std::make_unique<SelectCreateAccount>(s, ct, b);
+            r[InsertAttested::name(ct, b)] =
+                std::make_unique<InsertAttested>(s, ct, b);
+            r[PruneAttested::name(ct, b)] =
+                std::make_unique<PruneAttested>(s, ct, b);
+        }
+        r[UpdateSyncTx::name(b)] = std::make_unique<UpdateSyncTx>(s, b);
+        r[UpdateSyncLedger::name(b)] =
+            std::make_unique<UpdateSyncLedger>(s, b);
+        r[UpdateCheckpoint::name(b)] =
+            std::make_unique<UpdateCheckpoint>(s, b);
+    }
+    return r;
+}
+
+}  // namespace db_stmt
+}  // namespace xbwd
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <xbwd/basics/ChainTypes.h>
+#include <xbwd/core/DatabaseCon.h>
+#include <xbwd/core/SociDB.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xbwd {
+namespace db_stmt {
+
+// Statements used on the hot path, prepared once per session from the db_init
+// table names. The members are the variables the statement is bound to: set
+// them, then execute `st`. Blobs are replaced (not reused) before every
+// execution, an empty blob is stored as NULL.
+//
+// The statements of a bridge of the "Bridges" config run on the tables of
+// the bridge, their names end with ":<Name>" of its config. The `bridge`
+// members are the serialized STXChainBridge of a row, not that name.
+
+struct InsertClaim : public PreparedStatement
+{
+    soci::blob txnId;
+    std::uint32_t ledgerSeq = 0;
+    std::uint64_t claimID = 0;
+    int success = 0;
+    soci::blob amt;
+    soci::blob bridge;
+    soci::blob sendingAccount;
+    soci::blob rewardAccount;
+    soci::blob otherChainDst;
+    soci::blob signingAccount;
+    soci::blob publicKey;
+    soci::blob signature;
+    soci::statement st;
+
+    InsertClaim(
+        soci::session& s, ChainType ct, std::string const& bridgeName = {});
+
+    static std::string
+    name(ChainType ct, std::string const& bridge = {});
+};
+
+struct InsertCreateAccount : public PreparedStatement
+{
+    soci::blob txnId;
+    std::uint32_t ledgerSeq = 0;
+    std::uint64_t createCount = 0;
+    int success = 0;
+    soci::blob amt;
+    soci::blob rewardAmt;
+    soci::blob bridge;
+    soci::blob sendingAccount;
+    soci::blob rewardAccount;
+    soci::blob otherChainDst;
+    soci::blob signingAccount;
+    soci::blob publicKey;
+    soci::blob signature;
+    soci::statement st;
+
+    InsertCreateAccount(
+        soci::session& s, ChainType ct, std::string const& bridgeName = {});
+
+    static std::string
+    name(ChainType ct, std::string const& bridge = {});
+};
+
+// Update the transaction hash of the sync table row of a chain
+struct UpdateSyncTx : public PreparedStatement
+{
+    soci::blob txnId;
+    std::uint32_t chainType = 0;
+    soci::statement st;
+
+    explicit UpdateSyncTx(soci::session& s, std::string const& bridge = {});
+
+    static std::string
+    name(std::string const& bridge = {});
+};
+
+// Update the processed ledger of the sync table row of a chain
+struct UpdateSyncLedger : public PreparedStatement
+{
+    std::uint32_t ledgerSeq = 0;
+    std::uint32_t chainType = 0;
+    soci::statement st;
+
+    explicit UpdateSyncLedger(soci::session& s, std::string const& bridge = {});
+
+    static std::string
+    name(std::string const& bridge = {});
+};
+
+// Raise the processed ledgers of the checkpoint row of a chain
+struct UpdateCheckpoint : public PreparedStatement
+{
+    std::uint32_t doorLedgerSeq = 0;
+    std::uint32_t submitLedgerSeq = 0;
+    std::uint32_t chainType = 0;
+    soci::statement st;
+
+    explicit UpdateCheckpoint(soci::session& s, std::string const& bridge = {});
+
+    static std::string
+    name(std::string const& bridge = {});
+};
+
+// Insert the digest of an attestation, ignore the known ones
+struct InsertAttested : public PreparedStatement
+{
+    soci::blob digest;
+    std::uint32_t ledgerSeq = 0;
+    soci::statement st;
+
+    InsertAttested(
+        soci::session& s, ChainType ct, std::string const& bridge = {});
+
+    static std::string
+    name(ChainType ct, std::string const& bridge = {});
+};
+
+// Delete the digests of the attestations older than the ledger
+struct PruneAttested : public PreparedStatement
+{
+    std::uint32_t ledgerSeq = 0;
+    soci::statement st;
+
+    PruneAttested(
+        soci::session& s, ChainType ct, std::string const& bridge = {});
+
+    static std::string
+    name(ChainType ct, std::string const& bridge = {});
+};
+
+// Delete the ClaimIDs or the CreateCounts in [first, last]
+struct DeleteIDRange : public PreparedStatement
+{
+    std::uint64_t first = 0;
+    std::uint64_t last = 0;
+    soci::statement st;
+
+    DeleteIDRange(
+        soci::session& s,
+        ChainType ct,
+        bool isCreateAccount,
+        std::string const& bridge = {});
+
+    static std::string
+    name(ChainType ct, bool isCreateAccount, std::string const& bridge = {});
+};
+
+// Select the ClaimIDs or the CreateCounts of the rows older than the ledger,
+// fetched one by one
+struct SelectPrunedIDs : public PreparedStatement
+{
+    std::uint32_t ledgerSeq = 0;
+    std::uint64_t id = 0;
+    soci::statement st;
+
+    SelectPrunedIDs(
+        soci::session& s,
+        ChainType ct,
+        bool isCreateAccount,
+        std::string const& bridge = {});
+
+    static std::string
+    name(ChainType ct, bool isCreateAccount, std::string const& bridge = {});
+};
+
+// Delete the claim or the create account rows older than the ledger
+struct PruneClaims : public PreparedStatement
+{
+    std::uint32_t ledgerSeq = 0;
+    soci::statement st;
+
+    PruneClaims(
+        soci::session& s,
+        ChainType ct,
+        bool isCreateAccount,
+        std::string const& bridge = {});
+
+    static std::string
+    name(ChainType ct, bool isCreateAccount, std::string const& bridge = {});
+};
+
+// Select a successful claim attestation. With `withDst` the destination is a
+// part of the key, otherwise it is returned.
+struct SelectClaim : public PreparedStatement
+{
+    // key
+    std::uint64_t claimID = 0;
+    soci::blob amt;
+    soci::blob bridge;
+    soci::blob sendingAccount;
+    soci::blob otherChainDst;
+
+    // result
+    soci::blob signingAccount;
+    soci::blob signature;
+    soci::blob publicKey;
+    soci::blob rewardAccount;
+    soci::indicator sigInd = soci::i_null;
+    soci::indicator otherChainDstInd = soci::i_null;
+    soci::statement st;
+
+    SelectClaim(
+        soci::session& s,
+        ChainType ct,
+        bool withDst,
+        std::string const& bridgeName = {});
+
+    // Replace the result blobs, so data of the previous query can't leak
+    // through when there is no match. Return true if a row was found.
+    bool
+    execute(soci::session& s);
+
+    static std::string
+    name(ChainType ct, bool withDst, std::string const& bridge = {});
+};
+
+struct SelectCreateAccount : public PreparedStatement
+{
+    // key
+    std::uint64_t createCount = 0;
+    soci::blob amt;
+    soci::blob rewardAmt;
+    soci::blob bridge;
+    soci::blob sendingAccount;
+    soci::blob otherChainDst;
+
+    // result
+    soci::blob signingAccount;
+    soci::blob signature;
+    soci::blob publicKey;
+    soci::blob rewardAccount;
+    soci::statement st;
+
+    SelectCreateAccount(
+        soci::session& s, ChainType ct, std::string const& bridgeName = {});
+
+    bool
+    execute(soci::session& s);
+
+    static std::string
+    name(ChainType ct, std::string const& bridge = {});
+};
+
+// Prepare all the statements above on the session
+PreparedStatements
+prepareAll(soci::session& s);
+
+// The same for the tables of each bridge, "" is the bridge of the top level
+// config
+PreparedStatements
+prepareBridges(soci::session& s, std::vector<std::string> const& bridges);
+
+}  // namespace db_stmt
+}  // namespace xbwd
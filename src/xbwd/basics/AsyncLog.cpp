@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/AsyncLog.h>
+
+#include <xbwd/basics/StructuredLog.h>
+
+#include <ripple/beast/core/CurrentThreadName.h>
+
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+
+namespace xbwd {
+
+std::atomic<AsyncLog*> AsyncLog::active_ = nullptr;
+std::atomic<std::uint64_t> AsyncLog::instances_ = 0;
+
+AsyncLog::Ring::Ring(std::size_t capacity)
+    : slots_(std::bit_ceil(std::max<std::size_t>(capacity, 2)))
+    , mask_(slots_.size() - 1)
+{
+}
+
+bool
+AsyncLog::Ring::push(std::unique_ptr<Record>& r)
+{
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size())
+        return false;
+    slots_[tail & mask_] = std::move(r);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+std::unique_ptr<AsyncLog::Record>
+AsyncLog::Ring::pop()
+{
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+        return {};
+    auto r = std::move(slots_[head & mask_]);
+    head_.store(head + 1, std::memory_order_release);
+    return r;
+}
+
+bool
+AsyncLog::Ring::empty() const
+{
+    return head_.load(std::memory_order_acquire) ==
+        tail_.load(std::memory_order_acquire);
+}
+
+AsyncLog::AsyncLog(std::size_t ringSize, beast::Journal j)
+    : id_(++instances_)
+    , ringSize_(ringSize)
+    , j_(j)
+    , thread_(&AsyncLog::run, this)
+{
+    active_.store(this, std::memory_order_release);
+}
+
+AsyncLog::~AsyncLog()
+{
+    active_.store(nullptr, std::memory_order_release);
+    {
+        std::lock_guard l{m_};
+        stop_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+}
+
+AsyncLog::Ring&
+AsyncLog::threadRing()
+{
+    // The ring of this thread for the current instance
+    struct Local
+    {
+        std::uint64_t owner = 0;
+        std::shared_ptr<Ring> ring;
+    };
+    static thread_local Local local;
+    if (local.owner != id_)
+    {
+        local.ring = std::make_shared<Ring>(ringSize_);
+        local.owner = id_;
+        std::lock_guard l{m_};
+        rings_.push_back(local.ring);
+    }
+    return *local.ring;
+}
+
+void
+AsyncLog::push(
+    beast::Journal::Stream const& stream,
+    std::string_view msg,
+    std::vector<LogField>&& fields)
+{
+    auto r = std::make_unique<Record>(
+        Record{stream, std::string(msg), std::move(fields)});
+    if (!threadRing().push(r))
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+AsyncLog::write(Record const& r)
+{
+    beast::Journal::ScopedStream s{r.stream, r.msg};
+    s << " {";
+    char const* sep = "";
+    for (auto const& f : r.fields)
+    {
+        s << sep << '"' << f.name << "\": ";
+        sep = ", ";
+        std::visit(
+            [&](auto const& v) {
+                if constexpr (std::is_same_v<
+                                  std::decay_t<decltype(v)>,
+                                  Json::Value>)
+                    s << string_for_log(v);
+                else if (f.quoted)
+                    s << '"' << v << '"';
+                else
+                    s << v;
+            },
+            f.value);
+    }
+    s << '}';
+}
+
+bool
+AsyncLog::drain()
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard l{m_};
+        // The rings of the threads gone, once written out
+        std::erase_if(rings_, [](auto const& ring) {
+            return ring.use_count() == 1 && ring->empty();
+        });
+        rings = rings_;
+    }
+
+    bool any = false;
+    for (auto const& ring : rings)
+    {
+        // A bounded number per ring, not to starve the others
+        for (std::size_t i = 0; i < ringSize_; ++i)
+        {
+            auto const r = ring->pop();
+            if (!r)
+                break;
+            write(*r);
+            any = true;
+        }
+    }
+
+    if (auto const dropped = dropped_.load(std::memory_order_relaxed);
+        dropped != reported_)
+    {
+        JLOG(j_.warn()) << "Async log dropped " << dropped - reported_
+                        << " messages, " << dropped << " in total";
+        reported_ = dropped;
+    }
+    return any;
+}
+
+void
+AsyncLog::run()
+{
+    beast::setCurrentThreadName("async log");
+    for (;;)
+    {
+        // Polled, the call sites do not wake this thread up
+        if (drain())
+            continue;
+        std::unique_lock l{m_};
+        if (stop_)
+            break;
+        cv_.wait_for(l, std::chrono::milliseconds(10));
+    }
+    // The messages pushed before the stop
+    while (drain())
+        ;
+}
+
+}  // namespace xbwd
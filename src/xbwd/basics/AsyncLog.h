@@ -0,0 +1,168 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/ThreadSaftyAnalysis.h>
+
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace xbwd {
+
+// A JLOGV field, captured by the calling thread to be formatted later. The
+// Json values are only serialized by the log thread.
+struct LogField
+{
+    using Value = std::variant<
+        std::int64_t,
+        std::uint64_t,
+        double,
+        bool,
+        std::string,
+        Json::Value>;
+
+    std::string name;
+    Value value;
+    bool quoted;
+};
+
+/**
+ *  The JLOGV messages are formatted and written by one background thread.
+ *
+ *  Each thread logging has its own bounded single producer, single consumer
+ *  ring, so the call sites never take a lock. When the ring of a thread is
+ *  full the message is dropped: the drops are counted and reported in the
+ *  log by the background thread.
+ *
+ *  While an instance lives, JLOGV uses it. The threads logging must be
+ *  stopped before it is destroyed. The messages of the different threads
+ *  may be written out of order.
+ */
+class AsyncLog
+{
+public:
+    struct Record
+    {
+        beast::Journal::Stream stream;
+        std::string msg;
+        std::vector<LogField> fields;
+    };
+
+private:
+    class Ring
+    {
+        std::vector<std::unique_ptr<Record>> slots_;
+        std::size_t const mask_;
+        // Written by the consumer
+        std::atomic<std::size_t> head_ = 0;
+        // Written by the producer
+        std::atomic<std::size_t> tail_ = 0;
+
+    public:
+        // The capacity is rounded up to a power of two
+        explicit Ring(std::size_t capacity);
+
+        bool
+        push(std::unique_ptr<Record>& r);
+
+        std::unique_ptr<Record>
+        pop();
+
+        bool
+        empty() const;
+    };
+
+    static std::atomic<AsyncLog*> active_;
+    // Tells the rings of the instances apart
+    static std::atomic<std::uint64_t> instances_;
+
+    std::uint64_t const id_;
+    std::size_t const ringSize_;
+    beast::Journal j_;
+
+    std::mutex m_;
+    std::vector<std::shared_ptr<Ring>> GUARDED_BY(m_) rings_;
+    std::condition_variable cv_;
+    bool GUARDED_BY(m_) stop_ = false;
+
+    std::atomic<std::uint64_t> dropped_ = 0;
+    std::uint64_t reported_ = 0;
+
+    std::thread thread_;
+
+public:
+    // ringSize - the messages queued by each thread
+    AsyncLog(std::size_t ringSize, beast::Journal j);
+
+    // Write the queued messages
+    ~AsyncLog();
+
+    AsyncLog(AsyncLog const&) = delete;
+    AsyncLog&
+    operator=(AsyncLog const&) = delete;
+
+    static AsyncLog*
+    active()
+    {
+        return active_.load(std::memory_order_acquire);
+    }
+
+    void
+    push(
+        beast::Journal::Stream const& stream,
+        std::string_view msg,
+        std::vector<LogField>&& fields);
+
+    std::uint64_t
+    dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Format a message as JLOGV does
+    static void
+    write(Record const& r);
+
+private:
+    Ring&
+    threadRing();
+
+    // Return false if all the rings were empty
+    bool
+    drain();
+
+    void
+    run();
+};
+
+}  // namespace xbwd
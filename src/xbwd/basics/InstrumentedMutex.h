@@ -0,0 +1,231 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/Metrics.h>
+#include <xbwd/basics/ThreadSaftyAnalysis.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace xbwd {
+
+/**
+ *  Contention of the locks of a name: the acquisitions, the ones that had to
+ *  wait, and the wait and hold times. The locks of the same name share their
+ *  stats, they live as long as the process.
+ */
+class LockStats
+{
+    std::string const name_;
+
+public:
+    metrics::Counter acquisitions_;
+    metrics::Counter contended_;
+    metrics::Histogram wait_;
+    metrics::Histogram hold_;
+
+    explicit LockStats(std::string_view name) : name_(name)
+    {
+    }
+
+    std::string const&
+    name() const
+    {
+        return name_;
+    }
+
+    static LockStats&
+    named(std::string_view name)
+    {
+        auto& r = registry();
+        std::lock_guard l{r.m};
+        auto it = r.stats.find(name);
+        if (it == r.stats.end())
+            it = r.stats
+                     .emplace(
+                         std::string(name), std::make_unique<LockStats>(name))
+                     .first;
+        return *it->second;
+    }
+
+    // In the order of the names
+    static void
+    forEach(std::function<void(LockStats const&)> const& f)
+    {
+        auto& r = registry();
+        std::lock_guard l{r.m};
+        for (auto const& kv : r.stats)
+            f(*kv.second);
+    }
+
+private:
+    struct Registry
+    {
+        std::mutex m;
+        std::map<std::string, std::unique_ptr<LockStats>, std::less<>> stats;
+    };
+
+    static Registry&
+    registry()
+    {
+        static Registry r;
+        return r;
+    }
+};
+
+/**
+ *  A mutex that records its contention in the LockStats of its name.
+ *
+ *  A lock first tries the mutex, only a failed try measures the wait. The
+ *  hold time is from the outermost lock to its unlock, so the recursive
+ *  mutexes are measured once per owner.
+ */
+template <class Mutex = std::mutex>
+class CAPABILITY("mutex") InstrumentedMutex
+{
+    using clock = std::chrono::steady_clock;
+
+    Mutex m_;
+    LockStats& stats_;
+    // Of the owner only
+    std::uint32_t depth_ = 0;
+    clock::time_point acquired_;
+
+public:
+    InstrumentedMutex(std::string_view name) : stats_(LockStats::named(name))
+    {
+    }
+
+    InstrumentedMutex(InstrumentedMutex const&) = delete;
+    InstrumentedMutex&
+    operator=(InstrumentedMutex const&) = delete;
+
+    void
+    lock() ACQUIRE()
+    {
+        if (m_.try_lock())
+        {
+            onAcquired();
+        }
+        else
+        {
+            auto const start = clock::now();
+            m_.lock();
+            onAcquired();
+            stats_.contended_.inc();
+            stats_.wait_.observe(acquired_ - start);
+        }
+        stats_.acquisitions_.inc();
+    }
+
+    bool
+    try_lock() TRY_ACQUIRE(true)
+    {
+        if (!m_.try_lock())
+            return false;
+        onAcquired();
+        stats_.acquisitions_.inc();
+        return true;
+    }
+
+    void
+    unlock() RELEASE()
+    {
+        if (--depth_ == 0)
+            stats_.hold_.observe(clock::now() - acquired_);
+        m_.unlock();
+    }
+
+    LockStats const&
+    stats() const
+    {
+        return stats_;
+    }
+
+private:
+    void
+    onAcquired()
+    {
+        if (depth_++ == 0)
+            acquired_ = clock::now();
+    }
+};
+
+/**
+ *  The mutex of the locks to profile: instrumented when built with
+ *  XBWD_LOCK_PROFILING (the lock_profiling CMake option), a plain mutex
+ *  with a name otherwise.
+ */
+#ifdef XBWD_LOCK_PROFILING
+template <class Mutex = std::mutex>
+using ProfiledMutex = InstrumentedMutex<Mutex>;
+#else
+template <class Mutex = std::mutex>
+class CAPABILITY("mutex") ProfiledMutex : public Mutex
+{
+public:
+    ProfiledMutex(std::string_view)
+    {
+    }
+};
+#endif
+
+// The stats of all the instrumented locks, empty unless some are
+inline void
+writeLockMetrics(metrics::Writer& w)
+{
+    LockStats::forEach([&](LockStats const& s) {
+        w.counter(
+            "xbwd_lock_acquisitions_total",
+            "Acquisitions of the instrumented locks.",
+            {{"lock", s.name()}},
+            s.acquisitions_.value());
+    });
+    LockStats::forEach([&](LockStats const& s) {
+        w.counter(
+            "xbwd_lock_contended_total",
+            "Acquisitions that waited for another owner of the lock.",
+            {{"lock", s.name()}},
+            s.contended_.value());
+    });
+    LockStats::forEach([&](LockStats const& s) {
+        w.histogram(
+            "xbwd_lock_wait_seconds",
+            "Time waited for the contended acquisitions of the lock.",
+            {{"lock", s.name()}},
+            s.wait_);
+    });
+    LockStats::forEach([&](LockStats const& s) {
+        w.histogram(
+            "xbwd_lock_hold_seconds",
+            "Time the lock was held.",
+            {{"lock", s.name()}},
+            s.hold_);
+    });
+}
+
+}  // namespace xbwd
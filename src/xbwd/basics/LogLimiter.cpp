@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/LogLimiter.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace xbwd {
+
+std::atomic<bool> LogLimiter::any_ = false;
+
+LogLimiter::Site::Site(LogLimit const& l, clock_type::time_point now)
+    : limit(l), tokens(l.burst), last(now), reported(now)
+{
+}
+
+LogLimiter&
+LogLimiter::instance()
+{
+    static LogLimiter limiter;
+    return limiter;
+}
+
+std::optional<std::uint64_t>
+LogLimiter::check(std::size_t jlogId, clock_type::time_point now) const
+{
+    std::shared_lock sl{m_};
+    auto const it = sites_.find(jlogId);
+    if (it == sites_.end())
+        return 0;
+
+    auto& site = *it->second;
+    std::lock_guard l{site.m};
+    auto const suppress = [&site]() -> std::optional<std::uint64_t> {
+        ++site.pending;
+        ++site.suppressed;
+        return {};
+    };
+
+    if (site.limit.sample > 1 && site.seen++ % site.limit.sample)
+        return suppress();
+
+    if (site.limit.rate > 0)
+    {
+        std::chrono::duration<double> const elapsed = now - site.last;
+        site.last = std::max(site.last, now);
+        site.tokens = std::min<double>(
+            site.limit.burst,
+            site.tokens + std::max(elapsed.count(), 0.0) * site.limit.rate);
+        if (site.tokens < 1)
+            return suppress();
+        site.tokens -= 1;
+    }
+
+    ++site.logged;
+    site.reported = std::max(site.reported, now);
+    return std::exchange(site.pending, 0);
+}
+
+std::vector<std::pair<std::size_t, std::uint64_t>>
+LogLimiter::flush(clock_type::time_point now) const
+{
+    std::vector<std::pair<std::size_t, std::uint64_t>> r;
+    std::shared_lock sl{m_};
+    for (auto const& [id, site] : sites_)
+    {
+        std::lock_guard l{site->m};
+        if (!site->pending || now - site->reported < flushInterval)
+            continue;
+        r.emplace_back(id, std::exchange(site->pending, 0));
+        site->reported = now;
+    }
+    return r;
+}
+
+void
+LogLimiter::set(std::size_t jlogId, LogLimit const& limit)
+{
+    auto site = std::make_unique<Site>(limit, clock_type::now());
+    std::unique_lock l{m_};
+    sites_[jlogId] = std::move(site);
+    any_.store(true, std::memory_order_relaxed);
+}
+
+bool
+LogLimiter::clear(std::size_t jlogId)
+{
+    std::unique_lock l{m_};
+    auto const erased = sites_.erase(jlogId) > 0;
+    any_.store(!sites_.empty(), std::memory_order_relaxed);
+    return erased;
+}
+
+Json::Value
+LogLimiter::getJson() const
+{
+    Json::Value r(Json::arrayValue);
+    std::shared_lock sl{m_};
+    for (auto const& [id, site] : sites_)
+    {
+        Json::Value js(Json::objectValue);
+        js["jlog_id"] = static_cast<Json::UInt>(id);
+        js["rate"] = site->limit.rate;
+        js["burst"] = site->limit.burst;
+        js["sample"] = site->limit.sample;
+        {
+            std::lock_guard l{site->m};
+            js["logged"] = static_cast<Json::UInt>(site->logged);
+            js["suppressed"] = static_cast<Json::UInt>(site->suppressed);
+        }
+        r.append(std::move(js));
+    }
+    return r;
+}
+
+}  // namespace xbwd
@@ -0,0 +1,132 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/ThreadSaftyAnalysis.h>
+
+#include <ripple/json/json_value.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace xbwd {
+
+// Applied to the JLOGV sites of a jlogId
+struct LogLimit
+{
+    // Messages per second once the burst is spent, 0 - no rate limit
+    double rate = 0;
+    std::uint32_t burst = 1;
+    // Log one message in that many, before the rate limit
+    std::uint32_t sample = 1;
+};
+
+/**
+ *  Rate limits and sampling of the JLOGV sites, set at runtime by jlogId.
+ *
+ *  The jlogId is the line of the site, the sites on the same line of
+ *  different files share their limit. The first message logged after some
+ *  were suppressed has a "suppressed" field with their number, so a burst
+ *  is summarized once the rate allows it. The number of a site gone quiet
+ *  is taken by flush(), logged periodically by the app. Without any limit
+ *  set, checking a site is one relaxed atomic load.
+ */
+class LogLimiter
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    // A site is flushed once it logged nothing for that long
+    static constexpr std::chrono::seconds flushInterval{10};
+
+private:
+    struct Site
+    {
+        std::mutex m;
+        LogLimit const limit;
+        double GUARDED_BY(m) tokens;
+        clock_type::time_point GUARDED_BY(m) last;
+        std::uint64_t GUARDED_BY(m) seen = 0;
+        // Suppressed since the last message logged or flushed
+        std::uint64_t GUARDED_BY(m) pending = 0;
+        // The last message logged or flushed
+        clock_type::time_point GUARDED_BY(m) reported;
+        std::uint64_t GUARDED_BY(m) logged = 0;
+        std::uint64_t GUARDED_BY(m) suppressed = 0;
+
+        Site(LogLimit const& l, clock_type::time_point now);
+    };
+
+    static std::atomic<bool> any_;
+
+    mutable std::shared_mutex m_;
+    std::map<std::size_t, std::unique_ptr<Site>> GUARDED_BY(m_) sites_;
+
+public:
+    static LogLimiter&
+    instance();
+
+    /**
+     * Whether to log a message of the site
+     * @return the messages suppressed since the last one logged, nothing if
+     * this one is suppressed too
+     */
+    static std::optional<std::uint64_t>
+    check(std::size_t jlogId)
+    {
+        if (!any_.load(std::memory_order_relaxed))
+            return 0;
+        return instance().check(jlogId, clock_type::now());
+    }
+
+    std::optional<std::uint64_t>
+    check(std::size_t jlogId, clock_type::time_point now) const;
+
+    // Replace the limit of the jlogId, with fresh counters
+    void
+    set(std::size_t jlogId, LogLimit const& limit);
+
+    // Return false if the jlogId had no limit
+    bool
+    clear(std::size_t jlogId);
+
+    /**
+     * Take the messages suppressed of the sites that logged nothing since
+     * flushInterval
+     * @return the jlogIds and their numbers, of the sites with some
+     */
+    std::vector<std::pair<std::size_t, std::uint64_t>>
+    flush(clock_type::time_point now) const;
+
+    // The limits, with the messages logged and suppressed
+    Json::Value
+    getJson() const;
+};
+
+}  // namespace xbwd
@@ -0,0 +1,178 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/ThreadSaftyAnalysis.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace xbwd {
+
+// Bounded least recently used cache. The keys are hashed to shards with their
+// own lock and capacity, the lookups of different keys rarely contend. A
+// capacity of 0 disables the cache.
+//
+// An erase bumps the generation of the shard. A read-through put gives the
+// generation seen before its read, so a value read before an erase doesn't
+// come back after it.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class LruCache
+{
+    using Entry = std::pair<Key, Value>;
+
+    struct Shard
+    {
+        mutable std::mutex m_;
+        // Most recently used first
+        std::list<Entry> GUARDED_BY(m_) list_;
+        std::unordered_map<Key, typename std::list<Entry>::iterator, Hash>
+            GUARDED_BY(m_) map_;
+        std::uint64_t GUARDED_BY(m_) generation_ = 0;
+    };
+
+    std::size_t const shardCapacity_;
+    std::vector<Shard> shards_;
+    Hash const hash_;
+    std::atomic_uint64_t hits_{0};
+    std::atomic_uint64_t misses_{0};
+
+    Shard&
+    shard(Key const& key)
+    {
+        return shards_[hash_(key) % shards_.size()];
+    }
+
+public:
+    // The capacity is split evenly between the shards
+    explicit LruCache(std::size_t capacity, std::size_t shards = 16)
+        : shardCapacity_((capacity + shards - 1) / shards), shards_(shards)
+    {
+    }
+
+    std::optional<Value>
+    get(Key const& key)
+    {
+        if (!shardCapacity_)
+            return {};
+
+        auto& s = shard(key);
+        std::lock_guard l{s.m_};
+        auto it = s.map_.find(key);
+        if (it == s.map_.end())
+        {
+            ++misses_;
+            return {};
+        }
+        ++hits_;
+        s.list_.splice(s.list_.begin(), s.list_, it->second);
+        return it->second->second;
+    }
+
+    // Generation to give to a put() after a read of the key elsewhere
+    std::uint64_t
+    generation(Key const& key)
+    {
+        auto& s = shard(key);
+        std::lock_guard l{s.m_};
+        return s.generation_;
+    }
+
+    void
+    put(Key const& key, Value value)
+    {
+        put(key, std::move(value), std::nullopt);
+    }
+
+    // Dropped if the key was erased after the generation was taken
+    void
+    put(Key const& key, Value value, std::optional<std::uint64_t> generation)
+    {
+        if (!shardCapacity_)
+            return;
+
+        auto& s = shard(key);
+        std::lock_guard l{s.m_};
+        if (generation && *generation != s.generation_)
+            return;
+
+        if (auto it = s.map_.find(key); it != s.map_.end())
+        {
+            it->second->second = std::move(value);
+            s.list_.splice(s.list_.begin(), s.list_, it->second);
+            return;
+        }
+
+        s.list_.emplace_front(key, std::move(value));
+        s.map_.emplace(key, s.list_.begin());
+        if (s.list_.size() > shardCapacity_)
+        {
+            s.map_.erase(s.list_.back().first);
+            s.list_.pop_back();
+        }
+    }
+
+    void
+    erase(Key const& key)
+    {
+        auto& s = shard(key);
+        std::lock_guard l{s.m_};
+        ++s.generation_;
+        if (auto it = s.map_.find(key); it != s.map_.end())
+        {
+            s.list_.erase(it->second);
+            s.map_.erase(it);
+        }
+    }
+
+    std::size_t
+    size() const
+    {
+        std::size_t r = 0;
+        for (auto const& s : shards_)
+        {
+            std::lock_guard l{s.m_};
+            r += s.list_.size();
+        }
+        return r;
+    }
+
+    std::uint64_t
+    hits() const
+    {
+        return hits_;
+    }
+
+    std::uint64_t
+    misses() const
+    {
+        return misses_;
+    }
+};
+
+}  // namespace xbwd
@@ -0,0 +1,327 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace xbwd {
+
+// Wakeup that can't be lost. A waiter reads a token, checks its condition,
+// and waits on the token: any notify() after the token was read releases it.
+// notify() does not take the mutex unless some thread is waiting.
+class Wakeup
+{
+    std::atomic_uint64_t seq_{0};
+    std::atomic_uint32_t waiters_{0};
+    std::mutex m_;
+    std::condition_variable cv_;
+
+public:
+    std::uint64_t
+    token() const
+    {
+        return seq_.load();
+    }
+
+    void
+    notify()
+    {
+        seq_.fetch_add(1);
+        if (waiters_.load())
+        {
+            std::lock_guard l{m_};
+            cv_.notify_all();
+        }
+    }
+
+    void
+    wait(std::uint64_t token)
+    {
+        ++waiters_;
+        {
+            std::unique_lock l{m_};
+            cv_.wait(l, [&] { return seq_.load() != token; });
+        }
+        --waiters_;
+    }
+};
+
+/**
+ *  Bounded multi producer, single consumer queue.
+ *
+ *  The ring buffer of D. Vyukov: a producer claims a cell with one CAS and
+ *  publishes it with the cell sequence number, the consumer never blocks a
+ *  producer. A producer waits when the queue is full, items are never dropped.
+ *  The time an item spent in the queue is measured on the consumer side.
+ */
+template <class T>
+class MPSCQueue
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct Stats
+    {
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+        std::uint64_t pushed = 0;
+        std::uint64_t fullWaits = 0;
+        std::uint64_t lastLatencyUs = 0;
+        std::uint64_t maxLatencyUs = 0;
+        std::uint64_t avgLatencyUs = 0;
+    };
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> seq_;
+        std::optional<T> value_;
+        clock::time_point enqueued_;
+    };
+
+    std::size_t const mask_;
+    std::unique_ptr<Cell[]> const cells_;
+
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+
+    Wakeup ready_;
+    Wakeup space_;
+    std::atomic_bool closed_{false};
+
+    std::atomic_uint64_t fullWaits_{0};
+    std::atomic_uint64_t lastLatencyUs_{0};
+    std::atomic_uint64_t maxLatencyUs_{0};
+    std::atomic_uint64_t totalLatencyUs_{0};
+
+public:
+    // The capacity is rounded up to a power of 2
+    explicit MPSCQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1)
+        , cells_(std::make_unique<Cell[]>(mask_ + 1))
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            cells_[i].seq_.store(i, std::memory_order_relaxed);
+    }
+
+    MPSCQueue(MPSCQueue const&) = delete;
+    MPSCQueue&
+    operator=(MPSCQueue const&) = delete;
+
+    // Any thread. Wait while the queue is full. Return false, and drop the
+    // item, only if the queue is full and closed.
+    template <class U>
+    bool
+    push(U&& v)
+    {
+        Cell* cell = nullptr;
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &cells_[pos & mask_];
+            auto const seq = cell->seq_.load(std::memory_order_acquire);
+            auto const dif = static_cast<std::intptr_t>(seq) -
+                static_cast<std::intptr_t>(pos);
+            if (dif == 0)
+            {
+                if (tail_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+            {
+                // Full, the consumer has not released the cell yet
+                auto const t = space_.token();
+                if (closed_)
+                    return false;
+                if (cell->seq_.load(std::memory_order_acquire) == seq)
+                {
+                    ++fullWaits_;
+                    space_.wait(t);
+                }
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value_.emplace(std::forward<U>(v));
+        cell->enqueued_ = clock::now();
+        cell->seq_.store(pos + 1, std::memory_order_release);
+        ready_.notify();
+        return true;
+    }
+
+    // Consumer only. Return false if the queue is empty.
+    bool
+    tryPop(T& out)
+    {
+        auto const pos = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        if (cell.seq_.load(std::memory_order_acquire) != pos + 1)
+            return false;
+
+        out = std::move(*cell.value_);
+        cell.value_.reset();
+        onPopped(cell.enqueued_);
+
+        head_.store(pos + 1, std::memory_order_relaxed);
+        cell.seq_.store(pos + mask_ + 1, std::memory_order_release);
+        space_.notify();
+        return true;
+    }
+
+    // Consumer only. Move all the available items to `out`, return the number
+    // of moved items.
+    std::size_t
+    popAll(std::vector<T>& out)
+    {
+        std::size_t n = 0;
+        for (;;)
+        {
+            auto const pos = head_.load(std::memory_order_relaxed);
+            Cell& cell = cells_[pos & mask_];
+            if (cell.seq_.load(std::memory_order_acquire) != pos + 1)
+                break;
+
+            out.push_back(std::move(*cell.value_));
+            cell.value_.reset();
+            onPopped(cell.enqueued_);
+
+            head_.store(pos + 1, std::memory_order_relaxed);
+            cell.seq_.store(pos + mask_ + 1, std::memory_order_release);
+            ++n;
+        }
+        if (n)
+            space_.notify();
+        return n;
+    }
+
+    // Consumer only. Wait for items and move all the available ones to `out`.
+    // Return false, without waiting, once the queue is closed and empty.
+    bool
+    waitPopAll(std::vector<T>& out)
+    {
+        for (;;)
+        {
+            auto const t = ready_.token();
+            if (popAll(out))
+                return true;
+            if (closed_)
+                return false;
+            ready_.wait(t);
+        }
+    }
+
+    // Consumer only. The same, but also return once `ready()` holds. It is
+    // called before the items are popped, the producers setting its state
+    // call notify() afterward.
+    template <class Ready>
+    bool
+    waitPopAll(std::vector<T>& out, Ready&& ready)
+    {
+        for (;;)
+        {
+            auto const t = ready_.token();
+            bool const r = ready();
+            if (popAll(out) || r)
+                return true;
+            if (closed_)
+                return false;
+            ready_.wait(t);
+        }
+    }
+
+    // Any thread. Wake the consumer waiting on waitPopAll(out, ready).
+    void
+    notify()
+    {
+        ready_.notify();
+    }
+
+    // Release the consumer and the producers waiting on a full queue. Items
+    // can still be pushed while there is room, and popped.
+    void
+    close()
+    {
+        closed_ = true;
+        ready_.notify();
+        space_.notify();
+    }
+
+    std::size_t
+    capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    // Approximate, the queue may be modified concurrently
+    std::size_t
+    size() const
+    {
+        auto const head = head_.load(std::memory_order_relaxed);
+        auto const tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    Stats
+    stats() const
+    {
+        Stats s;
+        s.size = size();
+        s.capacity = capacity();
+        auto const popped = head_.load(std::memory_order_relaxed);
+        s.pushed = tail_.load(std::memory_order_relaxed);
+        s.fullWaits = fullWaits_;
+        s.lastLatencyUs = lastLatencyUs_;
+        s.maxLatencyUs = maxLatencyUs_;
+        s.avgLatencyUs = popped ? totalLatencyUs_ / popped : 0;
+        return s;
+    }
+
+private:
+    void
+    onPopped(clock::time_point const& enqueued)
+    {
+        std::uint64_t const us =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                clock::now() - enqueued)
+                .count();
+        lastLatencyUs_.store(us, std::memory_order_relaxed);
+        totalLatencyUs_.fetch_add(us, std::memory_order_relaxed);
+        if (us > maxLatencyUs_.load(std::memory_order_relaxed))
+            maxLatencyUs_.store(us, std::memory_order_relaxed);
+    }
+};
+
+}  // namespace xbwd
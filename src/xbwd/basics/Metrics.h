@@ -0,0 +1,315 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace xbwd {
+namespace metrics {
+
+// A thread always updates the same shard, the threads of different shards
+// don't write to the same cache line. The shards are summed when reported.
+std::size_t constexpr Shards = 16;
+
+inline std::size_t
+shardIndex()
+{
+    static std::atomic_size_t next{0};
+    thread_local std::size_t const index =
+        next.fetch_add(1, std::memory_order_relaxed) % Shards;
+    return index;
+}
+
+class Counter
+{
+    struct alignas(64) Shard
+    {
+        std::atomic_uint64_t value_{0};
+    };
+    std::array<Shard, Shards> shards_;
+
+public:
+    void
+    inc(std::uint64_t n = 1)
+    {
+        shards_[shardIndex()].value_.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    std::uint64_t
+    value() const
+    {
+        std::uint64_t r = 0;
+        for (auto const& s : shards_)
+            r += s.value_.load(std::memory_order_relaxed);
+        return r;
+    }
+};
+
+// Durations in microseconds, in fixed buckets
+class Histogram
+{
+public:
+    // Upper bounds of the buckets, the last bucket has no bound
+    static constexpr std::array<std::uint64_t, 16> bounds{
+        100,
+        250,
+        500,
+        1'000,
+        2'500,
+        5'000,
+        10'000,
+        25'000,
+        50'000,
+        100'000,
+        250'000,
+        500'000,
+        1'000'000,
+        2'500'000,
+        5'000'000,
+        10'000'000};
+
+    struct Snapshot
+    {
+        // Not cumulative
+        std::array<std::uint64_t, bounds.size() + 1> buckets{};
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+    };
+
+private:
+    struct alignas(64) Shard
+    {
+        std::array<std::atomic_uint64_t, bounds.size() + 1> buckets_{};
+        std::atomic_uint64_t sum_{0};
+    };
+    std::array<Shard, Shards> shards_;
+
+public:
+    void
+    observe(std::uint64_t us)
+    {
+        std::size_t i = 0;
+        while (i < bounds.size() && us > bounds[i])
+            ++i;
+        auto& s = shards_[shardIndex()];
+        s.buckets_[i].fetch_add(1, std::memory_order_relaxed);
+        s.sum_.fetch_add(us, std::memory_order_relaxed);
+    }
+
+    template <class Rep, class Period>
+    void
+    observe(std::chrono::duration<Rep, Period> d)
+    {
+        observe(static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(d)
+                .count()));
+    }
+
+    Snapshot
+    snapshot() const
+    {
+        Snapshot r;
+        for (auto const& s : shards_)
+        {
+            for (std::size_t i = 0; i < r.buckets.size(); ++i)
+            {
+                auto const n = s.buckets_[i].load(std::memory_order_relaxed);
+                r.buckets[i] += n;
+                r.count += n;
+            }
+            r.sum += s.sum_.load(std::memory_order_relaxed);
+        }
+        return r;
+    }
+};
+
+using Labels =
+    std::initializer_list<std::pair<std::string_view, std::string_view>>;
+
+/**
+ *  The Prometheus text format. The samples of a metric must be written one
+ *  after the other, the HELP and TYPE lines are written with the first one.
+ */
+class Writer
+{
+public:
+    using LabelVector = std::vector<std::pair<std::string, std::string>>;
+
+private:
+    std::string out_;
+    std::string name_;
+    LabelVector common_;
+
+public:
+    // Written before the labels of each sample until replaced
+    void
+    commonLabels(LabelVector labels)
+    {
+        common_ = std::move(labels);
+    }
+
+    void
+    counter(
+        std::string_view name,
+        std::string_view help,
+        Labels labels,
+        std::uint64_t value)
+    {
+        header(name, help, "counter");
+        sample(name, {}, labels, value);
+    }
+
+    void
+    gauge(
+        std::string_view name,
+        std::string_view help,
+        Labels labels,
+        std::uint64_t value)
+    {
+        header(name, help, "gauge");
+        sample(name, {}, labels, value);
+    }
+
+    // Seconds, as the Prometheus convention
+    void
+    histogram(
+        std::string_view name,
+        std::string_view help,
+        Labels labels,
+        Histogram const& h)
+    {
+        header(name, help, "histogram");
+        auto const s = h.snapshot();
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < s.buckets.size(); ++i)
+        {
+            cumulative += s.buckets[i];
+            auto const le = i < Histogram::bounds.size()
+                ? seconds(Histogram::bounds[i])
+                : std::string("+Inf");
+            sample(name, "_bucket", labels, cumulative, le);
+        }
+        sample(name, "_sum", labels, seconds(s.sum));
+        sample(name, "_count", labels, s.count);
+    }
+
+    std::string const&
+    str() const
+    {
+        return out_;
+    }
+
+private:
+    static std::string
+    seconds(std::uint64_t us)
+    {
+        auto r = std::to_string(us / 1'000'000);
+        if (auto const frac = us % 1'000'000)
+        {
+            auto f = std::to_string(frac);
+            f.insert(0, 6 - f.size(), '0');
+            f.erase(f.find_last_not_of('0') + 1);
+            r += '.' + f;
+        }
+        return r;
+    }
+
+    void
+    header(
+        std::string_view name,
+        std::string_view help,
+        std::string_view type)
+    {
+        if (name == name_)
+            return;
+        name_ = name;
+        out_ += "# HELP ";
+        out_ += name;
+        out_ += ' ';
+        out_ += help;
+        out_ += "\n# TYPE ";
+        out_ += name;
+        out_ += ' ';
+        out_ += type;
+        out_ += '\n';
+    }
+
+    template <class V>
+    void
+    sample(
+        std::string_view name,
+        std::string_view suffix,
+        Labels labels,
+        V const& value,
+        std::string_view le = {})
+    {
+        out_ += name;
+        out_ += suffix;
+        if (common_.size() || labels.size() || !le.empty())
+        {
+            char sep = '{';
+            for (auto const& [k, v] : common_)
+            {
+                out_ += sep;
+                out_ += k;
+                out_ += "=\"";
+                out_ += v;
+                out_ += '"';
+                sep = ',';
+            }
+            for (auto const& [k, v] : labels)
+            {
+                out_ += sep;
+                out_ += k;
+                out_ += "=\"";
+                out_ += v;
+                out_ += '"';
+                sep = ',';
+            }
+            if (!le.empty())
+            {
+                out_ += sep;
+                out_ += "le=\"";
+                out_ += le;
+                out_ += '"';
+            }
+            out_ += '}';
+        }
+        out_ += ' ';
+        if constexpr (std::is_convertible_v<V, std::string_view>)
+            out_ += value;
+        else
+            out_ += std::to_string(value);
+        out_ += '\n';
+    }
+};
+
+}  // namespace metrics
+}  // namespace xbwd
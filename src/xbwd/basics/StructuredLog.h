@@ -1,8 +1,15 @@
 #pragma once
 
+#include <xbwd/basics/AsyncLog.h>
+#include <xbwd/basics/LogLimiter.h>
+
 #include <ripple/basics/Log.h>
 #include <ripple/json/json_writer.h>
 
+#include <sstream>
+#include <string_view>
+#include <type_traits>
+
 namespace xbwd {
 
 [[nodiscard]] inline std::string
@@ -73,28 +80,99 @@ jlogv_fields(
         std::forward<Stream>(stream), ", ", std::forward<Ts>(nameValues)...);
 }
 
+// The field as jlogv_fields would print it, for the AsyncLog thread
+template <class T1, class T2>
+LogField
+jlogv_capture(std::tuple<T1 const&, T2 const&> const& nameValue)
+{
+    using T = std::decay_t<T2>;
+    auto const& v = std::get<1>(nameValue);
+    std::string name{std::string_view{std::get<0>(nameValue)}};
+    if constexpr (
+        std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+        std::is_same_v<T, unsigned char>)
+        return {std::move(name), std::string(1, v), false};
+    else if constexpr (std::is_same_v<T, bool>)
+        return {std::move(name), v, false};
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        return {std::move(name), static_cast<std::int64_t>(v), false};
+    else if constexpr (std::is_integral_v<T>)
+        return {std::move(name), static_cast<std::uint64_t>(v), false};
+    else if constexpr (std::is_floating_point_v<T>)
+        return {std::move(name), static_cast<double>(v), false};
+    else if constexpr (std::is_same_v<T, Json::Value>)
+        return {
+            std::move(name),
+            v,
+            !v.isObject() && !v.isNumeric() && !v.isBool()};
+    else if constexpr (std::is_convertible_v<T2 const&, std::string_view>)
+        return {std::move(name), std::string(std::string_view(v)), true};
+    else
+    {
+        std::ostringstream os;
+        os << v;
+        return {
+            std::move(name),
+            std::move(os).str(),
+            !std::is_same_v<T, ::Json::Compact>};
+    }
+}
+
+template <class Stream, class... Ts>
+void
+jlogv_write(Stream&& stream, std::string_view const& msg, Ts&&... nameValues)
+{
+    // Formatted by the log thread
+    if (auto* const async = AsyncLog::active())
+    {
+        async->push(stream, msg, {jlogv_capture(nameValues)...});
+        return;
+    }
+
+    beast::Journal::ScopedStream s{std::forward<Stream>(stream), msg};
+    s << " {";
+    jlogv_fields(s, "", std::forward<Ts>(nameValues)...);
+    s << '}';
+}
+
 template <class Stream, class... Ts>
 void
 jlogv(
     Stream&& stream,
     std::size_t lineNo,
+    std::uint64_t suppressed,
     std::string_view const& msg,
     Ts&&... nameValues)
 {
-    beast::Journal::ScopedStream s{std::forward<Stream>(stream), msg};
-    s << " {";
-    jlogv_fields(s, "", std::forward<Ts>(nameValues)..., jv("jlogId", lineNo));
-    s << '}';
+    // The messages of the site the LogLimiter did not log
+    if (suppressed)
+        jlogv_write(
+            std::forward<Stream>(stream),
+            msg,
+            std::forward<Ts>(nameValues)...,
+            jv("suppressed", suppressed),
+            jv("jlogId", lineNo));
+    else
+        jlogv_write(
+            std::forward<Stream>(stream),
+            msg,
+            std::forward<Ts>(nameValues)...,
+            jv("jlogId", lineNo));
 }
 
 // Wraps a Journal::Stream to skip evaluation of
-// expensive argument lists if the stream is not active.
+// expensive argument lists if the stream is not active,
+// or if the LogLimiter suppresses the message.
 #ifndef JLOGV
-#define JLOGV(x, msg, ...) \
-    if (!x)                \
-    {                      \
-    }                      \
-    else                   \
-        xbwd::jlogv(x, __LINE__, msg, __VA_ARGS__)
+#define JLOGV(x, msg, ...)                                               \
+    if (!x)                                                              \
+    {                                                                    \
+    }                                                                    \
+    else if (auto const jlogvLogged = xbwd::LogLimiter::check(__LINE__); \
+             !jlogvLogged)                                               \
+    {                                                                    \
+    }                                                                    \
+    else                                                                 \
+        xbwd::jlogv(x, __LINE__, *jlogvLogged, msg, __VA_ARGS__)
 #endif
 }  // namespace xbwd
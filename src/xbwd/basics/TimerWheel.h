@@ -0,0 +1,124 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace xbwd {
+
+// Hashed timer wheel. A timer goes to the slot of its deadline tick, modulo
+// the number of slots, and advance() visits the slots of the ticks passed.
+// Adding is O(1) and a tick is O(timers in the slot), whatever the number of
+// timers. There is no cancel: the user ignores the keys it no longer tracks.
+template <class Key>
+class TimerWheel
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+private:
+    struct Timer
+    {
+        Key key_;
+        std::uint64_t tick_;
+    };
+
+    clock::duration const tick_;
+    clock::time_point const start_;
+    std::vector<std::vector<Timer>> slots_;
+    // Ticks advanced from start_
+    std::uint64_t current_ = 0;
+    std::size_t size_ = 0;
+
+public:
+    TimerWheel(
+        clock::duration tick,
+        std::size_t slots,
+        clock::time_point start = clock::now())
+        : tick_(tick), start_(start), slots_(slots)
+    {
+        if (tick_ <= clock::duration::zero() || slots_.empty())
+            throw std::runtime_error("TimerWheel: invalid tick or slots");
+    }
+
+    // Due on the first tick at or after `deadline`, never the current one
+    void
+    add(Key key, clock::time_point deadline)
+    {
+        std::uint64_t tick = current_ + 1;
+        if (deadline > start_)
+        {
+            auto const t = (deadline - start_ + tick_ - clock::duration(1)) /
+                tick_;
+            tick = std::max(tick, static_cast<std::uint64_t>(t));
+        }
+        slots_[tick % slots_.size()].push_back({std::move(key), tick});
+        ++size_;
+    }
+
+    // The keys of the timers due at `now`
+    std::vector<Key>
+    advance(clock::time_point now)
+    {
+        std::vector<Key> due;
+        if (now <= start_)
+            return due;
+        auto const target = static_cast<std::uint64_t>((now - start_) / tick_);
+        if (target <= current_)
+            return due;
+        // A full turn visits every slot
+        auto const first = target - current_ > slots_.size()
+            ? target - slots_.size()
+            : current_;
+        for (auto t = first + 1; t <= target; ++t)
+        {
+            auto& slot = slots_[t % slots_.size()];
+            for (std::size_t i = 0; i < slot.size();)
+            {
+                // From the next turns
+                if (slot[i].tick_ > target)
+                {
+                    ++i;
+                    continue;
+                }
+                due.push_back(std::move(slot[i].key_));
+                slot[i] = std::move(slot.back());
+                slot.pop_back();
+                --size_;
+            }
+        }
+        current_ = target;
+        return due;
+    }
+
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+};
+
+}  // namespace xbwd
@@ -0,0 +1,218 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/client/ChainConnection.h>
+
+#include <xbwd/basics/StructuredLog.h>
+#include <xbwd/client/RpcResultParse.h>
+
+#include <ripple/protocol/jss.h>
+
+#include <algorithm>
+#include <optional>
+
+namespace xbwd {
+
+ChainConnection::ChainConnection(
+    ChainType chainType,
+    boost::asio::io_service& ios,
+    std::vector<beast::IP::Endpoint> const& ips,
+    beast::Journal j)
+    : chainType_(chainType)
+    , j_(j)
+    , ws_(std::make_unique<WebsocketClient>(
+          [this](Json::Value const& msg) { onMessage(msg); },
+          [this]() { onConnect(); },
+          ios,
+          ips,
+          /*headers*/ std::unordered_map<std::string, std::string>{},
+          j,
+          &traffic_,
+          "ws " + to_string(chainType)))
+{
+}
+
+ChainConnection::~ChainConnection()
+{
+    shutdown();
+}
+
+std::size_t
+ChainConnection::subscribe(Subscriber s)
+{
+    std::lock_guard l{subscribersMtx_};
+    subscribers_.push_back(std::move(s));
+    return subscribers_.size() - 1;
+}
+
+void
+ChainConnection::unsubscribe(std::size_t sub)
+{
+    std::lock_guard l{subscribersMtx_};
+    auto& s = subscribers_.at(sub);
+    s.onMessage = nullptr;
+    s.onConnect = nullptr;
+}
+
+void
+ChainConnection::connect()
+{
+    if (ws_)
+        ws_->connect();
+}
+
+void
+ChainConnection::shutdown()
+{
+    // Not under the subscribers lock, the callback thread is joined
+    ws_.reset();
+}
+
+std::uint32_t
+ChainConnection::send(
+    std::size_t sub,
+    std::string const& cmd,
+    Json::Value const& params,
+    std::function<void(std::uint32_t)> onID)
+{
+    return ws_->send(
+        cmd, params, to_string(chainType_), [&](std::uint32_t id) {
+            {
+                std::lock_guard l{ownersMtx_};
+                owners_[id] = sub;
+            }
+            onID(id);
+        });
+}
+
+std::uint32_t
+ChainConnection::reserveId(std::size_t sub)
+{
+    auto const id = ws_->reserveId();
+    std::lock_guard l{ownersMtx_};
+    owners_[id] = sub;
+    return id;
+}
+
+void
+ChainConnection::deliver(Json::Value const& msg)
+{
+    ws_->deliver(msg);
+}
+
+void
+ChainConnection::reconnect(std::string_view reason)
+{
+    ws_->reconnect(reason);
+}
+
+void
+ChainConnection::switchEndpoint(std::size_t idx, std::string_view reason)
+{
+    ws_->switchEndpoint(idx, reason);
+}
+
+std::size_t
+ChainConnection::endpointIdx() const
+{
+    return ws_ ? ws_->endpointIdx() : 0;
+}
+
+void
+ChainConnection::setHedge(HedgeFunc f)
+{
+    std::lock_guard l{hedgeMtx_};
+    hedge_ = std::move(f);
+}
+
+bool
+ChainConnection::hedge(
+    std::string const& cmd,
+    Json::Value const& params,
+    std::function<void(Json::Value const&)> onResponse)
+{
+    std::lock_guard l{hedgeMtx_};
+    return hedge_ && hedge_(cmd, params, std::move(onResponse));
+}
+
+bool
+ChainConnection::wants(Subscriber const& s, Json::Value const& msg) const
+{
+    auto const& tx = msg[ripple::jss::transaction];
+    if (auto const bridge = rpcResultParse::parseBridge(tx))
+        return *bridge == s.bridge;
+    auto const src = rpcResultParse::parseSrcAccount(tx);
+    return src &&
+        std::find(s.accounts.begin(), s.accounts.end(), *src) !=
+        s.accounts.end();
+}
+
+void
+ChainConnection::onMessage(Json::Value const& msg)
+{
+    if (msg.isMember(ripple::jss::id) && msg[ripple::jss::id].isIntegral())
+    {
+        auto const owner = [&]() -> std::optional<std::size_t> {
+            std::lock_guard l{ownersMtx_};
+            auto const i = owners_.find(msg[ripple::jss::id].asUInt());
+            if (i == owners_.end())
+                return {};
+            auto const r = i->second;
+            owners_.erase(i);
+            return r;
+        }();
+        if (!owner)
+        {
+            // A late reply, its request was answered by a timeout
+            JLOGV(
+                j_.trace(),
+                "ChainConnection reply without a subscriber",
+                jv("chainType", to_string(chainType_)),
+                jv("id", msg[ripple::jss::id]));
+            return;
+        }
+
+        std::lock_guard l{subscribersMtx_};
+        if (auto const& s = subscribers_[*owner]; s.onMessage)
+            s.onMessage(msg);
+        return;
+    }
+
+    std::lock_guard l{subscribersMtx_};
+    bool const isTx = msg.isMember(ripple::jss::transaction);
+    bool const any = isTx &&
+        std::any_of(
+            subscribers_.begin(),
+            subscribers_.end(),
+            [&](Subscriber const& s) { return wants(s, msg); });
+    for (auto const& s : subscribers_)
+        if (s.onMessage && (!any || wants(s, msg)))
+            s.onMessage(msg);
+}
+
+void
+ChainConnection::onConnect()
+{
+    std::lock_guard l{subscribersMtx_};
+    for (auto const& s : subscribers_)
+        if (s.onConnect)
+            s.onConnect();
+}
+
+}  // namespace xbwd
@@ -0,0 +1,182 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/ChainTypes.h>
+#include <xbwd/basics/ThreadSaftyAnalysis.h>
+#include <xbwd/client/WebsocketClient.h>
+
+#include <ripple/beast/net/IPEndpoint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/STXChainBridge.h>
+
+#include <boost/asio/io_service.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace xbwd {
+
+/**
+ *  The websocket connection to a chain, shared by the listeners of the
+ *  bridges of the process.
+ *
+ *  A reply goes to the listener that sent the request, the ids are owned by
+ *  the listener they were assigned to. The ledger stream goes to all the
+ *  listeners. A transaction pushed by the accounts stream goes to the
+ *  listeners of its bridge, or of its account (door or submit account), to
+ *  all of them if none matches.
+ *
+ *  The listeners subscribe before connect(), the callbacks run on the
+ *  callback thread of the websocket client.
+ */
+class ChainConnection
+{
+public:
+    struct Subscriber
+    {
+        ripple::STXChainBridge bridge;
+        // The door and the submit accounts of the listener
+        std::vector<ripple::AccountID> accounts;
+        std::function<void(Json::Value const&)> onMessage;
+        std::function<void()> onConnect;
+    };
+
+    // Send a copy of a request to the best other node, return false if not
+    // sent. Set by the subscriber probing the nodes.
+    using HedgeFunc = std::function<bool(
+        std::string const& cmd,
+        Json::Value const& params,
+        std::function<void(Json::Value const&)> onResponse)>;
+
+private:
+    ChainType const chainType_;
+    beast::Journal j_;
+
+    // Held while a callback runs, the callbacks of a listener are not called
+    // once unsubscribe() returns
+    std::mutex subscribersMtx_;
+    std::vector<Subscriber> GUARDED_BY(subscribersMtx_) subscribers_;
+
+    std::mutex ownersMtx_;
+    // The subscriber of the ids waiting for a reply
+    std::unordered_map<std::uint32_t, std::size_t> GUARDED_BY(ownersMtx_)
+        owners_;
+
+    // Held while a hedged request is sent, the nodes are not used once
+    // setHedge(nullptr) returns
+    std::mutex hedgeMtx_;
+    HedgeFunc GUARDED_BY(hedgeMtx_) hedge_;
+
+    WebsocketClient::Traffic traffic_;
+    std::unique_ptr<WebsocketClient> ws_;
+
+public:
+    ChainConnection(
+        ChainType chainType,
+        boost::asio::io_service& ios,
+        std::vector<beast::IP::Endpoint> const& ips,
+        beast::Journal j);
+    ~ChainConnection();
+
+    ChainConnection(ChainConnection const&) = delete;
+    ChainConnection&
+    operator=(ChainConnection const&) = delete;
+
+    // Return the index of the subscriber, its handle for the other calls.
+    // The first one probes the nodes and moves the connection to the
+    // healthiest one.
+    std::size_t
+    subscribe(Subscriber s) EXCLUDES(subscribersMtx_);
+
+    void
+    unsubscribe(std::size_t sub) EXCLUDES(subscribersMtx_);
+
+    void
+    connect();
+
+    void
+    shutdown();
+
+    // As WebsocketClient::send, the reply goes to the subscriber
+    std::uint32_t
+    send(
+        std::size_t sub,
+        std::string const& cmd,
+        Json::Value const& params,
+        std::function<void(std::uint32_t)> onID) EXCLUDES(ownersMtx_);
+
+    // An id of the subscriber for a request not sent, answered with
+    // deliver()
+    std::uint32_t
+    reserveId(std::size_t sub) EXCLUDES(ownersMtx_);
+
+    // Queue a reply, routed by its id as the received ones
+    void
+    deliver(Json::Value const& msg);
+
+    void
+    reconnect(std::string_view reason);
+
+    void
+    switchEndpoint(std::size_t idx, std::string_view reason);
+
+    std::size_t
+    endpointIdx() const;
+
+    void
+    setHedge(HedgeFunc f) EXCLUDES(hedgeMtx_);
+
+    // The hedged requests of all the subscribers go to the nodes of the one
+    // probing them
+    bool
+    hedge(
+        std::string const& cmd,
+        Json::Value const& params,
+        std::function<void(Json::Value const&)> onResponse)
+        EXCLUDES(hedgeMtx_);
+
+    WebsocketClient::Traffic const&
+    traffic() const
+    {
+        return traffic_;
+    }
+
+private:
+    void
+    onMessage(Json::Value const& msg) EXCLUDES(subscribersMtx_, ownersMtx_);
+
+    void
+    onConnect() EXCLUDES(subscribersMtx_);
+
+    // Of a stream transaction
+    bool
+    wants(Subscriber const& s, Json::Value const& msg) const;
+};
+
+}  // namespace xbwd
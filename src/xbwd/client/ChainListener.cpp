@@ -36,6 +36,8 @@
 #include <ripple/protocol/LedgerFormats.h>
 #include <ripple/protocol/SField.h>
 #include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STObject.h>
+#include <ripple/protocol/STTx.h>
 #include <ripple/protocol/TER.h>
 #include <ripple/protocol/TxFlags.h>
 #include <ripple/protocol/json_get_or_throw.h>
@@ -48,6 +50,24 @@ namespace xbwd {
 
 class Federator;
 
+namespace {
+
+char const* const timeoutError = "timeout";
+
+// An error reply to the request `id`, as rippled's
+Json::Value
+rpcError(std::uint32_t id, std::string const& error)
+{
+    Json::Value msg;
+    msg[ripple::jss::id] = id;
+    msg[ripple::jss::status] = "error";
+    msg[ripple::jss::error] = error;
+    msg[ripple::jss::type] = "response";
+    return msg;
+}
+
+}  // namespace
+
 ChainListener::ChainListener(
     ChainType chainType,
     ripple::STXChainBridge const sidechain,
@@ -55,32 +75,91 @@ ChainListener::ChainListener(
     Federator& federator,
     std::optional<ripple::AccountID> signAccount,
     std::uint32_t txLimit,
+    bool binaryAccountTx,
+    std::uint32_t backfillRanges,
+    bool subscribeAccounts,
     std::uint32_t lastLedgerProcessed,
+    std::uint32_t lastSubmitLedgerProcessed,
     beast::Journal j)
     : chainType_{chainType}
     , bridge_{sidechain}
+    , submitAccount_(submitAccount)
     , submitAccountStr_(
           submitAccount ? ripple::toBase58(*submitAccount) : std::string{})
     , federator_(federator)
     , signAccount_(signAccount)
     , j_{j}
     , txLimit_(txLimit)
+    , binaryAccountTx_(binaryAccountTx)
+    , backfillRanges_(backfillRanges)
+    , subscribeAccounts_(subscribeAccounts)
+    , ledgerProcessedSubmit_(
+          submitAccount ? lastSubmitLedgerProcessed : std::uint32_t(0))
+    , submitLedgerCheckpoint_(
+          submitAccount ? lastSubmitLedgerProcessed : std::uint32_t(0))
 {
     hp_.lastLedgerProcessed_ = lastLedgerProcessed;
 }
 
 void
-ChainListener::init(boost::asio::io_service& ios, beast::IP::Endpoint const& ip)
+ChainListener::init(
+    boost::asio::io_service& ios,
+    std::shared_ptr<ChainConnection> conn,
+    std::vector<beast::IP::Endpoint> const& ips,
+    bool hedgeRequests)
 {
-    wsClient_ = std::make_unique<WebsocketClient>(
+    std::vector<ripple::AccountID> accounts{bridge_.door(chainType_)};
+    if (submitAccount_)
+        accounts.push_back(*submitAccount_);
+    conn_ = std::move(conn);
+    sub_ = conn_->subscribe(ChainConnection::Subscriber{
+        bridge_,
+        std::move(accounts),
         [this](Json::Value const& msg) { onMessage(msg); },
-        [this]() { onConnect(); },
-        ios,
-        ip,
-        /*headers*/ std::unordered_map<std::string, std::string>{},
-        j_);
+        [this]() { onConnect(); }});
+
+    // The listeners of the other bridges hedge through the nodes of the
+    // first one
+    hedgeRequests_ = hedgeRequests && ips.size() > 1;
 
-    wsClient_->connect();
+    // One listener of the connection moves it
+    if (ips.size() > 1 && sub_ == 0)
+    {
+        for (auto const& ip : ips)
+        {
+            auto& node = *nodes_.emplace_back(std::make_unique<Node>(ip));
+            node.ws_ = std::make_unique<WebsocketClient>(
+                [this, &node](Json::Value const& msg) {
+                    onNodeMessage(node, msg);
+                },
+                [] {},
+                ios,
+                ip,
+                /*headers*/ std::unordered_map<std::string, std::string>{},
+                j_,
+                /*traffic*/ nullptr,
+                "ws prb " + to_string(chainType_));
+        }
+        probeTimer_ = std::make_unique<boost::asio::steady_timer>(ios);
+        if (hedgeRequests_)
+            conn_->setHedge([this](
+                                std::string const& cmd,
+                                Json::Value const& params,
+                                RpcCallback onResponse) {
+                auto* node = hedgeNode();
+                return node &&
+                    sendToNode(*node, cmd, params, std::move(onResponse));
+            });
+    }
+    timeoutTimer_ = std::make_unique<boost::asio::steady_timer>(ios);
+    resumeTimer_ = std::make_unique<boost::asio::steady_timer>(ios);
+
+    for (auto& node : nodes_)
+        node->ws_->connect();
+    if (probeTimer_)
+        scheduleProbe();
+    scheduleTimeouts();
+    scheduleResume();
 }
 
 void
@@ -97,7 +176,7 @@ ChainListener::onConnect()
             // processed with transaction parsing.
             // account_tx present in the
             // Cycle, so there is no reconnect for it
-            wsClient_->reconnect("Can't process Account Info");
+            conn_->reconnect("Can't process Account Info");
             return;
         }
         Json::Value params;
@@ -123,7 +202,7 @@ ChainListener::onConnect()
     auto signAccInfoCb = [this, mainFlow](Json::Value const& msg) {
         if (!processSigningAccountInfo(msg))
         {
-            wsClient_->reconnect("Can't process Signing Account Info");
+            conn_->reconnect("Can't process Signing Account Info");
             return;
         }
         mainFlow();
@@ -131,13 +210,35 @@ ChainListener::onConnect()
 
     // Clear on re-connect
     inRequest_ = false;
+    // Subscribed again once account_tx caught up
+    accountsStream_ = false;
+    accountsSubscribing_ = false;
+
+    // The replies to the previous connection are lost
+    {
+        std::vector<std::uint32_t> lost;
+        {
+            std::lock_guard lock(callbacksMtx_);
+            for (auto const& [id, cb] : callbacks_)
+                lost.push_back(id);
+        }
+        for (auto const id : lost)
+            conn_->deliver(rpcError(id, "disconnected"));
+    }
+
+    // The history starts again, or continues with the stream
+    ++pausedGeneration_;
+    {
+        std::lock_guard l{pausedMtx_};
+        paused_.clear();
+    }
 
     // Resume only if history finished
     if (hp_.state_ != HistoryProcessor::FINISHED)
     {
         ledgerReqMax_ = 0;
         ledgerProcessedDoor_ = 0;
-        ledgerProcessedSubmit_ = 0;
+        ledgerProcessedSubmit_ = submitLedgerCheckpoint_;
         prevLedgerIndex_ = 0;
         txnHistoryIndex_ = 0;
         hp_.clear();
@@ -158,14 +259,26 @@ ChainListener::onConnect()
 void
 ChainListener::shutdown()
 {
-    wsClient_.reset();
+    if (probeTimer_)
+        probeTimer_->cancel();
+    if (timeoutTimer_)
+        timeoutTimer_->cancel();
+    if (resumeTimer_)
+        resumeTimer_->cancel();
+    if (conn_)
+    {
+        if (!nodes_.empty())
+            conn_->setHedge(nullptr);
+        conn_->unsubscribe(sub_);
+    }
+    for (auto& node : nodes_)
+        node->ws_.reset();
 }
 
 std::uint32_t
 ChainListener::send(std::string const& cmd, Json::Value const& params) const
 {
-    auto const chainName = to_string(chainType_);
-    return wsClient_->send(cmd, params, chainName, [](std::uint32_t) {});
+    return conn_->send(sub_, cmd, params, [](std::uint32_t) {});
 }
 
 void
@@ -178,9 +291,38 @@ void
 ChainListener::send(
     std::string const& cmd,
     Json::Value const& params,
-    RpcCallback onResponse)
+    RpcCallback onResponse,
+    bool hedge)
 {
     auto const chainName = to_string(chainType_);
+
+    bool const full = [&] {
+        std::lock_guard lock(callbacksMtx_);
+        return callbacks_.size() >= maxCallbacks_;
+    }();
+    if (full)
+    {
+        JLOGV(
+            j_.warn(),
+            "ChainListener too many requests waiting",
+            jv("chainType", chainName),
+            jv("command", cmd));
+        failRequest(std::move(onResponse), "tooBusy");
+        return;
+    }
+
+    if (hedge && hedgeRequests_)
+    {
+        auto done = std::make_shared<std::atomic_bool>(false);
+        onResponse = [done, cb = std::move(onResponse)](
+                         Json::Value const& msg) {
+            if (!done->exchange(true))
+                cb(msg);
+        };
+        if (conn_->hedge(cmd, params, onResponse))
+            hedgedRequests_.inc();
+    }
+
     // JLOGV(
     //     j_.trace(),
     //     "ChainListener send",
@@ -188,12 +330,126 @@ ChainListener::send(
     //     jv("command", cmd),
     //     jv("params", params));
 
-    auto id = wsClient_->send(
-        cmd, params, chainName, [this, onResponse](std::uint32_t id) {
-            std::lock_guard lock(callbacksMtx_);
-            callbacks_.emplace(id, onResponse);
+    bool sent = false;
+    auto id = conn_->send(
+        sub_, cmd, params, [this, &onResponse, &sent](std::uint32_t id) {
+            addCallback(id, onResponse);
+            sent = true;
         });
     // JLOGV(j_.trace(), "ChainListener send id", jv("id", id));
+
+    // Not connected, the timeout answers it once the connection is back or
+    // still down
+    if (!sent)
+        addCallback(conn_->reserveId(sub_), std::move(onResponse));
+}
+
+void
+ChainListener::addCallback(std::uint32_t id, RpcCallback onResponse)
+{
+    auto const now = std::chrono::steady_clock::now();
+    std::lock_guard lock(callbacksMtx_);
+    callbacks_.emplace(id, std::make_pair(std::move(onResponse), now));
+    deadlines_.add(id, now + rpcTimeout_);
+}
+
+void
+ChainListener::failRequest(RpcCallback onResponse, std::string const& error)
+{
+    auto const id = conn_->reserveId(sub_);
+    addCallback(id, std::move(onResponse));
+    conn_->deliver(rpcError(id, error));
+}
+
+void
+ChainListener::scheduleTimeouts()
+{
+    timeoutTimer_->expires_after(std::chrono::seconds(1));
+    timeoutTimer_->async_wait([this](boost::system::error_code const& ec) {
+        if (ec == boost::asio::error::operation_aborted)
+            return;
+        checkTimeouts();
+        scheduleTimeouts();
+    });
+}
+
+void
+ChainListener::checkTimeouts()
+{
+    std::vector<std::uint32_t> expired;
+    {
+        std::lock_guard lock(callbacksMtx_);
+        for (auto const id :
+             deadlines_.advance(std::chrono::steady_clock::now()))
+            if (callbacks_.contains(id))
+                expired.push_back(id);
+    }
+    if (expired.empty() || !conn_)
+        return;
+
+    rpcTimeouts_.inc(expired.size());
+    JLOGV(
+        j_.warn(),
+        "ChainListener requests timed out",
+        jv("chainType", to_string(chainType_)),
+        jv("count", expired.size()));
+    for (auto const id : expired)
+        conn_->deliver(rpcError(id, timeoutError));
+
+    if ((timeoutsInRow_ += static_cast<std::uint32_t>(expired.size())) >=
+        maxTimeoutsInRow_)
+    {
+        timeoutsInRow_ = 0;
+        conn_->reconnect("requests timed out");
+    }
+}
+
+void
+ChainListener::unlessPaused(std::function<void()> f)
+{
+    if (!federator_.historyPaused(chainType_))
+    {
+        f();
+        return;
+    }
+    std::lock_guard l{pausedMtx_};
+    paused_.push_back(
+        [this, generation = pausedGeneration_, f = std::move(f)] {
+            if (generation == pausedGeneration_)
+                f();
+        });
+}
+
+void
+ChainListener::resumeHistory()
+{
+    std::vector<std::function<void()>> resumed;
+    {
+        std::lock_guard l{pausedMtx_};
+        if (paused_.empty() || federator_.historyPaused(chainType_))
+            return;
+        resumed.swap(paused_);
+    }
+    // Through the callbacks, the history state is only used on the callback
+    // thread
+    for (auto& f : resumed)
+    {
+        auto const id = conn_->reserveId(sub_);
+        addCallback(id, [f = std::move(f)](Json::Value const&) { f(); });
+        conn_->deliver(rpcError(id, "resumed"));
+    }
+}
+
+void
+ChainListener::scheduleResume()
+{
+    resumeTimer_->expires_after(resumeInterval_);
+    resumeTimer_->async_wait([this](boost::system::error_code const& ec) {
+        if (ec == boost::asio::error::operation_aborted)
+            return;
+        resumeHistory();
+        scheduleResume();
+    });
 }
 
 template <class E>
@@ -204,9 +460,176 @@ ChainListener::pushEvent(E&& e) const
     federator_.push(std::move(e));
 }
 
+bool
+ChainListener::sendToNode(
+    Node& node,
+    std::string const& cmd,
+    Json::Value const& params,
+    RpcCallback onResponse) const
+{
+    // The id is only assigned when connected
+    bool sent = false;
+    node.ws_->send(
+        cmd,
+        params,
+        to_string(chainType_),
+        [&node, &sent, onResponse](std::uint32_t id) {
+            std::lock_guard lock(node.callbacksMtx_);
+            node.callbacks_.emplace(id, onResponse);
+            sent = true;
+        });
+    return sent;
+}
+
+void
+ChainListener::onNodeMessage(Node& node, Json::Value const& msg) const
+{
+    // Only the replies, the node connections don't subscribe
+    if (!msg.isMember(ripple::jss::id) || !msg[ripple::jss::id].isIntegral())
+        return;
+
+    RpcCallback cb;
+    {
+        std::lock_guard lock(node.callbacksMtx_);
+        auto i = node.callbacks_.find(msg[ripple::jss::id].asUInt());
+        if (i == node.callbacks_.end())
+            return;
+        cb = std::move(i->second);
+        node.callbacks_.erase(i);
+    }
+    cb(msg);
+}
+
+void
+ChainListener::scheduleProbe()
+{
+    probeTimer_->expires_after(probeInterval_);
+    probeTimer_->async_wait([this](boost::system::error_code const& ec) {
+        if (ec == boost::asio::error::operation_aborted)
+            return;
+        probeNodes();
+        scheduleProbe();
+    });
+}
+
+void
+ChainListener::probeNodes()
+{
+    for (auto& n : nodes_)
+    {
+        auto& node = *n;
+        if (node.missed_ >= maxMissed_)
+        {
+            // Their replies are not coming
+            std::lock_guard lock(node.callbacksMtx_);
+            node.callbacks_.clear();
+        }
+        ++node.missed_;
+        auto const sent = std::chrono::steady_clock::now();
+        sendToNode(
+            node,
+            "server_info",
+            Json::Value(),
+            [&node, sent](Json::Value const& msg) {
+                std::uint64_t const us =
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - sent)
+                        .count();
+                auto const avg = node.latencyUs_.load();
+                node.latencyUs_ = avg ? avg - avg / 4 + us / 4 : us;
+                node.missed_ = 0;
+
+                auto const& info = msg[ripple::jss::result][ripple::jss::info];
+                auto const& seq =
+                    info[ripple::jss::validated_ledger][ripple::jss::seq];
+                node.validatedLedger_ = seq.isIntegral() ? seq.asUInt() : 0;
+            });
+    }
+
+    auto const maxValidated = maxValidatedLedger();
+
+    auto const active = conn_->endpointIdx();
+    std::optional<std::size_t> best;
+    std::uint64_t bestScore = 0;
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+    {
+        auto const score = nodeScore(*nodes_[i], maxValidated);
+        if (score && (!best || *score < bestScore))
+        {
+            best = i;
+            bestScore = *score;
+        }
+    }
+    if (!best || (*best == active))
+        return;
+
+    auto const activeScore = nodeScore(*nodes_[active], maxValidated);
+    if (activeScore && (*activeScore < bestScore + switchMargin_))
+        return;
+
+    JLOGV(
+        j_.warn(),
+        "Moving the stream to a healthier node",
+        jv("chainType", to_string(chainType_)),
+        jv("from", nodes_[active]->ep_.to_string()),
+        jv("to", nodes_[*best]->ep_.to_string()),
+        jv("fromScore", activeScore ? *activeScore : 0),
+        jv("toScore", bestScore));
+    conn_->switchEndpoint(*best, "healthier node");
+}
+
+std::uint32_t
+ChainListener::maxValidatedLedger() const
+{
+    std::uint32_t maxValidated = 0;
+    for (auto const& node : nodes_)
+        if (node->missed_ < maxMissed_)
+            maxValidated =
+                std::max(maxValidated, node->validatedLedger_.load());
+    return maxValidated;
+}
+
+std::optional<std::uint64_t>
+ChainListener::nodeScore(Node const& node, std::uint32_t maxValidated) const
+{
+    auto const validated = node.validatedLedger_.load();
+    if ((node.missed_ >= maxMissed_) || !validated)
+        return {};
+    auto const lag = maxValidated > validated ? maxValidated - validated : 0;
+    return std::uint64_t(lag) * 1000 + node.latencyUs_ / 1000;
+}
+
+ChainListener::Node*
+ChainListener::hedgeNode() const
+{
+    auto const maxValidated = maxValidatedLedger();
+
+    auto const active = conn_->endpointIdx();
+    Node* best = nullptr;
+    std::uint64_t bestScore = 0;
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+    {
+        if (i == active)
+            continue;
+        auto const score = nodeScore(*nodes_[i], maxValidated);
+        if (score && (!best || *score < bestScore))
+        {
+            best = nodes_[i].get();
+            bestScore = *score;
+        }
+    }
+    return best;
+}
+
 void
 ChainListener::onMessage(Json::Value const& msg)
 {
+    // A reply from rippled, not from the timeouts
+    auto const isReply = [&msg] {
+        return !msg.isMember(ripple::jss::error) ||
+            (msg[ripple::jss::error] != timeoutError);
+    };
+
     auto callbackOpt = [&]() -> std::optional<RpcCallback> {
         if (msg.isMember(ripple::jss::id) && msg[ripple::jss::id].isIntegral())
         {
@@ -215,8 +638,12 @@ ChainListener::onMessage(Json::Value const& msg)
             auto i = callbacks_.find(callbackId);
             if (i != callbacks_.end())
             {
-                auto cb = i->second;
+                auto cb = std::move(i->second.first);
+                rpcRoundTrip_.observe(
+                    std::chrono::steady_clock::now() - i->second.second);
                 callbacks_.erase(i);
+                if (isReply())
+                    timeoutsInRow_ = 0;
                 return cb;
             }
         }
@@ -229,7 +656,7 @@ ChainListener::onMessage(Json::Value const& msg)
             j_.trace(),
             "ChainListener onMessage, reply to a callback",
             jv("chainType", to_string(chainType_)),
-            jv("msg", msg.toStyledString()));
+            jv("msg", msg));
         (*callbackOpt)(msg);
     }
     else
@@ -288,6 +715,78 @@ isDeletedAccCnt(Json::Value const& meta, std::uint64_t createCnt)
     return false;
 }
 
+bool
+isDeleted(
+    ripple::STObject const& meta,
+    ripple::SF_UINT64 const& field,
+    std::uint64_t value)
+{
+    if (!meta.isFieldPresent(ripple::sfAffectedNodes))
+        return false;
+
+    for (auto const& an : meta.getFieldArray(ripple::sfAffectedNodes))
+    {
+        if (an.getFName() != ripple::sfDeletedNode ||
+            !an.isFieldPresent(ripple::sfFinalFields))
+            continue;
+        auto const& ff = an.peekAtField(ripple::sfFinalFields)
+                             .downcast<ripple::STObject>();
+        if (ff[~field] == value)
+            return true;
+    }
+
+    return false;
+}
+
+bool
+isDeletedClaimId(ripple::STObject const& meta, std::uint64_t claimID)
+{
+    return isDeleted(meta, ripple::sfXChainClaimID, claimID);
+}
+
+bool
+isDeletedAccCnt(ripple::STObject const& meta, std::uint64_t createCnt)
+{
+    return isDeleted(meta, ripple::sfXChainAccountCreateCount, createCnt);
+}
+
+std::optional<std::uint64_t>
+getU64(Json::Value const& transaction, ripple::SF_UINT64 const& field)
+{
+    return Json::getOptional<std::uint64_t>(transaction, field);
+}
+
+std::optional<std::uint64_t>
+getU64(ripple::STTx const& transaction, ripple::SF_UINT64 const& field)
+{
+    return transaction[~field];
+}
+
+// The signer list and the account settings are parsed from JSON
+Json::Value const&
+txJson(Json::Value const& transaction)
+{
+    return transaction;
+}
+
+Json::Value
+txJson(ripple::STTx const& transaction)
+{
+    return transaction.getJson(ripple::JsonOptions::none);
+}
+
+std::optional<std::int32_t>
+historyIndex(Json::Value const& msg)
+{
+    // only history stream messages have the index
+    if (!msg.isMember(ripple::jss::account_history_tx_index) ||
+        !msg[ripple::jss::account_history_tx_index].isIntegral())
+        return {};
+    // values < 0 are historical txns. values >= 0 are new transactions.
+    // Only the initial sync needs historical txns.
+    return msg[ripple::jss::account_history_tx_index].asInt();
+}
+
 std::optional<event::NewLedger>
 checkLedger(ChainType chainType, Json::Value const& msg)
 {
@@ -329,15 +828,7 @@ ChainListener::processMessage(Json::Value const& msg)
             std::forward<decltype(v)>(v)...);
     };
 
-    auto txnHistoryIndex = [&]() -> std::optional<std::int32_t> {
-        // only history stream messages have the index
-        if (!msg.isMember(ripple::jss::account_history_tx_index) ||
-            !msg[ripple::jss::account_history_tx_index].isIntegral())
-            return {};
-        // values < 0 are historical txns. values >= 0 are new transactions.
-        // Only the initial sync needs historical txns.
-        return msg[ripple::jss::account_history_tx_index].asInt();
-    }();
+    auto const txnHistoryIndex = historyIndex(msg);
     bool const isHistory = txnHistoryIndex && (*txnHistoryIndex < 0);
 
     if (isHistory && hp_.stopHistory_)
@@ -357,24 +848,60 @@ ChainListener::processMessage(Json::Value const& msg)
     {
         ledgerIndex_ = newLedgerEv->ledgerIndex_;
         ledgerFee_ = newLedgerEv->fee_;
+        if (!submitAccountStr_.empty())
+            requestFees(newLedgerEv->ledgerIndex_);
         pushEvent(std::move(*newLedgerEv));
         processNewLedger(newLedgerEv->ledgerIndex_);
         return;
     }
 
-    if (!msg.isMember(ripple::jss::validated) ||
-        !msg[ripple::jss::validated].asBool())
-        return ignoreRet("not validated");
-
     if (!msg.isMember(ripple::jss::transaction))
         return ignoreRet("no tx");
 
-    auto const& transaction = msg[ripple::jss::transaction];
-
     if (!msg.isMember(ripple::jss::meta))
         return ignoreRet("no meta");
 
-    auto const& meta = msg[ripple::jss::meta];
+    if (!txnHistoryIndex && accountsStream_)
+    {
+        // Pushed by the accounts stream, ordered as the account_tx ones
+        auto const lgrSeq = rpcResultParse::parseLedgerSeq(msg);
+        if (!lgrSeq || (*lgrSeq <= streamStart_))
+            return ignoreRet("requested with account_tx");
+        Json::Value tx = msg;
+        tx[ripple::jss::account_history_tx_index] = txnHistoryIndex_++;
+        tx[ripple::jss::account_history_boundary] = true;
+        return processTransaction(
+            tx, tx[ripple::jss::transaction], tx[ripple::jss::meta]);
+    }
+
+    processTransaction(
+        msg, msg[ripple::jss::transaction], msg[ripple::jss::meta]);
+}
+
+template <class Tx, class Meta>
+void
+ChainListener::processTransaction(
+    Json::Value const& msg,
+    Tx const& transaction,
+    Meta const& meta)
+{
+    auto const chainName = to_string(chainType_);
+
+    auto ignoreRet = [&](std::string_view reason, auto&&... v) {
+        JLOGV(
+            j_.trace(),
+            "ignoring listener message",
+            jv("chainType", chainName),
+            jv("reason", reason),
+            std::forward<decltype(v)>(v)...);
+    };
+
+    auto const txnHistoryIndex = historyIndex(msg);
+    bool const isHistory = txnHistoryIndex && (*txnHistoryIndex < 0);
+
+    if (!msg.isMember(ripple::jss::validated) ||
+        !msg[ripple::jss::validated].asBool())
+        return ignoreRet("not validated");
 
     if (!msg.isMember(ripple::jss::engine_result_code))
         return ignoreRet("no engine result code");
@@ -447,8 +974,7 @@ ChainListener::processMessage(Json::Value const& msg)
     switch (*txnTypeOpt)
     {
         case XChainTxnType::xChainClaim: {
-            auto const claimID = Json::getOptional<std::uint64_t>(
-                transaction, ripple::sfXChainClaimID);
+            auto const claimID = getU64(transaction, ripple::sfXChainClaimID);
 
             if (!claimID)
                 return ignoreRet("no claimID");
@@ -469,8 +995,7 @@ ChainListener::processMessage(Json::Value const& msg)
         }
         break;
         case XChainTxnType::xChainCommit: {
-            auto const claimID = Json::getOptional<std::uint64_t>(
-                transaction, ripple::sfXChainClaimID);
+            auto const claimID = getU64(transaction, ripple::sfXChainClaimID);
 
             if (!claimID)
                 return ignoreRet("no claimID");
@@ -536,11 +1061,7 @@ ChainListener::processMessage(Json::Value const& msg)
         break;
 #ifdef USE_BATCH_ATTESTATION
         case XChainTxnType::xChainAddAttestationBatch: {
-            if (rpcResultParse::fieldMatchesStr(
-                    transaction,
-                    ripple::jss::Account,
-                    submitAccountStr_.c_str()) &&
-                txnSeq)
+            if (src == submitAccount_ && txnSeq)
             {
                 pushEvent(
                     event::XChainAttestsResult{chainType_, *txnSeq, txnTER});
@@ -555,20 +1076,18 @@ ChainListener::processMessage(Json::Value const& msg)
         case XChainTxnType::xChainAddClaimAttestation: {
             std::optional<std::uint64_t> claimID, accountCreateCount;
 
-            bool const isOwn = rpcResultParse::fieldMatchesStr(
-                transaction, ripple::jss::Account, submitAccountStr_.c_str());
+            bool const isOwn = src == submitAccount_;
             bool const isFinal = [&]() {
                 if (txnTypeOpt == XChainTxnType::xChainAddClaimAttestation)
                 {
-                    claimID = Json::getOptional<std::uint64_t>(
-                        transaction, ripple::sfXChainClaimID);
+                    claimID = getU64(transaction, ripple::sfXChainClaimID);
                     return claimID && isDeletedClaimId(meta, *claimID);
                 }
                 else if (
                     txnTypeOpt ==
                     XChainTxnType::xChainAddAccountCreateAttestation)
                 {
-                    accountCreateCount = Json::getOptional<std::uint64_t>(
+                    accountCreateCount = getU64(
                         transaction, ripple::sfXChainAccountCreateCount);
                     return accountCreateCount &&
                         isDeletedAccCnt(meta, *accountCreateCount);
@@ -630,7 +1149,7 @@ ChainListener::processMessage(Json::Value const& msg)
         break;
         case XChainTxnType::SignerListSet: {
             if (txnSuccess && !isHistory)
-                processSignerListSet(transaction);
+                processSignerListSet(txJson(transaction));
             else
                 return ignoreRet(
                     isHistory ? "skip in history mode" : "not success");
@@ -639,7 +1158,7 @@ ChainListener::processMessage(Json::Value const& msg)
         break;
         case XChainTxnType::AccountSet: {
             if (txnSuccess && !isHistory)
-                processAccountSet(transaction);
+                processAccountSet(txJson(transaction));
             else
                 return ignoreRet(
                     isHistory ? "skip in history mode" : "not success");
@@ -648,7 +1167,7 @@ ChainListener::processMessage(Json::Value const& msg)
         break;
         case XChainTxnType::SetRegularKey: {
             if (txnSuccess && !isHistory)
-                processSetRegularKey(transaction);
+                processSetRegularKey(txJson(transaction));
             else
                 return ignoreRet(
                     isHistory ? "skip in history mode" : "not success");
@@ -894,12 +1413,19 @@ ChainListener::processServerInfo(Json::Value const& msg)
         };
         checkCompleteLedgers();
 
+        // Not reported when the server is not loaded
+        if (jinfo.isMember(ripple::jss::load_factor) &&
+            jinfo[ripple::jss::load_factor].isNumeric())
+            loadFactor_ = static_cast<std::uint32_t>(
+                jinfo[ripple::jss::load_factor].asDouble() * 1000);
+
         JLOGV(
             j_.info(),
             "server_info",
             jv("chainType", chainName),
             jv("minValidatedLedger", hp_.minValidatedLedger_),
-            jv("networkID", networkID));
+            jv("networkID", networkID),
+            jv("loadFactor", loadFactor_.load()));
     }
     catch (std::exception const& e)
     {
@@ -1242,7 +1768,7 @@ ChainListener::processSetRegularKey(Json::Value const& msg) const
     }
 }
 
-void
+std::string
 ChainListener::processTx(Json::Value const& v) const
 {
     std::string const chainName = to_string(chainType_);
@@ -1258,14 +1784,20 @@ ChainListener::processTx(Json::Value const& v) const
             jv("reason", reason),
             jv("chainType", chainName),
             jv("msg", v));
+        return std::string(reason);
     };
 
     try
     {
+        // Timed out, not found
+        if (v.isMember(ripple::jss::error))
+            return warn_ret(v[ripple::jss::error].asString());
         if (!v.isMember(ripple::jss::result))
             return warn_ret("missing result field");
 
         auto const& msg = v[ripple::jss::result];
+        if (msg.isMember(ripple::jss::error))
+            return warn_ret(msg[ripple::jss::error].asString());
 
         if (!msg.isMember(ripple::jss::validated) ||
             !msg[ripple::jss::validated].asBool())
@@ -1375,6 +1907,7 @@ ChainListener::processTx(Json::Value const& v) const
             jv("exception", e.what()),
             jv("chainType", chainName),
             jv("msg", v));
+        return "exception";
     }
     catch (...)
     {
@@ -1384,7 +1917,9 @@ ChainListener::processTx(Json::Value const& v) const
             jv("exception", "unknown exception"),
             jv("chainType", chainName),
             jv("msg", v));
+        return "exception";
     }
+    return {};
 }
 
 std::uint32_t
@@ -1411,6 +1946,56 @@ ChainListener::getCurrentFee() const
     return ledgerFee_;
 }
 
+void
+ChainListener::requestFees(std::uint32_t ledger)
+{
+    auto feeCb = [this](Json::Value const& msg) { processFee(msg); };
+    send("fee", Json::Value(), feeCb);
+
+    if (ledger % serverInfoInterval_ == 0)
+    {
+        auto serverInfoCb = [this](Json::Value const& msg) {
+            processServerInfo(msg);
+        };
+        send("server_info", Json::Value(), serverInfoCb);
+    }
+}
+
+void
+ChainListener::processFee(Json::Value const& msg)
+{
+    // {"result": {"drops": {"open_ledger_fee": "10", ...}, ...}}
+    if (!msg.isMember(ripple::jss::result))
+        return;
+    auto const& jres = msg[ripple::jss::result];
+    if (!jres.isMember(ripple::jss::drops))
+        return;
+    auto const& jdrops = jres[ripple::jss::drops];
+    if (!jdrops.isMember(ripple::jss::open_ledger_fee) ||
+        !jdrops[ripple::jss::open_ledger_fee].isString())
+        return;
+
+    auto const s = jdrops[ripple::jss::open_ledger_fee].asString();
+    std::uint32_t fee = 0;
+    auto const [p, ec] = std::from_chars(s.data(), s.data() + s.size(), fee);
+    if (ec != std::errc() || p != s.data() + s.size())
+    {
+        JLOGV(
+            j_.warn(),
+            "ignoring fee message",
+            jv("chainType", to_string(chainType_)),
+            jv("open_ledger_fee", s));
+        return;
+    }
+    openLedgerFee_ = fee;
+}
+
+FeeState
+ChainListener::getFeeState() const
+{
+    return {ledgerFee_, openLedgerFee_, loadFactor_};
+}
+
 std::uint32_t
 ChainListener::getHistoryProcessedLedger() const
 {
@@ -1418,11 +2003,13 @@ ChainListener::getHistoryProcessedLedger() const
 }
 
 void
-ChainListener::processAccountTx(Json::Value const& msg)
+ChainListener::processAccountTx(Json::Value const& msg, BackfillPage backfill)
 {
-    bool const requestContinue = processAccountTxHlp(msg);
+    bool const requestContinue = processAccountTxHlp(msg, backfill);
 
-    if (hp_.state_ == HistoryProcessor::WAIT_CB)
+    // The backfill waits for its last page
+    if ((hp_.state_ == HistoryProcessor::WAIT_CB) &&
+        (backfill != BackfillPage::more))
         hp_.state_ = HistoryProcessor::RETR_HISTORY;
 
     if (hp_.state_ != HistoryProcessor::FINISHED)
@@ -1445,7 +2032,9 @@ ChainListener::processAccountTx(Json::Value const& msg)
 }
 
 bool
-ChainListener::processAccountTxHlp(Json::Value const& msg)
+ChainListener::processAccountTxHlp(
+    Json::Value const& msg,
+    BackfillPage backfill)
 {
     static std::string const errTopic = "ignoring account_tx response";
 
@@ -1530,7 +2119,11 @@ ChainListener::processAccountTxHlp(Json::Value const& msg)
     }
 
     auto const& transactions = result[ripple::jss::transactions];
-    bool const isMarker = result.isMember("marker");
+    // The backfill already requested the next page of its range, or the
+    // next range
+    bool const isMarker = backfill == BackfillPage::no
+        ? result.isMember("marker")
+        : backfill == BackfillPage::more;
     std::uint32_t cnt = 0;
     for (auto it = transactions.begin(); it != transactions.end(); ++it, ++cnt)
     {
@@ -1561,12 +2154,26 @@ ChainListener::processAccountTxHlp(Json::Value const& msg)
         }
         auto const& meta = entry[ripple::jss::meta];
 
-        if (!entry.isMember(ripple::jss::tx))
+        // binary=true entries have the hex blobs, with the ledger index aside
+        bool const isBinary = entry.isMember(ripple::jss::tx_blob);
+        std::optional<ripple::STTx> stTx;
+        std::optional<ripple::STObject> stMeta;
+        if (isBinary)
+        {
+            stTx = rpcResultParse::parseTxBlob(entry[ripple::jss::tx_blob]);
+            stMeta = rpcResultParse::parseMetaBlob(meta);
+            if (!stTx || !stMeta)
+            {
+                warnCont("malformed blob", jv("entry", entry));
+                throw std::runtime_error("processAccountTx malformed blob");
+            }
+        }
+        else if (!entry.isMember(ripple::jss::tx))
         {
             warnCont("no tx", jv("entry", entry));
             throw std::runtime_error("processAccountTx no tx");
         }
-        auto const& tx = entry[ripple::jss::tx];
+        auto const& tx = isBinary ? entry : entry[ripple::jss::tx];
 
         Json::Value history = Json::objectValue;
 
@@ -1605,23 +2212,34 @@ ChainListener::processAccountTxHlp(Json::Value const& msg)
         }
         history[ripple::jss::account_history_tx_index] =
             isHistorical ? --txnHistoryIndex_ : txnHistoryIndex_++;
-        std::string const tr = meta["TransactionResult"].asString();
-        history[ripple::jss::engine_result] = tr;
-        auto const tc = ripple::transCode(tr);
+        auto const tc = [&]() -> std::optional<ripple::TER> {
+            if (!isBinary)
+                return ripple::transCode(meta["TransactionResult"].asString());
+            if (!stMeta->isFieldPresent(ripple::sfTransactionResult))
+                return {};
+            return ripple::TER::fromInt(
+                stMeta->getFieldU8(ripple::sfTransactionResult));
+        }();
         if (!tc)
         {
             warnCont("no TransactionResult", jv("entry", entry));
             throw std::runtime_error("processAccountTx no TransactionResult");
         }
+        history[ripple::jss::engine_result] = ripple::transToken(*tc);
         history[ripple::jss::engine_result_code] = *tc;
         history[ripple::jss::ledger_index] = ledgerIdx;
-        history[ripple::jss::meta] = meta;
-        history[ripple::jss::transaction] = tx;
         history[ripple::jss::validated] =
             entry[ripple::jss::validated].asBool();
         history[ripple::jss::type] = ripple::jss::transaction;
 
-        processMessage(history);
+        if (isBinary)
+            processTransaction(history, *stTx, *stMeta);
+        else
+        {
+            history[ripple::jss::meta] = meta;
+            history[ripple::jss::transaction] = tx;
+            processMessage(history);
+        }
     }
 
     if (hp_.accoutTxProcessed_ && (cnt >= hp_.accoutTxProcessed_) &&
@@ -1662,25 +2280,37 @@ ChainListener::processAccountTxHlp(Json::Value const& msg)
     if (isMarker &&
         ((hp_.state_ == HistoryProcessor::FINISHED) || !hp_.stopHistory_))
     {
-        std::string const account = result[ripple::jss::account].asString();
-        accountTx(account, ledgerMin, ledgerMax, result[ripple::jss::marker]);
+        if (backfill == BackfillPage::no)
+        {
+            std::string const account =
+                result[ripple::jss::account].asString();
+            auto next = [this,
+                         account,
+                         ledgerMin,
+                         ledgerMax,
+                         marker = result[ripple::jss::marker]] {
+                accountTx(account, ledgerMin, ledgerMax, marker);
+            };
+            // The stream catch up once the history is done is not held
+            if (hp_.state_ == HistoryProcessor::FINISHED)
+                next();
+            else
+                unlessPaused(std::move(next));
+        }
         return true;
     }
 
     return false;
 }
 
-void
-ChainListener::accountTx(
+Json::Value
+ChainListener::accountTxParams(
     std::string const& account,
     std::uint32_t ledger_min,
     std::uint32_t ledger_max,
-    Json::Value const& marker)
+    Json::Value const& marker,
+    std::uint32_t limit) const
 {
-    inRequest_ = true;
-    if (hp_.state_ != HistoryProcessor::FINISHED)
-        hp_.marker_ = marker;
-
     Json::Value txParams;
     txParams[ripple::jss::account] = account;
 
@@ -1694,14 +2324,203 @@ ChainListener::accountTx(
     else
         txParams[ripple::jss::ledger_index_max] = -1;
 
-    txParams[ripple::jss::binary] = false;
-    txParams[ripple::jss::limit] = txLimit_;
+    txParams[ripple::jss::binary] = binaryAccountTx_;
+    txParams[ripple::jss::limit] = limit;
     txParams[ripple::jss::forward] = hp_.state_ == HistoryProcessor::FINISHED;
     if (!marker.isNull())
         txParams[ripple::jss::marker] = marker;
-    send("account_tx", txParams, [this](Json::Value const& msg) {
-        processAccountTx(msg);
-    });
+    return txParams;
+}
+
+void
+ChainListener::accountTx(
+    std::string const& account,
+    std::uint32_t ledger_min,
+    std::uint32_t ledger_max,
+    Json::Value const& marker)
+{
+    inRequest_ = true;
+    if (hp_.state_ != HistoryProcessor::FINISHED)
+    {
+        hp_.marker_ = marker;
+        hp_.markerLedgerMax_ = ledger_max;
+    }
+
+    send(
+        "account_tx",
+        accountTxParams(account, ledger_min, ledger_max, marker, txLimit_),
+        [this](Json::Value const& msg) { processAccountTx(msg); });
+}
+
+bool
+ChainListener::startBackfill()
+{
+    // Down to the ledger processed by the previous session, or to the oldest
+    // ledger of the server
+    auto const low = hp_.lastLedgerProcessed_ ? hp_.lastLedgerProcessed_
+                                              : hp_.minValidatedLedger_;
+    if ((backfillRanges_ < 2) || !low || (hp_.startupLedger_ <= low))
+        return false;
+
+    auto const span = hp_.startupLedger_ - low + 1;
+    auto const cnt = std::min(backfillRanges_, span);
+    auto const size = (span + cnt - 1) / cnt;
+
+    auto& bf = hp_.backfill_;
+    bf.clear();
+    for (auto max = hp_.startupLedger_;;)
+    {
+        auto const min = max - low + 1 > size ? max - size + 1 : low;
+        bf.ranges_.push_back(Backfill::Range{min, max, txLimit_});
+        if (min == low)
+            break;
+        max = min - 1;
+    }
+
+    JLOGV(
+        j_.info(),
+        "Start history backfill",
+        jv("chainType", to_string(chainType_)),
+        jv("ranges", bf.ranges_.size()),
+        jv("startupLedger", hp_.startupLedger_),
+        jv("ledgerMin", low));
+
+    for (std::size_t i = 0; i < bf.ranges_.size(); ++i)
+        sendBackfillReq(i, Json::Value());
+    return true;
+}
+
+void
+ChainListener::sendBackfillReq(std::size_t idx, Json::Value const& marker)
+{
+    auto& range = hp_.backfill_.ranges_[idx];
+    range.sent_ = std::chrono::steady_clock::now();
+    send(
+        "account_tx",
+        accountTxParams(
+            ripple::toBase58(bridge_.door(chainType_)),
+            range.min_,
+            range.max_,
+            marker,
+            range.limit_),
+        [this, generation = hp_.backfill_.generation_, idx, marker](
+            Json::Value const& msg) {
+            processBackfillPage(generation, idx, marker, msg);
+        });
+}
+
+void
+ChainListener::processBackfillPage(
+    std::uint32_t generation,
+    std::size_t idx,
+    Json::Value const& marker,
+    Json::Value const& msg)
+{
+    auto& bf = hp_.backfill_;
+    if ((generation != bf.generation_) || (idx >= bf.ranges_.size()))
+        return;
+
+    auto& range = bf.ranges_[idx];
+    bool const error = ripple::RPC::contains_error(msg) ||
+        !msg.isMember(ripple::jss::result);
+    if (error)
+        range.done_ = true;
+    else
+    {
+        auto const& result = msg[ripple::jss::result];
+
+        // Larger pages while they come back fast, smaller ones once they are
+        // slow
+        auto const elapsed = std::chrono::steady_clock::now() - range.sent_;
+        if (elapsed > std::chrono::seconds(2))
+            range.limit_ = std::max(txLimit_ / 4, range.limit_ / 2);
+        else if (
+            (elapsed < std::chrono::milliseconds(500)) &&
+            (result[ripple::jss::transactions].size() >= range.limit_))
+            range.limit_ = std::min(txLimit_ * 4, range.limit_ * 2);
+        range.limit_ = std::max(range.limit_, std::uint32_t(1));
+
+        if (result.isMember(ripple::jss::marker))
+            range.next_ = result[ripple::jss::marker];
+        else
+            range.done_ = true;
+    }
+    range.pages_.push_back(Backfill::Page{msg, marker, error});
+
+    if (range.next_ &&
+        ((idx == bf.current_) || (range.pages_.size() < Backfill::maxPages_)))
+    {
+        auto next = std::move(*range.next_);
+        range.next_.reset();
+        unlessPaused([this, generation, idx, next = std::move(next)] {
+            if (generation == hp_.backfill_.generation_)
+                sendBackfillReq(idx, next);
+        });
+    }
+
+    drainBackfill();
+}
+
+void
+ChainListener::drainBackfill()
+{
+    auto& bf = hp_.backfill_;
+    while (bf.active())
+    {
+        auto& range = bf.ranges_[bf.current_];
+        if (range.pages_.empty())
+        {
+            if (!range.done_)
+            {
+                // Held while the newer ranges were processed
+                if (range.next_)
+                {
+                    auto next = std::move(*range.next_);
+                    range.next_.reset();
+                    unlessPaused([this,
+                                  generation = bf.generation_,
+                                  idx = bf.current_,
+                                  next = std::move(next)] {
+                        if (generation == hp_.backfill_.generation_)
+                            sendBackfillReq(idx, next);
+                    });
+                }
+                return;
+            }
+            ++bf.current_;
+            continue;
+        }
+
+        auto const page = std::move(range.pages_.front());
+        range.pages_.pop_front();
+
+        bool const last = page.error_ ||
+            ((bf.current_ + 1 == bf.ranges_.size()) && range.done_ &&
+             range.pages_.empty());
+        if (last)
+        {
+            // The history continues as requested one page at a time: the
+            // ledger requests on an error, then this page again
+            hp_.marker_ = page.marker_;
+            hp_.markerLedgerMax_ = range.max_;
+            JLOGV(
+                j_.info(),
+                "History backfill finished",
+                jv("chainType", to_string(chainType_)),
+                jv("error", page.error_),
+                jv("ledgerMax", range.max_));
+            bf.clear();
+            processAccountTx(page.msg_, BackfillPage::last);
+            return;
+        }
+
+        processAccountTx(page.msg_, BackfillPage::more);
+        if ((hp_.state_ == HistoryProcessor::FINISHED) || hp_.stopHistory_)
+        {
+            bf.clear();
+            return;
+        }
+    }
 }
 
 void
@@ -1741,7 +2560,7 @@ ChainListener::sendLedgerReq(std::uint32_t cnt)
     }
 
     auto ledgerReqCb = [this, cnt](Json::Value const&) {
-        sendLedgerReq(cnt - 1);
+        unlessPaused([this, cnt] { sendLedgerReq(cnt - 1); });
     };
     Json::Value params;
     params[ripple::jss::ledger_index] = hp_.toRequestLedger_--;
@@ -1794,6 +2613,9 @@ ChainListener::processNewLedger(std::uint32_t ledgerIdx)
 
     if (hp_.state_ == HistoryProcessor::FINISHED)
     {
+        if (accountsStream_)
+            return processStreamLedger(ledgerIdx);
+
         if (inRequest_)
             return;
 
@@ -1815,6 +2637,9 @@ ChainListener::processNewLedger(std::uint32_t ledgerIdx)
             }
         }
 
+        if (subscribeAccounts_ && !accountsSubscribing_)
+            subscribeAccountsStream();
+
         return;
     }
 
@@ -1865,7 +2690,8 @@ ChainListener::processNewLedger(std::uint32_t ledgerIdx)
                     accountTx(
                         doorAccStr,
                         hp_.lastLedgerProcessed_,
-                        hp_.startupLedger_,
+                        hp_.markerLedgerMax_ ? hp_.markerLedgerMax_
+                                             : hp_.startupLedger_,
                         hp_.marker_);
                 }
             };
@@ -1879,7 +2705,9 @@ ChainListener::processNewLedger(std::uint32_t ledgerIdx)
             hp_.state_ = HistoryProcessor::WAIT_CB;
             // starts history from the latest ledger
             initStartupLedger(ledgerIdx);
-            accountTx(doorAccStr, hp_.lastLedgerProcessed_, hp_.startupLedger_);
+            if (!startBackfill())
+                accountTx(
+                    doorAccStr, hp_.lastLedgerProcessed_, hp_.startupLedger_);
             break;
         }
         case HistoryProcessor::RETR_LEDGERS:
@@ -1891,6 +2719,86 @@ ChainListener::processNewLedger(std::uint32_t ledgerIdx)
     }
 }
 
+void
+ChainListener::subscribeAccountsStream()
+{
+    accountsSubscribing_ = true;
+
+    Json::Value params;
+    params[ripple::jss::accounts] = Json::arrayValue;
+    params[ripple::jss::accounts].append(
+        ripple::toBase58(bridge_.door(chainType_)));
+    if (!submitAccountStr_.empty())
+        params[ripple::jss::accounts].append(submitAccountStr_);
+
+    send("subscribe", params, [this](Json::Value const& msg) {
+        if (ripple::RPC::contains_error(msg))
+        {
+            // account_tx until the next try
+            JLOGV(
+                j_.warn(),
+                "Can't subscribe to the accounts stream",
+                jv("chainType", to_string(chainType_)),
+                jv("msg", msg));
+            accountsSubscribing_ = false;
+            return;
+        }
+
+        // The ledgers seen before the reply, the stream owns the next ones
+        streamStart_ = streamLedger_ = ledgerIndex_;
+        accountsStream_ = true;
+        JLOGV(
+            j_.info(),
+            "Subscribed to the accounts stream",
+            jv("chainType", to_string(chainType_)),
+            jv("streamStart", streamStart_),
+            jv("ledgerReqMax", ledgerReqMax_));
+        if (streamStart_ > ledgerReqMax_)
+            requestAccountsTx(ledgerReqMax_ + 1, streamStart_);
+    });
+}
+
+void
+ChainListener::processStreamLedger(std::uint32_t ledger)
+{
+    if (ledger <= streamLedger_)
+        return;
+
+    // The transactions of a ledger are pushed just after it, none for the
+    // ledgers not in the stream
+    if (ledger > streamLedger_ + 1)
+    {
+        JLOGV(
+            j_.warn(),
+            "Gap in the ledger stream",
+            jv("chainType", to_string(chainType_)),
+            jv("from", streamLedger_ + 1),
+            jv("to", ledger - 1));
+        requestAccountsTx(streamLedger_ + 1, ledger - 1);
+    }
+    streamLedger_ = ledger;
+
+    // All the transactions before this ledger are in, unless a gap is being
+    // requested
+    if (!inRequest_)
+    {
+        ledgerProcessedDoor_ = ledger - 1;
+        if (!submitAccountStr_.empty())
+            ledgerProcessedSubmit_ = ledger - 1;
+    }
+}
+
+void
+ChainListener::requestAccountsTx(
+    std::uint32_t ledgerMin,
+    std::uint32_t ledgerMax)
+{
+    ledgerReqMax_ = std::max(ledgerReqMax_, ledgerMax);
+    accountTx(ripple::toBase58(bridge_.door(chainType_)), ledgerMin, ledgerMax);
+    if (!submitAccountStr_.empty())
+        accountTx(submitAccountStr_, ledgerMin, ledgerMax);
+}
+
 bool
 ChainListener::processBridgeReq(Json::Value const& msg) const
 {
@@ -1918,6 +2826,58 @@ ChainListener::processBridgeReq(Json::Value const& msg) const
     return bridge == bridge_;
 }
 
+WebsocketClient::Traffic const&
+ChainListener::getWsTraffic() const
+{
+    return conn_->traffic();
+}
+
+metrics::Histogram const&
+ChainListener::getRpcRoundTrip() const
+{
+    return rpcRoundTrip_;
+}
+
+std::vector<ChainListener::NodeHealth>
+ChainListener::getNodesHealth() const
+{
+    auto const maxValidated = maxValidatedLedger();
+
+    std::vector<NodeHealth> ret;
+    auto const active = conn_ ? conn_->endpointIdx() : 0;
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+    {
+        auto const& node = *nodes_[i];
+        auto const validated = node.validatedLedger_.load();
+        ret.push_back(
+            {node.ep_.to_string(),
+             maxValidated > validated ? maxValidated - validated : 0,
+             node.latencyUs_ / 1000,
+             nodeScore(node, maxValidated).has_value(),
+             i == active});
+    }
+    return ret;
+}
+
+metrics::Counter const&
+ChainListener::getHedgedRequests() const
+{
+    return hedgedRequests_;
+}
+
+std::size_t
+ChainListener::getOutstandingRequests() const
+{
+    std::lock_guard lock(callbacksMtx_);
+    return callbacks_.size();
+}
+
+metrics::Counter const&
+ChainListener::getRpcTimeouts() const
+{
+    return rpcTimeouts_;
+}
+
 Json::Value
 ChainListener::getInfo() const
 {
@@ -1932,10 +2892,12 @@ HistoryProcessor::clear()
     state_ = CHECK_BRIDGE;
     stopHistory_ = false;
     marker_.clear();
+    markerLedgerMax_ = 0;
     accoutTxProcessed_ = 0;
     startupLedger_ = 0;
     toRequestLedger_ = 0;
     minValidatedLedger_ = 0;
+    backfill_.clear();
 }
 
 }  // namespace xbwd
@@ -20,7 +20,10 @@
 
 #include <xbwd/basics/ChainTypes.h>
 #include <xbwd/basics/ThreadSaftyAnalysis.h>
+#include <xbwd/basics/TimerWheel.h>
+#include <xbwd/client/ChainConnection.h>
 #include <xbwd/client/WebsocketClient.h>
+#include <xbwd/federator/FeeStrategy.h>
 
 #include <ripple/beast/net/IPEndpoint.h>
 #include <ripple/beast/utility/Journal.h>
@@ -29,16 +32,75 @@
 
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/ip/address.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace xbwd {
 
 class Federator;
 
+// Concurrent retrieval of the history. The ledgers of the history are split
+// into ranges, newest first, requested at the same time. The pages of a range
+// are buffered until the newer ranges are processed, so the transactions are
+// processed in the same order as with one account_tx request at a time.
+struct Backfill
+{
+    // Pages buffered by a range before it stops requesting more
+    static constexpr std::size_t maxPages_ = 8;
+
+    struct Page
+    {
+        Json::Value msg_;
+        // Marker the page was requested with
+        Json::Value marker_;
+        // Error response, the history continues without the backfill
+        bool error_ = false;
+    };
+
+    struct Range
+    {
+        std::uint32_t min_ = 0;
+        std::uint32_t max_ = 0;
+        // Adapted to the response time of the pages
+        std::uint32_t limit_ = 0;
+        std::deque<Page> pages_;
+        // Marker of the next page, held while too many pages are buffered
+        std::optional<Json::Value> next_;
+        // The last page is received
+        bool done_ = false;
+        std::chrono::steady_clock::time_point sent_;
+    };
+
+    std::vector<Range> ranges_;
+    // The range being processed, the later ones are buffered
+    std::size_t current_ = 0;
+    // The responses to a previous backfill are ignored
+    std::uint32_t generation_ = 0;
+
+    bool
+    active() const
+    {
+        return current_ < ranges_.size();
+    }
+
+    void
+    clear()
+    {
+        ranges_.clear();
+        current_ = 0;
+        ++generation_;
+    }
+};
+
 struct HistoryProcessor
 {
     enum state : int {
@@ -57,6 +119,8 @@ struct HistoryProcessor
 
     // Save last history request before requesting for ledgers
     Json::Value marker_;
+    // ledger_index_max of the marker_ request, 0 - startupLedger_
+    std::uint32_t markerLedgerMax_ = 0;
     std::uint32_t accoutTxProcessed_ = 0;
 
     // Ledger that divide transactions on historical and new
@@ -77,6 +141,8 @@ struct HistoryProcessor
     // last processed ledger from previous session
     std::uint32_t lastLedgerProcessed_ = 0;
 
+    Backfill backfill_;
+
     void
     clear();
 };
@@ -87,21 +153,98 @@ private:
     ChainType const chainType_;
 
     ripple::STXChainBridge const bridge_;
+    std::optional<ripple::AccountID> const submitAccount_;
     std::string const submitAccountStr_;
     Federator& federator_;
     std::optional<ripple::AccountID> const signAccount_;
     beast::Journal j_;
 
-    std::unique_ptr<WebsocketClient> wsClient_;
+    // Shared with the listeners of the other bridges of the chain
+    std::shared_ptr<ChainConnection> conn_;
+    // Subscriber index in conn_
+    std::size_t sub_ = 0;
     mutable std::mutex callbacksMtx_;
 
     using RpcCallback = std::function<void(Json::Value const&)>;
-    std::unordered_map<std::uint32_t, RpcCallback> GUARDED_BY(callbacksMtx_)
-        callbacks_;
+    // With the time the request was sent
+    std::unordered_map<
+        std::uint32_t,
+        std::pair<RpcCallback, std::chrono::steady_clock::time_point>>
+        GUARDED_BY(callbacksMtx_) callbacks_;
+    // The requests without a reply in time are answered with a "timeout"
+    // error, after maxTimeoutsInRow_ of them the listener reconnects
+    std::chrono::seconds const rpcTimeout_{30};
+    std::uint32_t const maxTimeoutsInRow_ = 3;
+    // Requests waiting for a reply, the next ones fail with "tooBusy"
+    std::size_t const maxCallbacks_ = 4096;
+    TimerWheel<std::uint32_t> GUARDED_BY(callbacksMtx_)
+        deadlines_{std::chrono::seconds(1), 64};
+    std::unique_ptr<boost::asio::steady_timer> timeoutTimer_;
+    std::atomic_uint32_t timeoutsInRow_ = 0;
+
+    // The next history requests, held while Federator::historyPaused()
+    std::mutex pausedMtx_;
+    std::vector<std::function<void()>> GUARDED_BY(pausedMtx_) paused_;
+    // The held requests of a previous connection are dropped, callback
+    // thread only
+    std::uint32_t pausedGeneration_ = 0;
+    std::chrono::milliseconds const resumeInterval_{100};
+    std::unique_ptr<boost::asio::steady_timer> resumeTimer_;
+    metrics::Counter rpcTimeouts_;
+
+    // From the request to the callback
+    metrics::Histogram rpcRoundTrip_;
+
+    // A rippled node of the chain, probed with server_info on its own
+    // connection. The stream moves to the healthiest node, the hedged
+    // requests go to the best other one.
+    struct Node
+    {
+        beast::IP::Endpoint const ep_;
+        std::unique_ptr<WebsocketClient> ws_;
+        std::mutex callbacksMtx_;
+        std::unordered_map<std::uint32_t, RpcCallback> GUARDED_BY(
+            callbacksMtx_) callbacks_;
+        std::atomic_uint32_t validatedLedger_ = 0;
+        // Moving average of the server_info round trip
+        std::atomic_uint64_t latencyUs_ = 0;
+        // Probes without a reply, the node is down after maxMissed_
+        std::atomic_uint32_t missed_ = 0;
+
+        explicit Node(beast::IP::Endpoint const& ep) : ep_(ep)
+        {
+        }
+    };
+    static constexpr std::uint32_t maxMissed_ = 3;
+    // The stream moves when another node scores that much better, a ledger
+    // of lag scores 1000 and the latency 1 per ms
+    static constexpr std::uint64_t switchMargin_ = 3000;
+    std::chrono::seconds const probeInterval_{4};
+    // Empty with one endpoint
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::unique_ptr<boost::asio::steady_timer> probeTimer_;
+    bool hedgeRequests_ = false;
+    metrics::Counter hedgedRequests_;
 
     std::uint32_t const minUserLedger_ = 3;
     // Maximum transactions per one request for given account.
     std::uint32_t const txLimit_ = 10;
+    // Request account_tx with binary=true, decode the blobs into the typed
+    // transaction and metadata
+    bool const binaryAccountTx_ = false;
+    // Ledger ranges of the history requested concurrently, < 2 - one
+    // account_tx request at a time
+    std::uint32_t const backfillRanges_ = 0;
+    // Once the history is done, the validated transactions of the door and
+    // submit accounts are pushed by the accounts stream. account_tx only
+    // fills the gaps in the ledger stream.
+    bool const subscribeAccounts_ = false;
+    bool accountsStream_ = false;
+    bool accountsSubscribing_ = false;
+    // The stream transactions up to this ledger are requested with account_tx
+    std::uint32_t streamStart_ = 0;
+    // Last ledger of the ledger stream with the accounts stream
+    std::uint32_t streamLedger_ = 0;
     // accout_tx request can be divided into chunks (txLimit_ size) with
     // severeal requests. This flag do not allow other transactions request to
     // be started in the middle of current request.
@@ -114,6 +257,9 @@ private:
     // last ledger that was processed for Signing account (in case of errors /
     // disconnects)
     std::atomic_uint32_t ledgerProcessedSubmit_ = 0;
+    // Signing account ledger saved in the checkpoint of previous session.
+    // The new transactions are requested from there once the history is done.
+    std::uint32_t const submitLedgerCheckpoint_ = 0;
     // To determine ledger boundary acros consecutive requests for given
     // account.
     std::int32_t prevLedgerIndex_ = 0;
@@ -124,6 +270,10 @@ private:
     // current ledger info
     std::atomic_uint32_t ledgerIndex_ = 0;
     std::atomic_uint32_t ledgerFee_ = 0;
+    // fee escalation, from 'fee' and server_info
+    std::atomic_uint32_t openLedgerFee_ = 0;
+    std::atomic_uint32_t loadFactor_ = 1000;
+    std::uint32_t const serverInfoInterval_ = 16;
 
     HistoryProcessor hp_;
 
@@ -135,13 +285,25 @@ public:
         Federator& federator,
         std::optional<ripple::AccountID> signAccount,
         std::uint32_t txLimit,
+        bool binaryAccountTx,
+        std::uint32_t backfillRanges,
+        bool subscribeAccounts,
         std::uint32_t lastLedgerProcessed,
+        std::uint32_t lastSubmitLedgerProcessed,
         beast::Journal j);
 
     ~ChainListener() = default;
 
+    // Subscribe to the connection of the chain, it is connected by its owner
+    // once the listeners of all the bridges are subscribed. The first
+    // endpoint is used for the stream until another node is healthier: the
+    // first listener of the connection probes the nodes and moves it.
     void
-    init(boost::asio::io_service& ios, beast::IP::Endpoint const& ip);
+    init(
+        boost::asio::io_service& ios,
+        std::shared_ptr<ChainConnection> conn,
+        std::vector<beast::IP::Endpoint> const& ips,
+        bool hedgeRequests);
 
     void
     shutdown();
@@ -152,17 +314,49 @@ public:
     Json::Value
     getInfo() const;
 
+    WebsocketClient::Traffic const&
+    getWsTraffic() const;
+
+    metrics::Histogram const&
+    getRpcRoundTrip() const;
+
+    struct NodeHealth
+    {
+        std::string endpoint_;
+        // Validated ledgers behind the most advanced node
+        std::uint32_t lag_ = 0;
+        std::uint64_t latencyMs_ = 0;
+        bool up_ = false;
+        bool active_ = false;
+    };
+
+    // Empty with one endpoint
+    std::vector<NodeHealth>
+    getNodesHealth() const;
+
+    metrics::Counter const&
+    getHedgedRequests() const;
+
+    std::size_t
+    getOutstandingRequests() const EXCLUDES(callbacksMtx_);
+
+    metrics::Counter const&
+    getRpcTimeouts() const;
+
     /**
      * send a RPC and call the callback with the RPC result
      * @param cmd PRC command
      * @param params RPC command parameter
      * @param onResponse callback to process RPC result
+     * @param hedge send to the best other node as well, the first reply is
+     * used
      */
     void
     send(
         std::string const& cmd,
         Json::Value const& params,
-        RpcCallback onResponse);
+        RpcCallback onResponse,
+        bool hedge = false);
 
     // Returns command id that will be returned in the response
     std::uint32_t
@@ -172,8 +366,9 @@ public:
     /**
      * process tx RPC response
      * @param v the response
+     * @return why the transaction is not attested, empty if it is
      */
-    void
+    std::string
     processTx(Json::Value const& v) const;
 
     std::uint32_t
@@ -191,6 +386,9 @@ public:
     std::uint32_t
     getCurrentFee() const;
 
+    FeeState
+    getFeeState() const;
+
 private:
     void
     onMessage(Json::Value const& msg) EXCLUDES(callbacksMtx_);
@@ -201,12 +399,28 @@ private:
     void
     processMessage(Json::Value const& msg);
 
+    // Push the events of a transaction. `Tx` and `Meta` are the JSON or the
+    // typed (binary account_tx) transaction and metadata, `msg` has the
+    // stream fields.
+    template <class Tx, class Meta>
+    void
+    processTransaction(
+        Json::Value const& msg,
+        Tx const& transaction,
+        Meta const& meta);
+
+    // An account_tx page continues with the request of its marker, or with
+    // the next page buffered by the backfill
+    enum class BackfillPage { no, more, last };
+
     void
-    processAccountTx(Json::Value const& msg);
+    processAccountTx(
+        Json::Value const& msg,
+        BackfillPage backfill = BackfillPage::no);
 
     // return true if request is continue
     bool
-    processAccountTxHlp(Json::Value const& msg);
+    processAccountTxHlp(Json::Value const& msg, BackfillPage backfill);
 
     // return true if no errors in response OR account doesn't exist
     bool
@@ -215,6 +429,14 @@ private:
     void
     processServerInfo(Json::Value const& msg);
 
+    void
+    processFee(Json::Value const& msg);
+
+    // The open ledger fee for the attestations of the next ledger, and the
+    // load factor from time to time
+    void
+    requestFees(std::uint32_t ledger);
+
     // return true if no errors in response OR account doesn't exist
     bool
     processSigningAccountInfo(Json::Value const& msg) const;
@@ -238,10 +460,79 @@ private:
     void
     initStartupLedger(std::uint32_t ledger);
 
+    void
+    subscribeAccountsStream();
+
+    // A new ledger with the accounts stream, request the ledgers skipped
+    void
+    processStreamLedger(std::uint32_t ledger);
+
+    // account_tx for the door and submit accounts
+    void
+    requestAccountsTx(std::uint32_t ledgerMin, std::uint32_t ledgerMax);
+
     template <class E>
     void
     pushEvent(E&& e) const;
 
+    void
+    addCallback(std::uint32_t id, RpcCallback onResponse)
+        EXCLUDES(callbacksMtx_);
+
+    // Answer the request with an error, without sending it
+    void
+    failRequest(RpcCallback onResponse, std::string const& error);
+
+    // Answer the requests past their deadline
+    void
+    checkTimeouts() EXCLUDES(callbacksMtx_);
+
+    void
+    scheduleTimeouts();
+
+    // Run the next history request `f` now, or once the federator queues of
+    // the chain drained
+    void
+    unlessPaused(std::function<void()> f) EXCLUDES(pausedMtx_);
+
+    // Send the held history requests on the callback thread, if the queues
+    // drained
+    void
+    resumeHistory() EXCLUDES(pausedMtx_);
+
+    void
+    scheduleResume();
+
+    // return false if the node is not connected
+    bool
+    sendToNode(
+        Node& node,
+        std::string const& cmd,
+        Json::Value const& params,
+        RpcCallback onResponse) const;
+
+    void
+    onNodeMessage(Node& node, Json::Value const& msg) const;
+
+    // Probe the nodes, move the stream to the healthiest one
+    void
+    probeNodes();
+
+    void
+    scheduleProbe();
+
+    // Of the reachable nodes
+    std::uint32_t
+    maxValidatedLedger() const;
+
+    // Score of the reachable nodes, lower is better
+    std::optional<std::uint64_t>
+    nodeScore(Node const& node, std::uint32_t maxValidated) const;
+
+    // Best reachable node other than the stream one
+    Node*
+    hedgeNode() const;
+
     void
     accountTx(
         std::string const& account,
@@ -249,6 +540,32 @@ private:
         std::uint32_t ledger_max = 0,
         Json::Value const& marker = Json::Value());
 
+    Json::Value
+    accountTxParams(
+        std::string const& account,
+        std::uint32_t ledger_min,
+        std::uint32_t ledger_max,
+        Json::Value const& marker,
+        std::uint32_t limit) const;
+
+    // return false if the history is requested one page at a time
+    bool
+    startBackfill();
+
+    void
+    sendBackfillReq(std::size_t idx, Json::Value const& marker);
+
+    void
+    processBackfillPage(
+        std::uint32_t generation,
+        std::size_t idx,
+        Json::Value const& marker,
+        Json::Value const& msg);
+
+    // Process the buffered pages in ledger order
+    void
+    drainBackfill();
+
     void
     accountInfo();
 
@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/client/FlatJson.h>
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace xbwd {
+
+namespace {
+
+class FlatParser
+{
+    std::string_view const doc_;
+    std::size_t pos_ = 0;
+
+public:
+    explicit FlatParser(std::string_view doc) : doc_(doc)
+    {
+    }
+
+    bool
+    parse(Json::Value& jv)
+    {
+        skipWs();
+        if (!consume('{'))
+            return false;
+        jv = Json::Value(Json::objectValue);
+        skipWs();
+        if (consume('}'))
+            return atEnd();
+
+        for (;;)
+        {
+            skipWs();
+            auto const key = string();
+            if (!key)
+                return false;
+            skipWs();
+            if (!consume(':'))
+                return false;
+            skipWs();
+            if (!value(jv[std::string(*key)]))
+                return false;
+            skipWs();
+            if (consume('}'))
+                return atEnd();
+            if (!consume(','))
+                return false;
+        }
+    }
+
+private:
+    bool
+    atEnd()
+    {
+        skipWs();
+        return pos_ == doc_.size();
+    }
+
+    void
+    skipWs()
+    {
+        while (pos_ < doc_.size() &&
+               (doc_[pos_] == ' ' || doc_[pos_] == '\t' ||
+                doc_[pos_] == '\n' || doc_[pos_] == '\r'))
+            ++pos_;
+    }
+
+    bool
+    consume(char c)
+    {
+        if (pos_ >= doc_.size() || doc_[pos_] != c)
+            return false;
+        ++pos_;
+        return true;
+    }
+
+    bool
+    consume(std::string_view word)
+    {
+        if (doc_.substr(pos_, word.size()) != word)
+            return false;
+        pos_ += word.size();
+        return true;
+    }
+
+    // Without escapes, the escaped strings are decoded by Json::Reader
+    std::optional<std::string_view>
+    string()
+    {
+        if (!consume('"'))
+            return {};
+        auto const end = doc_.find_first_of("\"\\", pos_);
+        if (end == std::string_view::npos || doc_[end] != '"')
+            return {};
+        auto const s = doc_.substr(pos_, end - pos_);
+        pos_ = end + 1;
+        return s;
+    }
+
+    // The integers as Json::Reader::decodeNumber: Int if it fits, else UInt
+    bool
+    integer(Json::Value& jv)
+    {
+        auto const end = doc_.find_first_of(",} \t\n\r", pos_);
+        if (end == std::string_view::npos)
+            return false;
+        auto const token = doc_.substr(pos_, end - pos_);
+        std::int64_t v = 0;
+        auto const [p, ec] =
+            std::from_chars(token.data(), token.data() + token.size(), v);
+        if (ec != std::errc() || p != token.data() + token.size())
+            return false;
+        if (v < Json::Value::minInt || v > Json::Value::maxUInt)
+            return false;
+        if (v <= Json::Value::maxInt)
+            jv = static_cast<Json::Int>(v);
+        else
+            jv = static_cast<Json::UInt>(v);
+        pos_ = end;
+        return true;
+    }
+
+    bool
+    value(Json::Value& jv)
+    {
+        if (pos_ >= doc_.size())
+            return false;
+        switch (doc_[pos_])
+        {
+            case '"': {
+                auto const s = string();
+                if (!s)
+                    return false;
+                jv = std::string(*s);
+                return true;
+            }
+            case 't':
+                jv = true;
+                return consume("true");
+            case 'f':
+                jv = false;
+                return consume("false");
+            case 'n':
+                return consume("null");
+            case '-':
+                [[fallthrough]];
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                return integer(jv);
+            default:
+                // Nested object or array
+                return false;
+        }
+    }
+};
+
+}  // namespace
+
+bool
+parseFlatJson(std::string_view doc, Json::Value& jv)
+{
+    return FlatParser(doc).parse(jv);
+}
+
+}  // namespace xbwd
@@ -0,0 +1,40 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/json/json_value.h>
+
+#include <string_view>
+
+namespace xbwd {
+
+/**
+ *  Parse a JSON object with only scalar members, as the ledger stream
+ *  messages, in one pass and without the token stack of Json::Reader.
+ *
+ *  Return false, with `jv` unspecified, as soon as the object has a nested
+ *  object or array (the responses, with their "result"), an escaped string
+ *  or a non-integer number, or is malformed. These are left to
+ *  Json::Reader, which gives the same value for the objects accepted here.
+ */
+bool
+parseFlatJson(std::string_view doc, Json::Value& jv);
+
+}  // namespace xbwd
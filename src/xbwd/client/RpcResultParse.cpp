@@ -20,7 +20,11 @@
 #include <xbwd/client/RpcResultParse.h>
 #include <xbwd/rpc/fromJSON.h>
 
+#include <ripple/basics/StringUtilities.h>
+#include <ripple/protocol/LedgerFormats.h>
 #include <ripple/protocol/SField.h>
+#include <ripple/protocol/Serializer.h>
+#include <ripple/protocol/TxFormats.h>
 #include <ripple/protocol/jss.h>
 
 namespace xbwd {
@@ -281,7 +285,13 @@ parseTxSeq(Json::Value const& transaction)
         if (!transaction.isMember(ripple::jss::Sequence) ||
             !transaction[ripple::jss::Sequence].isIntegral())
             return {};
-        return transaction[ripple::jss::Sequence].asUInt();
+        auto const seq = transaction[ripple::jss::Sequence].asUInt();
+        // Sent with a ticket
+        auto const& ticketField = ripple::sfTicketSequence.getJsonName();
+        if (!seq && transaction.isMember(ticketField) &&
+            transaction[ticketField].isIntegral())
+            return transaction[ticketField].asUInt();
+        return seq;
     }
     catch (...)
     {
@@ -322,5 +332,217 @@ parseDeliveredAmt(Json::Value const& transaction, Json::Value const& meta)
     }
     return deliveredAmt;
 }
+
+namespace {
+
+std::optional<ripple::Blob>
+unHex(Json::Value const& blob)
+{
+    if (!blob.isString())
+        return {};
+    auto data = ripple::strUnHex(blob.asString());
+    if (!data || data->empty())
+        return {};
+    return data;
+}
+
+}  // namespace
+
+std::optional<ripple::STTx>
+parseTxBlob(Json::Value const& blob)
+{
+    try
+    {
+        if (auto const data = unHex(blob))
+        {
+            ripple::SerialIter sit(ripple::makeSlice(*data));
+            return ripple::STTx(sit);
+        }
+    }
+    catch (...)
+    {
+    }
+    return {};
+}
+
+std::optional<ripple::STObject>
+parseMetaBlob(Json::Value const& blob)
+{
+    try
+    {
+        if (auto const data = unHex(blob))
+        {
+            ripple::SerialIter sit(ripple::makeSlice(*data));
+            return ripple::STObject(sit, ripple::sfMetadata);
+        }
+    }
+    catch (...)
+    {
+    }
+    return {};
+}
+
+std::optional<std::uint64_t>
+parseCreateCount(ripple::STObject const& meta)
+{
+    try
+    {
+        if (!meta.isFieldPresent(ripple::sfAffectedNodes))
+            return {};
+        for (auto const& node : meta.getFieldArray(ripple::sfAffectedNodes))
+        {
+            if (node.getFName() != ripple::sfModifiedNode ||
+                node.getFieldU16(ripple::sfLedgerEntryType) !=
+                    ripple::ltBRIDGE ||
+                !node.isFieldPresent(ripple::sfFinalFields))
+                continue;
+            auto const& ff = node.peekAtField(ripple::sfFinalFields)
+                                 .downcast<ripple::STObject>();
+            if (auto const count = ff[~ripple::sfXChainAccountCreateCount])
+                return count;
+        }
+    }
+    catch (...)
+    {
+    }
+    return {};
+}
+
+std::optional<ripple::STAmount>
+parseRewardAmt(ripple::STTx const& transaction)
+{
+    return transaction[~ripple::sfSignatureReward];
+}
+
+std::optional<XChainTxnType>
+parseXChainTxnType(ripple::STTx const& transaction)
+{
+    using enum xbwd::XChainTxnType;
+    switch (transaction.getTxnType())
+    {
+        case ripple::ttXCHAIN_COMMIT:
+            return xChainCommit;
+        case ripple::ttXCHAIN_CLAIM:
+            return xChainClaim;
+        case ripple::ttXCHAIN_CREATE_BRIDGE:
+            return xChainCreateBridge;
+        case ripple::ttXCHAIN_ACCOUNT_CREATE_COMMIT:
+            return xChainAccountCreateCommit;
+        case ripple::ttXCHAIN_ADD_ACCOUNT_CREATE_ATTESTATION:
+            return xChainAddAccountCreateAttestation;
+        case ripple::ttXCHAIN_ADD_CLAIM_ATTESTATION:
+            return xChainAddClaimAttestation;
+        case ripple::ttSIGNER_LIST_SET:
+            return SignerListSet;
+        case ripple::ttACCOUNT_SET:
+            return AccountSet;
+        case ripple::ttREGULAR_KEY_SET:
+            return SetRegularKey;
+        default:
+            break;
+    }
+    return {};
+}
+
+std::optional<ripple::AccountID>
+parseSrcAccount(ripple::STTx const& transaction)
+{
+    return transaction[~ripple::sfAccount];
+}
+
+std::optional<ripple::AccountID>
+parseDstAccount(ripple::STTx const& transaction, XChainTxnType txnType)
+{
+    switch (txnType)
+    {
+        case XChainTxnType::xChainAccountCreateCommit:
+            [[fallthrough]];
+        case XChainTxnType::xChainClaim:
+            return transaction[~ripple::sfDestination];
+        case XChainTxnType::xChainCommit:
+            return transaction[~ripple::sfOtherChainDestination];
+        default:
+            break;
+    }
+    return {};
+}
+
+std::optional<ripple::AccountID>
+parseOtherSrcAccount(ripple::STTx const& transaction, XChainTxnType txnType)
+{
+    switch (txnType)
+    {
+        case XChainTxnType::xChainCommit:
+            [[fallthrough]];
+        case XChainTxnType::xChainAccountCreateCommit:
+            return transaction[~ripple::sfAccount];
+
+        case XChainTxnType::xChainAddClaimAttestation:
+            [[fallthrough]];
+        case XChainTxnType::xChainAddAccountCreateAttestation:
+            return transaction[~ripple::sfOtherChainSource];
+        default:
+            break;
+    }
+    return {};
+}
+
+std::optional<ripple::AccountID>
+parseOtherDstAccount(ripple::STTx const& transaction, XChainTxnType txnType)
+{
+    switch (txnType)
+    {
+        case XChainTxnType::xChainAccountCreateCommit:
+            [[fallthrough]];
+        case XChainTxnType::xChainAddClaimAttestation:
+            [[fallthrough]];
+        case XChainTxnType::xChainAddAccountCreateAttestation:
+            return transaction[~ripple::sfDestination];
+
+        case XChainTxnType::xChainCommit:
+            return transaction[~ripple::sfOtherChainDestination];
+        default:
+            break;
+    }
+    return {};
+}
+
+std::optional<ripple::STXChainBridge>
+parseBridge(ripple::STTx const& transaction)
+{
+    return transaction[~ripple::sfXChainBridge];
+}
+
+std::optional<ripple::uint256>
+parseTxHash(ripple::STTx const& transaction)
+{
+    return transaction.getTransactionID();
+}
+
+std::optional<std::uint32_t>
+parseTxSeq(ripple::STTx const& transaction)
+{
+    auto const seq = transaction.getFieldU32(ripple::sfSequence);
+    // Sent with a ticket
+    if (!seq)
+    {
+        if (auto const ticket = transaction[~ripple::sfTicketSequence])
+            return ticket;
+    }
+    return seq;
+}
+
+std::optional<ripple::STAmount>
+parseDeliveredAmt(
+    ripple::STTx const& transaction,
+    ripple::STObject const& meta)
+{
+    std::optional<ripple::STAmount> deliveredAmt =
+        meta[~ripple::sfDeliveredAmount];
+    // As the JSON parse, override with amount
+    if (auto const amt = transaction[~ripple::sfAmount])
+        deliveredAmt = amt;
+    return deliveredAmt;
+}
 }  // namespace rpcResultParse
 }  // namespace xbwd
@@ -21,6 +21,8 @@
 #include <ripple/json/json_value.h>
 #include <ripple/protocol/AccountID.h>
 #include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STObject.h>
+#include <ripple/protocol/STTx.h>
 #include <ripple/protocol/STXChainBridge.h>
 
 #include <optional>
@@ -83,5 +85,50 @@ parseLedgerSeq(Json::Value const& msg);
 
 std::optional<ripple::STAmount>
 parseDeliveredAmt(Json::Value const& transaction, Json::Value const& meta);
+
+// The binary (binary=true) account_tx entries. The hex blobs are decoded
+// into the typed transaction and metadata, the fields are read from them
+// without the JSON rendering.
+
+std::optional<ripple::STTx>
+parseTxBlob(Json::Value const& blob);
+
+std::optional<ripple::STObject>
+parseMetaBlob(Json::Value const& blob);
+
+std::optional<std::uint64_t>
+parseCreateCount(ripple::STObject const& meta);
+
+std::optional<ripple::STAmount>
+parseRewardAmt(ripple::STTx const& transaction);
+
+std::optional<XChainTxnType>
+parseXChainTxnType(ripple::STTx const& transaction);
+
+std::optional<ripple::AccountID>
+parseSrcAccount(ripple::STTx const& transaction);
+
+std::optional<ripple::AccountID>
+parseDstAccount(ripple::STTx const& transaction, XChainTxnType txnType);
+
+std::optional<ripple::AccountID>
+parseOtherSrcAccount(ripple::STTx const& transaction, XChainTxnType txnType);
+
+std::optional<ripple::AccountID>
+parseOtherDstAccount(ripple::STTx const& transaction, XChainTxnType txnType);
+
+std::optional<ripple::STXChainBridge>
+parseBridge(ripple::STTx const& transaction);
+
+std::optional<ripple::uint256>
+parseTxHash(ripple::STTx const& transaction);
+
+std::optional<std::uint32_t>
+parseTxSeq(ripple::STTx const& transaction);
+
+std::optional<ripple::STAmount>
+parseDeliveredAmt(
+    ripple::STTx const& transaction,
+    ripple::STObject const& meta);
 }  // namespace rpcResultParse
 }  // namespace xbwd
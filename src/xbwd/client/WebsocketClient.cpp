@@ -20,8 +20,10 @@
 #include <xbwd/client/WebsocketClient.h>
 
 #include <xbwd/basics/StructuredLog.h>
+#include <xbwd/client/FlatJson.h>
 
 #include <ripple/basics/Log.h>
+#include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/json/Output.h>
 #include <ripple/json/json_reader.h>
 #include <ripple/json/json_writer.h>
@@ -32,7 +34,10 @@
 
 #include <chrono>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
 #include <unordered_map>
+#include <utility>
 
 using namespace std::chrono_literals;
 
@@ -40,18 +45,6 @@ namespace xbwd {
 
 auto constexpr CONNECT_TIMEOUT = std::chrono::seconds{5};
 
-template <class ConstBuffers>
-std::string
-WebsocketClient::buffer_string(ConstBuffers const& b)
-{
-    using boost::asio::buffer;
-    using boost::asio::buffer_size;
-    std::string s;
-    s.resize(buffer_size(b));
-    buffer_copy(buffer(&s[0], s.size()), b);
-    return s;
-}
-
 void
 WebsocketClient::cleanup()
 {
@@ -97,17 +90,49 @@ WebsocketClient::WebsocketClient(
     boost::asio::io_service& ios,
     beast::IP::Endpoint const& ip,
     std::unordered_map<std::string, std::string> const& headers,
-    beast::Journal j)
+    beast::Journal j,
+    Traffic* traffic,
+    std::string const& threadName)
+    : WebsocketClient(
+          std::move(onMessage),
+          std::move(onConnect),
+          ios,
+          std::vector<beast::IP::Endpoint>{ip},
+          headers,
+          j,
+          traffic,
+          threadName)
+{
+}
+
+WebsocketClient::WebsocketClient(
+    std::function<void(Json::Value const&)> onMessage,
+    std::function<void()> onConnect,
+    boost::asio::io_service& ios,
+    std::vector<beast::IP::Endpoint> const& ips,
+    std::unordered_map<std::string, std::string> const& headers,
+    beast::Journal j,
+    Traffic* traffic,
+    std::string const& threadName)
     : ios_(ios)
     , strand_(ios_)
     , stream_(ios_)
     , ws_(stream_)
     , onMessageCallback_(onMessage)
     , timer_(ios)
-    , ep_(ip.address(), ip.port())
+    , eps_([&ips] {
+        std::vector<boost::asio::ip::tcp::endpoint> eps;
+        for (auto const& ip : ips)
+            eps.emplace_back(ip.address(), ip.port());
+        if (eps.empty())
+            throw std::runtime_error("WebsocketClient: no endpoint");
+        return eps;
+    }())
     , headers_(headers)
     , onConnectCallback_(onConnect)
     , j_{j}
+    , traffic_(traffic)
+    , threadName_(threadName)
     , callbackThread_(&WebsocketClient::runCallbacks, this)
 {
 }
@@ -122,6 +147,7 @@ WebsocketClient::~WebsocketClient()
 void
 WebsocketClient::connect()
 {
+    auto const ep = eps_[epIdx_ % eps_.size()];
     try
     {
         {
@@ -133,27 +159,43 @@ WebsocketClient::connect()
 
             rb_.clear();
             // TODO: Change all the beast::IP:Endpoints to boost endpoints
-            stream_.connect(ep_);
+            stream_.connect(ep);
             ws_.set_option(boost::beast::websocket::stream_base::decorator(
                 [&](boost::beast::websocket::request_type& req) {
                     for (auto const& h : headers_)
                         req.set(h.first, h.second);
                 }));
             ws_.handshake(
-                ep_.address().to_string() + ":" + std::to_string(ep_.port()),
+                ep.address().to_string() + ":" + std::to_string(ep.port()),
                 "/");
             state_ = ST_CONNECTED;
+            auto const epoch = ++epoch_;
+            {
+                std::lock_guard lm(messageMut_);
+                readPaused_ = false;
+            }
+            {
+                // Written to the previous connection or nowhere
+                std::lock_guard lq(writeMut_);
+                writeQueue_.clear();
+                writing_ = false;
+                if (traffic_)
+                    traffic_->writeQueueSize_ = 0;
+            }
 
             JLOGV(
                 j_.info(),
                 "WebsocketClient connected to",
-                jv("ip", ep_.address()),
-                jv("port", ep_.port()));
+                jv("ip", ep.address()),
+                jv("port", ep.port()));
 
             ws_.async_read(
                 rb_,
                 std::bind(
-                    &WebsocketClient::onReadMsg, this, std::placeholders::_1));
+                    &WebsocketClient::onReadMsg,
+                    this,
+                    std::placeholders::_1,
+                    epoch));
         }
 
         onConnectCallback_();
@@ -164,8 +206,10 @@ WebsocketClient::connect()
             j_.debug(),
             "WebsocketClient::exception connecting to endpoint",
             jv("what", e.what()),
-            jv("ip", ep_.address()),
-            jv("port", ep_.port()));
+            jv("ip", ep.address()),
+            jv("port", ep.port()));
+        // Fail over to the next endpoint
+        epIdx_ = (epIdx_ + 1) % eps_.size();
         reconnect("exception in connection");
     }
 }
@@ -199,29 +243,110 @@ WebsocketClient::send(
     auto const id = nextId_++;
     onID(id);
     params[ripple::jss::id] = id;
-    auto const s = to_string(params);
+    auto s = to_string(params);
     JLOGV(
         j_.trace(),
         "WebsocketClient::send",
         jv("chainType", chain),
         jv("msg", params));
-    try
+
+    bool start = false;
     {
-        std::lock_guard l{m_};
-        ws_.write_some(true, boost::asio::buffer(s));
+        std::lock_guard l{writeMut_};
+        writeQueue_.push_back(std::move(s));
+        if (traffic_)
+            traffic_->writeQueueSize_ = writeQueue_.size();
+        start = !std::exchange(writing_, true);
     }
-    catch (...)
+    if (start)
+        ios_.post(strand_.wrap(
+            [this, epoch = epoch_.load()] { doWrite(epoch); }));
+    return id;
+}
+
+void
+WebsocketClient::deliver(Json::Value const& msg)
+{
+    auto const s = to_string(msg);
+    std::lock_guard l(messageMut_);
+    auto b = takeBuffer();
+    b.commit(boost::asio::buffer_copy(
+        b.prepare(s.size()), boost::asio::buffer(s)));
+    receivingQueue_.push_back(std::move(b));
+    if (traffic_)
+        traffic_->queueSize_ = receivingQueue_.size();
+    messageCv_.notify_one();
+}
+
+std::uint32_t
+WebsocketClient::reserveId()
+{
+    return nextId_++;
+}
+
+void
+WebsocketClient::doWrite(std::uint32_t epoch)
+{
     {
-        reconnect("exception at sending data");
+        std::lock_guard l{writeMut_};
+        // connect() reset the queue
+        if (epoch != epoch_)
+            return;
+        if (writeQueue_.empty())
+        {
+            writing_ = false;
+            return;
+        }
+        writeMsg_ = std::move(writeQueue_.front());
+        writeQueue_.pop_front();
+        if (traffic_)
+            traffic_->writeQueueSize_ = writeQueue_.size();
     }
-    return id;
+
+    std::lock_guard l{m_};
+    ws_.async_write(
+        boost::asio::buffer(writeMsg_),
+        strand_.wrap(std::bind(
+            &WebsocketClient::onWriteMsg,
+            this,
+            std::placeholders::_1,
+            std::placeholders::_2,
+            epoch)));
+}
+
+void
+WebsocketClient::onWriteMsg(
+    error_code const& ec,
+    std::size_t size,
+    std::uint32_t epoch)
+{
+    if ((state_ != ST_CONNECTED) || (epoch != epoch_))
+        return;
+
+    if (ec)
+    {
+        JLOGV(j_.error(), "WebsocketClient::onWriteMsg error", jv("ec", ec));
+        reconnect("error writing data");
+        return;
+    }
+
+    if (traffic_)
+    {
+        traffic_->writeMsgs_.inc();
+        traffic_->writeBytes_.inc(size);
+    }
+    doWrite(epoch);
 }
 
 void
-WebsocketClient::onReadMsg(error_code const& ec)
+WebsocketClient::onReadMsg(error_code const& ec, std::uint32_t epoch)
 {
     if (ec)
     {
+        // The read of a connection already closed
+        if ((state_ != ST_CONNECTED) || (epoch != epoch_))
+            return;
+
         boost::beast::websocket::close_reason reason;
         {
             std::lock_guard l{m_};
@@ -239,26 +364,119 @@ WebsocketClient::onReadMsg(error_code const& ec)
         return;
     }
 
+    auto const size = rb_.size();
+    if (traffic_)
+    {
+        traffic_->readMsgs_.inc();
+        traffic_->readBytes_.inc(size);
+    }
+    auto const avg = avgMsgSize_.load(std::memory_order_relaxed);
+    avgMsgSize_.store(avg - avg / 8 + size / 8, std::memory_order_relaxed);
+
+    bool paused = false;
     {
         std::lock_guard l(messageMut_);
         receivingQueue_.push_back(std::move(rb_));
+        rb_ = takeBuffer();
+        if (receivingQueue_.size() >= highWater_)
+        {
+            paused = readPaused_ = true;
+            pausedEpoch_ = epoch;
+        }
+        if (traffic_)
+            traffic_->queueSize_ = receivingQueue_.size();
         messageCv_.notify_one();
     }
 
+    if (paused)
     {
-        std::lock_guard l{m_};
-        if (state_ != ST_CONNECTED)
-            return;
-        rb_.clear();
-        ws_.async_read(
-            rb_,
-            std::bind(
-                &WebsocketClient::onReadMsg, this, std::placeholders::_1));
+        // Resumed by the callback thread
+        if (traffic_)
+            traffic_->readPauses_.inc();
+        JLOGV(
+            j_.warn(),
+            "WebsocketClient::onReadMsg read paused",
+            jv("queueSize", highWater_));
+        return;
     }
+
+    startRead(epoch);
+}
+
+void
+WebsocketClient::startRead(std::uint32_t epoch)
+{
+    std::lock_guard l{m_};
+    if (state_ != ST_CONNECTED || epoch != epoch_)
+        return;
+    ws_.async_read(
+        rb_,
+        std::bind(
+            &WebsocketClient::onReadMsg,
+            this,
+            std::placeholders::_1,
+            epoch));
+}
+
+boost::beast::flat_buffer
+WebsocketClient::takeBuffer()
+{
+    if (!pool_.empty())
+    {
+        auto b = std::move(pool_.back());
+        pool_.pop_back();
+        if (traffic_)
+            traffic_->bufferHits_.inc();
+        return b;
+    }
+
+    if (traffic_)
+        traffic_->bufferMisses_.inc();
+    boost::beast::flat_buffer b;
+    b.reserve(avgMsgSize_.load(std::memory_order_relaxed));
+    return b;
+}
+
+void
+WebsocketClient::recycleBuffers()
+{
+    auto const maxCapacity = 8 * avgMsgSize_.load(std::memory_order_relaxed);
+    std::lock_guard l(messageMut_);
+    for (auto& b : processingQueue_)
+    {
+        if (pool_.size() >= poolSize_)
+            break;
+        if (b.capacity() > maxCapacity)
+            continue;
+        b.clear();
+        pool_.push_back(std::move(b));
+    }
+    processingQueue_.clear();
 }
 
 void
 WebsocketClient::reconnect(std::string_view reason)
+{
+    restart(reason, CONNECT_TIMEOUT);
+}
+
+void
+WebsocketClient::switchEndpoint(std::size_t idx, std::string_view reason)
+{
+    epIdx_ = idx % eps_.size();
+    restart(reason, std::chrono::milliseconds{0});
+}
+
+std::size_t
+WebsocketClient::endpointIdx() const
+{
+    return epIdx_;
+}
+
+void
+WebsocketClient::restart(
+    std::string_view reason,
+    std::chrono::milliseconds delay)
 {
     std::lock_guard<std::mutex> l(shutdownM_);
 
@@ -266,11 +484,15 @@ WebsocketClient::reconnect(std::string_view reason)
         return;
     state_ = ST_INIT;
 
-    JLOGV(j_.info(), "WebsocketClient::reconnect()", jv("reason", reason));
+    JLOGV(
+        j_.info(),
+        "WebsocketClient::reconnect()",
+        jv("reason", reason),
+        jv("endpoint", epIdx_.load()));
 
     boost::system::error_code ecc;
     stream_.close(ecc);
-    timer_.expires_after(CONNECT_TIMEOUT);
+    timer_.expires_after(delay);
     timer_.async_wait([this](boost::system::error_code const& ec) {
         if (ec == boost::asio::error::operation_aborted)
             return;
@@ -287,23 +509,34 @@ WebsocketClient::onReadDone()
 void
 WebsocketClient::runCallbacks()
 {
+    beast::setCurrentThreadName(threadName_);
+
     std::uint64_t maxSize = 0;
+    Json::Reader jr;
 
     for (; state_ != ST_SHUTDOWN;)
     {
-        processingQueue_.clear();
+        std::optional<std::uint32_t> resume;
         {
             std::unique_lock l{messageMut_};
             if (receivingQueue_.empty())
                 messageCv_.wait_for(l, 50ms);
             processingQueue_.swap(receivingQueue_);
+            if (traffic_)
+                traffic_->queueSize_ = 0;
+            if (std::exchange(readPaused_, false))
+                resume = pausedEpoch_;
         }
+        if (resume)
+            ios_.post([this, epoch = *resume] { startRead(epoch); });
 
         auto const x = processingQueue_.size();
 
         if (x > maxSize)
         {
             maxSize = x;
+            if (traffic_)
+                traffic_->maxQueueSize_ = maxSize;
             JLOGV(
                 j_.info(),
                 "WebsocketClient::runCallbacks",
@@ -315,14 +548,22 @@ WebsocketClient::runCallbacks()
             if (state_ == ST_SHUTDOWN)
                 break;
 
-            auto const s = buffer_string(rb.data());
+            auto const data = rb.cdata();
+            std::string_view const s(
+                static_cast<char const*>(data.data()), data.size());
             // JLOGV(j_.trace(), "WebsocketClient::runCallbacks",
             // jv("queueSize", x), jv("msg", s));
+            // The ledger stream messages are flat, the responses are left to
+            // the full parse at their first nested member
             Json::Value jval;
-            Json::Reader jr;
-            jr.parse(s, jval);
+            if (!parseFlatJson(s, jval))
+            {
+                jval = Json::Value();
+                jr.parse(s.data(), s.data() + s.size(), jval);
+            }
             onMessageCallback_(jval);
         }
+        recycleBuffers();
     }
 
     JLOGV(
@@ -19,6 +19,7 @@
 */
 //==============================================================================
 
+#include <xbwd/basics/Metrics.h>
 #include <xbwd/basics/ThreadSaftyAnalysis.h>
 
 #include <ripple/beast/net/IPEndpoint.h>
@@ -28,7 +29,7 @@
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/strand.hpp>
-#include <boost/beast/core/multi_buffer.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/websocket/stream.hpp>
 #include <boost/optional.hpp>
 
@@ -38,17 +39,35 @@
 #include <functional>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace xbwd {
 
 // TODO: Replace this class with `ServerHandler`
 class WebsocketClient
 {
-    using error_code = boost::system::error_code;
+public:
+    // Messages and bytes, read and written. Owned by the user of the client,
+    // so they can be read after the client is gone.
+    struct Traffic
+    {
+        metrics::Counter readMsgs_;
+        metrics::Counter readBytes_;
+        metrics::Counter writeMsgs_;
+        metrics::Counter writeBytes_;
+        // Receive buffers taken from the pool or allocated
+        metrics::Counter bufferHits_;
+        metrics::Counter bufferMisses_;
+        // Reads stopped at the high-water mark of the receive queue
+        metrics::Counter readPauses_;
+        std::atomic_uint64_t queueSize_{0};
+        std::atomic_uint64_t maxQueueSize_{0};
+        // Messages sent and not written yet
+        std::atomic_uint64_t writeQueueSize_{0};
+    };
 
-    template <class ConstBuffers>
-    static std::string
-    buffer_string(ConstBuffers const& b);
+private:
+    using error_code = boost::system::error_code;
 
     // mutex for ws_
     std::mutex m_;
@@ -64,25 +83,60 @@ class WebsocketClient
     boost::asio::ip::tcp::socket stream_;
     boost::beast::websocket::stream<boost::asio::ip::tcp::socket&> GUARDED_BY(
         m_) ws_;
-    boost::beast::multi_buffer rb_;
+    // Contiguous, parsed in place
+    boost::beast::flat_buffer rb_;
 
     std::function<void(Json::Value const&)> onMessageCallback_;
     std::atomic_uint32_t nextId_{0};
 
     boost::asio::basic_waitable_timer<std::chrono::steady_clock> timer_;
-    boost::asio::ip::tcp::endpoint const ep_;
+    // Tried in turn, from the first one
+    std::vector<boost::asio::ip::tcp::endpoint> const eps_;
+    std::atomic_size_t epIdx_{0};
     std::unordered_map<std::string, std::string> const headers_;
     std::function<void()> onConnectCallback_;
     beast::Journal j_;
+    Traffic* const traffic_;
 
     std::mutex messageMut_;
     std::condition_variable messageCv_;
-    std::deque<boost::beast::multi_buffer> receivingQueue_, processingQueue_;
+    std::deque<boost::beast::flat_buffer> receivingQueue_, processingQueue_;
+
+    // The receive buffers go back to the pool once their callbacks run. The
+    // buffers much larger than the average message are released.
+    static constexpr std::size_t poolSize_ = 32;
+    // The reads stop while that many messages wait for the callback thread,
+    // TCP holds rippled back until they are processed
+    static constexpr std::size_t highWater_ = 256;
+    std::vector<boost::beast::flat_buffer> GUARDED_BY(messageMut_) pool_;
+    bool GUARDED_BY(messageMut_) readPaused_ = false;
+    std::uint32_t GUARDED_BY(messageMut_) pausedEpoch_ = 0;
+    // Moving average of the message sizes, reserved in the new buffers
+    std::atomic_size_t avgMsgSize_{4096};
+    // Incremented on connect, the reads and writes of a previous connection
+    // don't continue
+    std::atomic_uint32_t epoch_{0};
+
+    // Outbound messages, written one at a time on the strand. The messages
+    // sent while a write is in flight are written back to back after it.
+    std::mutex writeMut_;
+    std::deque<std::string> GUARDED_BY(writeMut_) writeQueue_;
+    bool GUARDED_BY(writeMut_) writing_ = false;
+    // The message in flight, only used on the strand
+    std::string writeMsg_;
+
+    std::string const threadName_;
     std::thread callbackThread_;
 
     void
     runCallbacks();
 
+    boost::beast::flat_buffer
+    takeBuffer() REQUIRES(messageMut_);
+
+    void
+    recycleBuffers() EXCLUDES(messageMut_);
+
     void
     cleanup();
 
@@ -94,20 +148,42 @@ public:
         boost::asio::io_service& ios,
         beast::IP::Endpoint const& ip,
         std::unordered_map<std::string, std::string> const& headers,
-        beast::Journal j);
+        beast::Journal j,
+        Traffic* traffic = nullptr,
+        std::string const& threadName = "ws callbacks");
+
+    // Connect to the next endpoint when the connection fails
+    WebsocketClient(
+        std::function<void(Json::Value const&)> onMessage,
+        std::function<void()> onConnect,
+        boost::asio::io_service& ios,
+        std::vector<beast::IP::Endpoint> const& ips,
+        std::unordered_map<std::string, std::string> const& headers,
+        beast::Journal j,
+        Traffic* traffic = nullptr,
+        std::string const& threadName = "ws callbacks");
 
     ~WebsocketClient();
 
     void
     connect();
 
-    // Returns command id that will be returned in the response
+    // Returns command id that will be returned in the response. The message
+    // is queued, it is written asynchronously.
     std::uint32_t
     send(
         std::string const& cmd,
         Json::Value params,
         std::string const& chain,
-        std::function<void(std::uint32_t)> onID) EXCLUDES(m_);
+        std::function<void(std::uint32_t)> onID) EXCLUDES(writeMut_);
+
+    // Queue `msg` for the callback thread, as a message received
+    void
+    deliver(Json::Value const& msg) EXCLUDES(messageMut_);
+
+    // An id for a request not sent, answered with deliver()
+    std::uint32_t
+    reserveId();
 
     void
     shutdown() EXCLUDES(shutdownM_);
@@ -115,9 +191,33 @@ public:
     void
     reconnect(std::string_view reason) EXCLUDES(shutdownM_);
 
+    // Reconnect to the endpoint `idx` without waiting
+    void
+    switchEndpoint(std::size_t idx, std::string_view reason)
+        EXCLUDES(shutdownM_);
+
+    // Index of the endpoint connected or tried next
+    std::size_t
+    endpointIdx() const;
+
 private:
     void
-    onReadMsg(error_code const& ec) EXCLUDES(m_);
+    restart(std::string_view reason, std::chrono::milliseconds delay)
+        EXCLUDES(shutdownM_);
+
+    void
+    onReadMsg(error_code const& ec, std::uint32_t epoch) EXCLUDES(m_);
+
+    // Read the next message if `epoch` is the current connection
+    void
+    startRead(std::uint32_t epoch) EXCLUDES(m_);
+
+    // Write the next queued message, on the strand
+    void
+    doWrite(std::uint32_t epoch) EXCLUDES(m_, writeMut_);
+
+    void
+    onWriteMsg(error_code const& ec, std::size_t size, std::uint32_t epoch);
 
     // Called when the read op terminates
     void
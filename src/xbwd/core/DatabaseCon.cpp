@@ -28,18 +28,31 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 namespace xbwd {
 
+namespace {
+
+// PRAGMA auto_vacuum value
+int constexpr autoVacuumIncremental = 2;
+
+}  // namespace
+
 DatabaseCon::DatabaseCon(
     boost::filesystem::path const& pPath,
     std::vector<std::string> const* commonPragma,
     std::vector<std::string> const& pragma,
     std::vector<std::string> const& initSQL,
-    beast::Journal j)
-    : session_(std::make_shared<soci::session>()), j_(j)
+    beast::Journal j,
+    DatabaseSetup const& setup)
+    : session_(std::make_shared<soci::session>())
+    , vacuumPages_(setup.vacuumPages)
+    , j_(j)
 {
     const auto pParent = pPath.parent_path();
     boost::system::error_code ec;
@@ -61,6 +74,55 @@ DatabaseCon::DatabaseCon(
 
     open(*session_, "sqlite", pPath.string());
 
+    // The auto vacuum mode of a database with tables only changes with a
+    // VACUUM, done once here
+    if (setup.vacuumPages)
+    {
+        int mode = 0;
+        *session_ << "PRAGMA auto_vacuum;", soci::into(mode);
+        if (mode != autoVacuumIncremental)
+        {
+            int tables = 0;
+            *session_ << "SELECT COUNT(*) FROM sqlite_master;",
+                soci::into(tables);
+            *session_ << "PRAGMA auto_vacuum=INCREMENTAL;";
+            if (tables)
+            {
+                JLOGV(
+                    j_.warn(),
+                    "vacuum the db for the incremental auto vacuum",
+                    jv("path", pPath.string()),
+                    jv("mode", mode));
+                *session_ << "VACUUM;";
+            }
+        }
+    }
+
+    if (setup.wal)
+    {
+        soci::statement st = session_->prepare << "PRAGMA journal_mode=WAL;";
+        st.execute(true);
+    }
+    if (!setup.synchronous.empty())
+    {
+        static std::array<char const*, 4> const modes{
+            "OFF", "NORMAL", "FULL", "EXTRA"};
+        if (std::none_of(modes.begin(), modes.end(), [&](char const* m) {
+                return boost::iequals(setup.synchronous, m);
+            }))
+        {
+            JLOGV(
+                j_.fatal(),
+                "invalid synchronous mode",
+                jv("mode", setup.synchronous));
+            throw std::runtime_error(
+                "invalid synchronous mode: " + setup.synchronous);
+        }
+        soci::statement st = session_->prepare
+            << ("PRAGMA synchronous=" + setup.synchronous + ";");
+        st.execute(true);
+    }
+
     if (commonPragma)
     {
         for (auto const& p : *commonPragma)
@@ -79,5 +141,137 @@ DatabaseCon::DatabaseCon(
         soci::statement st = session_->prepare << sql;
         st.execute(true);
     }
+
+    if (!setup.wal)
+    {
+        if (setup.readers)
+            JLOGV(
+                j_.warn(),
+                "db readers ignored, WAL journal is off",
+                jv("readers", setup.readers));
+        return;
+    }
+
+    // The tables exist now, the readers can open the database
+    for (std::uint32_t i = 0; i < setup.readers; ++i)
+        readers_.push_back(std::make_unique<Reader>(pPath.string()));
+
+    std::lock_guard l{lock_};
+    checkpointer_ = std::make_unique<WALCheckpointer>(
+        *session_, pPath.string(), setup.checkpointPages, j_);
+}
+
+DatabaseCon::~DatabaseCon()
+{
+    std::lock_guard l{lock_};
+    checkpointer_.reset();
+}
+
+DatabaseCon::Reader::Reader(std::string const& path)
+    : session_(std::make_shared<soci::session>())
+{
+    open(*session_, "sqlite", path);
+    for (auto const p : {"PRAGMA query_only=ON;", "PRAGMA busy_timeout=5000;"})
+    {
+        soci::statement st = session_->prepare << p;
+        st.execute(true);
+    }
 }
+
+void
+DatabaseCon::incrementalVacuum()
+{
+    if (!vacuumPages_)
+        return;
+
+    // The pragma frees one page per step
+    std::lock_guard l{lock_};
+    int freed = 0;
+    soci::statement st =
+        (session_->prepare << "PRAGMA incremental_vacuum(" +
+             std::to_string(vacuumPages_) + ");",
+         soci::into(freed));
+    st.execute();
+    while (st.fetch())
+        ;
+}
+
+thread_local DatabaseCon::Pin* DatabaseCon::pinned_ = nullptr;
+
+LockedSociSession
+DatabaseCon::checkoutReadDb()
+{
+    for (auto* p = pinned_; p; p = p->prev_)
+    {
+        // The mutex is recursive, the pinned session is already locked
+        if (p->db_ == this)
+            return LockedSociSession(p->session_, *p->lock_, p->prepared_);
+    }
+
+    Pin pin;
+    return checkoutReadDb(pin);
+}
+
+LockedSociSession
+DatabaseCon::checkoutReadDb(Pin& pin)
+{
+    auto take = [&pin](auto& session, auto& lock, auto& prepared) {
+        pin.session_ = session;
+        pin.lock_ = &lock;
+        pin.prepared_ = &prepared;
+    };
+
+    if (readers_.empty())
+    {
+        take(session_, lock_, prepared_);
+        return checkoutDb();
+    }
+
+    // Take the first idle reader, starting from the next one in turn. If all
+    // are busy wait on that one.
+    auto const n = readers_.size();
+    auto const start = nextReader_++ % n;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto& r = *readers_[(start + i) % n];
+        std::unique_lock l{r.lock_, std::try_to_lock};
+        if (l.owns_lock())
+        {
+            take(r.session_, r.lock_, r.prepared_);
+            return LockedSociSession(r.session_, std::move(l), &r.prepared_);
+        }
+    }
+
+    auto& r = *readers_[start];
+    take(r.session_, r.lock_, r.prepared_);
+    return LockedSociSession(r.session_, r.lock_, &r.prepared_);
+}
+
+DatabaseCon::PinnedReadDb::PinnedReadDb(DatabaseCon& db)
+    : session_(db.checkoutReadDb(pin_))
+{
+    pin_.db_ = &db;
+    pin_.prev_ = pinned_;
+    pinned_ = &pin_;
+}
+
+DatabaseCon::PinnedReadDb::~PinnedReadDb()
+{
+    pinned_ = pin_.prev_;
+}
+
+void
+DatabaseCon::prepareStatements(PrepareFunc const& prepare)
+{
+    {
+        std::lock_guard l{lock_};
+        prepared_ = prepare(*session_);
+    }
+    for (auto& r : readers_)
+    {
+        std::lock_guard l{r->lock_};
+        r->prepared_ = prepare(*r->session_);
+    }
+}
+
 }  // namespace xbwd
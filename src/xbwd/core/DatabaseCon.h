@@ -18,14 +18,20 @@
 */
 //==============================================================================
 
+#include <xbwd/basics/InstrumentedMutex.h>
 #include <xbwd/core/SociDB.h>
 
 #include <boost/filesystem/path.hpp>
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace soci {
@@ -34,22 +40,46 @@ class session;
 
 namespace xbwd {
 
+// Statement prepared once on a session and executed many times. Derived
+// classes own the variables the statement is bound to, so users only assign
+// them and execute the statement.
+struct PreparedStatement
+{
+    virtual ~PreparedStatement() = default;
+};
+
+using PreparedStatements =
+    std::unordered_map<std::string, std::unique_ptr<PreparedStatement>>;
+
 class LockedSociSession
 {
 public:
-    using mutex = std::recursive_mutex;
+    using mutex = ProfiledMutex<std::recursive_mutex>;
 
 private:
     std::shared_ptr<soci::session> session_;
     std::unique_lock<mutex> lock_;
+    PreparedStatements* prepared_;
 
 public:
-    LockedSociSession(std::shared_ptr<soci::session> it, mutex& m)
-        : session_(std::move(it)), lock_(m)
+    LockedSociSession(
+        std::shared_ptr<soci::session> it,
+        mutex& m,
+        PreparedStatements* prepared = nullptr)
+        : session_(std::move(it)), lock_(m), prepared_(prepared)
+    {
+    }
+    LockedSociSession(
+        std::shared_ptr<soci::session> it,
+        std::unique_lock<mutex>&& lock,
+        PreparedStatements* prepared)
+        : session_(std::move(it)), lock_(std::move(lock)), prepared_(prepared)
     {
     }
     LockedSociSession(LockedSociSession&& rhs) noexcept
-        : session_(std::move(rhs.session_)), lock_(std::move(rhs.lock_))
+        : session_(std::move(rhs.session_))
+        , lock_(std::move(rhs.lock_))
+        , prepared_(rhs.prepared_)
     {
     }
     LockedSociSession() = delete;
@@ -76,22 +106,85 @@ public:
     {
         return bool(session_);
     }
+
+    // Statement prepared by DatabaseCon::prepareStatements(). It is bound to
+    // this session, so it may only be used while the session is checked out.
+    template <class T>
+    T&
+    prepared(std::string const& name)
+    {
+        if (prepared_)
+        {
+            if (auto it = prepared_->find(name); it != prepared_->end())
+                return static_cast<T&>(*it->second);
+        }
+        throw std::logic_error("missing prepared statement: " + name);
+    }
+};
+
+// Tuning of the sqlite connections
+struct DatabaseSetup
+{
+    // Use the write ahead log journal. Readers then never wait on the writer,
+    // and a background thread checkpoints the log.
+    bool wal = false;
+
+    // Value of PRAGMA synchronous: OFF, NORMAL, FULL or EXTRA. Empty - keep
+    // the sqlite default.
+    std::string synchronous;
+
+    // Number of read-only sessions. Only used with the WAL journal.
+    std::uint32_t readers = 0;
+
+    // WAL size (in pages) that trigger a checkpoint
+    std::uint32_t checkpointPages = 1000;
+
+    // Use the incremental auto vacuum, see incrementalVacuum(). An older
+    // database is vacuumed once when opened. 0 - no auto vacuum.
+    std::uint32_t vacuumPages = 0;
 };
 
 class DatabaseCon
 {
+    // Read session checked out by a PinnedReadDb
+    struct Pin
+    {
+        DatabaseCon const* db_ = nullptr;
+        std::shared_ptr<soci::session> session_;
+        LockedSociSession::mutex* lock_ = nullptr;
+        PreparedStatements* prepared_ = nullptr;
+        Pin* prev_ = nullptr;
+    };
+
 public:
+    // While it lives, checkoutReadDb() on the calling thread returns the same
+    // read session, a batch of queries doesn't go back to the pool each time
+    class PinnedReadDb
+    {
+        Pin pin_;
+        LockedSociSession session_;
+
+    public:
+        explicit PinnedReadDb(DatabaseCon& db);
+        ~PinnedReadDb();
+
+        PinnedReadDb(PinnedReadDb const&) = delete;
+        PinnedReadDb&
+        operator=(PinnedReadDb const&) = delete;
+    };
+
     DatabaseCon(
         boost::filesystem::path const& dataDir,
         std::string const& dbName,
         std::vector<std::string> const& pragma,
         std::vector<std::string> const& initSQL,
-        beast::Journal j)
-        : DatabaseCon(dataDir / dbName, nullptr, pragma, initSQL, j)
+        beast::Journal j,
+        DatabaseSetup const& setup = {})
+        : DatabaseCon(dataDir / dbName, nullptr, pragma, initSQL, j, setup)
     {
     }
 
-    ~DatabaseCon() = default;
+    ~DatabaseCon();
 
     soci::session&
     getSession()
@@ -102,18 +195,49 @@ public:
     LockedSociSession
     checkoutDb()
     {
-        return LockedSociSession(session_, lock_);
+        return LockedSociSession(session_, lock_, &prepared_);
+    }
+
+    // Session for queries that don't modify the database. It is taken from
+    // the readers pool, so it does not wait on the writer. Without readers it
+    // is the writer session.
+    LockedSociSession
+    checkoutReadDb();
+
+    using PrepareFunc = std::function<PreparedStatements(soci::session&)>;
+
+    // Prepare the statements used on the hot path, on the writer and on all
+    // the readers. They live as long as the sessions do.
+    void
+    prepareStatements(PrepareFunc const& prepare);
+
+    std::size_t
+    readers() const
+    {
+        return readers_.size();
     }
 
+    // Return up to DatabaseSetup::vacuumPages free pages to the file system,
+    // after the rows were deleted. No-op without the auto vacuum.
+    void
+    incrementalVacuum();
+
 private:
     DatabaseCon(
         boost::filesystem::path const& pPath,
         std::vector<std::string> const* commonPragma,
         std::vector<std::string> const& pragma,
         std::vector<std::string> const& initSQL,
-        beast::Journal j);
+        beast::Journal j,
+        DatabaseSetup const& setup);
 
-    LockedSociSession::mutex lock_;
+    LockedSociSession
+    checkoutReadDb(Pin& pin);
+
+    // Innermost pin of the thread
+    static thread_local Pin* pinned_;
+
+    LockedSociSession::mutex lock_{"db_writer"};
 
     // checkpointer may outlive the DatabaseCon when the checkpointer jobQueue
     // callback locks a weak pointer and the DatabaseCon is then destroyed. In
@@ -123,6 +247,24 @@ private:
     // shared_ptr in this class. session_ will never be null.
     std::shared_ptr<soci::session> const session_;
 
+    // Guarded by lock_
+    PreparedStatements prepared_;
+
+    struct Reader
+    {
+        LockedSociSession::mutex lock_{"db_reader"};
+        std::shared_ptr<soci::session> const session_;
+        PreparedStatements prepared_;  // guarded by lock_
+
+        explicit Reader(std::string const& path);
+    };
+    std::vector<std::unique_ptr<Reader>> readers_;
+    std::atomic_uint32_t nextReader_{0};
+
+    std::unique_ptr<WALCheckpointer> checkpointer_;
+
+    std::uint32_t const vacuumPages_;
+
     beast::Journal j_;
 };
 
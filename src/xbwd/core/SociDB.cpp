@@ -24,9 +24,12 @@
 
 #include <xbwd/core/SociDB.h>
 
+#include <xbwd/basics/StructuredLog.h>
+
 #include <ripple/basics/ByteUtilities.h>
 #include <ripple/basics/Slice.h>
 #include <ripple/basics/contract.h>
+#include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/protocol/PublicKey.h>
 #include <ripple/protocol/SField.h>
 #include <ripple/protocol/STAmount.h>
@@ -40,8 +43,6 @@
 
 namespace xbwd {
 
-static auto checkpointPageCount = 1000;
-
 namespace detail {
 
 std::string
@@ -114,6 +115,93 @@ getKBUsedDB(soci::session& s)
     return 0;  // Silence compiler warning.
 }
 
+WALCheckpointer::WALCheckpointer(
+    soci::session& writer,
+    std::string const& path,
+    std::uint32_t pages,
+    beast::Journal j)
+    : writer_(writer), pages_(static_cast<int>(pages)), j_(j)
+{
+    open(session_, "sqlite", path);
+    // Replaces the sqlite auto checkpoint, which would run on the writer
+    sqlite_api::sqlite3_wal_hook(
+        getConnection(writer_), &WALCheckpointer::walHook, this);
+    thread_ = std::thread(&WALCheckpointer::run, this);
+}
+
+WALCheckpointer::~WALCheckpointer()
+{
+    sqlite_api::sqlite3_wal_hook(getConnection(writer_), nullptr, nullptr);
+    {
+        std::lock_guard l{m_};
+        stop_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+int
+WALCheckpointer::walHook(
+    void* ctx,
+    sqlite_api::sqlite3*,
+    char const*,
+    int pages)
+{
+    auto* const self = static_cast<WALCheckpointer*>(ctx);
+    if (pages >= self->pages_)
+        self->schedule();
+    return SQLITE_OK;
+}
+
+void
+WALCheckpointer::schedule()
+{
+    {
+        std::lock_guard l{m_};
+        pending_ = true;
+    }
+    cv_.notify_one();
+}
+
+void
+WALCheckpointer::run()
+{
+    beast::setCurrentThreadName("DB checkpoint");
+
+    for (;;)
+    {
+        {
+            std::unique_lock l{m_};
+            cv_.wait(l, [this] { return pending_ || stop_; });
+            if (stop_)
+                break;
+            pending_ = false;
+        }
+
+        // Passive mode never waits on the readers or on the writer
+        int log = 0, ckpt = 0;
+        auto const ret = sqlite_api::sqlite3_wal_checkpoint_v2(
+            getConnection(session_),
+            nullptr,
+            SQLITE_CHECKPOINT_PASSIVE,
+            &log,
+            &ckpt);
+        if (ret != SQLITE_OK)
+        {
+            JLOGV(j_.warn(), "WAL checkpoint failed", jv("error", ret));
+            continue;
+        }
+
+        ++checkpoints_;
+        JLOGV(
+            j_.trace(),
+            "WAL checkpoint",
+            jv("logPages", log),
+            jv("checkpointedPages", ckpt));
+    }
+}
+
 soci::blob
 convert(std::vector<std::uint8_t> const& from, soci::session& s)
 {
@@ -183,6 +271,14 @@ convert(ripple::AccountID const& from, soci::session& s)
     return to;
 }
 
+soci::blob
+convert(ripple::uint256 const& from, soci::session& s)
+{
+    soci::blob to(s);
+    to.write(0, reinterpret_cast<char const*>(from.data()), from.size());
+    return to;
+}
+
 }  // namespace xbwd
 
 #if defined(__clang__)
@@ -41,9 +41,14 @@
 #include <ripple/protocol/STXChainBridge.h>
 
 #define SOCI_USE_BOOST
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
+#include <mutex>
 #include <soci/soci.h>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace sqlite_api {
@@ -72,6 +77,60 @@ getKBUsedAll(soci::session& s);
 std::uint32_t
 getKBUsedDB(soci::session& s);
 
+/**
+ *  Checkpoint the write ahead log of a database in a background thread.
+ *
+ *  The WAL hook of the writer session wakes the thread up when the log grows
+ *  over `pages` pages. The checkpoint runs on a session of its own, so the
+ *  writer is never held while the log is copied into the database.
+ */
+class WALCheckpointer
+{
+    soci::session& writer_;
+    soci::session session_;
+    int const pages_;
+    beast::Journal j_;
+
+    std::mutex m_;
+    std::condition_variable cv_;
+    bool pending_ = false;
+    bool stop_ = false;
+    std::atomic_uint64_t checkpoints_{0};
+
+    std::thread thread_;
+
+public:
+    // The writer session must be locked by the caller while the checkpointer
+    // is constructed and destroyed, as it installs and removes the WAL hook
+    WALCheckpointer(
+        soci::session& writer,
+        std::string const& path,
+        std::uint32_t pages,
+        beast::Journal j);
+    ~WALCheckpointer();
+
+    WALCheckpointer(WALCheckpointer const&) = delete;
+    WALCheckpointer&
+    operator=(WALCheckpointer const&) = delete;
+
+    // Request a checkpoint, it is run asynchronously
+    void
+    schedule();
+
+    std::uint64_t
+    checkpoints() const
+    {
+        return checkpoints_;
+    }
+
+private:
+    static int
+    walHook(void* ctx, sqlite_api::sqlite3* conn, char const* db, int pages);
+
+    void
+    run();
+};
+
 template <class T>
 T
 convert(soci::blob&);
@@ -145,6 +204,74 @@ convert(soci::blob& from)
     return a;
 }
 
+template <>
+inline ripple::uint256
+convert(soci::blob& from)
+{
+    ripple::uint256 h;
+    if (h.size() != from.get_len())
+        throw std::runtime_error("Soci blob size mismatch");
+    from.read(0, reinterpret_cast<char*>(h.data()), from.get_len());
+    return h;
+}
+
+// The same for the blob columns of the bulk reads, fetched in std::string
+template <class T>
+T
+convert(std::string const&);
+
+template <>
+inline ripple::Buffer
+convert(std::string const& from)
+{
+    return ripple::Buffer(from.data(), from.size());
+}
+
+template <>
+inline ripple::PublicKey
+convert(std::string const& from)
+{
+    return ripple::PublicKey{ripple::makeSlice(from)};
+}
+
+template <>
+inline ripple::STAmount
+convert(std::string const& from)
+{
+    ripple::SerialIter s(from.data(), from.size());
+    return ripple::STAmount{s, ripple::sfAmount};
+}
+
+template <>
+inline ripple::STXChainBridge
+convert(std::string const& from)
+{
+    ripple::SerialIter s(from.data(), from.size());
+    return ripple::STXChainBridge{s, ripple::sfXChainBridge};
+}
+
+template <>
+inline ripple::AccountID
+convert(std::string const& from)
+{
+    ripple::AccountID a;
+    if (a.size() != from.size())
+        throw std::runtime_error("Soci blob size mismatch");
+    std::memcpy(a.data(), from.data(), from.size());
+    return a;
+}
+
+template <>
+inline ripple::uint256
+convert(std::string const& from)
+{
+    ripple::uint256 h;
+    if (h.size() != from.size())
+        throw std::runtime_error("Soci blob size mismatch");
+    std::memcpy(h.data(), from.data(), from.size());
+    return h;
+}
+
 soci::blob
 convert(std::vector<std::uint8_t> const& from, soci::session& s);
 soci::blob
@@ -159,6 +286,8 @@ soci::blob
 convert(ripple::STXChainBridge const& from, soci::session& s);
 soci::blob
 convert(ripple::AccountID const& from, soci::session& s);
+soci::blob
+convert(ripple::uint256 const& from, soci::session& s);
 
 }  // namespace xbwd
 
@@ -0,0 +1,146 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace xbwd {
+
+/**
+ *  When the in-progress batch of attestations of a chain is submitted.
+ *
+ *  Without a delay, at a ledger boundary of the events, at every new ledger
+ *  and at the cap of a batch. With a delay, the batch keeps filling across
+ *  the ledgers until it reaches the target size or its oldest attestation
+ *  waited the delay, in ledgers of the submitting chain. The cap always
+ *  submits.
+ */
+class AttestCoalescer
+{
+public:
+    enum Reason { fr_size, fr_boundary, fr_deadline, fr_last };
+
+    // Of the submitted batches, the last bucket holds the bigger ones
+    static constexpr std::size_t SizeBuckets = 16;
+
+private:
+    std::size_t const cap_;
+    std::size_t const target_;
+    std::uint32_t const maxDelay_;
+
+    // Ledger of the oldest attestation of the batch
+    std::optional<std::uint32_t> first_;
+
+    std::array<std::uint64_t, fr_last> flushes_{};
+    std::array<std::uint64_t, SizeBuckets> sizes_{};
+    std::uint64_t attests_ = 0;
+
+public:
+    // 0 target - the cap
+    AttestCoalescer(std::size_t cap, std::size_t target, std::uint32_t maxDelay)
+        : cap_(std::max<std::size_t>(cap, 1))
+        , target_(target ? std::clamp<std::size_t>(target, 1, cap_) : cap_)
+        , maxDelay_(maxDelay)
+    {
+    }
+
+    // An attestation was added, `size` are in the batch. Return true if the
+    // batch is to be submitted, it is counted as submitted.
+    bool
+    onAdd(std::size_t size, std::uint32_t ledger, bool ledgerBoundary)
+    {
+        if (!first_)
+            first_ = ledger;
+        if (size >= cap_ || (maxDelay_ && size >= target_))
+            return flush(size, fr_size);
+        if (!maxDelay_ && ledgerBoundary)
+            return flush(size, fr_boundary);
+        if (maxDelay_ && expired(ledger))
+            return flush(size, fr_deadline);
+        return false;
+    }
+
+    // A new ledger of the submitting chain, the same for the batch so far
+    bool
+    onLedger(std::size_t size, std::uint32_t ledger)
+    {
+        if (!size)
+            return false;
+        if (!maxDelay_)
+            return flush(size, fr_boundary);
+        if (expired(ledger))
+            return flush(size, fr_deadline);
+        return false;
+    }
+
+    std::size_t
+    target() const
+    {
+        return target_;
+    }
+
+    std::uint32_t
+    maxDelay() const
+    {
+        return maxDelay_;
+    }
+
+    std::uint64_t
+    flushes(Reason r) const
+    {
+        return flushes_[r];
+    }
+
+    // Batches of `size` attestations, `SizeBuckets` and over for the last
+    std::uint64_t
+    batches(std::size_t size) const
+    {
+        return sizes_[std::clamp<std::size_t>(size, 1, SizeBuckets) - 1];
+    }
+
+    std::uint64_t
+    attestations() const
+    {
+        return attests_;
+    }
+
+private:
+    bool
+    expired(std::uint32_t ledger) const
+    {
+        return first_ && ledger >= *first_ + maxDelay_;
+    }
+
+    bool
+    flush(std::size_t size, Reason r)
+    {
+        ++flushes_[r];
+        ++sizes_[std::min(size, SizeBuckets) - 1];
+        attests_ += size;
+        first_.reset();
+        return true;
+    }
+};
+
+}  // namespace xbwd
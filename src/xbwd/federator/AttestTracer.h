@@ -0,0 +1,255 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/ChainTypes.h>
+#include <xbwd/basics/Metrics.h>
+#include <xbwd/basics/ThreadSaftyAnalysis.h>
+
+#include <boost/container_hash/hash.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace xbwd {
+
+/**
+ *  Latency of the attestations, from the commit transaction to the
+ *  attestation in a validated ledger.
+ *
+ *  A trace is started when the attestation is made, the time of each stage
+ *  is recorded, and the trace is finished when the attestation is confirmed.
+ *  The latency of each stage, from the stage before it, goes to the
+ *  histograms once the trace is finished, and the last finished traces are
+ *  kept. The oldest unfinished traces are dropped when there are too many.
+ */
+class AttestTracer
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    enum Stage {
+        // The listener parsed the commit transaction
+        st_received,
+        // The event loop processed it
+        st_dispatched,
+        // Written to the DB
+        st_dbCommitted,
+        // The attestation transaction was signed, the last time if resubmitted
+        st_signed,
+        // And sent to the chain
+        st_submitted,
+        // In a validated ledger
+        st_confirmed,
+        st_last
+    };
+
+    static constexpr std::array<char const*, st_last> stageNames{
+        "received",
+        "dispatched",
+        "db_committed",
+        "signed",
+        "submitted",
+        "confirmed"};
+
+    // The stage the latency of a stage is measured from. The DB and the
+    // signatures are concurrent, both follow the dispatch.
+    static constexpr std::array<Stage, st_last> previousStage{
+        st_received,
+        st_received,
+        st_dispatched,
+        st_dispatched,
+        st_signed,
+        st_submitted};
+
+    struct Key
+    {
+        // The chain the attestation is submitted to
+        ChainType chain;
+        bool createAccount;
+        // Claim ID or create count
+        std::uint64_t id;
+
+        bool
+        operator==(Key const& o) const = default;
+    };
+
+    struct Trace
+    {
+        Key key;
+        std::chrono::system_clock::time_point wallReceived;
+        std::array<std::optional<clock::time_point>, st_last> stages;
+        std::uint32_t submits = 0;
+    };
+
+private:
+    struct KeyHash
+    {
+        std::size_t
+        operator()(Key const& k) const
+        {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, static_cast<int>(k.chain));
+            boost::hash_combine(seed, k.createAccount);
+            boost::hash_combine(seed, k.id);
+            return seed;
+        }
+    };
+
+    struct by_key
+    {
+    };
+
+    using Container = boost::multi_index::multi_index_container<
+        Trace,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_unique<
+                boost::multi_index::tag<by_key>,
+                boost::multi_index::member<Trace, Key, &Trace::key>,
+                KeyHash>>>;
+
+    std::size_t const maxActive_;
+    std::size_t const keep_;
+
+    mutable std::mutex m_;
+    Container GUARDED_BY(m_) active_;
+    // Newest first
+    std::deque<Trace> GUARDED_BY(m_) finished_;
+
+    std::array<metrics::Histogram, st_last> latency_;
+    metrics::Histogram total_;
+
+public:
+    AttestTracer(std::size_t maxActive, std::size_t keep)
+        : maxActive_(maxActive), keep_(keep)
+    {
+    }
+
+    AttestTracer(AttestTracer const&) = delete;
+    AttestTracer&
+    operator=(AttestTracer const&) = delete;
+
+    void
+    start(Key const& key, clock::time_point received, clock::time_point now)
+        EXCLUDES(m_)
+    {
+        Trace t{key, std::chrono::system_clock::now() - (now - received), {}};
+        t.stages[st_received] = received;
+        t.stages[st_dispatched] = now;
+
+        std::lock_guard l{m_};
+        // Replaces an unfinished trace of the same attestation
+        active_.get<by_key>().erase(key);
+        active_.push_back(std::move(t));
+        while (active_.size() > maxActive_)
+            active_.pop_front();
+    }
+
+    // The keys without a trace are ignored. A confirmation finishes the trace.
+    void
+    record(
+        Stage stage,
+        std::vector<Key> const& keys,
+        clock::time_point now = clock::now()) EXCLUDES(m_)
+    {
+        if (keys.empty())
+            return;
+
+        std::lock_guard l{m_};
+        auto& idx = active_.get<by_key>();
+        for (auto const& key : keys)
+        {
+            auto it = idx.find(key);
+            if (it == idx.end())
+                continue;
+            idx.modify(it, [&](Trace& t) {
+                t.stages[stage] = now;
+                if (stage == st_submitted)
+                    ++t.submits;
+            });
+            if (stage != st_confirmed)
+                continue;
+
+            observe(*it);
+            finished_.push_front(*it);
+            if (finished_.size() > keep_)
+                finished_.pop_back();
+            idx.erase(it);
+        }
+    }
+
+    // At most `limit` finished traces, newest first
+    std::vector<Trace>
+    recent(std::size_t limit) const EXCLUDES(m_)
+    {
+        std::lock_guard l{m_};
+        auto const n = std::min(limit, finished_.size());
+        return {finished_.begin(), finished_.begin() + n};
+    }
+
+    std::size_t
+    active() const EXCLUDES(m_)
+    {
+        std::lock_guard l{m_};
+        return active_.size();
+    }
+
+    // Empty for st_received
+    metrics::Histogram const&
+    latency(Stage stage) const
+    {
+        return latency_[stage];
+    }
+
+    // From the commit transaction to the confirmation
+    metrics::Histogram const&
+    total() const
+    {
+        return total_;
+    }
+
+private:
+    void
+    observe(Trace const& t)
+    {
+        for (std::size_t s = st_dispatched; s < st_last; ++s)
+        {
+            auto const& cur = t.stages[s];
+            auto const& prev = t.stages[previousStage[s]];
+            if (cur && prev && *cur >= *prev)
+                latency_[s].observe(*cur - *prev);
+        }
+        total_.observe(*t.stages[st_confirmed] - *t.stages[st_received]);
+    }
+};
+
+}  // namespace xbwd
@@ -0,0 +1,97 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/ChainTypes.h>
+#include <xbwd/basics/LruCache.h>
+
+#include <ripple/basics/Buffer.h>
+#include <ripple/protocol/AccountID.h>
+#include <ripple/protocol/PublicKey.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STXChainBridge.h>
+
+#include <boost/container_hash/hash.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace xbwd {
+
+// Row of the claim and create account tables answering the witness and
+// witness_account_create requests
+struct AttestationCacheKey
+{
+    // The chain of the commit transaction
+    ChainType chain;
+    bool createAccount;
+    // Claim ID or create count
+    std::uint64_t id;
+
+    bool
+    operator==(AttestationCacheKey const& o) const = default;
+
+    struct Hash
+    {
+        std::size_t
+        operator()(AttestationCacheKey const& k) const
+        {
+            std::size_t seed = 0;
+            boost::hash_combine(seed, static_cast<int>(k.chain));
+            boost::hash_combine(seed, k.createAccount);
+            boost::hash_combine(seed, k.id);
+            return seed;
+        }
+    };
+};
+
+struct CachedAttestation
+{
+    ripple::STXChainBridge bridge;
+    ripple::STAmount deliveredAmt;
+    // Create account only
+    std::optional<ripple::STAmount> rewardAmt;
+    ripple::AccountID sendingAccount;
+    ripple::AccountID rewardAccount;
+    std::optional<ripple::AccountID> otherChainDst;
+    ripple::AccountID signingAccount;
+    ripple::PublicKey publicKey;
+    ripple::Buffer signature;
+
+    // The fields of the request the DB query matches. A request without
+    // destination matches any.
+    bool
+    matches(
+        ripple::STXChainBridge const& b,
+        ripple::STAmount const& amt,
+        std::optional<ripple::STAmount> const& reward,
+        ripple::AccountID const& sending,
+        std::optional<ripple::AccountID> const& dst) const
+    {
+        return bridge == b && deliveredAmt == amt && rewardAmt == reward &&
+            sendingAccount == sending && (!dst || otherChainDst == dst);
+    }
+};
+
+using AttestationCache =
+    LruCache<AttestationCacheKey, CachedAttestation, AttestationCacheKey::Hash>;
+
+}  // namespace xbwd
@@ -20,10 +20,13 @@
 #include <xbwd/federator/Federator.h>
 
 #include <xbwd/app/App.h>
+#include <xbwd/app/AttestationStore.h>
 #include <xbwd/app/DBInit.h>
+#include <xbwd/app/DBStatements.h>
 #include <xbwd/basics/ChainTypes.h>
 #include <xbwd/basics/StructuredLog.h>
 #include <xbwd/client/RpcResultParse.h>
+#include <xbwd/federator/FeeStrategy.h>
 #include <xbwd/federator/TxnSupport.h>
 
 #include <ripple/basics/strHex.h>
@@ -36,6 +39,7 @@
 #include <ripple/protocol/STParsedJSON.h>
 #include <ripple/protocol/STTx.h>
 #include <ripple/protocol/Seed.h>
+#include <ripple/protocol/digest.h>
 #include <ripple/protocol/jss.h>
 
 #include <fmt/core.h>
@@ -45,8 +49,11 @@
 #include <cmath>
 #include <exception>
 #include <future>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 
 namespace xbwd {
 
@@ -64,6 +71,142 @@ make_Federator(
     return r;
 }
 
+namespace {
+
+SubmitWindow
+makeSubmitWindow(config::Config const& config)
+{
+    return SubmitWindow{
+        config.adaptiveWindow ? config.minAttToSend : config.maxAttToSend,
+        config.maxAttToSend};
+}
+
+AttestCoalescer
+makeCoalescer(config::Config const& config)
+{
+#ifdef USE_BATCH_ATTESTATION
+    std::size_t const cap =
+        config.useBatch ? ripple::AttestationBatch::maxAttestations : 1;
+#else
+    std::size_t const cap = 1;
+#endif
+    return AttestCoalescer{cap, config.batchTarget, config.batchMaxDelay};
+}
+
+template <class T>
+struct DBAttest
+{
+    ripple::uint256 transID;
+    std::uint64_t id = 0;
+    T attest;
+};
+
+using DBClaim = DBAttest<ripple::Attestations::AttestationClaim>;
+using DBCreateAccount =
+    DBAttest<ripple::Attestations::AttestationCreateAccount>;
+
+struct DBLoadTimes
+{
+    std::size_t rows = 0;
+    std::size_t decoded = 0;
+    std::uint64_t fetchUs = 0;
+    std::uint64_t decodeUs = 0;
+    std::uint64_t applyUs = 0;
+    std::uint64_t totalUs = 0;
+};
+
+// Scan the rows of the table by chunks. A chunk is decoded on a worker thread
+// while the next one is fetched, the decoded chunks are applied in order on
+// the calling thread.
+template <class Decode, class Apply>
+DBLoadTimes
+bulkLoad(
+    AttestationStore& store,
+    ChainType ct,
+    bool isCreateAccount,
+    Decode&& decode,
+    Apply&& apply)
+{
+    using clock = std::chrono::steady_clock;
+    using Decoded =
+        std::invoke_result_t<Decode&, std::vector<AttestationRow> const&>;
+
+    auto elapsedUs = [](clock::time_point from) -> std::uint64_t {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   clock::now() - from)
+            .count();
+    };
+
+    DBLoadTimes r;
+    auto const start = clock::now();
+
+    std::future<std::pair<Decoded, std::uint64_t>> pending;
+    auto applyPending = [&] {
+        auto [decoded, decodeUs] = pending.get();
+        r.decodeUs += decodeUs;
+        r.decoded += decoded.size();
+        auto const t = clock::now();
+        apply(std::move(decoded));
+        r.applyUs += elapsedUs(t);
+    };
+
+    // The fetch of a chunk is the time since the previous one was handed
+    auto fetchStart = clock::now();
+    store.scan(
+        ct, isCreateAccount, [&](std::vector<AttestationRow>&& rows) {
+            r.fetchUs += elapsedUs(fetchStart);
+            r.rows += rows.size();
+
+            if (pending.valid())
+                applyPending();
+            pending = std::async(
+                std::launch::async,
+                [&decode, &elapsedUs, batch = std::move(rows)] {
+                    auto const t = clock::now();
+                    auto decoded = decode(batch);
+                    return std::make_pair(std::move(decoded), elapsedUs(t));
+                });
+            fetchStart = clock::now();
+        });
+    r.fetchUs += elapsedUs(fetchStart);
+    if (pending.valid())
+        applyPending();
+
+    r.totalUs = elapsedUs(start);
+    return r;
+}
+
+// The traces of the attestations of a submission to chain `ct`
+std::vector<AttestTracer::Key>
+traceKeys(ChainType ct, Submission const& sub)
+{
+    std::vector<AttestTracer::Key> r;
+    r.reserve(sub.numAttestations());
+    sub.forAttestIDs(
+        [&](std::uint64_t id) { r.push_back({ct, false, id}); },
+        [&](std::uint64_t id) { r.push_back({ct, true, id}); });
+    return r;
+}
+
+// The traces of the commit events of a DB batch
+std::vector<AttestTracer::Key>
+traceKeys(std::vector<FederatorDBEvent> const& events)
+{
+    std::vector<AttestTracer::Key> r;
+    for (auto const& event : events)
+    {
+        if (auto const e = std::get_if<event::XChainCommitDetected>(&event))
+            r.push_back({otherChain(e->chainType_), false, e->claimID_});
+        else if (
+            auto const e =
+                std::get_if<event::XChainAccountCreateCommitDetected>(&event))
+            r.push_back({otherChain(e->chainType_), true, e->createCount_});
+    }
+    return r;
+}
+
+}  // namespace
+
 Federator::Chain::Chain(config::ChainConfig const& config)
     : rewardAccount_{config.rewardAccount}
     , txnSubmit_(config.txnSubmit)
@@ -78,27 +221,39 @@ Federator::Federator(
     beast::Journal j)
     : app_{app}
     , bridge_{config.bridge}
+    , bridgeName_{config.name}
     , chains_{Chain{config.lockingChainConfig}, Chain{config.issuingChainConfig}}
     , autoSubmit_{chains_[ChainType::locking].txnSubmit_ &&
                   chains_[ChainType::locking].txnSubmit_->shouldSubmit,
                   chains_[ChainType::issuing].txnSubmit_ &&
                   chains_[ChainType::issuing].txnSubmit_->shouldSubmit}
-    , maxAttToSend_(config.maxAttToSend)
+    , submitWindow_{makeSubmitWindow(config), makeSubmitWindow(config)}
     , signingAccount_(config.signingAccount)
     , keyType_{config.keyType}
     , signingPK_{derivePublicKey(config.keyType, config.signingKey)}
     , signingSK_{config.signingKey}
+    , coalescers_{makeCoalescer(config), makeCoalescer(config)}
     , j_(j)
     , useBatch_(config.useBatch)
+    , retainLedgers_(config.database.retainLedgers)
+    , attestationCache_(config.attestationCacheSize)
+    , signingPool_(config.signingThreads)
 {
     signerListsInfo_[ChainType::locking].ignoreSignerList_ =
         config.lockingChainConfig.ignoreSignerList;
     signerListsInfo_[ChainType::issuing].ignoreSignerList_ =
         config.issuingChainConfig.ignoreSignerList;
 
+    for (auto const ct : {ChainType::locking, ChainType::issuing})
+    {
+        auto const file = bridgeName_.empty()
+            ? fmt::format("replay_{}", to_string(ct))
+            : fmt::format("replay_{}_{}", to_string(ct), bridgeName_);
+        replays_[ct] = std::make_unique<ReplayBuffer>(
+            bridge_, config.dataDir / file, ReplayMemoryBytes);
+    }
+
     std::fill(loopLocked_.begin(), loopLocked_.end(), true);
-    events_[ChainType::locking].reserve(16);
-    events_[ChainType::issuing].reserve(16);
 }
 
 void
@@ -114,7 +269,8 @@ Federator::init(
             auto const sql = fmt::format(
                 R"sql(SELECT ChainType, TransID, LedgerSeq FROM {table_name};
             )sql",
-                fmt::arg("table_name", db_init::xChainSyncTable));
+                fmt::arg(
+                    "table_name", db_init::xChainSyncTableName(bridgeName_)));
 
             std::uint32_t chainType = 0;
             std::string transID;
@@ -139,15 +295,17 @@ Federator::init(
                 }
                 auto const ct = static_cast<ChainType>(chainType);
 
-                if (!initSync_[ct].dbTxnHash_.parseHex(transID))
+                if (transID.size() != ripple::uint256::size())
                 {
                     JLOG(j_.error())
                         << "error reading database: cannot parse transation "
                            "hash "
-                        << transID << ". Recreating init sync table.";
+                        << ripple::strHex(transID)
+                        << ". Recreating init sync table.";
                     return false;
                 }
 
+                initSync_[ct].dbTxnHash_ = convert<ripple::uint256>(transID);
                 initSync_[ct].dbLedgerSqn_ = ledgerSeq;
                 ++rows;
             }
@@ -171,31 +329,33 @@ Federator::init(
                 auto const sql = fmt::format(
                     R"sql(DELETE FROM {table_name};
             )sql",
-                    fmt::arg("table_name", db_init::xChainSyncTable));
+                    fmt::arg(
+                        "table_name",
+                        db_init::xChainSyncTableName(bridgeName_)));
                 *session << sql;
             }
             for (auto const ct : {ChainType::locking, ChainType::issuing})
             {
                 initSync_[ct].dbLedgerSqn_ = 0u;
                 initSync_[ct].dbTxnHash_ = {};
-                auto const txnIdHex = ripple::strHex(
-                    initSync_[ct].dbTxnHash_.begin(),
-                    initSync_[ct].dbTxnHash_.end());
                 auto session = app_.getXChainTxnDB().checkoutDb();
+                soci::blob txnId = convert(initSync_[ct].dbTxnHash_, *session);
                 auto const sql = fmt::format(
                     R"sql(INSERT INTO {table_name}
                       (ChainType, TransID, LedgerSeq)
                       VALUES
                       (:ct, :txnId, :lgrSeq);
                 )sql",
-                    fmt::arg("table_name", db_init::xChainSyncTable));
+                    fmt::arg(
+                        "table_name",
+                        db_init::xChainSyncTableName(bridgeName_)));
 
                 std::uint32_t ledgerSeq = initSync_[ct].dbLedgerSqn_;
                 *session << sql, soci::use(static_cast<std::uint32_t>(ct)),
-                    soci::use(txnIdHex), soci::use(ledgerSeq);
+                    soci::use(txnId), soci::use(ledgerSeq);
             }
             JLOG(j_.info()) << "created DB table for initial sync, "
-                            << db_init::xChainSyncTable;
+                            << db_init::xChainSyncTableName(bridgeName_);
         }
         catch (std::exception& e)
         {
@@ -207,12 +367,113 @@ Federator::init(
         }
     };
 
+    using clock = std::chrono::steady_clock;
+    auto elapsedMs = [](clock::time_point from) -> Json::UInt {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   clock::now() - from)
+            .count();
+    };
+
+    auto fillCheckpoint = [&]() {
+        try
+        {
+            auto session = app_.getXChainTxnDB().checkoutDb();
+            ChainArray<bool> found{false, false};
+            {
+                auto const sql = fmt::format(
+                    R"sql(SELECT ChainType, DoorLedgerSeq, SubmitLedgerSeq
+                          FROM {table_name};
+                )sql",
+                    fmt::arg(
+                        "table_name",
+                        db_init::xChainCheckpointTableName(bridgeName_)));
+
+                std::uint32_t chainType = 0;
+                std::uint32_t doorLedgerSeq = 0;
+                std::uint32_t submitLedgerSeq = 0;
+                soci::statement st =
+                    ((*session).prepare << sql,
+                     soci::into(chainType),
+                     soci::into(doorLedgerSeq),
+                     soci::into(submitLedgerSeq));
+                st.execute();
+                while (st.fetch())
+                {
+                    if (chainType !=
+                            static_cast<std::uint32_t>(ChainType::issuing) &&
+                        chainType !=
+                            static_cast<std::uint32_t>(ChainType::locking))
+                        continue;
+                    auto const ct = static_cast<ChainType>(chainType);
+                    initSync_[ct].dbDoorLedgerSqn_ = doorLedgerSeq;
+                    initSync_[ct].dbSubmitLedgerSqn_ = submitLedgerSeq;
+                    found[ct] = true;
+                }
+            }
+
+            for (auto const ct : {ChainType::locking, ChainType::issuing})
+            {
+                if (found[ct])
+                    continue;
+                auto const sql = fmt::format(
+                    R"sql(INSERT INTO {table_name}
+                      (ChainType, DoorLedgerSeq, SubmitLedgerSeq)
+                      VALUES
+                      (:ct, 0, 0);
+                )sql",
+                    fmt::arg(
+                        "table_name",
+                        db_init::xChainCheckpointTableName(bridgeName_)));
+                *session << sql, soci::use(static_cast<std::uint32_t>(ct));
+            }
+        }
+        catch (std::exception& e)
+        {
+            JLOGV(
+                j_.fatal(),
+                "error reading checkpoint table.",
+                jv("what", e.what()));
+            throw;
+        }
+
+        // The door account was processed up to its checkpoint, the history
+        // scan stops there.
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
+        {
+            auto& is = initSync_[ct];
+            if (is.dbDoorLedgerSqn_ > is.dbLedgerSqn_)
+            {
+                JLOGV(
+                    j_.info(),
+                    "resume from checkpoint",
+                    jv("chainType", to_string(ct)),
+                    jv("DB ledgerSqn", is.dbLedgerSqn_.load()),
+                    jv("door ledgerSqn", is.dbDoorLedgerSqn_),
+                    jv("submit ledgerSqn", is.dbSubmitLedgerSqn_));
+                is.dbLedgerSqn_ = is.dbDoorLedgerSqn_;
+            }
+        }
+    };
+
+    auto t = clock::now();
     if (!fillLastTxHash())
         initializeInitSyncTable();
+    fillCheckpoint();
+    JLOGV(j_.info(), "startup init sync table", jv("ms", elapsedMs(t)));
+
+    // The attestations are loaded while the listeners connect. The listeners
+    // only push events, they are processed once the load is finished, see
+    // unlockMainLoop().
+    dbLoad_ = std::async(std::launch::async, [this] {
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
+        {
+            readDBAttests(ct);
+            readDBAttested(ct);
+        }
+    });
 
     for (auto const ct : {ChainType::locking, ChainType::issuing})
     {
-        readDBAttests(ct);
         JLOGV(
             j_.info(),
             "Prepare init sync",
@@ -246,7 +507,11 @@ Federator::init(
             *this,
             config.signingAccount,
             config.txLimit,
+            config.binaryAccountTx,
+            config.backfillRanges,
+            config.subscribeAccounts,
             initSync_[ChainType::locking].dbLedgerSqn_,
+            initSync_[ChainType::locking].dbSubmitLedgerSqn_,
             l.journal("LListener"));
 
     std::unique_ptr<ChainListener> sidechainListener =
@@ -257,124 +522,113 @@ Federator::init(
             *this,
             config.signingAccount,
             config.txLimit,
+            config.binaryAccountTx,
+            config.backfillRanges,
+            config.subscribeAccounts,
             initSync_[ChainType::issuing].dbLedgerSqn_,
+            initSync_[ChainType::issuing].dbSubmitLedgerSqn_,
             l.journal("IListener"));
 
+    t = clock::now();
     chains_[ChainType::locking].listener_ = std::move(mainchainListener);
+    auto const endpoints = [](config::ChainConfig const& cc) {
+        std::vector<beast::IP::Endpoint> eps{cc.chainIp};
+        eps.insert(eps.end(), cc.fallbackIps.begin(), cc.fallbackIps.end());
+        return eps;
+    };
     chains_[ChainType::locking].listener_->init(
-        ios, config.lockingChainConfig.chainIp);
+        app_.get_io_service(ChainType::locking),
+        app_.chainConnection(ChainType::locking),
+        endpoints(config.lockingChainConfig),
+        config.lockingChainConfig.hedgeRequests);
     chains_[ChainType::issuing].listener_ = std::move(sidechainListener);
     chains_[ChainType::issuing].listener_->init(
-        ios, config.issuingChainConfig.chainIp);
+        app_.get_io_service(ChainType::issuing),
+        app_.chainConnection(ChainType::issuing),
+        endpoints(config.issuingChainConfig),
+        config.issuingChainConfig.hedgeRequests);
+    JLOGV(j_.info(), "startup listeners init", jv("ms", elapsedMs(t)));
 }
 
 void
 Federator::readDBAttests(ChainType ct)
 {
     auto const oct = otherChain(ct);
-    int commits = 0;
-    int creates = 0;
-
-    try
-    {
-        auto const& tblName = db_init::xChainCreateAccountTableName(ct);
-        auto session = app_.getXChainTxnDB().checkoutDb();
-        soci::blob amtBlob(*session);
-        soci::blob rewardAmtBlob(*session);
-        soci::blob bridgeBlob(*session);
-        soci::blob sendingAccountBlob(*session);
-        soci::blob rewardAccountBlob(*session);
-        soci::blob otherChainDstBlob(*session);
-        soci::blob signingAccountBlob(*session);
-        soci::blob publicKeyBlob(*session);
-        soci::blob signatureBlob(*session);
-
-        std::string transID;
-        int ledgerSeq;
-        int createCount;
-        int success;
-
-        auto const sql = fmt::format(
-            R"sql(SELECT TransID, LedgerSeq, CreateCount, Success, DeliveredAmt, RewardAmt,
-                     Bridge, SendingAccount, RewardAccount, OtherChainDst,
-                     SigningAccount, PublicKey, Signature
-                  FROM {table_name} ORDER BY CreateCount;
-        )sql",
-            fmt::arg("table_name", tblName));
-
-        soci::indicator otherChainDstInd;
-        soci::statement st =
-            ((*session).prepare << sql,
-             soci::into(transID),
-             soci::into(ledgerSeq),
-             soci::into(createCount),
-             soci::into(success),
-             soci::into(amtBlob),
-             soci::into(rewardAmtBlob),
-             soci::into(bridgeBlob),
-             soci::into(sendingAccountBlob),
-             soci::into(rewardAccountBlob),
-             soci::into(otherChainDstBlob, otherChainDstInd),
-             soci::into(signingAccountBlob),
-             soci::into(publicKeyBlob),
-             soci::into(signatureBlob));
-        st.execute();
+    bool const wasLockingSend = ct == ChainType::locking;
 
-        ripple::STXChainBridge bridge;
+    // Called on the decoding thread
+    auto checkDBBridge = [this](std::string const& b) {
+        auto const bridge = convert<ripple::STXChainBridge>(b);
+        if (bridge == bridge_)
+            return true;
+        JLOGV(
+            j_.warn(),
+            "readDBAttests bridge mismatch, skipping attestation",
+            jv("db bridge", bridge.getJson(ripple::JsonOptions::none)),
+            jv("current bridge", bridge_.getJson(ripple::JsonOptions::none)));
+        return false;
+    };
 
-        while (st.fetch())
+    // The submissions are pushed under the lock, with the NetworkID known at
+    // that time. A later NetworkID is set by setNetworkID().
+    auto pushSubmissions = [&](std::vector<SubmissionPtr>&& subs) {
+        std::lock_guard tl{txnsMutex_};
+        for (auto& p : subs)
         {
-            auto signingAccount =
-                convert<ripple::AccountID>(signingAccountBlob);
-            auto signingPK = convert<ripple::PublicKey>(publicKeyBlob);
-            auto sigBuf = convert<ripple::Buffer>(signatureBlob);
-            auto sendingAmount = convert<ripple::STAmount>(amtBlob);
-            auto rewardAmount = convert<ripple::STAmount>(rewardAmtBlob);
-            auto sendingAccount =
-                convert<ripple::AccountID>(sendingAccountBlob);
-            auto rewardAccount = convert<ripple::AccountID>(rewardAccountBlob);
-            auto dstAccount = convert<ripple::AccountID>(otherChainDstBlob);
-            auto bridge = convert<ripple::STXChainBridge>(bridgeBlob);
-            if (bridge != bridge_)
-            {
-                JLOGV(
-                    j_.warn(),
-                    "readDBAttests bridge mismatch, skipping attestation",
-                    jv("db bridge", bridge.getJson(ripple::JsonOptions::none)),
-                    jv("current bridge",
-                       bridge_.getJson(ripple::JsonOptions::none)));
-                continue;
-            }
-
-            txnsInProcessing_[ct].insert(
-                {fmt::format("create: {:x}", createCount), transID});
-            if (!autoSubmit_[ct])
-                continue;
-
-            // The attestation will be created by the other chain
-            auto p = SubmissionPtr(new SubmissionCreateAccount(
-                0,  // will be updated when new ledger arrive
-                0,  // will be updated if resubmitted
-                0,  // will be updated when NetworkID arrive
-                bridge,
-                ripple::Attestations::AttestationCreateAccount{
-                    signingAccount,
-                    signingPK,
-                    sigBuf,
-                    sendingAccount,
-                    sendingAmount,
-                    rewardAmount,
-                    rewardAccount,
-                    ct == ChainType::locking,
-                    static_cast<std::uint64_t>(createCount),
-                    dstAccount}));
-            {
-                std::lock_guard tl{txnsMutex_};
-                submitted_[oct].emplace_back(std::move(p));
-            }
-
-            ++creates;
+            p->networkID_ = networkID_[oct];
+            submitted_[oct].push_back(std::move(p));
         }
+    };
+
+    DBLoadTimes creates;
+    try
+    {
+        creates = bulkLoad(
+            app_.attestationStore(bridgeName_),
+            ct,
+            true,
+            [&](std::vector<AttestationRow> const& rows) {
+                std::vector<DBCreateAccount> r;
+                r.reserve(rows.size());
+                for (auto const& row : rows)
+                {
+                    if (!checkDBBridge(row.bridge))
+                        continue;
+                    r.push_back(
+                        {row.txnHash,
+                         row.id,
+                         ripple::Attestations::AttestationCreateAccount{
+                             convert<ripple::AccountID>(row.signingAccount),
+                             convert<ripple::PublicKey>(row.publicKey),
+                             convert<ripple::Buffer>(row.signature),
+                             convert<ripple::AccountID>(row.sendingAccount),
+                             convert<ripple::STAmount>(row.amt),
+                             convert<ripple::STAmount>(row.rewardAmt),
+                             convert<ripple::AccountID>(row.rewardAccount),
+                             wasLockingSend,
+                             row.id,
+                             convert<ripple::AccountID>(row.otherChainDst)}});
+                }
+                return r;
+            },
+            [&](auto&& attests) {
+                std::vector<SubmissionPtr> subs;
+                for (auto& a : attests)
+                {
+                    txnsInProcessing_[ct].insert({{true, a.id}, a.transID});
+                    if (!autoSubmit_[ct])
+                        continue;
+
+                    // The attestation will be created by the other chain
+                    subs.push_back(SubmissionPtr(new SubmissionCreateAccount(
+                        0,  // will be updated when new ledger arrive
+                        0,  // will be updated if resubmitted
+                        0,  // set when pushed
+                        bridge_,
+                        std::move(a.attest))));
+                }
+                pushSubmissions(std::move(subs));
+            });
     }
     catch (std::exception& e)
     {
@@ -385,119 +639,119 @@ Federator::readDBAttests(ChainType ct)
         throw;
     }
 
+    DBLoadTimes commits;
     try
     {
-        auto const& tblName = db_init::xChainTableName(ct);
-        auto session = app_.getXChainTxnDB().checkoutDb();
-        soci::blob amtBlob(*session);
-        soci::blob bridgeBlob(*session);
-        soci::blob sendingAccountBlob(*session);
-        soci::blob rewardAccountBlob(*session);
-        soci::blob otherChainDstBlob(*session);
-        soci::blob signingAccountBlob(*session);
-        soci::blob publicKeyBlob(*session);
-        soci::blob signatureBlob(*session);
-
-        std::string transID;
-        int ledgerSeq;
-        int claimID;
-        int success;
+        commits = bulkLoad(
+            app_.attestationStore(bridgeName_),
+            ct,
+            false,
+            [&](std::vector<AttestationRow> const& rows) {
+                std::vector<DBClaim> r;
+                r.reserve(rows.size());
+                for (auto const& row : rows)
+                {
+                    if (!checkDBBridge(row.bridge))
+                        continue;
+                    std::optional<ripple::AccountID> optDst;
+                    if (!row.otherChainDst.empty())
+                        optDst = convert<ripple::AccountID>(row.otherChainDst);
+                    r.push_back(
+                        {row.txnHash,
+                         row.id,
+                         ripple::Attestations::AttestationClaim{
+                             convert<ripple::AccountID>(row.signingAccount),
+                             convert<ripple::PublicKey>(row.publicKey),
+                             convert<ripple::Buffer>(row.signature),
+                             convert<ripple::AccountID>(row.sendingAccount),
+                             convert<ripple::STAmount>(row.amt),
+                             convert<ripple::AccountID>(row.rewardAccount),
+                             wasLockingSend,
+                             row.id,
+                             optDst}});
+                }
+                return r;
+            },
+            [&](auto&& attests) {
+                std::vector<SubmissionPtr> subs;
+                for (auto& a : attests)
+                {
+                    txnsInProcessing_[ct].insert({{false, a.id}, a.transID});
+                    if (!autoSubmit_[ct])
+                        continue;
+
+                    // The attestation will be created by the other chain
+                    subs.push_back(SubmissionPtr(new SubmissionClaim(
+                        0,  // will be updated when new ledger arrive
+                        0,  // will be updated if resubmitted
+                        0,  // set when pushed
+                        bridge_,
+                        std::move(a.attest))));
+                }
+                pushSubmissions(std::move(subs));
+            });
+    }
+    catch (std::exception& e)
+    {
+        JLOGV(
+            j_.fatal(),
+            "readDBAttests error reading commit table.",
+            jv("what", e.what()));
+        throw;
+    }
+
+    auto toJson = [](DBLoadTimes const& t) {
+        Json::Value r{Json::objectValue};
+        r["rows"] = static_cast<Json::UInt>(t.rows);
+        r["decoded"] = static_cast<Json::UInt>(t.decoded);
+        r["fetch_ms"] = static_cast<Json::UInt>(t.fetchUs / 1000);
+        r["decode_ms"] = static_cast<Json::UInt>(t.decodeUs / 1000);
+        r["apply_ms"] = static_cast<Json::UInt>(t.applyUs / 1000);
+        r["total_ms"] = static_cast<Json::UInt>(t.totalUs / 1000);
+        return r;
+    };
+    JLOGV(
+        j_.info(),
+        "readDBAttests",
+        jv("chainType", to_string(ct)),
+        jv("commit", toJson(commits)),
+        jv("create account", toJson(creates)));
+}
 
+void
+Federator::readDBAttested(ChainType ct)
+{
+    auto& attested = initSync_[ct].dbAttestedTx_;
+    try
+    {
+        auto session = app_.getXChainTxnDB().checkoutDb();
         auto const sql = fmt::format(
-            R"sql(SELECT TransID, LedgerSeq, ClaimID, Success, DeliveredAmt,
-                     Bridge, SendingAccount, RewardAccount, OtherChainDst,
-                     SigningAccount, PublicKey, Signature
-                  FROM {table_name} ORDER BY ClaimID;
+            R"sql(SELECT Digest FROM {table_name};
         )sql",
-            fmt::arg("table_name", tblName));
-
-        soci::indicator otherChainDstInd;
-        soci::statement st =
-            ((*session).prepare << sql,
-             soci::into(transID),
-             soci::into(ledgerSeq),
-             soci::into(claimID),
-             soci::into(success),
-             soci::into(amtBlob),
-             soci::into(bridgeBlob),
-             soci::into(sendingAccountBlob),
-             soci::into(rewardAccountBlob),
-             soci::into(otherChainDstBlob, otherChainDstInd),
-             soci::into(signingAccountBlob),
-             soci::into(publicKeyBlob),
-             soci::into(signatureBlob));
-        st.execute();
+            fmt::arg(
+                "table_name",
+                db_init::xChainAttestedTableName(ct, bridgeName_)));
 
+        std::string digest;
+        soci::statement st = ((*session).prepare << sql, soci::into(digest));
+        st.execute();
         while (st.fetch())
-        {
-            auto signingAccount =
-                convert<ripple::AccountID>(signingAccountBlob);
-            auto signingPK = convert<ripple::PublicKey>(publicKeyBlob);
-            auto sigBuf = convert<ripple::Buffer>(signatureBlob);
-            auto sendingAmount = convert<ripple::STAmount>(amtBlob);
-            auto sendingAccount =
-                convert<ripple::AccountID>(sendingAccountBlob);
-            auto rewardAccount = convert<ripple::AccountID>(rewardAccountBlob);
-
-            std::optional<ripple::AccountID> optDst;
-            if (otherChainDstInd == soci::i_ok)
-            {
-                optDst.emplace();
-                *optDst = convert<ripple::AccountID>(otherChainDstBlob);
-            }
-
-            auto bridge = convert<ripple::STXChainBridge>(bridgeBlob);
-            if (bridge != bridge_)
-            {
-                JLOGV(
-                    j_.warn(),
-                    "readDBAttests bridge mismatch, skipping attestation",
-                    jv("db bridge", bridge.getJson(ripple::JsonOptions::none)),
-                    jv("current bridge",
-                       bridge_.getJson(ripple::JsonOptions::none)));
-                continue;
-            }
-
-            txnsInProcessing_[ct].insert(
-                {fmt::format("claim: {:x}", claimID), transID});
-            if (!autoSubmit_[ct])
-                continue;
-
-            // The attestation will be created by the other chain
-            auto p = SubmissionPtr(new SubmissionClaim(
-                0,  // will be updated when new ledger arrive
-                0,  // will be updated if resubmitted
-                0,  // will be updated when NetworkID arrive
-                bridge,
-                ripple::Attestations::AttestationClaim{
-                    signingAccount,
-                    signingPK,
-                    sigBuf,
-                    sendingAccount,
-                    sendingAmount,
-                    rewardAccount,
-                    ct == ChainType::locking,
-                    static_cast<std::uint64_t>(claimID),
-                    optDst}));
-            {
-                std::lock_guard tl{txnsMutex_};
-                submitted_[oct].emplace_back(std::move(p));
-            }
-
-            ++commits;
-        }
+            attested.insert(convert<ripple::uint256>(digest));
     }
     catch (std::exception& e)
     {
         JLOGV(
             j_.fatal(),
-            "readDBAttests error reading commit table.",
+            "readDBAttested error reading attested table.",
             jv("what", e.what()));
         throw;
     }
 
-    JLOG(j_.info()) << "readDBAttests " << to_string(ct) << " commit "
-                    << commits << " create account " << creates;
+    JLOGV(
+        j_.info(),
+        "readDBAttested",
+        jv("chainType", to_string(ct)),
+        jv("digests", static_cast<Json::UInt>(attested.size())));
 }
 
 Federator::~Federator()
@@ -542,11 +796,10 @@ Federator::stop()
     if (running_)
     {
         requestStop_ = true;
-        for (int i = 0; i < lt_last; ++i)
-        {
-            std::lock_guard l(cvMutexes_[i]);
-            cvs_[i].notify_all();
-        }
+        for (auto& q : events_)
+            q.close();
+        dbEvents_.close();
+        submitWakeup_.notify();
 
         for (int i = 0; i < lt_last; ++i)
             if (threads_[i].joinable())
@@ -560,37 +813,27 @@ Federator::push(FederatorEvent&& e)
 {
     ChainType ct;
     std::visit([&ct](auto const& e) { ct = e.chainType_; }, e);
-    LoopTypes const lt =
-        ct == ChainType::locking ? lt_event_locking : lt_event_issuing;
-
-    bool notify = false;
-    {
-        std::lock_guard l{eventsMutex_};
-        notify = events_[ct].empty();
-        events_[ct].push_back(std::move(e));
-    }
-    if (notify)
-    {
-        std::lock_guard l(cvMutexes_[lt]);
-        cvs_[lt].notify_all();
-    }
+    metrics_.events_[ct][e.index()].inc();
+    events_[ct].push(std::move(e));
 }
 
 void
 Federator::pushDB(FederatorDBEvent&& e)
 {
-    auto const lt = lt_db;
-    bool notify = false;
-    {
-        std::lock_guard l{eventsMutex_};
-        notify = dbEvents_.empty();
-        dbEvents_.push_back(std::move(e));
-    }
-    if (notify)
+    dbEvents_.push(std::move(e));
+}
+
+void
+Federator::pushDBLedger(event::DBUpdateLedger const& e)
+{
     {
-        std::lock_guard l(cvMutexes_[lt]);
-        cvs_[lt].notify_one();
+        std::lock_guard l{dbLedgerMutex_};
+        auto& slot = dbLedgerSlot_[e.chainType_];
+        if (slot)
+            ++dbStats_.ledgerCoalesced_;
+        slot = e;
     }
+    dbEvents_.notify();
 }
 
 // Called from 2 events that require attestations
@@ -621,31 +864,12 @@ Federator::initSync(
     bool const skip = historical && initSync_[ct].historyDone_;
     if (!skip)
     {
-        {
-            // TODO remove after tests or when adding multiple bridges
-            // assert order of insertion, so that the replay later will be in
-            // order
-            static ChainArray<std::int32_t> rpcOrderNew{-1, -1};
-            static ChainArray<std::int32_t> rpcOrderOld{0, 0};
-            JLOG(j_.trace()) << "initSync " << to_string(ct)
-                             << ", rpcOrderNew=" << rpcOrderNew[ct]
-                             << " rpcOrderOld=" << rpcOrderOld[ct]
-                             << " rpcOrder=" << rpcOrder;
-            if (historical)
-            {
-                assert(rpcOrderOld[ct] > rpcOrder);
-                rpcOrderOld[ct] = rpcOrder;
-            }
-            else
-            {
-                assert(rpcOrderNew[ct] < rpcOrder);
-                rpcOrderNew[ct] = rpcOrder;
-            }
-        }
+        JLOG(j_.trace()) << "initSync " << to_string(ct)
+                         << " rpcOrder=" << rpcOrder;
         if (historical)
-            replays_[ct].emplace_front(e);
+            replays_[ct]->pushFront(e);
         else
-            replays_[ct].emplace_back(e);
+            replays_[ct]->pushBack(e);
     }
 
     tryFinishInitSync(ct);
@@ -675,6 +899,17 @@ AttestedHistoryTx::fromEvent(FederatorEvent const& r)
         return {};
 }
 
+ripple::uint256
+AttestedHistoryTx::digest() const
+{
+    return ripple::sha512Half(
+        static_cast<std::uint32_t>(type_),
+        src_,
+        dst_,
+        createCount_ ? *createCount_ : 0,
+        claimID_ ? *claimID_ : 0);
+}
+
 void
 Federator::tryFinishInitSync(ChainType const ct)
 {
@@ -690,16 +925,20 @@ Federator::tryFinishInitSync(ChainType const ct)
             "initSyncDone",
             jv("chainType", to_string(ct)),
             jv("account", toBase58(bridge_.door(ct))),
-            jv("events to replay", replays_[ct].size()));
+            jv("events to replay", replays_[ct]->size()),
+            jv("spilled bytes", replays_[ct]->fileBytes()));
 
         initSync_[ct].syncing_ = false;
         chains_[ct].listener_->stopHistoricalTxns();
 
+        // The attestations to this chain are expired and resubmitted from
+        // now on, the held events wait for the other chain
         if (initSync_[oct].syncing_)
         {
             JLOGV(
                 j_.info(),
                 "initSyncDone waiting for other chain",
+                jv("chainType", to_string(ct)),
                 jv("other chain", to_string(oct)));
         }
     }
@@ -710,38 +949,45 @@ Federator::tryFinishInitSync(ChainType const ct)
     for (auto const cht : {ChainType::locking, ChainType::issuing})
     {
         auto const ocht = otherChain(cht);
-        auto& repl(replays_[cht]);
+        auto& repl(*replays_[cht]);
+        auto& attested(initSync_[ocht].attestedTx_);
+        auto& dbAttested(initSync_[ocht].dbAttestedTx_);
+        JLOGV(
+            j_.info(),
+            "initSyncDone start replay",
+            jv("chainType", to_string(cht)),
+            jv("account", ripple::toBase58(bridge_.door(cht))),
+            jv("events to replay", repl.size()),
+            jv("spilled bytes", repl.fileBytes()),
+            jv("attested events", attested.size()),
+            jv("DB attested events", dbAttested.size()));
+
         std::uint32_t del_cnt = 0;
-        std::size_t const rel_size = repl.size();
-        for (auto it = repl.begin(); it != repl.end();)
-        {
-            auto const ah = AttestedHistoryTx::fromEvent(*it);
+        repl.forEach([&](FederatorEvent&& event) {
+            auto const ah = AttestedHistoryTx::fromEvent(event);
             // events from the one side checking against attestations from the
             // other side
-            if (ah && initSync_[ocht].attestedTx_.contains(*ah))
+            if (ah)
             {
-                ++del_cnt;
-                it = repl.erase(it);
+                auto const digest = ah->digest();
+                if (attested.contains(digest) || dbAttested.contains(digest))
+                {
+                    ++del_cnt;
+                    return;
+                }
             }
-            else
-                ++it;
-        }
+            std::visit([this](auto const& e) { this->onEvent(e); }, event);
+        });
 
         JLOGV(
             j_.info(),
-            "initSyncDone start replay",
+            "initSyncDone replayed",
             jv("chainType", to_string(cht)),
-            jv("account", ripple::toBase58(bridge_.door(cht))),
-            jv("events to replay", rel_size),
-            jv("attested events", initSync_[ocht].attestedTx_.size()),
-            jv("events to delete", del_cnt));
+            jv("events deleted", del_cnt));
 
-        for (auto const& event : repl)
-        {
-            std::visit([this](auto const& e) { this->onEvent(e); }, event);
-        }
         repl.clear();
-        initSync_[ocht].attestedTx_.clear();
+        attested.clear();
+        dbAttested.clear();
     }
     syncFinished_ = true;
 }
@@ -753,84 +999,265 @@ Federator::isSyncing() const
         initSync_[ChainType::issuing].syncing_;
 }
 
-void
-Federator::onEvent(event::XChainCommitDetected const& e)
+Json::Value
+Federator::getSyncInfo(ChainType ct) const
 {
-    auto const ct = e.chainType_;
+    using namespace std::chrono;
+
+    auto const& sync = initSync_[ct];
+    Json::Value ret{Json::objectValue};
+    bool const syncing = sync.syncing_;
+    ret["syncing"] = syncing;
+    ret["replayed"] = syncFinished_.load();
+    if (!syncing)
+        return ret;
+
+    // The history goes back from the startup ledger to the checkpoint of the
+    // previous session. Without a checkpoint its end is not known.
+    auto const processed = chains_[ct].listener_->getHistoryProcessedLedger();
+    auto const target = sync.dbLedgerSqn_.load();
+    if (!processed || !target)
+        return ret;
+    auto const remaining = processed > target ? processed - target : 0;
+    ret["history_ledger"] = processed;
+    ret["ledgers_remaining"] = remaining;
+
+    auto const startLedger = sync.historyStartLedger_.load();
+    if (startLedger <= processed)
+        return ret;
+    auto const elapsed = steady_clock::now() -
+        steady_clock::time_point(steady_clock::duration(sync.historyStart_));
+    auto const eta = elapsed * remaining / (startLedger - processed);
+    ret["eta_s"] =
+        static_cast<Json::UInt>(duration_cast<seconds>(eta).count());
+    return ret;
+}
+
+bool
+Federator::historyPaused(ChainType ct)
+{
+    // replays_ is not a mark: it only drains once the history is done. The
+    // attestations of the events of the chain are submitted to the other one.
     auto const oct = otherChain(ct);
-    JLOGV(j_.debug(), "onEvent XChainCommitDetected", jv("event", e.toJson()));
+    HistoryLoad const load{
+        events_[ct].size(),
+        dbEvents_.size(),
+        pendingCounts_[oct].commits() + pendingCounts_[oct].creates()};
 
-    if (isSyncing())
+    auto& paused = historyPaused_[ct];
+    if (!paused)
     {
-        if (!e.rpcOrder_)
-        {
-            JLOGV(j_.error(), "syncing, no rpc order", jv("event", e.toJson()));
-            return;
-        }
-        initSync(ct, e.txnHash_, *e.rpcOrder_, e);
-        return;
+        if (!HistoryPauseMarks.paused(false, load))
+            return false;
+        if (paused.exchange(true))
+            return true;
+        historyPauses_[ct].inc();
+        JLOGV(
+            j_.info(),
+            "History paused",
+            jv("chainType", to_string(ct)),
+            jv("events", load.events),
+            jv("dbEvents", load.dbEvents),
+            jv("txns", load.txns));
+        return true;
     }
 
-    if (e.rpcOrder_ && *e.rpcOrder_ < initSync_[ct].rpcOrder_)
-    {
+    if (HistoryPauseMarks.paused(true, load))
+        return true;
+    if (paused.exchange(false))
         JLOGV(
             j_.info(),
-            "skip older",
-            jv("event", e.toJson()),
-            jv("initSync rpcOrder", initSync_[ct].rpcOrder_));
-        return;
-    }
+            "History resumed",
+            jv("chainType", to_string(ct)),
+            jv("events", load.events),
+            jv("dbEvents", load.dbEvents),
+            jv("txns", load.txns));
+    return false;
+}
 
-    auto const txnIdHex = ripple::strHex(e.txnHash_.begin(), e.txnHash_.end());
-    auto const res = txnsInProcessing_[ct].insert(
-        {fmt::format("claim: {:x}", e.claimID_), txnIdHex});
-    if (!res.second)
+std::optional<ripple::Attestations::AttestationClaim>
+Federator::makeAttestation(event::XChainCommitDetected const& e) const
+{
+    if (!ripple::isTesSuccess(e.status_))
+        return std::nullopt;
+    if (!e.deliveredAmt_)
     {
-        // Already have this transaction
-        // TODO: Sanity check the claim id and deliveredAmt match
-        // TODO: Stop historical transaction collection
         JLOGV(
-            j_.warn(), "XChainCommit already present", jv("event", e.toJson()));
-        return;  // Don't store it again
+            j_.error(),
+            "missing delivered amount in successful xchain transfer",
+            jv("event", e.toJson()));
+        return std::nullopt;
     }
 
+    auto const ct = e.chainType_;
     // The attestation will be send from the other chain, so the other chain
     // will get the reward
-    auto const& rewardAccount = chains_[oct].rewardAccount_;
-    auto const& optDst = e.otherChainDst_;
-    bool const success = ripple::isTesSuccess(e.status_);
-
-    // non-const so it may be moved from
-    auto claimOpt =
-        [&]() -> std::optional<ripple::Attestations::AttestationClaim> {
-        if (!success)
-            return std::nullopt;
-        if (!e.deliveredAmt_)
-        {
-            JLOGV(
-                j_.error(),
-                "missing delivered amount in successful xchain transfer",
-                jv("event", e.toJson()));
-            return std::nullopt;
-        }
+    auto const& rewardAccount = chains_[otherChain(ct)].rewardAccount_;
+    auto const signingAccount =
+        signingAccount_ ? *signingAccount_ : ripple::calcAccountID(signingPK_);
 
+    if (e.signature_)
         return ripple::Attestations::AttestationClaim{
-            e.bridge_,
-            signingAccount_ ? *signingAccount_
-                            : ripple::calcAccountID(signingPK_),
+            signingAccount,
             signingPK_,
-            signingSK_,
+            *e.signature_,
             e.src_,
             *e.deliveredAmt_,
             rewardAccount,
             ct == ChainType::locking,
             e.claimID_,
-            optDst};
-    }();
+            e.otherChainDst_};
+
+    return ripple::Attestations::AttestationClaim{
+        e.bridge_,
+        signingAccount,
+        signingPK_,
+        signingSK_,
+        e.src_,
+        *e.deliveredAmt_,
+        rewardAccount,
+        ct == ChainType::locking,
+        e.claimID_,
+        e.otherChainDst_};
+}
+
+std::optional<ripple::Attestations::AttestationCreateAccount>
+Federator::makeAttestation(event::XChainAccountCreateCommitDetected const& e)
+    const
+{
+    if (!ripple::isTesSuccess(e.status_))
+        return std::nullopt;
+    if (!e.deliveredAmt_)
+    {
+        JLOGV(
+            j_.error(),
+            "missing delivered amount in successful xchain create transfer",
+            jv("event", e.toJson()));
+        return std::nullopt;
+    }
+
+    auto const ct = e.chainType_;
+    // Attestation will be send from other chain, so the other chain will get
+    // the reward
+    auto const& rewardAccount = chains_[otherChain(ct)].rewardAccount_;
+    auto const signingAccount =
+        signingAccount_ ? *signingAccount_ : ripple::calcAccountID(signingPK_);
+
+    if (e.signature_)
+        return ripple::Attestations::AttestationCreateAccount{
+            signingAccount,
+            signingPK_,
+            *e.signature_,
+            e.src_,
+            *e.deliveredAmt_,
+            e.rewardAmt_,
+            rewardAccount,
+            ct == ChainType::locking,
+            e.createCount_,
+            e.otherChainDst_};
+
+    return ripple::Attestations::AttestationCreateAccount{
+        e.bridge_,
+        signingAccount,
+        signingPK_,
+        signingSK_,
+        e.src_,
+        *e.deliveredAmt_,
+        e.rewardAmt_,
+        rewardAccount,
+        ct == ChainType::locking,
+        e.createCount_,
+        e.otherChainDst_};
+}
+
+std::vector<std::future<void>>
+Federator::signAttestations(std::vector<FederatorEvent>& events)
+{
+    std::vector<std::future<void>> r(events.size());
+    if (!signingPool_.threads())
+        return r;
+
+    for (std::size_t i = 0; i < events.size(); ++i)
+    {
+        std::visit(
+            [&, this](auto& e) {
+                using T = std::decay_t<decltype(e)>;
+                if constexpr (
+                    std::is_same_v<T, event::XChainCommitDetected> ||
+                    std::is_same_v<T, event::XChainAccountCreateCommitDetected>)
+                {
+                    if (e.signature_ || !ripple::isTesSuccess(e.status_) ||
+                        !e.deliveredAmt_)
+                        return;
+                    // The event is not touched by this thread until the
+                    // future is ready
+                    r[i] = signingPool_.submit([this, &e] {
+                        if (auto att = makeAttestation(e))
+                            e.signature_ = std::move(att->signature);
+                    });
+                }
+            },
+            events[i]);
+    }
+    return r;
+}
+
+void
+Federator::onEvent(event::XChainCommitDetected const& e)
+{
+    auto const ct = e.chainType_;
+    auto const oct = otherChain(ct);
+    auto const dispatched = AttestTracer::clock::now();
+    JLOGV(j_.debug(), "onEvent XChainCommitDetected", jv("event", e.toJson()));
+
+    if (isSyncing())
+    {
+        if (!e.rpcOrder_)
+        {
+            JLOGV(j_.error(), "syncing, no rpc order", jv("event", e.toJson()));
+            return;
+        }
+        initSync(ct, e.txnHash_, *e.rpcOrder_, e);
+        return;
+    }
+
+    if (e.rpcOrder_ && *e.rpcOrder_ < initSync_[ct].rpcOrder_)
+    {
+        JLOGV(
+            j_.info(),
+            "skip older",
+            jv("event", e.toJson()),
+            jv("initSync rpcOrder", initSync_[ct].rpcOrder_));
+        return;
+    }
+
+    auto const res =
+        txnsInProcessing_[ct].insert({{false, e.claimID_}, e.txnHash_});
+    if (!res.second)
+    {
+        // Already have this transaction
+        // TODO: Sanity check the claim id and deliveredAmt match
+        // TODO: Stop historical transaction collection
+        JLOGV(
+            j_.warn(), "XChainCommit already present", jv("event", e.toJson()));
+        return;  // Don't store it again
+    }
+
+    // non-const so it may be moved from
+    auto claimOpt = makeAttestation(e);
 
     assert(!claimOpt || claimOpt->verify(e.bridge_));
 
-    pushDB(event::XChainCommitDetected(e));
+    // Before the DB event, the DB commit is a stage of the trace
+    if (autoSubmit_[oct] && claimOpt)
+        tracer_.start({oct, false, e.claimID_}, e.received_, dispatched);
+
+    {
+        event::XChainCommitDetected dbEvent(e);
+        if (claimOpt)
+            dbEvent.signature_ = claimOpt->signature;
+        pushDB(std::move(dbEvent));
+    }
 
     // The attestation will be created by the other chain
     if (autoSubmit_[oct] && claimOpt)
@@ -848,72 +1275,46 @@ Federator::onDBEvent(const event::XChainCommitDetected& e)
     auto const ct = e.chainType_;
 
     auto const oct = otherChain(ct);
-    auto const& tblName = db_init::xChainTableName(ct);
 
-    auto const txnIdHex = ripple::strHex(e.txnHash_.begin(), e.txnHash_.end());
-
-    // soci complains about a bool
-    int const success = ripple::isTesSuccess(e.status_) ? 1 : 0;
+    bool const success = ripple::isTesSuccess(e.status_);
 
     // The attestation will be send from the other chain, so the other chain
     // will get the reward
     auto const& rewardAccount = chains_[oct].rewardAccount_;
     auto const& optDst = e.otherChainDst_;
 
-    auto const claimOpt =
-        [&]() -> std::optional<ripple::Attestations::AttestationClaim> {
-        if (!success)
-            return std::nullopt;
-        if (!e.deliveredAmt_)
-        {
-            JLOGV(
-                j_.error(),
-                "missing delivered amount in successful xchain transfer",
-                jv("event", e.toJson()));
-            return std::nullopt;
-        }
+    // Signed by the event thread already
+    auto const claimOpt = makeAttestation(e);
 
-        return ripple::Attestations::AttestationClaim{
-            e.bridge_,
-            signingAccount_ ? *signingAccount_
-                            : ripple::calcAccountID(signingPK_),
-            signingPK_,
-            signingSK_,
-            e.src_,
-            *e.deliveredAmt_,
-            rewardAccount,
-            ct == ChainType::locking,
-            e.claimID_,
-            optDst};
-    }();
+    // A delete of the same claim earlier in the batch is for the old row
+    std::erase(dbBatchDeletes_[ct][false], e.claimID_);
 
     {
-        auto session = app_.getXChainTxnDB().checkoutDb();
-
-        // Soci blob does not play well with optional. Store an empty blob
-        // when missing delivered amount
-        soci::blob amtBlob = e.deliveredAmt_
-            ? convert(*e.deliveredAmt_, *session)
-            : soci::blob(*session);
-        soci::blob bridgeBlob = convert(bridge_, *session);
-        soci::blob sendingAccountBlob =
-            convert(ripple::AccountID(e.src_), *session);
-        soci::blob rewardAccountBlob = convert(rewardAccount, *session);
-        soci::blob signingAccountBlob = claimOpt
-            ? convert(claimOpt->attestationSignerAccount, *session)
-            : soci::blob(*session);
-        soci::blob publicKeyBlob = convert(signingPK_, *session);
-        soci::blob signatureBlob = claimOpt
-            ? convert(claimOpt->signature, *session)
-            : soci::blob(*session);
-        soci::blob otherChainDstBlob =
-            optDst ? convert(*optDst, *session) : soci::blob(*session);
+        AttestationRow row;
+        row.txnHash = e.txnHash_;
+        row.ledgerSeq = e.ledgerSeq_;
+        row.id = e.claimID_;
+        row.success = success;
+        // Left empty when missing delivered amount
+        if (e.deliveredAmt_)
+            row.amt = serialize(*e.deliveredAmt_);
+        row.bridge = serialize(bridge_);
+        row.sendingAccount = serialize(ripple::AccountID(e.src_));
+        row.rewardAccount = serialize(rewardAccount);
+        if (claimOpt)
+        {
+            row.signingAccount = serialize(claimOpt->attestationSignerAccount);
+            row.signature = serialize(claimOpt->signature);
+        }
+        row.publicKey = serialize(signingPK_);
+        if (optDst)
+            row.otherChainDst = serialize(*optDst);
 
         JLOGV(
             j_.trace(),
             "Insert into claim table",
             jv("chainType", to_string(ct)),
-            jv("tableName", tblName),
+            jv("tableName", db_init::xChainTableName(ct, bridgeName_)),
             jv("success", success),
             jv("ledgerSeq", e.ledgerSeq_),
             jv("claimID", fmt::format("{:x}", e.claimID_)),
@@ -929,32 +1330,26 @@ Federator::onDBEvent(const event::XChainCommitDetected& e)
                    ? std::string()
                    : ripple::toBase58(claimOpt->attestationSignerAccount)));
 
-        auto const sql = fmt::format(
-            R"sql(INSERT INTO {table_name}
-                  (TransID, LedgerSeq, ClaimID, Success, DeliveredAmt, Bridge,
-                   SendingAccount, RewardAccount, OtherChainDst, SigningAccount, PublicKey, Signature)
-                  VALUES
-                  (:txnId, :lgrSeq, :claimID, :success, :amt, :bridge,
-                   :sendingAccount, :rewardAccount, :otherChainDst, :signingAccount, :pk, :sig);
-            )sql",
-            fmt::arg("table_name", tblName));
-
-        *session << sql, soci::use(txnIdHex), soci::use(e.ledgerSeq_),
-            soci::use(e.claimID_), soci::use(success), soci::use(amtBlob),
-            soci::use(bridgeBlob), soci::use(sendingAccountBlob),
-            soci::use(rewardAccountBlob), soci::use(otherChainDstBlob),
-            soci::use(signingAccountBlob), soci::use(publicKeyBlob),
-            soci::use(signatureBlob);
-    }
-    {
-        auto session = app_.getXChainTxnDB().checkoutDb();
-        auto const sql = fmt::format(
-            R"sql(UPDATE {table_name} SET TransID = :tx_hash WHERE ChainType = :chain_type;
-            )sql",
-            fmt::arg("table_name", db_init::xChainSyncTable));
-        auto const chainType = static_cast<std::uint32_t>(ct);
-        *session << sql, soci::use(txnIdHex), soci::use(chainType);
+        app_.attestationStore(bridgeName_).insert(ct, false, row);
     }
+
+    // What the witness RPC would read back
+    if (success && claimOpt && e.deliveredAmt_)
+        dbBatchCache_.emplace_back(
+            AttestationCacheKey{ct, false, e.claimID_},
+            CachedAttestation{
+                bridge_,
+                *e.deliveredAmt_,
+                std::nullopt,
+                ripple::AccountID(e.src_),
+                rewardAccount,
+                optDst,
+                claimOpt->attestationSignerAccount,
+                signingPK_,
+                claimOpt->signature});
+
+    // The sync table is updated once per DB batch, see dbLoop
+    dbBatchSyncTx_[ct] = e.txnHash_;
 }
 
 void
@@ -962,6 +1357,7 @@ Federator::onEvent(event::XChainAccountCreateCommitDetected const& e)
 {
     auto const ct = e.chainType_;
     auto const oct = otherChain(ct);
+    auto const dispatched = AttestTracer::clock::now();
     JLOGV(
         j_.debug(),
         "onEvent XChainAccountCreateCommitDetected",
@@ -988,9 +1384,8 @@ Federator::onEvent(event::XChainAccountCreateCommitDetected const& e)
         return;
     }
 
-    auto const txnIdHex = ripple::strHex(e.txnHash_.begin(), e.txnHash_.end());
-    auto const res = txnsInProcessing_[ct].insert(
-        {fmt::format("create: {:x}", e.createCount_), txnIdHex});
+    auto const res =
+        txnsInProcessing_[ct].insert({{true, e.createCount_}, e.txnHash_});
     if (!res.second)
     {
         // Already have this transaction
@@ -1003,45 +1398,20 @@ Federator::onEvent(event::XChainAccountCreateCommitDetected const& e)
         return;  // Don't store it again
     }
 
-    // soci complains about a bool
-    int const success = ripple::isTesSuccess(e.status_) ? 1 : 0;
-    // Attestation will be send from other chain, so the other chain will get
-    // the reward
-    auto const& rewardAccount = chains_[oct].rewardAccount_;
-    auto const& dst = e.otherChainDst_;
-
     // non-const so it may be moved from
-    auto createOpt =
-        [&]() -> std::optional<ripple::Attestations::AttestationCreateAccount> {
-        if (!success)
-            return std::nullopt;
-        if (!e.deliveredAmt_)
-        {
-            JLOGV(
-                j_.error(),
-                "missing delivered amount in successful xchain create transfer",
-                jv("event", e.toJson()));
-            return std::nullopt;
-        }
-
-        return ripple::Attestations::AttestationCreateAccount{
-            e.bridge_,
-            signingAccount_ ? *signingAccount_
-                            : ripple::calcAccountID(signingPK_),
-            signingPK_,
-            signingSK_,
-            e.src_,
-            *e.deliveredAmt_,
-            e.rewardAmt_,
-            rewardAccount,
-            ct == ChainType::locking,
-            e.createCount_,
-            dst};
-    }();
+    auto createOpt = makeAttestation(e);
 
     assert(!createOpt || createOpt->verify(e.bridge_));
 
-    pushDB(event::XChainAccountCreateCommitDetected(e));
+    if (autoSubmit_[oct] && createOpt)
+        tracer_.start({oct, true, e.createCount_}, e.received_, dispatched);
+
+    {
+        event::XChainAccountCreateCommitDetected dbEvent(e);
+        if (createOpt)
+            dbEvent.signature_ = createOpt->signature;
+        pushDB(std::move(dbEvent));
+    }
 
     // The attestation will be created by the other chain
     if (autoSubmit_[oct] && createOpt)
@@ -1058,72 +1428,49 @@ Federator::onDBEvent(event::XChainAccountCreateCommitDetected const& e)
 
     auto const ct = e.chainType_;
     auto const oct = otherChain(ct);
-    auto const& tblName = db_init::xChainCreateAccountTableName(ct);
 
-    auto const txnIdHex = ripple::strHex(e.txnHash_.begin(), e.txnHash_.end());
-
-    // soci complains about a bool
-    int const success = ripple::isTesSuccess(e.status_) ? 1 : 0;
+    bool const success = ripple::isTesSuccess(e.status_);
     auto const& rewardAccount = chains_[oct].rewardAccount_;
     auto const& dst = e.otherChainDst_;
 
-    auto const createOpt =
-        [&]() -> std::optional<ripple::Attestations::AttestationCreateAccount> {
-        if (!success)
-            return std::nullopt;
-        if (!e.deliveredAmt_)
-        {
-            JLOGV(
-                j_.error(),
-                "missing delivered amount in successful xchain create transfer",
-                jv("event", e.toJson()));
-            return std::nullopt;
-        }
+    // Signed by the event thread already
+    auto const createOpt = makeAttestation(e);
 
-        return ripple::Attestations::AttestationCreateAccount{
-            e.bridge_,
-            signingAccount_ ? *signingAccount_
-                            : ripple::calcAccountID(signingPK_),
-            signingPK_,
-            signingSK_,
-            e.src_,
-            *e.deliveredAmt_,
-            e.rewardAmt_,
-            rewardAccount,
-            ct == ChainType::locking,
-            e.createCount_,
-            dst};
-    }();
+    // A delete of the same create account earlier in the batch is for the
+    // old row
+    std::erase(dbBatchDeletes_[ct][true], e.createCount_);
 
     {
-        auto session = app_.getXChainTxnDB().checkoutDb();
-
-        // Soci blob does not play well with optional. Store an empty blob when
-        // missing delivered amount
-        soci::blob amtBlob = e.deliveredAmt_
-            ? convert(*e.deliveredAmt_, *session)
-            : soci::blob(*session);
-        soci::blob rewardAmtBlob = convert(e.rewardAmt_, *session);
-        soci::blob bridgeBlob = convert(bridge_, *session);
+        AttestationRow row;
+        row.txnHash = e.txnHash_;
+        row.ledgerSeq = e.ledgerSeq_;
+        row.id = e.createCount_;
+        row.success = success;
+        // Left empty when missing delivered amount
+        if (e.deliveredAmt_)
+            row.amt = serialize(*e.deliveredAmt_);
+        row.rewardAmt = serialize(e.rewardAmt_);
+        row.bridge = serialize(bridge_);
         // Convert to an AccountID first, because if the type changes we want to
         // catch it.
         ripple::AccountID const& sendingAccount{e.src_};
-        soci::blob sendingAccountBlob = convert(sendingAccount, *session);
-        soci::blob rewardAccountBlob = convert(rewardAccount, *session);
-        soci::blob signingAccountBlob = createOpt
-            ? convert(createOpt->attestationSignerAccount, *session)
-            : soci::blob(*session);
-        soci::blob publicKeyBlob = convert(signingPK_, *session);
-        soci::blob signatureBlob = createOpt
-            ? convert(createOpt->signature, *session)
-            : soci::blob(*session);
-        soci::blob otherChainDstBlob = convert(dst, *session);
+        row.sendingAccount = serialize(sendingAccount);
+        row.rewardAccount = serialize(rewardAccount);
+        if (createOpt)
+        {
+            row.signingAccount =
+                serialize(createOpt->attestationSignerAccount);
+            row.signature = serialize(createOpt->signature);
+        }
+        row.publicKey = serialize(signingPK_);
+        row.otherChainDst = serialize(dst);
 
         JLOGV(
             j_.trace(),
             "Insert into create table",
             jv("chainType", to_string(ct)),
-            jv("tableName", tblName),
+            jv("tableName",
+               db_init::xChainCreateAccountTableName(ct, bridgeName_)),
             jv("success", success),
             jv("ledgerSeq", e.ledgerSeq_),
             jv("createCount", fmt::format("{:x}", e.createCount_)),
@@ -1139,32 +1486,26 @@ Federator::onDBEvent(event::XChainAccountCreateCommitDetected const& e)
                    ? std::string()
                    : ripple::toBase58(createOpt->attestationSignerAccount)));
 
-        auto const sql = fmt::format(
-            R"sql(INSERT INTO {table_name}
-                  (TransID, LedgerSeq, CreateCount, Success, DeliveredAmt, RewardAmt, Bridge,
-                   SendingAccount, RewardAccount, otherChainDst, SigningAccount, PublicKey, Signature)
-                  VALUES
-                  (:txnId, :lgrSeq, :createCount, :success, :amt, :rewardAmt, :bridge,
-                   :sendingAccount, :rewardAccount, :otherChainDst, :signingAccount, :pk, :sig);
-            )sql",
-            fmt::arg("table_name", tblName));
-
-        *session << sql, soci::use(txnIdHex), soci::use(e.ledgerSeq_),
-            soci::use(e.createCount_), soci::use(success), soci::use(amtBlob),
-            soci::use(rewardAmtBlob), soci::use(bridgeBlob),
-            soci::use(sendingAccountBlob), soci::use(rewardAccountBlob),
-            soci::use(otherChainDstBlob), soci::use(signingAccountBlob),
-            soci::use(publicKeyBlob), soci::use(signatureBlob);
-    }
-    {
-        auto session = app_.getXChainTxnDB().checkoutDb();
-        auto const sql = fmt::format(
-            R"sql(UPDATE {table_name} SET TransID = :tx_hash WHERE ChainType = :chain_type;
-            )sql",
-            fmt::arg("table_name", db_init::xChainSyncTable));
-        auto const chainType = static_cast<std::uint32_t>(ct);
-        *session << sql, soci::use(txnIdHex), soci::use(chainType);
+        app_.attestationStore(bridgeName_).insert(ct, true, row);
     }
+
+    // What the witness_account_create RPC would read back
+    if (success && createOpt && e.deliveredAmt_)
+        dbBatchCache_.emplace_back(
+            AttestationCacheKey{ct, true, e.createCount_},
+            CachedAttestation{
+                bridge_,
+                *e.deliveredAmt_,
+                e.rewardAmt_,
+                sendingAccount,
+                rewardAccount,
+                dst,
+                createOpt->attestationSignerAccount,
+                signingPK_,
+                createOpt->signature});
+
+    // The sync table is updated once per DB batch, see dbLoop
+    dbBatchSyncTx_[ct] = e.txnHash_;
 }
 
 void
@@ -1196,7 +1537,13 @@ void
 Federator::onDBEvent(event::DBDelete const& e)
 {
     JLOGV(j_.debug(), "onDBEvent", jv("event", e.toJson()));
-    deleteFromDB(e.chainType_, e.id_, e.isCreateAccount);
+    // TODO add bridge
+    dbBatchDeletes_[e.chainType_][e.isCreateAccount].push_back(e.id_);
+
+    AttestationCacheKey const key{e.chainType_, e.isCreateAccount, e.id_};
+    std::erase_if(
+        dbBatchCache_, [&key](auto const& p) { return p.first == key; });
+    attestationCache_.erase(key);
 }
 
 #ifdef USE_BATCH_ATTESTATION
@@ -1282,6 +1629,16 @@ static std::unordered_set<ripple::TERUnderlyingType> SkippableTxnResult(
      ripple::tecINSUFFICIENT_RESERVE,
      ripple::tecNO_DST_INSUF_XRP});
 
+// rippled is overloaded and can't hold the transaction
+static bool
+isQueueFull(ripple::TER ter)
+{
+    return ter == ripple::telCAN_NOT_QUEUE ||
+        ter == ripple::telCAN_NOT_QUEUE_FULL ||
+        ter == ripple::telCAN_NOT_QUEUE_FEE ||
+        ter == ripple::telINSUF_FEE_P;
+}
+
 void
 Federator::onEvent(event::XChainAttestsResult const& e)
 {
@@ -1300,27 +1657,28 @@ Federator::onEvent(event::XChainAttestsResult const& e)
 
     // Can be several attestations with the same ClaimID
     std::vector<SubmissionPtr> subToDelete;
-    subToDelete.reserve(2);  // no more expected
     {
         std::lock_guard l{txnsMutex_};
         auto& subs = submitted_[ct];
-        std::list<SubmissionPtr>::iterator it = subs.begin();
-        do
-        {
-            if (it = std::find_if(
-                    it,
-                    subs.end(),
-                    [&](auto const& i) {
-                        return e.isFinal_
-                            ? i->checkID(e.claimID_, e.createCount_)
-                            : i->accountSqn_ == e.accountSqn_;
-                    });
-                it != subs.end())
-            {
-                subToDelete.push_back(std::move(*it));
-                it = subs.erase(it);
-            }
-        } while (e.isFinal_ && (it != subs.end()));
+        if (e.isFinal_)
+            subToDelete = subs.extractByID(e.claimID_, e.createCount_);
+        else if (auto sub = subs.extractBySqn(e.accountSqn_))
+            subToDelete.push_back(std::move(sub));
+
+        // The transactions of this server included in the ledger
+        if (!e.isHistory_)
+            for (auto const& sub : subToDelete)
+                if (sub->accountSqn_ && sub->accountSqn_ == e.accountSqn_)
+                    submitWindow_[ct].onLanded();
+    }
+    // Room for more in the submit window
+    if (!subToDelete.empty())
+        submitWakeup_.notify();
+    for (auto const& sub : subToDelete)
+    {
+        metrics_.attests_[ct][am_validated].inc(sub->numAttestations());
+        tracer_.record(AttestTracer::st_confirmed, traceKeys(ct, *sub));
+        publishAttestations(ct, *sub, "validated");
     }
 
     for (auto& sub : subToDelete)
@@ -1331,7 +1689,7 @@ Federator::onEvent(event::XChainAttestsResult const& e)
             e.claimID_)
         {
             cnt = txnsInProcessing_[oct].get<1>().erase(
-                fmt::format("claim: {:x}", *e.claimID_));
+                TransactionCache::ID{false, *e.claimID_});
         }
         else if (
             (e.type_ ==
@@ -1339,7 +1697,7 @@ Federator::onEvent(event::XChainAttestsResult const& e)
             e.createCount_)
         {
             cnt = txnsInProcessing_[oct].get<1>().erase(
-                fmt::format("create: {:x}", *e.createCount_));
+                TransactionCache::ID{true, *e.createCount_});
         }
         else
         {
@@ -1368,11 +1726,17 @@ Federator::onEvent(event::XChainAttestsResult const& e)
             jv("cacheRemoved", cnt));
     }
 
+    AttestedHistoryTx const attested{
+        e.type_, e.src_, e.dst_, e.createCount_, e.claimID_};
+    auto const digest = attested.digest();
+    if (ripple::isTesSuccess(e.ter_))
+        pushDB(event::DBAttested{
+            ct, digest, chains_[ct].listener_->getCurrentLedger()});
+
     if (e.isHistory_)
     {
         // save latest attestation
-        initSync_[ct].attestedTx_.insert(AttestedHistoryTx{
-            e.type_, e.src_, e.dst_, e.createCount_, e.claimID_});
+        initSync_[ct].attestedTx_.insert(digest);
 
         JLOGV(
             j_.debug(),
@@ -1413,157 +1777,396 @@ Federator::onEvent(event::NewLedger const& e)
         jv("event", e.toJson()));
 
     // Fix TTL for tx from DB
-    [[maybe_unused]] static bool runOnce = [&]() {
+    if (!ttlFixed_[ct])
+    {
         std::lock_guard l{txnsMutex_};
-        auto& subs = submitted_[ct];
-        for (auto& s : subs)
-            if (!s->lastLedgerSeq_)
-                s->lastLedgerSeq_ =
+        submitted_[ct].modifyAll([&](Submission& s) {
+            if (!s.lastLedgerSeq_)
+                s.lastLedgerSeq_ =
                     chains_[ct].listener_->getCurrentLedger() + TxnTTLLedgers;
-        return true;
-    }();
+        });
+        ttlFixed_[ct] = true;
+    }
 
     // tryFinishInitSync
     checkProcessedLedger(ct);
 
-    if (!autoSubmit_[ct] || isSyncing())
+    if (!autoSubmit_[ct] || initSync_[ct].syncing_)
         return;
 
     auto const x =
         std::min(std::min(submitLedgerIndex, doorLedgerIndex), e.ledgerIndex_);
     auto const minLedger = x ? x - 1 : 0;
-    pushDB(event::DBUpdateLedger{ct, minLedger});
+    // The checkpoint waits for the replay, the held events of the chain would
+    // be skipped by the history of the next session
+    if (syncFinished_)
+    {
+        auto const doorLedger = std::min(doorLedgerIndex, e.ledgerIndex_);
+        auto const submitLedger = std::min(submitLedgerIndex, e.ledgerIndex_);
+        pushDBLedger(event::DBUpdateLedger{
+            ct,
+            minLedger,
+            doorLedger ? doorLedger - 1 : 0,
+            submitLedger ? submitLedger - 1 : 0});
+    }
     checkExpired(ct, minLedger);
 }
 
 void
 Federator::checkExpired(ChainType ct, std::uint32_t ledger)
 {
-    bool notify = false;
+    bool resubmit = false;
     {
         std::lock_guard l{txnsMutex_};
 
-        auto& subs = submitted_[ct];
-        auto& errs = errored_[ct];
-
         // add expired txn to errored_ for resubmit
-        auto firstFresh =
-            std::find_if(subs.begin(), subs.end(), [ledger](auto const& s) {
-                return s->lastLedgerSeq_ > ledger;
-            });
-
-        for (auto it = subs.begin(); it != firstFresh;)
+        auto expired = submitted_[ct].extractExpired(ledger);
+        if (!expired.empty())
+            shrinkWindow(ct, "expired");
+        for (auto& sub : expired)
         {
             assert(!initSync_[ct].syncing_);
-            auto& front = *it;
-            if (front->retriesAllowed_ > 0)
+            metrics_.attests_[ct][am_expired].inc(sub->numAttestations());
+            if (sub->retriesAllowed_ > 0)
             {
                 JLOGV(
                     j_.warn(),
                     "Ledger TTL expired, move to errored",
                     jv("chainType", to_string(ct)),
                     jv("retries",
-                       static_cast<std::uint32_t>(front->retriesAllowed_)),
-                    jv("accSqn", front->accountSqn_),
-                    jv("lastLedger", front->lastLedgerSeq_),
-                    jv("tx", front->getJson()));
-
-                front->retriesAllowed_--;
-                front->accountSqn_ = 0;
-                front->lastLedgerSeq_ = 0;
-                ++it;
+                       static_cast<std::uint32_t>(sub->retriesAllowed_)),
+                    jv("accSqn", sub->accountSqn_),
+                    jv("lastLedger", sub->lastLedgerSeq_),
+                    jv("tx", sub->getJson()));
+
+                sub->retriesAllowed_--;
+                sub->accountSqn_ = 0;
+                sub->ticket_ = false;
+                sub->lastLedgerSeq_ = 0;
+                metrics_.attests_[ct][am_resubmitted].inc(
+                    sub->numAttestations());
+                errored_[ct].push_back(std::move(sub));
             }
             else
             {
-                auto const attestedIDs = front->forAttestIDs();
+                publishAttestations(ct, *sub, "failed");
+                auto const attestedIDs = sub->forAttestIDs();
                 JLOGV(
                     j_.warn(),
                     "Giving up after repeated retries",
                     jv("chainType", to_string(ct)),
                     jv("commitAttests", attestedIDs.first),
                     jv("createAttests", attestedIDs.second),
-                    jv(front->getLogName(), front->getJson()));
-                it = subs.erase(it);
+                    jv(sub->getLogName(), sub->getJson()));
             }
         }
 
-        if (subs.begin() != firstFresh)
-        {
-            auto& front = subs.front();
-            auto where =
-                std::find_if(errs.begin(), errs.end(), [&front](auto const& s) {
-                    return *front < *s;
-                });
-            errs.insert(
-                where,
-                std::make_move_iterator(subs.begin()),
-                std::make_move_iterator(firstFresh));
-            subs.erase(subs.begin(), firstFresh);
-        }
-
-        notify = !errored_[ct].empty();
-    }
-    if (notify)
-    {
-        std::lock_guard l(cvMutexes_[lt_txnSubmit]);
-        cvs_[lt_txnSubmit].notify_all();
+        resubmit = !errored_[ct].empty();
     }
-    else
+    // A new ledger may also make the submit loop ready
+    submitWakeup_.notify();
+    if (!resubmit)
     {
         std::lock_guard bl{batchMutex_};
-        if (curClaimAtts_[ct].size() + curCreateAtts_[ct].size() > 0)
+        if (coalescers_[ct].onLedger(
+                curClaimAtts_[ct].size() + curCreateAtts_[ct].size(),
+                chains_[ct].listener_->getCurrentLedger()))
             pushAttOnSubmitTxn(bridge_, ct);
     }
 }
 
 void
-Federator::checkProcessedLedger(ChainType ct)
+Federator::shrinkWindow(ChainType ct, std::string_view reason)
 {
-    auto const historyProcessedLedger =
-        chains_[ct].listener_->getHistoryProcessedLedger();
-    // If last tx not set (expected for issuing side) then check last processed
-    // ledger
-    if (initSync_[ct].syncing_ && !initSync_[ct].historyDone_ &&
-        initSync_[ct].dbLedgerSqn_ && historyProcessedLedger &&
-        (historyProcessedLedger <= initSync_[ct].dbLedgerSqn_))
-    {
-        initSync_[ct].historyDone_ = true;
+    auto& window = submitWindow_[ct];
+    if (window.onCongestion(chains_[ct].listener_->getCurrentLedger()))
         JLOGV(
-            j_.trace(),
-            "initSync found previous processed ledger",
-            jv("chain", to_string(ct)),
-            jv("dbLedger", initSync_[ct].dbLedgerSqn_),
-            jv("historyLedger", historyProcessedLedger));
-        tryFinishInitSync(ct);
-    }
+            j_.info(),
+            "Submit window decreased",
+            jv("chainType", to_string(ct)),
+            jv("reason", reason),
+            jv("window size", window.size()));
+}
+
+bool
+Federator::useTickets(ChainType ct) const
+{
+    return chains_[ct].txnSubmit_ && chains_[ct].txnSubmit_->tickets;
 }
 
 void
-Federator::onDBEvent(event::DBUpdateLedger const& e)
+Federator::refreshTickets(ChainType ct)
 {
-    JLOGV(j_.debug(), "onDBEvent", jv("event", e.toJson()));
+    auto const ledger = chains_[ct].listener_->getCurrentLedger();
+    {
+        std::lock_guard l{txnsMutex_};
+        auto& pool = tickets_[ct];
+        if (!ledger || pool.refreshing_ || pool.refreshLedger_ >= ledger ||
+            pool.free_.size() >= chains_[ct].txnSubmit_->tickets)
+            return;
+        pool.refreshing_ = true;
+        pool.taken_.clear();
+    }
 
-    auto const ledger = e.ledger_;
-    auto const ct = e.chainType_;
+    auto callback = [this, ct](Json::Value const& msg) {
+        std::set<std::uint32_t> owned;
+        bool const ok = msg.isMember(ripple::jss::result) &&
+            msg[ripple::jss::result].isMember(ripple::jss::account_objects) &&
+            msg[ripple::jss::result][ripple::jss::account_objects].isArray();
+        if (ok)
+        {
+            auto const& ticketField = ripple::sfTicketSequence.getJsonName();
+            for (auto const& o :
+                 msg[ripple::jss::result][ripple::jss::account_objects])
+                if (o.isMember(ticketField) && o[ticketField].isIntegral())
+                    owned.insert(o[ticketField].asUInt());
+        }
 
-    if (ledger > initSync_[ct].dbLedgerSqn_)
-    {
-        auto session = app_.getXChainTxnDB().checkoutDb();
-        auto const sql = fmt::format(
-            "UPDATE {} SET LedgerSeq = :ledger_sqn WHERE ChainType = "
-            ":chain_type;",
-            db_init::xChainSyncTable);
-        *session << sql, soci::use(ledger),
-            soci::use(static_cast<std::uint32_t>(ct));
+        auto const wanted = chains_[ct].txnSubmit_->tickets;
+        auto const ledger = chains_[ct].listener_->getCurrentLedger();
+        {
+            std::lock_guard l{txnsMutex_};
+            auto& pool = tickets_[ct];
+            pool.refreshing_ = false;
+            pool.refreshLedger_ = ledger;
+            if (!ok)
+            {
+                JLOGV(
+                    j_.warn(),
+                    "Can't read the tickets",
+                    jv("chainType", to_string(ct)),
+                    jv("msg", msg));
+                return;
+            }
 
-        initSync_[ct].dbLedgerSqn_ = ledger;
+            // The previous TicketCreate is in the validated ledger, or
+            // expired
+            if (owned.size() < wanted && pool.createLastLedger_ < ledger)
+                pool.toCreate_ = wanted - owned.size();
 
-        JLOGV(
-            j_.trace(),
+            for (auto const& s : submitted_[ct])
+                if (s->ticket_)
+                    owned.erase(s->accountSqn_);
+            for (auto const t : pool.taken_)
+                owned.erase(t);
+            pool.free_ = std::move(owned);
+
+            JLOGV(
+                j_.debug(),
+                "Tickets refreshed",
+                jv("chainType", to_string(ct)),
+                jv("free", pool.free_.size()),
+                jv("toCreate", pool.toCreate_));
+        }
+        submitWakeup_.notify();
+    };
+
+    Json::Value request;
+    request[ripple::jss::account] =
+        ripple::toBase58(chains_[ct].txnSubmit_->submittingAccount);
+    request[ripple::jss::type] = ripple::jss::ticket;
+    request[ripple::jss::ledger_index] = "validated";
+    request[ripple::jss::limit] = 400;
+    chains_[ct].listener_->send("account_objects", request, callback);
+}
+
+void
+Federator::createTickets(ChainType ct, std::uint32_t count)
+{
+    auto const& txnSubmit = *chains_[ct].txnSubmit_;
+    auto const lastLedgerSeq =
+        chains_[ct].listener_->getCurrentLedger() + TxnTTLLedgers;
+    ripple::XRPAmount const fee{static_cast<std::int64_t>(computeFee(
+        chains_[ct].listener_->getFeeState(),
+        0,
+        {FeeExtraDrops, txnSubmit.maxFee}))};
+    auto const txn = txn::getSignedTicketCreate(
+        txnSubmit.submittingAccount,
+        count,
+        accountSqns_[ct],
+        lastLedgerSeq,
+        networkID_[ct],
+        fee,
+        txnSubmit.keypair,
+        j_);
+
+    JLOGV(
+        j_.info(),
+        "Creating tickets",
+        jv("chainType", to_string(ct)),
+        jv("count", count),
+        jv("accountSqn", accountSqns_[ct]),
+        jv("lastLedgerSeq", lastLedgerSeq));
+
+    // The tickets take the next sequences, read them again if needed
+    accountSqns_[ct] = 0;
+    {
+        std::lock_guard l{txnsMutex_};
+        tickets_[ct].toCreate_ = 0;
+        tickets_[ct].createLastLedger_ = lastLedgerSeq;
+    }
+
+    Json::Value request;
+    request[ripple::jss::tx_blob] =
+        ripple::strHex(txn.getSerializer().peekData());
+    auto callback = [this, ct](Json::Value const& v) {
+        if (v.isMember(ripple::jss::result) &&
+            v[ripple::jss::result].isMember(ripple::jss::engine_result))
+            JLOGV(
+                j_.info(),
+                "TicketCreate submit result",
+                jv("chainType", to_string(ct)),
+                jv("result",
+                   v[ripple::jss::result][ripple::jss::engine_result]));
+    };
+    chains_[ct].listener_->send("submit", request, callback, /*hedge*/ true);
+}
+
+void
+Federator::checkProcessedLedger(ChainType ct)
+{
+    auto const historyProcessedLedger =
+        chains_[ct].listener_->getHistoryProcessedLedger();
+    auto& sync = initSync_[ct];
+    if (sync.syncing_ && historyProcessedLedger && !sync.historyStartLedger_)
+    {
+        sync.historyStart_ =
+            std::chrono::steady_clock::now().time_since_epoch().count();
+        sync.historyStartLedger_ = historyProcessedLedger;
+    }
+
+    // If last tx not set (expected for issuing side) then check last processed
+    // ledger
+    if (initSync_[ct].syncing_ && !initSync_[ct].historyDone_ &&
+        initSync_[ct].dbLedgerSqn_ && historyProcessedLedger &&
+        (historyProcessedLedger <= initSync_[ct].dbLedgerSqn_))
+    {
+        initSync_[ct].historyDone_ = true;
+        JLOGV(
+            j_.trace(),
+            "initSync found previous processed ledger",
+            jv("chain", to_string(ct)),
+            jv("dbLedger", initSync_[ct].dbLedgerSqn_),
+            jv("historyLedger", historyProcessedLedger));
+        tryFinishInitSync(ct);
+    }
+}
+
+void
+Federator::onDBEvent(event::DBUpdateLedger const& e)
+{
+    JLOGV(j_.debug(), "onDBEvent", jv("event", e.toJson()));
+
+    auto const ledger = e.ledger_;
+    auto const ct = e.chainType_;
+
+    if (ledger > initSync_[ct].dbLedgerSqn_)
+    {
+        auto session = app_.getXChainTxnDB().checkoutDb();
+        auto& q = session.prepared<db_stmt::UpdateSyncLedger>(
+            db_stmt::UpdateSyncLedger::name(bridgeName_));
+        q.ledgerSeq = ledger;
+        q.chainType = static_cast<std::uint32_t>(ct);
+        q.st.execute(true);
+
+        initSync_[ct].dbLedgerSqn_ = ledger;
+
+        JLOGV(
+            j_.trace(),
             "syncDB update processed ledger",
             jv("chainType", to_string(ct)),
             jv("ledger", ledger));
     }
+
+    {
+        auto session = app_.getXChainTxnDB().checkoutDb();
+        auto& q = session.prepared<db_stmt::UpdateCheckpoint>(
+            db_stmt::UpdateCheckpoint::name(bridgeName_));
+        q.doorLedgerSeq = e.doorLedger_;
+        q.submitLedgerSeq = e.submitLedger_;
+        q.chainType = static_cast<std::uint32_t>(ct);
+        q.st.execute(true);
+    }
+
+    // The digests are pruned by the ledgers of the chain they landed on
+    if (ledger > AttestedKeepLedgers)
+    {
+        auto session = app_.getXChainTxnDB().checkoutDb();
+        auto& q = session.prepared<db_stmt::PruneAttested>(
+            db_stmt::PruneAttested::name(ct, bridgeName_));
+        q.ledgerSeq = ledger - AttestedKeepLedgers;
+        q.st.execute(true);
+    }
+
+    if (retainLedgers_ && ledger > retainLedgers_)
+        pruneDB(ct, ledger - retainLedgers_);
+}
+
+void
+Federator::publishAttestation(
+    AttestationCacheKey const& key,
+    char const* status,
+    CachedAttestation const* att)
+{
+    auto& publisher = app_.publisher();
+    if (publisher.empty())
+        return;
+
+    Json::Value jv(Json::objectValue);
+    jv[ripple::jss::type] = "attestation";
+    jv[ripple::jss::status] = status;
+    jv["chain_type"] = to_string(key.chain);
+    jv[key.createAccount ? "create_count" : "claim_id"] =
+        static_cast<Json::UInt>(key.id);
+    if (att)
+    {
+        auto constexpr none = ripple::JsonOptions::none;
+        jv["bridge"] = att->bridge.getJson(none);
+        jv["sending_amount"] = att->deliveredAmt.getJson(none);
+        if (att->rewardAmt)
+            jv["reward_amount"] = att->rewardAmt->getJson(none);
+        jv["sending_account"] = ripple::toBase58(att->sendingAccount);
+        jv["reward_account"] = ripple::toBase58(att->rewardAccount);
+        if (att->otherChainDst)
+            jv["destination"] = ripple::toBase58(*att->otherChainDst);
+        jv["signing_account"] = ripple::toBase58(att->signingAccount);
+        jv["public_key"] = ripple::strHex(att->publicKey);
+        jv["signature"] = ripple::strHex(att->signature);
+    }
+    publisher.publish(jv);
+}
+
+void
+Federator::publishAttestations(
+    ChainType ct,
+    Submission const& sub,
+    char const* status)
+{
+    if (app_.publisher().empty())
+        return;
+
+    // The attestations of the events of the other chain
+    auto const oct = otherChain(ct);
+    sub.forAttestIDs(
+        [&](std::uint64_t id) {
+            publishAttestation({oct, false, id}, status);
+        },
+        [&](std::uint64_t id) {
+            publishAttestation({oct, true, id}, status);
+        });
+}
+
+void
+Federator::onDBEvent(event::DBAttested const& e)
+{
+    JLOGV(j_.trace(), "onDBEvent", jv("event", e.toJson()));
+
+    auto session = app_.getXChainTxnDB().checkoutDb();
+    auto& q = session.prepared<db_stmt::InsertAttested>(
+        db_stmt::InsertAttested::name(e.chainType_, bridgeName_));
+    q.digest = convert(e.digest_, *session);
+    q.ledgerSeq = e.ledger_;
+    q.st.execute(true);
 }
 
 void
@@ -1660,7 +2263,6 @@ Federator::pushAttOnSubmitTxn(
     ChainType chainType)
 {
     // batch mutex must already be held
-    bool notify = false;
     auto const& signerListInfo(signerListsInfo_[chainType]);
     if (signerListInfo.ignoreSignerList_ ||
         (signerListInfo.status_ != SignerListInfo::absent))
@@ -1671,8 +2273,6 @@ Federator::pushAttOnSubmitTxn(
             jv("ChainType", to_string(chainType)));
 
         std::lock_guard tl{txnsMutex_};
-        notify = txns_[ChainType::locking].empty() &&
-            txns_[ChainType::issuing].empty();
 
         if (useBatch_)
         {
@@ -1687,7 +2287,7 @@ Federator::pushAttOnSubmitTxn(
                     curCreateAtts_[chainType].begin(),
                     curCreateAtts_[chainType].end()}));
 
-            txns_[chainType].emplace_back(std::move(p));
+            txns_[chainType].push_back(std::move(p));
 #else
             throw std::runtime_error(
                 "Please compile with USE_BATCH_ATTESTATION to use Batch "
@@ -1701,14 +2301,14 @@ Federator::pushAttOnSubmitTxn(
             {
                 auto p = SubmissionPtr(new SubmissionClaim(
                     0, 0, networkID_[chainType], bridge, claim));
-                txns_[chainType].emplace_back(std::move(p));
+                txns_[chainType].push_back(std::move(p));
             }
 
             for (auto const& create : curCreateAtts_[chainType])
             {
                 auto p = SubmissionPtr(new SubmissionCreateAccount(
                     0, 0, networkID_[chainType], bridge, create));
-                txns_[chainType].emplace_back(std::move(p));
+                txns_[chainType].push_back(std::move(p));
             }
         }
     }
@@ -1722,12 +2322,9 @@ Federator::pushAttOnSubmitTxn(
 
     curClaimAtts_[chainType].clear();
     curCreateAtts_[chainType].clear();
+    batchCounts_[chainType].clear();
 
-    if (notify)
-    {
-        std::lock_guard l(cvMutexes_[lt_txnSubmit]);
-        cvs_[lt_txnSubmit].notify_all();
-    }
+    submitWakeup_.notify();
 }
 
 void
@@ -1739,10 +2336,14 @@ Federator::pushAtt(
 {
     std::lock_guard bl{batchMutex_};
     curClaimAtts_[chainType].emplace_back(std::move(att));
+    batchCounts_[chainType].add(1, 0);
     auto const attSize =
         curClaimAtts_[chainType].size() + curCreateAtts_[chainType].size();
     assert(attSize <= maxAttests());
-    if (ledgerBoundary || attSize >= maxAttests())
+    if (coalescers_[chainType].onAdd(
+            attSize,
+            chains_[chainType].listener_->getCurrentLedger(),
+            ledgerBoundary))
         pushAttOnSubmitTxn(bridge, chainType);
 }
 
@@ -1755,25 +2356,37 @@ Federator::pushAtt(
 {
     std::lock_guard bl{batchMutex_};
     curCreateAtts_[chainType].emplace_back(std::move(att));
+    batchCounts_[chainType].add(0, 1);
     auto const attSize =
         curClaimAtts_[chainType].size() + curCreateAtts_[chainType].size();
     assert(attSize <= maxAttests());
-    if (ledgerBoundary || attSize >= maxAttests())
+    if (coalescers_[chainType].onAdd(
+            attSize,
+            chains_[chainType].listener_->getCurrentLedger(),
+            ledgerBoundary))
         pushAttOnSubmitTxn(bridge, chainType);
 }
 
-void
-Federator::submitTxn(SubmissionPtr&& submission, ChainType ct)
+std::optional<ripple::STTx>
+Federator::signTxn(
+    Submission const& submission,
+    ChainType ct,
+    ripple::XRPAmount const& fee) const
 {
-    if (submission->numAttestations() == 0)
-        return;
+    if (submission.numAttestations() == 0)
+        return std::nullopt;
 
     // already verified txnSubmit before call submitTxn()
     config::TxnSubmit const& txnSubmit = *chains_[ct].txnSubmit_;
-    ripple::XRPAmount fee{
-        chains_[ct].listener_->getCurrentFee() + FeeExtraDrops};
-    ripple::STTx const toSubmit = submission->getSignedTxn(txnSubmit, fee, j_);
+    return submission.getSignedTxn(txnSubmit, fee, j_);
+}
 
+void
+Federator::submitTxn(
+    SubmissionPtr&& submission,
+    ChainType ct,
+    ripple::STTx const& toSubmit)
+{
     auto const attestedIDs = submission->forAttestIDs();
     JLOGV(
         j_.trace(),
@@ -1804,37 +2417,34 @@ Federator::submitTxn(SubmissionPtr&& submission, ChainType ct)
             {
                 auto txnTER = ripple::TER::fromInt(
                     result[ripple::jss::engine_result_code].asInt());
-                if (ripple::isTemMalformed(txnTER))
+                if (isQueueFull(txnTER))
+                {
+                    std::lock_guard l{txnsMutex_};
+                    shrinkWindow(ct, transToken(txnTER));
+                }
+                else if (ripple::isTemMalformed(txnTER))
                 {
                     if (result.isMember(ripple::jss::tx_json))
                     {
                         auto const& txJson = result[ripple::jss::tx_json];
-                        if (txJson.isMember(ripple::jss::Sequence) &&
-                            txJson[ripple::jss::Sequence].isIntegral())
+                        // The sequence or the ticket sequence
+                        if (auto const sqn =
+                                rpcResultParse::parseTxSeq(txJson))
                         {
-                            std::uint32_t sqn =
-                                txJson[ripple::jss::Sequence].asUInt();
-
                             std::lock_guard l{txnsMutex_};
-                            auto& subs = submitted_[ct];
-                            if (auto it = std::find_if(
-                                    subs.begin(),
-                                    subs.end(),
-                                    [&](auto const& i) {
-                                        return i->accountSqn_ == sqn;
-                                    });
-                                it != subs.end())
+                            if (auto const sub =
+                                    submitted_[ct].extractBySqn(*sqn))
                             {
-                                auto const attestedIDs = (*it)->forAttestIDs();
+                                auto const attestedIDs = sub->forAttestIDs();
                                 JLOGV(
                                     j_.warn(),
                                     "Tem txn submit result, removing "
                                     "submission",
-                                    jv("account sequence", sqn),
+                                    jv("account sequence", *sqn),
                                     jv("chainType", to_string(ct)),
                                     jv("commitAttests", attestedIDs.first),
                                     jv("createAttests", attestedIDs.second));
-                                subs.erase(it);
+                                submitWakeup_.notify();
                             }
                         }
                     }
@@ -1843,17 +2453,34 @@ Federator::submitTxn(SubmissionPtr&& submission, ChainType ct)
         }
     };
 
+    metrics_.attests_[ct][am_submitted].inc(submission->numAttestations());
+    publishAttestations(ct, *submission, "submitted");
     {
         std::lock_guard tl{txnsMutex_};
-        submitted_[ct].emplace_back(std::move(submission));
+        submitted_[ct].push_back(std::move(submission));
     }
-    chains_[ct].listener_->send("submit", request, callback);
+    chains_[ct].listener_->send("submit", request, callback, /*hedge*/ true);
     // JLOG(j_.trace()) << "txn submitted";  // the listener logs as well
 }
 
 void
 Federator::unlockMainLoop()
 {
+    if (dbLoad_.valid())
+    {
+        // Rethrow the DB load errors
+        auto const t = std::chrono::steady_clock::now();
+        dbLoad_.get();
+        JLOGV(
+            j_.info(),
+            "startup DB load wait",
+            jv("ms",
+               static_cast<Json::UInt>(
+                   std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - t)
+                       .count())));
+    }
+
     for (int i = 0; i < lt_last; ++i)
     {
         std::lock_guard l(loopMutexes_[i]);
@@ -1877,26 +2504,19 @@ Federator::mainLoop(ChainType ct)
     localEvents.reserve(16);
     while (!requestStop_)
     {
+        assert(localEvents.empty());
+        if (!events.waitPopAll(localEvents))
+            break;
+
+        // The signatures are computed in parallel, the events are processed
+        // in order
+        auto signatures = signAttestations(localEvents);
+        for (std::size_t i = 0; i < localEvents.size(); ++i)
         {
-            std::lock_guard l{eventsMutex_};
-            assert(localEvents.empty());
-            localEvents.swap(events);
+            if (signatures[i].valid())
+                signatures[i].get();
+            std::visit([this](auto&& e) { this->onEvent(e); }, localEvents[i]);
         }
-        if (localEvents.empty())
-        {
-            using namespace std::chrono_literals;
-            // In rare cases, an event may be pushed and the condition
-            // variable signaled before the condition variable is waited on.
-            // To handle this, set a timeout on the wait.
-            std::unique_lock l{cvMutexes_[lt]};
-            // Allow for spurious wakeups. The alternative requires locking the
-            // eventsMutex_
-            cvs_[lt].wait_for(l, 1s);
-            continue;
-        }
-
-        for (auto const& event : localEvents)
-            std::visit([this](auto&& e) { this->onEvent(e); }, event);
         localEvents.clear();
     }
 }
@@ -1935,7 +2555,7 @@ Federator::txnSubmitLoop()
     // Lifetime of the captured variables is almost program-wide, cause 'while
     // (!requestStop_)' loop will never stop. The loop will stop just before
     // shutdown and connections will be closed too, so callback will not fire.
-    auto getReady = [&](ChainType chain) -> bool {
+    auto ledgerReady = [&](ChainType chain) -> bool {
         if (!chains_[chain].listener_->getCurrentLedger() ||
             !chains_[chain].listener_->getCurrentFee())
         {
@@ -1943,6 +2563,12 @@ Federator::txnSubmitLoop()
                 << "Not ready, waiting for validated ledgers from stream";
             return false;
         }
+        return true;
+    };
+
+    auto getReady = [&](ChainType chain) -> bool {
+        if (!ledgerReady(chain))
+            return false;
 
         // TODO add other readiness check such as verify if witness is in
         // signerList as needed
@@ -1985,18 +2611,24 @@ Federator::txnSubmitLoop()
                             << "got account sqn " << accountInfoSqns[ct];
                     }
 
-                    {
-                        // advance the loop
-                        std::lock_guard l(cvMutexes_[lt]);
-                        cvs_[lt].notify_one();
-                    }
+                    // advance the loop
+                    submitWakeup_.notify();
+                    return;
                 }
             }
+
+            // Error or timeout, requested again by the next loop
+            {
+                std::lock_guard aiLock{accountInfoMutex};
+                waitingAccountInfo[ct] = false;
+            }
+            submitWakeup_.notify();
         };
         Json::Value request;
         request[ripple::jss::account] = accountStrs[chain];
         request[ripple::jss::ledger_index] = "validated";
-        chains_[chain].listener_->send("account_info", request, callback);
+        chains_[chain].listener_->send(
+            "account_info", request, callback, /*hedge*/ true);
         JLOG(j_.trace()) << "Not ready, waiting account sqn";
         return false;
     };
@@ -2004,6 +2636,9 @@ Federator::txnSubmitLoop()
     std::uint32_t skipCtr = 0;
     while (!requestStop_)
     {
+        // Taken before the state is checked, so a notification sent while
+        // the loop runs is not lost
+        auto const wakeupToken = submitWakeup_.token();
         bool waitForEvent = true;
 
         for (auto const ct : {ChainType::locking, ChainType::issuing})
@@ -2011,25 +2646,44 @@ Federator::txnSubmitLoop()
             if (accountStrs[ct].empty())
                 continue;
 
-            decltype(txns_)::type localTxns;
-            decltype(txns_)::type* pLocal = nullptr;
+            std::vector<SubmissionPtr> localTxns;
+            std::vector<std::uint32_t> localTickets;
             bool checkReady = false;
+            bool fromErrored = false;
+
+            bool const tickets = useTickets(ct);
+            if (tickets)
+            {
+                refreshTickets(ct);
+                std::uint32_t toCreate = 0;
+                {
+                    std::lock_guard l{txnsMutex_};
+                    toCreate = tickets_[ct].toCreate_;
+                }
+                if (toCreate && getReady(ct))
+                    createTickets(ct, toCreate);
+            }
 
             {
                 std::lock_guard l{txnsMutex_};
-                if (maxAttToSend_ && (submitted_[ct].size() > maxAttToSend_))
+                if (submitWindow_[ct].size() &&
+                    (submitted_[ct].size() > submitWindow_[ct].size()))
                 {
                     ++skipCtr;
                     continue;
                 }
 
-                if (errored_[ct].empty())
+                if (tickets)
                 {
-                    if (!txns_[ct].empty())
-                    {
-                        checkReady = true;
-                        pLocal = &(txns_[ct]);
-                    }
+                    // A failed submission does not hold the others, it is
+                    // resubmitted with another ticket
+                    fromErrored = !errored_[ct].empty();
+                    checkReady = (fromErrored || !txns_[ct].empty()) &&
+                        !tickets_[ct].free_.empty();
+                }
+                else if (errored_[ct].empty())
+                {
+                    checkReady = !txns_[ct].empty();
                 }
                 else
                 {
@@ -2037,75 +2691,112 @@ Federator::txnSubmitLoop()
                     {
                         accountSqns_[ct] = 0;
                         checkReady = true;
-                        pLocal = &(errored_[ct]);
+                        fromErrored = true;
                     }
                 }
             }
 
             if (checkReady)
             {
-                if (!getReady(ct))
+                if (!(tickets ? ledgerReady(ct) : getReady(ct)))
                     continue;
                 std::lock_guard l{txnsMutex_};
 
-                std::uint32_t const numToSend = maxAttToSend_
-                    ? (submitted_[ct].size() <= maxAttToSend_
-                           ? maxAttToSend_ - submitted_[ct].size()
+                std::size_t const waiting =
+                    fromErrored ? errored_[ct].size() : txns_[ct].size();
+                std::size_t const windowSize = submitWindow_[ct].size();
+                std::size_t numToSend = windowSize
+                    ? (submitted_[ct].size() <= windowSize
+                           ? windowSize - submitted_[ct].size()
                            : 0)
-                    : pLocal->size();
+                    : waiting;
+                if (tickets)
+                    numToSend =
+                        std::min(numToSend, tickets_[ct].free_.size());
                 if (!numToSend)
                 {
                     ++skipCtr;
                     continue;
                 }
 
-                if (pLocal->size() <= numToSend)
-                    localTxns.swap(*pLocal);
-                else
+                if (!fromErrored && waiting > numToSend)
                 {
                     JLOGV(
                         j_.trace(),
                         "Waiting size exceed window size",
                         jv("chainType", to_string(ct)),
-                        jv("waiting size", pLocal->size()),
-                        jv("window size", maxAttToSend_),
+                        jv("waiting size", waiting),
+                        jv("window size", windowSize),
                         jv("send size", numToSend),
                         jv("skipped iterations", skipCtr));
                     skipCtr = 0;
+                }
+                // By priority class, see SubmissionQueue
+                localTxns = fromErrored ? errored_[ct].extractFirst(numToSend)
+                                        : txns_[ct].extractFirst(numToSend);
 
-                    auto start = pLocal->begin();
-                    auto finish = start + numToSend;
-                    localTxns.assign(
-                        std::make_move_iterator(start),
-                        std::make_move_iterator(finish));
-                    pLocal->erase(start, finish);
+                if (tickets)
+                {
+                    auto& pool = tickets_[ct];
+                    while (localTickets.size() < localTxns.size())
+                    {
+                        auto const ticket = *pool.free_.begin();
+                        pool.free_.erase(pool.free_.begin());
+                        pool.taken_.insert(ticket);
+                        localTickets.push_back(ticket);
+                    }
                 }
             }
 
             waitForEvent = waitForEvent && localTxns.empty();
 
-            for (auto& txn : localTxns)
+            if (localTxns.empty())
+                continue;
+
+            // The sequences (or tickets) are assigned in order, then the
+            // transactions are signed in parallel and submitted in order
+            auto const feeState = chains_[ct].listener_->getFeeState();
+            FeeLimits const feeLimits{
+                FeeExtraDrops, chains_[ct].txnSubmit_->maxFee};
+            std::vector<std::future<std::optional<ripple::STTx>>> signedTxns;
+            signedTxns.reserve(localTxns.size());
+            for (std::size_t i = 0; i < localTxns.size(); ++i)
             {
+                auto& txn = localTxns[i];
                 auto const lastLedgerSeq =
                     chains_[ct].listener_->getCurrentLedger() + TxnTTLLedgers;
                 txn->lastLedgerSeq_ = lastLedgerSeq;
-                txn->accountSqn_ = accountSqns_[ct]++;
-                submitTxn(std::move(txn), ct);
+                txn->ticket_ = tickets;
+                txn->accountSqn_ =
+                    tickets ? localTickets[i] : accountSqns_[ct]++;
+                // Escalate the fee of the resubmitted transactions
+                ripple::XRPAmount const fee{static_cast<std::int64_t>(
+                    computeFee(
+                        feeState,
+                        MaxResubmits - txn->retriesAllowed_,
+                        feeLimits))};
+                signedTxns.push_back(
+                    signingPool_.submit([this, &sub = *txn, ct, fee] {
+                        return signTxn(sub, ct, fee);
+                    }));
             }
-        }
 
-        if (waitForEvent)
-        {
-            using namespace std::chrono_literals;
-            // In rare cases, an event may be pushed and the condition
-            // variable signaled before the condition variable is waited on.
-            // To handle this, set a timeout on the wait.
-            std::unique_lock l{cvMutexes_[lt]};
-            // Allow for spurious wakeups. The alternative requires locking the
-            // eventsMutex_
-            cvs_[lt].wait_for(l, 1s);
-            continue;
+            for (std::size_t i = 0; i < localTxns.size(); ++i)
+            {
+                if (auto const toSubmit = signedTxns[i].get())
+                {
+                    metrics_.attests_[ct][am_signed].inc(
+                        localTxns[i]->numAttestations());
+                    auto const keys = traceKeys(ct, *localTxns[i]);
+                    tracer_.record(AttestTracer::st_signed, keys);
+                    submitTxn(std::move(localTxns[i]), ct, *toSubmit);
+                    tracer_.record(AttestTracer::st_submitted, keys);
+                }
+            }
         }
+
+        if (waitForEvent && !requestStop_)
+            submitWakeup_.wait(wakeupToken);
     }
 }
 
@@ -2120,40 +2811,175 @@ Federator::dbLoop()
 
     std::vector<FederatorDBEvent> localEvents;
     localEvents.reserve(16);
+    ChainArray<std::optional<event::DBUpdateLedger>> ledgers;
+    // Taken before the events are popped, so the events pushed before the
+    // ledger progress are in the same batch
+    auto takeLedgers = [&] {
+        std::lock_guard l{dbLedgerMutex_};
+        bool r = false;
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
+        {
+            if (dbLedgerSlot_[ct])
+            {
+                ledgers[ct] = std::move(dbLedgerSlot_[ct]);
+                dbLedgerSlot_[ct].reset();
+                r = true;
+            }
+        }
+        return r;
+    };
+
     while (!requestStop_)
     {
+        assert(localEvents.empty());
+        if (!dbEvents_.waitPopAll(localEvents, takeLedgers))
+            break;
+
+        auto const start = std::chrono::steady_clock::now();
         {
-            std::lock_guard l{eventsMutex_};
-            assert(localEvents.empty());
-            localEvents.swap(dbEvents_);
+            // The whole batch is written in one transaction, so there is one
+            // sync to disk per batch instead of one per statement. The
+            // session lock is recursive, onDBEvent handlers check it out
+            // again.
+            auto session = app_.getXChainTxnDB().checkoutDb();
+            soci::transaction tr(*session);
+            for (auto const& event : localEvents)
+                std::visit([this](auto&& e) { this->onDBEvent(e); }, event);
+            for (auto& ledger : ledgers)
+            {
+                if (!ledger)
+                    continue;
+                onDBEvent(*ledger);
+                ++dbStats_.ledgerUpdates_;
+                ledger.reset();
+            }
+            deleteDBBatch();
+            updateDBSyncTx();
+            // The attestation rows are durable before the sync tx is, so a
+            // crash replays the batch instead of losing it
+            app_.attestationStore(bridgeName_).commit();
+            tr.commit();
         }
-        if (localEvents.empty())
+        for (auto& [key, att] : dbBatchCache_)
         {
-            using namespace std::chrono_literals;
-            std::unique_lock l{cvMutexes_[lt]};
-            cvs_[lt].wait_for(l, 100ms);
-            continue;
+            publishAttestation(key, "signed", &att);
+            attestationCache_.put(key, std::move(att));
         }
-
-        auto const start =
-            duration_cast<std::chrono::milliseconds>(
-                std::chrono::high_resolution_clock::now().time_since_epoch())
-                .count();
-        for (auto const& event : localEvents)
-            std::visit([this](auto&& e) { this->onDBEvent(e); }, event);
-        auto const finish =
-            duration_cast<std::chrono::milliseconds>(
-                std::chrono::high_resolution_clock::now().time_since_epoch())
+        dbBatchCache_.clear();
+        auto const finish = std::chrono::steady_clock::now();
+        tracer_.record(
+            AttestTracer::st_dbCommitted, traceKeys(localEvents), finish);
+        auto const commitUs =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                finish - start)
                 .count();
+
+        std::uint32_t const batchSize = localEvents.size();
+        ++dbStats_.batches_;
+        dbStats_.events_ += batchSize;
+        dbStats_.lastSize_ = batchSize;
+        if (batchSize > dbStats_.maxSize_)
+            dbStats_.maxSize_ = batchSize;
+        dbStats_.lastCommitUs_ = commitUs;
+        dbStats_.totalCommitUs_ += commitUs;
+        if (commitUs > dbStats_.maxCommitUs_)
+            dbStats_.maxCommitUs_ = commitUs;
+        metrics_.dbCommit_.observe(commitUs);
+
         JLOGV(
             j_.debug(),
             "DB events processed",
-            jv("size", localEvents.size()),
-            jv("time(ms)", finish - start));
+            jv("size", batchSize),
+            jv("time(us)", commitUs));
         localEvents.clear();
     }
 }
 
+void
+Federator::updateDBSyncTx()
+{
+    for (auto const ct : {ChainType::locking, ChainType::issuing})
+    {
+        auto& txnHash = dbBatchSyncTx_[ct];
+        if (!txnHash)
+            continue;
+
+        auto session = app_.getXChainTxnDB().checkoutDb();
+        auto& q = session.prepared<db_stmt::UpdateSyncTx>(
+            db_stmt::UpdateSyncTx::name(bridgeName_));
+        q.txnId = convert(*txnHash, *session);
+        q.chainType = static_cast<std::uint32_t>(ct);
+        q.st.execute(true);
+        txnHash.reset();
+    }
+}
+
+void
+Federator::deleteDBBatch()
+{
+    for (auto const ct : {ChainType::locking, ChainType::issuing})
+    {
+        for (bool const isCreate : {false, true})
+        {
+            auto& ids = dbBatchDeletes_[ct][isCreate];
+            if (ids.empty())
+                continue;
+
+            // The IDs of a chain are consecutive, one erase per range
+            std::sort(ids.begin(), ids.end());
+            auto& store = app_.attestationStore(bridgeName_);
+            std::size_t ranges = 0;
+            for (auto it = ids.begin(); it != ids.end();)
+            {
+                auto last = it;
+                while (std::next(last) != ids.end() &&
+                       *std::next(last) <= *last + 1)
+                    ++last;
+                store.erase(ct, isCreate, *it, *last);
+                ++ranges;
+                it = std::next(last);
+            }
+
+            JLOGV(
+                j_.trace(),
+                "DB batch deleted",
+                jv("chainType", to_string(ct)),
+                jv("createAccount", isCreate),
+                jv("ids", ids.size()),
+                jv("ranges", ranges));
+            ids.clear();
+        }
+    }
+}
+
+void
+Federator::pruneDB(ChainType ct, std::uint32_t ledger)
+{
+    auto& store = app_.attestationStore(bridgeName_);
+    for (bool const isCreate : {false, true})
+    {
+        // The cache is the read path of the rows, it must not outlive them
+        auto const rows =
+            store.prune(ct, isCreate, ledger, [&](std::uint64_t id) {
+                AttestationCacheKey const key{ct, isCreate, id};
+                std::erase_if(dbBatchCache_, [&key](auto const& p) {
+                    return p.first == key;
+                });
+                attestationCache_.erase(key);
+            });
+        if (!rows)
+            continue;
+
+        JLOGV(
+            j_.debug(),
+            "DB pruned",
+            jv("chainType", to_string(ct)),
+            jv("createAccount", isCreate),
+            jv("ledger", ledger),
+            jv("rows", rows));
+    }
+}
+
 Json::Value
 Federator::getInfo() const
 {
@@ -2161,113 +2987,136 @@ Federator::getInfo() const
     // Track transactions per seconds
     // Track when last transaction or event was submitted
     Json::Value ret{Json::objectValue};
+    if (!bridgeName_.empty())
+        ret["name"] = bridgeName_;
     {
-        // Pending events
-        // In most cases, events have been moved by event loop thread
-        std::lock_guard l{eventsMutex_};
+        // Pending events. The queues can't be iterated, only the sizes are
+        // reported.
+        auto queueJson = [](auto const& q) {
+            auto const st = q.stats();
+            Json::Value jv{Json::objectValue};
+            jv["size"] = static_cast<Json::UInt>(st.size);
+            jv["capacity"] = static_cast<Json::UInt>(st.capacity);
+            jv["pushed"] = static_cast<Json::UInt>(st.pushed);
+            jv["full_waits"] = static_cast<Json::UInt>(st.fullWaits);
+            jv["last_latency_us"] = static_cast<Json::UInt>(st.lastLatencyUs);
+            jv["max_latency_us"] = static_cast<Json::UInt>(st.maxLatencyUs);
+            jv["avg_latency_us"] = static_cast<Json::UInt>(st.avgLatencyUs);
+            return jv;
+        };
+
         auto const sz = events_[ChainType::locking].size() +
             events_[ChainType::issuing].size();
         ret["pending_events_size"] = static_cast<unsigned>(sz);
-        if (sz > 0)
-        {
-            Json::Value pendingEvents{Json::arrayValue};
-            for (auto const& event : events_[ChainType::locking])
-            {
-                std::visit(
-                    [&](auto const& e) { pendingEvents.append(e.toJson()); },
-                    event);
-            }
-            for (auto const& event : events_[ChainType::issuing])
-            {
-                std::visit(
-                    [&](auto const& e) { pendingEvents.append(e.toJson()); },
-                    event);
-            }
-            ret["pending_events"] = pendingEvents;
-        }
+
+        Json::Value queues{Json::objectValue};
+        for (auto const ct : {ChainType::locking, ChainType::issuing})
+            queues[to_string(ct)] = queueJson(events_[ct]);
+        queues["db"] = queueJson(dbEvents_);
+        ret["event_queues"] = queues;
+    }
+
+    {
+        Json::Value db{Json::objectValue};
+        std::uint64_t const batches = dbStats_.batches_;
+        db["batches"] = static_cast<Json::UInt>(batches);
+        db["events"] = static_cast<Json::UInt>(dbStats_.events_.load());
+        db["last_batch_size"] = dbStats_.lastSize_.load();
+        db["max_batch_size"] = dbStats_.maxSize_.load();
+        db["last_commit_us"] =
+            static_cast<Json::UInt>(dbStats_.lastCommitUs_.load());
+        db["max_commit_us"] =
+            static_cast<Json::UInt>(dbStats_.maxCommitUs_.load());
+        db["avg_commit_us"] = static_cast<Json::UInt>(
+            batches ? dbStats_.totalCommitUs_ / batches : 0);
+        db["ledger_updates"] =
+            static_cast<Json::UInt>(dbStats_.ledgerUpdates_.load());
+        db["ledger_coalesced"] =
+            static_cast<Json::UInt>(dbStats_.ledgerCoalesced_.load());
+        db["store"] = app_.attestationStore(bridgeName_).getInfo();
+        ret["db"] = db;
     }
 
     for (ChainType ct : {ChainType::locking, ChainType::issuing})
     {
         Json::Value side{Json::objectValue};
         side["initiating"] = !syncFinished_ ? "True" : "False";
+        side["sync"] = getSyncInfo(ct);
+        side["history_paused"] = historyPaused_[ct].load();
+        side["history_pauses"] =
+            static_cast<Json::UInt>(historyPauses_[ct].value());
         side["ledger_index"] = chains_[ct].listener_->getCurrentLedger();
         side["fee"] = chains_[ct].listener_->getCurrentFee();
-
-        int commitCount = 0;
-        int createCount = 0;
-        Json::Value commitAttests{Json::arrayValue};
-        Json::Value createAttests{Json::arrayValue};
-        auto getAttests = [&](auto const& submissions) {
-            commitCount = 0;
-            createCount = 0;
-            commitAttests.clear();
-            createAttests.clear();
-            for (auto const& txn : submissions)
-            {
-                txn->forAttestIDs(
-                    [&](std::uint64_t id) {
-                        assert(
-                            id <= (std::uint64_t)
-                                      std::numeric_limits<std::uint32_t>::max);
-                        commitAttests.append((std::uint32_t)id);
-                        ++commitCount;
-                    },
-                    [&](std::uint64_t id) {
-                        assert(
-                            id <= (std::uint64_t)
-                                      std::numeric_limits<std::uint32_t>::max);
-                        createAttests.append((std::uint32_t)id);
-                        ++createCount;
-                    });
-            }
+        auto const feeState = chains_[ct].listener_->getFeeState();
+        side["open_ledger_fee"] = feeState.openLedgerFee;
+        side["load_factor"] = feeState.loadFactor / 1000.;
+
+        // The counters only, the IDs are listed by getAttestations()
+        auto countsJson = [](std::uint64_t commits, std::uint64_t creates) {
+            Json::Value jv{Json::objectValue};
+            jv["commit_attests_size"] = static_cast<Json::UInt>(commits);
+            jv["create_account_attests_size"] =
+                static_cast<Json::UInt>(creates);
+            return jv;
         };
+        side["submitted"] = countsJson(
+            submittedCounts_[ct].commits(), submittedCounts_[ct].creates());
+        side["errored"] = countsJson(
+            erroredCounts_[ct].commits(), erroredCounts_[ct].creates());
+        side["pending"] = countsJson(
+            pendingCounts_[ct].commits() + batchCounts_[ct].commits(),
+            pendingCounts_[ct].creates() + batchCounts_[ct].creates());
 
+        if (useBatch_)
         {
-            std::lock_guard l{txnsMutex_};
-            getAttests(submitted_[ct]);
-            Json::Value submitted{Json::objectValue};
-            submitted["commit_attests_size"] = commitCount;
-            if (commitCount)
-                submitted["commit_attests"] = commitAttests;
-            submitted["create_account_attests_size"] = createCount;
-            if (createCount)
-                submitted["create_account_attests"] = createAttests;
-            side["submitted"] = submitted;
-
-            getAttests(errored_[ct]);
-            Json::Value errored{Json::objectValue};
-            errored["commit_attests_size"] = commitCount;
-            if (commitCount > 0)
-                errored["commit_attests"] = commitAttests;
-            errored["create_account_attests_size"] = createCount;
-            if (createCount > 0)
-                errored["create_account_attests"] = createAttests;
-            side["errored"] = errored;
-
-            getAttests(txns_[ct]);
+            std::lock_guard bl{batchMutex_};
+            auto const& c = coalescers_[ct];
+            Json::Value batches{Json::objectValue};
+            batches["target"] = static_cast<Json::UInt>(c.target());
+            batches["max_delay"] = c.maxDelay();
+            batches["attestations"] = static_cast<Json::UInt>(c.attestations());
+            batches["size_flushes"] =
+                static_cast<Json::UInt>(c.flushes(AttestCoalescer::fr_size));
+            batches["boundary_flushes"] = static_cast<Json::UInt>(
+                c.flushes(AttestCoalescer::fr_boundary));
+            batches["deadline_flushes"] = static_cast<Json::UInt>(
+                c.flushes(AttestCoalescer::fr_deadline));
+            // Batches per size, the last entry counts the bigger ones too
+            Json::Value sizes{Json::arrayValue};
+            for (std::size_t n = 1; n <= AttestCoalescer::SizeBuckets; ++n)
+                sizes.append(static_cast<Json::UInt>(c.batches(n)));
+            batches["sizes"] = sizes;
+            side["batches"] = batches;
         }
+
         {
-            std::lock_guard l{batchMutex_};
-            for (auto const& a : curClaimAtts_[ct])
-            {
-                commitAttests.append((int)a.claimID);
-                ++commitCount;
-            }
-            for (auto const& a : curCreateAtts_[ct])
+            std::lock_guard l{txnsMutex_};
+            auto const& window = submitWindow_[ct];
+            Json::Value submitWindow{Json::objectValue};
+            submitWindow["adaptive"] = window.adaptive();
+            submitWindow["size"] = window.size();
+            submitWindow["min"] = window.min();
+            submitWindow["max"] = window.max();
+            submitWindow["landed"] = static_cast<Json::UInt>(window.landed());
+            submitWindow["decreases"] =
+                static_cast<Json::UInt>(window.decreases());
+            side["submit_window"] = submitWindow;
+
+            Json::Value scheduler{Json::objectValue};
+            scheduler["pending"] = txns_[ct].getInfo();
+            scheduler["errored"] = errored_[ct].getInfo();
+            side["scheduler"] = scheduler;
+
+            if (useTickets(ct))
             {
-                createAttests.append((int)a.createCount);
-                ++createCount;
+                auto const& pool = tickets_[ct];
+                Json::Value tickets{Json::objectValue};
+                tickets["free"] = static_cast<Json::UInt>(pool.free_.size());
+                tickets["to_create"] = pool.toCreate_;
+                tickets["create_last_ledger"] = pool.createLastLedger_;
+                side["tickets"] = tickets;
             }
         }
-        Json::Value pending{Json::objectValue};
-        pending["commit_attests_size"] = commitCount;
-        if (commitCount > 0)
-            pending["commit_attests"] = commitAttests;
-        pending["create_account_attests_size"] = createCount;
-        if (createCount > 0)
-            pending["create_account_attests"] = createAttests;
-        side["pending"] = pending;
 
         ret[to_string(ct)] = side;
     }
@@ -2275,37 +3124,469 @@ Federator::getInfo() const
     return ret;
 }
 
-void
-Federator::deleteFromDB(ChainType ct, std::uint64_t id, bool isCreateAccount)
+std::string
+Federator::getMetrics(
+    std::vector<std::unique_ptr<Federator>> const& federators)
 {
-    auto session = app_.getXChainTxnDB().checkoutDb();
-    auto const& tblName = [&]() {
-        if (isCreateAccount)
-            return db_init::xChainCreateAccountTableName(ct);
-        else
-            return db_init::xChainTableName(ct);
-    }();
+    static constexpr std::array<char const*, am_last> attestNames{
+        "signed", "submitted", "validated", "expired", "resubmitted"};
+    auto const chains = {ChainType::locking, ChainType::issuing};
+    assert(!federators.empty());
+    // The chain connections are shared by the bridges
+    auto const& front = *federators.front();
+
+    metrics::Writer w;
+    // The samples of a metric are written for every bridge in turn, the
+    // bridges of "Bridges" with their name as a label
+    auto const forEach = [&](auto&& write) {
+        for (auto const& f : federators)
+        {
+            metrics::Writer::LabelVector labels;
+            if (!f->bridgeName_.empty())
+                labels.emplace_back("bridge", f->bridgeName_);
+            w.commonLabels(std::move(labels));
+            write(*f);
+        }
+        w.commonLabels({});
+    };
 
-    auto const sql = [&]() {
-        if (isCreateAccount)
-            return fmt::format(
-                R"sql(DELETE FROM {table_name} WHERE CreateCount = :cid;
-                )sql",
-                fmt::arg("table_name", tblName));
-        else
-            return fmt::format(
-                R"sql(DELETE FROM {table_name} WHERE ClaimID = :cid;
-                )sql",
-                fmt::arg("table_name", tblName));
-    }();
-    *session << sql, soci::use(id);
-};
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            for (std::size_t i = 0; i < federatorEventNames.size(); ++i)
+                w.counter(
+                    "xbwd_events_total",
+                    "Events received from the chains.",
+                    {{"chain", to_string(ct)},
+                     {"type", federatorEventNames[i]}},
+                    f.metrics_.events_[ct][i].value());
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            for (std::size_t i = 0; i < am_last; ++i)
+                w.counter(
+                    "xbwd_attestations_total",
+                    "Attestations by state.",
+                    {{"chain", to_string(ct)}, {"state", attestNames[i]}},
+                    f.metrics_.attests_[ct][i].value());
+    });
+
+    forEach([&](Federator const& f) {
+        w.counter(
+            "xbwd_attestation_cache_total",
+            "Lookups of the witness RPCs in the attestation cache.",
+            {{"result", "hit"}},
+            f.attestationCache_.hits());
+        w.counter(
+            "xbwd_attestation_cache_total",
+            "Lookups of the witness RPCs in the attestation cache.",
+            {{"result", "miss"}},
+            f.attestationCache_.misses());
+    });
+
+    forEach([&](Federator const& f) {
+        w.gauge(
+            "xbwd_attestation_cache_size",
+            "Attestations in the cache.",
+            {},
+            f.attestationCache_.size());
+    });
+
+    if (auto const* async = AsyncLog::active())
+        w.counter(
+            "xbwd_log_dropped_total",
+            "Log messages dropped with a full async log queue.",
+            {},
+            async->dropped());
+
+    forEach([&](Federator const& f) {
+        w.histogram(
+            "xbwd_db_batch_seconds",
+            "Time to write one batch of DB events.",
+            {},
+            f.metrics_.dbCommit_);
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            w.gauge(
+                "xbwd_event_queue_size",
+                "Events waiting to be processed.",
+                {{"chain", to_string(ct)}},
+                f.events_[ct].size());
+    });
+
+    forEach([&](Federator const& f) {
+        w.gauge(
+            "xbwd_db_queue_size",
+            "DB events waiting to be written.",
+            {},
+            f.dbEvents_.size());
+    });
+
+    forEach([&](Federator const& f) {
+        // The attestations of txns_ and of the in-progress batches
+        for (auto const ct : chains)
+        {
+            w.gauge(
+                "xbwd_pending_attestations",
+                "Attestations waiting to be submitted.",
+                {{"chain", to_string(ct)}, {"kind", "commit"}},
+                f.pendingCounts_[ct].commits() +
+                    f.batchCounts_[ct].commits());
+            w.gauge(
+                "xbwd_pending_attestations",
+                "Attestations waiting to be submitted.",
+                {{"chain", to_string(ct)}, {"kind", "create_account"}},
+                f.pendingCounts_[ct].creates() +
+                    f.batchCounts_[ct].creates());
+        }
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+        {
+            w.gauge(
+                "xbwd_submitted_attestations",
+                "Attestations submitted and not validated yet.",
+                {{"chain", to_string(ct)}, {"kind", "commit"}},
+                f.submittedCounts_[ct].commits());
+            w.gauge(
+                "xbwd_submitted_attestations",
+                "Attestations submitted and not validated yet.",
+                {{"chain", to_string(ct)}, {"kind", "create_account"}},
+                f.submittedCounts_[ct].creates());
+        }
+    });
+
+    for (auto const ct : chains)
+    {
+        auto const& traffic = front.chains_[ct].listener_->getWsTraffic();
+        w.counter(
+            "xbwd_ws_messages_total",
+            "Websocket messages.",
+            {{"chain", to_string(ct)}, {"direction", "read"}},
+            traffic.readMsgs_.value());
+        w.counter(
+            "xbwd_ws_messages_total",
+            "Websocket messages.",
+            {{"chain", to_string(ct)}, {"direction", "write"}},
+            traffic.writeMsgs_.value());
+    }
+
+    for (auto const ct : chains)
+    {
+        auto const& traffic = front.chains_[ct].listener_->getWsTraffic();
+        w.counter(
+            "xbwd_ws_bytes_total",
+            "Websocket bytes.",
+            {{"chain", to_string(ct)}, {"direction", "read"}},
+            traffic.readBytes_.value());
+        w.counter(
+            "xbwd_ws_bytes_total",
+            "Websocket bytes.",
+            {{"chain", to_string(ct)}, {"direction", "write"}},
+            traffic.writeBytes_.value());
+    }
+
+    for (auto const ct : chains)
+    {
+        auto const& traffic = front.chains_[ct].listener_->getWsTraffic();
+        w.counter(
+            "xbwd_ws_buffers_total",
+            "Websocket receive buffers, reused from the pool or allocated.",
+            {{"chain", to_string(ct)}, {"result", "hit"}},
+            traffic.bufferHits_.value());
+        w.counter(
+            "xbwd_ws_buffers_total",
+            "Websocket receive buffers, reused from the pool or allocated.",
+            {{"chain", to_string(ct)}, {"result", "miss"}},
+            traffic.bufferMisses_.value());
+    }
+
+    for (auto const ct : chains)
+    {
+        auto const& traffic = front.chains_[ct].listener_->getWsTraffic();
+        w.gauge(
+            "xbwd_ws_queue_size",
+            "Websocket messages waiting for the callback thread.",
+            {{"chain", to_string(ct)}},
+            traffic.queueSize_.load());
+    }
+
+    for (auto const ct : chains)
+    {
+        auto const& traffic = front.chains_[ct].listener_->getWsTraffic();
+        w.gauge(
+            "xbwd_ws_write_queue_size",
+            "Websocket messages sent and waiting to be written.",
+            {{"chain", to_string(ct)}},
+            traffic.writeQueueSize_.load());
+    }
+
+    for (auto const ct : chains)
+    {
+        auto const& traffic = front.chains_[ct].listener_->getWsTraffic();
+        w.gauge(
+            "xbwd_ws_max_queue_size",
+            "Most websocket messages processed in one callback batch.",
+            {{"chain", to_string(ct)}},
+            traffic.maxQueueSize_.load());
+    }
+
+    for (auto const ct : chains)
+    {
+        auto const& traffic = front.chains_[ct].listener_->getWsTraffic();
+        w.counter(
+            "xbwd_ws_read_pauses_total",
+            "Websocket reads stopped at the high-water mark of the queue.",
+            {{"chain", to_string(ct)}},
+            traffic.readPauses_.value());
+    }
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            w.gauge(
+                "xbwd_history_paused",
+                "1 while the history requests wait for the queues to drain.",
+                {{"chain", to_string(ct)}},
+                f.historyPaused_[ct].load() ? 1 : 0);
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            w.counter(
+                "xbwd_history_pauses_total",
+                "History requests paused at the high mark of the queues.",
+                {{"chain", to_string(ct)}},
+                f.historyPauses_[ct].value());
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            w.gauge(
+                "xbwd_rpc_outstanding",
+                "Requests to the chain waiting for a reply.",
+                {{"chain", to_string(ct)}},
+                f.chains_[ct].listener_->getOutstandingRequests());
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            w.counter(
+                "xbwd_rpc_timeouts_total",
+                "Requests to the chain without a reply in time.",
+                {{"chain", to_string(ct)}},
+                f.chains_[ct].listener_->getRpcTimeouts().value());
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            w.counter(
+                "xbwd_rpc_hedged_total",
+                "Requests sent to a second node of the chain as well.",
+                {{"chain", to_string(ct)}},
+                f.chains_[ct].listener_->getHedgedRequests().value());
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            for (auto const& n : f.chains_[ct].listener_->getNodesHealth())
+                w.gauge(
+                    "xbwd_node_ledger_lag",
+                    "Validated ledgers of a node behind the most advanced "
+                    "node.",
+                    {{"chain", to_string(ct)}, {"node", n.endpoint_}},
+                    n.lag_);
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            for (auto const& n : f.chains_[ct].listener_->getNodesHealth())
+                w.gauge(
+                    "xbwd_node_latency_ms",
+                    "Moving average of the server_info round trip of a node.",
+                    {{"chain", to_string(ct)}, {"node", n.endpoint_}},
+                    n.latencyMs_);
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            for (auto const& n : f.chains_[ct].listener_->getNodesHealth())
+                w.gauge(
+                    "xbwd_node_up",
+                    "1 if the node replies to the probes.",
+                    {{"chain", to_string(ct)}, {"node", n.endpoint_}},
+                    n.up_ ? 1 : 0);
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            for (auto const& n : f.chains_[ct].listener_->getNodesHealth())
+                w.gauge(
+                    "xbwd_node_stream",
+                    "1 for the node of the ledger and transaction stream.",
+                    {{"chain", to_string(ct)}, {"node", n.endpoint_}},
+                    n.active_ ? 1 : 0);
+    });
+
+    forEach([&](Federator const& f) {
+        for (auto const ct : chains)
+            w.histogram(
+                "xbwd_rpc_round_trip_seconds",
+                "Time from a request to the chain to its callback.",
+                {{"chain", to_string(ct)}},
+                f.chains_[ct].listener_->getRpcRoundTrip());
+    });
+
+    forEach([&](Federator const& f) {
+        for (std::size_t s = AttestTracer::st_dispatched;
+             s < AttestTracer::st_last;
+             ++s)
+            w.histogram(
+                "xbwd_attest_stage_seconds",
+                "Latency of the attestation stages, from the stage before.",
+                {{"stage", AttestTracer::stageNames[s]}},
+                f.tracer_.latency(static_cast<AttestTracer::Stage>(s)));
+    });
+
+    forEach([&](Federator const& f) {
+        w.histogram(
+            "xbwd_attest_seconds",
+            "Latency from the commit transaction to the confirmed attestation.",
+            {},
+            f.tracer_.total());
+    });
+
+    writeLockMetrics(w);
+
+    return w.str();
+}
+
+Json::Value
+Federator::getTraces(std::uint32_t limit) const
+{
+    Json::Value traces{Json::arrayValue};
+    for (auto const& t : tracer_.recent(limit))
+    {
+        Json::Value jt{Json::objectValue};
+        jt["chain_type"] = to_string(t.key.chain);
+        jt[t.key.createAccount ? "create_count" : "claim_id"] =
+            static_cast<Json::UInt>(t.key.id);
+        jt["received_time"] = static_cast<Json::UInt>(
+            std::chrono::duration_cast<std::chrono::seconds>(
+                t.wallReceived.time_since_epoch())
+                .count());
+        jt["submits"] = t.submits;
+
+        // Microseconds since the commit transaction was received
+        Json::Value stages{Json::objectValue};
+        auto const& received = *t.stages[AttestTracer::st_received];
+        for (std::size_t s = AttestTracer::st_dispatched;
+             s < AttestTracer::st_last;
+             ++s)
+        {
+            if (auto const& stage = t.stages[s])
+                stages[AttestTracer::stageNames[s]] = static_cast<Json::UInt>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        *stage - received)
+                        .count());
+        }
+        jt["stages_us"] = stages;
+        traces.append(jt);
+    }
+
+    Json::Value ret{Json::objectValue};
+    ret["traces"] = traces;
+    ret["active"] = static_cast<Json::UInt>(tracer_.active());
+    return ret;
+}
+
+Json::Value
+Federator::getAttestations(
+    ChainType ct,
+    AttestList list,
+    std::uint32_t marker,
+    std::uint32_t limit) const
+{
+    Json::Value commitAttests{Json::arrayValue};
+    Json::Value createAttests{Json::arrayValue};
+    auto const addCommit = [&](std::uint64_t id) {
+        commitAttests.append(static_cast<Json::UInt>(id));
+    };
+    auto const addCreate = [&](std::uint64_t id) {
+        createAttests.append(static_cast<Json::UInt>(id));
+    };
+
+    // Position of the next entry, across the collections
+    std::uint32_t pos = 0;
+    std::uint32_t taken = 0;
+    bool more = false;
+    auto page = [&](auto const& entries, auto&& f) {
+        if (more)
+            return;
+        std::uint32_t const skip = marker > pos
+            ? std::min<std::uint32_t>(marker - pos, entries.size())
+            : 0;
+        pos += skip;
+        for (auto it = std::next(entries.begin(), skip); it != entries.end();
+             ++it, ++pos)
+        {
+            if (taken == limit)
+            {
+                more = true;
+                return;
+            }
+            f(*it);
+            ++taken;
+        }
+    };
+    auto const addSubmission = [&](auto const& s) {
+        s->forAttestIDs(addCommit, addCreate);
+    };
+
+    switch (list)
+    {
+        case AttestList::submitted: {
+            std::lock_guard l{txnsMutex_};
+            page(submitted_[ct], addSubmission);
+            break;
+        }
+        case AttestList::errored: {
+            std::lock_guard l{txnsMutex_};
+            page(errored_[ct].items(), addSubmission);
+            break;
+        }
+        case AttestList::pending: {
+            {
+                std::lock_guard l{txnsMutex_};
+                page(txns_[ct].items(), addSubmission);
+            }
+            std::lock_guard l{batchMutex_};
+            page(curClaimAtts_[ct], [&](auto const& a) {
+                addCommit(a.claimID);
+            });
+            page(curCreateAtts_[ct], [&](auto const& a) {
+                addCreate(a.createCount);
+            });
+            break;
+        }
+    }
+
+    Json::Value ret{Json::objectValue};
+    ret["commit_attests"] = commitAttests;
+    ret["create_account_attests"] = createAttests;
+    ret["limit"] = limit;
+    if (more)
+        ret["marker"] = pos;
+    return ret;
+}
 
 void
 Federator::pullAndAttestTx(
     ripple::STXChainBridge const& bridge,
     ChainType ct,
-    ripple::uint256 const& txHash,
+    std::vector<ripple::uint256> const& txHashes,
     Json::Value& result)
 {
     // TODO multi bridge
@@ -2315,13 +3596,70 @@ Federator::pullAndAttestTx(
         return;
     }
 
-    auto callback = [this, srcChain = ct](Json::Value const& v) {
-        chains_[srcChain].listener_->processTx(v);
+    std::vector<ripple::uint256> hashes;
+    hashes.reserve(txHashes.size());
+    for (auto const& h : txHashes)
+        if (std::find(hashes.begin(), hashes.end(), h) == hashes.end())
+            hashes.push_back(h);
+
+    // Outlives the request if a reply is late
+    struct Pulled
+    {
+        std::mutex m;
+        std::condition_variable cv;
+        std::vector<std::optional<Json::Value>> replies;
+        std::size_t left;
     };
+    auto pulled = std::make_shared<Pulled>();
+    pulled->replies.resize(hashes.size());
+    pulled->left = hashes.size();
+
+    // In flight together, the listener answers each one, if only with a
+    // timeout error
+    auto& listener = *chains_[ct].listener_;
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        Json::Value request;
+        request[ripple::jss::transaction] = to_string(hashes[i]);
+        listener.send(
+            "tx",
+            request,
+            [pulled, i](Json::Value const& v) {
+                std::lock_guard l{pulled->m};
+                if (pulled->replies[i])
+                    return;
+                pulled->replies[i] = v;
+                if (!--pulled->left)
+                    pulled->cv.notify_all();
+            },
+            /*hedge*/ true);
+    }
 
-    Json::Value request;
-    request[ripple::jss::transaction] = to_string(txHash);
-    chains_[ct].listener_->send("tx", request, callback);
+    std::vector<std::optional<Json::Value>> replies;
+    {
+        std::unique_lock l{pulled->m};
+        pulled->cv.wait_for(l, std::chrono::minutes(1), [&pulled] {
+            return !pulled->left;
+        });
+        replies = pulled->replies;
+    }
+
+    auto& jtxs = (result["transactions"] = Json::arrayValue);
+    for (std::size_t i = 0; i < hashes.size(); ++i)
+    {
+        Json::Value jtx(Json::objectValue);
+        jtx["tx_hash"] = to_string(hashes[i]);
+        if (!replies[i])
+            jtx[ripple::jss::status] = "timeout";
+        else if (auto const err = listener.processTx(*replies[i]); err.empty())
+            jtx[ripple::jss::status] = "attesting";
+        else
+        {
+            jtx[ripple::jss::status] = "ignored";
+            jtx["reason"] = err;
+        }
+        jtxs.append(std::move(jtx));
+    }
 }
 
 std::size_t
@@ -2396,22 +3734,179 @@ Federator::setNetworkID(std::uint32_t networkID, ChainType ct)
 
         // Fix NetworkID for tx from DB
         std::lock_guard tl{txnsMutex_};
-        auto& subs(submitted_[ct]);
-        for (auto& s : subs)
-            s->networkID_ = networkID;
+        submitted_[ct].modifyAll(
+            [networkID](Submission& s) { s.setNetworkID(networkID); });
     }
 }
 
 bool
 SubmissionSort::operator<(const SubmissionSort& s) const
 {
-    return v1 ? v1 < s.v1 : v2 < s.v2;
+    // Claims (v1 not set) first, then by ID
+    return std::tie(v1, v2) < std::tie(s.v1, s.v2);
 }
 
 bool
 SubmissionSort::operator==(const SubmissionSort& s) const
 {
-    return v1 ? v1 == s.v1 : v2 == s.v2;
+    return std::tie(v1, v2) == std::tie(s.v1, s.v2);
+}
+
+void
+AttestCounters::add(std::uint64_t commits, std::uint64_t creates)
+{
+    commits_.fetch_add(commits, std::memory_order_relaxed);
+    creates_.fetch_add(creates, std::memory_order_relaxed);
+}
+
+void
+AttestCounters::add(Submission const& s)
+{
+    s.forAttestIDs(
+        [this](std::uint64_t) {
+            commits_.fetch_add(1, std::memory_order_relaxed);
+        },
+        [this](std::uint64_t) {
+            creates_.fetch_add(1, std::memory_order_relaxed);
+        });
+}
+
+void
+AttestCounters::remove(Submission const& s)
+{
+    s.forAttestIDs(
+        [this](std::uint64_t) {
+            commits_.fetch_sub(1, std::memory_order_relaxed);
+        },
+        [this](std::uint64_t) {
+            creates_.fetch_sub(1, std::memory_order_relaxed);
+        });
+}
+
+void
+AttestCounters::clear()
+{
+    commits_.store(0, std::memory_order_relaxed);
+    creates_.store(0, std::memory_order_relaxed);
+}
+
+void
+SubmissionStore::push_back(SubmissionPtr&& s)
+{
+    counters_.add(*s);
+    c_.push_back(std::move(s));
+}
+
+SubmissionPtr
+SubmissionStore::extractBySqn(std::uint32_t accountSqn)
+{
+    auto& idx = c_.get<by_sqn>();
+    auto const it = idx.find(accountSqn);
+    if (it == idx.end())
+        return {};
+    counters_.remove(**it);
+    return std::move(idx.extract(it).value());
+}
+
+std::vector<SubmissionPtr>
+SubmissionStore::extractByID(
+    std::optional<std::uint64_t> const& claimID,
+    std::optional<std::uint64_t> const& createCount)
+{
+    std::vector<SubmissionPtr> r;
+    auto& idx = c_.get<by_id>();
+    auto extract = [&](SubmissionSort const& key) {
+        auto [it, last] = idx.equal_range(key);
+        while (it != last)
+        {
+            counters_.remove(**it);
+            r.push_back(std::move(idx.extract(it++).value()));
+        }
+    };
+    // The same keys as Submission*::getSort()
+    if (claimID)
+        extract({{}, *claimID});
+    if (createCount)
+        extract({*createCount, {}});
+    return r;
+}
+
+std::vector<SubmissionPtr>
+SubmissionStore::extractExpired(std::uint32_t ledger)
+{
+    std::vector<SubmissionPtr> r;
+    auto& idx = c_.get<by_ledger>();
+    auto const last = idx.upper_bound(ledger);
+    for (auto it = idx.begin(); it != last;)
+    {
+        counters_.remove(**it);
+        r.push_back(std::move(idx.extract(it++).value()));
+    }
+    return r;
+}
+
+void
+SubmissionQueue::push_back(SubmissionPtr&& s)
+{
+    // A batch is scheduled by its first create account, if any
+    std::optional<std::uint64_t> createCount;
+    s->forAttestIDs(
+        [](std::uint64_t) {},
+        [&](std::uint64_t id) {
+            if (!createCount || id < *createCount)
+                createCount = id;
+        });
+
+    // The others in the arrival order, the expiration order for the
+    // resubmits
+    Class cls = sc_claim;
+    if (createCount)
+        cls = sc_create;
+    else if (!s->retriesAllowed_)
+        cls = sc_last_retry;
+    counters_.add(*s);
+    scheduler_.push(cls, {createCount.value_or(0), 0}, std::move(s));
+}
+
+std::vector<SubmissionPtr>
+SubmissionQueue::extractFirst(std::size_t n)
+{
+    auto r = scheduler_.pop(n);
+    for (auto const& s : r)
+        counters_.remove(*s);
+    return r;
+}
+
+std::vector<Submission const*>
+SubmissionQueue::items() const
+{
+    std::vector<Submission const*> r;
+    r.reserve(scheduler_.size());
+    scheduler_.forEach([&r](SubmissionPtr const& s) { r.push_back(s.get()); });
+    return r;
+}
+
+Json::Value
+SubmissionQueue::getInfo() const
+{
+    static char const* const names[sc_last] = {
+        "last_retry", "create_account", "claim"};
+    auto const now = SubmitScheduler<SubmissionPtr>::clock::now();
+    Json::Value ret{Json::objectValue};
+    for (std::size_t cls = 0; cls < sc_last; ++cls)
+    {
+        auto const st = scheduler_.stats(cls, now);
+        Json::Value jv{Json::objectValue};
+        jv["depth"] = static_cast<Json::UInt>(st.depth);
+        jv["pushed"] = static_cast<Json::UInt>(st.pushed);
+        jv["popped"] = static_cast<Json::UInt>(st.popped);
+        jv["last_wait_us"] = static_cast<Json::UInt>(st.lastWaitUs);
+        jv["max_wait_us"] = static_cast<Json::UInt>(st.maxWaitUs);
+        jv["avg_wait_us"] = static_cast<Json::UInt>(st.avgWaitUs);
+        jv["oldest_wait_us"] = static_cast<Json::UInt>(st.oldestWaitUs);
+        ret[names[cls]] = jv;
+    }
+    return ret;
 }
 
 Submission::Submission(
@@ -2432,6 +3927,27 @@ Submission::getLogName() const
     return logName_;
 }
 
+ripple::STTx
+Submission::getSignedTxn(
+    config::TxnSubmit const& txn,
+    ripple::XRPAmount const& fee,
+    beast::Journal j) const
+{
+    if (body_.empty())
+        body_ = getTxnBody(txn, j);
+    return xbwd::txn::signTxnBody(
+        body_, accountSqn_, ticket_, lastLedgerSeq_, fee, txn.keypair, j);
+}
+
+void
+Submission::setNetworkID(std::uint32_t networkID)
+{
+    if (networkID_ == networkID)
+        return;
+    networkID_ = networkID;
+    body_ = ripple::Buffer();
+}
+
 bool
 Submission::operator<(const Submission& s) const
 {
@@ -2473,21 +3989,17 @@ SubmissionBatch::numAttestations() const
     return batch_.numAttestations();
 }
 
-ripple::STTx
-SubmissionBatch::getSignedTxn(
-    config::TxnSubmit const& txn,
-    ripple::XRPAmount const& fee,
-    beast::Journal j) const
+ripple::Buffer
+SubmissionBatch::getTxnBody(config::TxnSubmit const& txn, beast::Journal j)
+    const
 {
-    return xbwd::txn::getSignedTxn(
+    return xbwd::txn::getTxnBody(
         txn.submittingAccount,
         batch_,
         ripple::jss::XChainAddAttestations,
         batch_.getFName().getJsonName(),
-        accountSqn_,
-        lastLedgerSeq_,
-        fee,
-        txn.keypair,
+        networkID_,
+        txn.keypair.first,
         j);
 }
 
@@ -2529,22 +4041,17 @@ SubmissionClaim::numAttestations() const
     return 1;
 }
 
-ripple::STTx
-SubmissionClaim::getSignedTxn(
-    config::TxnSubmit const& txn,
-    ripple::XRPAmount const& fee,
-    beast::Journal j) const
+ripple::Buffer
+SubmissionClaim::getTxnBody(config::TxnSubmit const& txn, beast::Journal j)
+    const
 {
-    return xbwd::txn::getSignedTxn(
+    return xbwd::txn::getTxnBody(
         txn.submittingAccount,
         *this,
         ripple::jss::XChainAddClaimAttestation,
         Json::StaticString(nullptr),
-        accountSqn_,
-        lastLedgerSeq_,
         networkID_,
-        fee,
-        txn.keypair,
+        txn.keypair.first,
         j);
 }
 
@@ -2598,22 +4105,18 @@ SubmissionCreateAccount::numAttestations() const
     return 1;
 }
 
-ripple::STTx
-SubmissionCreateAccount::getSignedTxn(
+ripple::Buffer
+SubmissionCreateAccount::getTxnBody(
     config::TxnSubmit const& txn,
-    ripple::XRPAmount const& fee,
     beast::Journal j) const
 {
-    return xbwd::txn::getSignedTxn(
+    return xbwd::txn::getTxnBody(
         txn.submittingAccount,
         *this,
         ripple::jss::XChainAddAccountCreateAttestation,
         Json::StaticString(nullptr),
-        accountSqn_,
-        lastLedgerSeq_,
         networkID_,
-        fee,
-        txn.keypair,
+        txn.keypair.first,
         j);
 }
 
@@ -20,10 +20,21 @@
 
 #include <xbwd/app/Config.h>
 #include <xbwd/basics/ChainTypes.h>
+#include <xbwd/basics/InstrumentedMutex.h>
+#include <xbwd/basics/MPSCQueue.h>
+#include <xbwd/basics/Metrics.h>
 #include <xbwd/basics/StructuredLog.h>
 #include <xbwd/basics/ThreadSaftyAnalysis.h>
 #include <xbwd/client/ChainListener.h>
+#include <xbwd/federator/AttestationCache.h>
+#include <xbwd/federator/AttestCoalescer.h>
+#include <xbwd/federator/AttestTracer.h>
 #include <xbwd/federator/FederatorEvents.h>
+#include <xbwd/federator/HistoryPause.h>
+#include <xbwd/federator/ReplayBuffer.h>
+#include <xbwd/federator/SigningPool.h>
+#include <xbwd/federator/SubmitScheduler.h>
+#include <xbwd/federator/SubmitWindow.h>
 
 #include <ripple/basics/hardened_hash.h>
 #include <ripple/beast/net/IPEndpoint.h>
@@ -39,16 +50,21 @@
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
-#include <deque>
 #include <functional>
-#include <list>
+#include <future>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
 #include <utility>
@@ -64,6 +80,31 @@ static constexpr std::uint8_t MaxResubmits = 5;
 static constexpr std::uint8_t TxnTTLLedgers = 4;
 // txn fee in addition to the reference txn fee in the last observed ledger
 static constexpr std::uint32_t FeeExtraDrops = 10;
+// capacity of each event queue, a producer waits when its queue is full
+static constexpr std::size_t EventQueueCapacity = 1 << 14;
+// the history requests of a chain pause once its event queue, the DB queue or
+// the pending submissions of its attestations, to the other chain, reach the
+// high mark, until all are under the low mark. The listener isn't blocked on
+// a full queue by the history.
+static constexpr std::size_t QueueHighMark = EventQueueCapacity / 2;
+static constexpr std::size_t QueueLowMark = EventQueueCapacity / 8;
+static constexpr std::size_t TxnsHighMark = 1 << 13;
+static constexpr std::size_t TxnsLowMark = 1 << 11;
+static constexpr HistoryMarks HistoryPauseMarks{
+    QueueHighMark,
+    QueueLowMark,
+    TxnsHighMark,
+    TxnsLowMark};
+// the digests of the landed attestations are kept in the DB for about 3 days
+// of ledgers, a longer downtime falls back on the history scan
+static constexpr std::uint32_t AttestedKeepLedgers = 1 << 16;
+// the init sync replay of each chain keeps up to this many bytes of events in
+// memory, the others go to a file
+static constexpr std::size_t ReplayMemoryBytes = 32 << 20;
+// the latency traces of the attestations not confirmed yet, and of the last
+// confirmed ones
+static constexpr std::size_t TraceActiveMax = 1 << 14;
+static constexpr std::size_t TraceKeep = 1 << 10;
 
 struct SubmissionSort
 {
@@ -85,6 +126,8 @@ struct Submission
     // control mechanism and probably does not worth it?
     std::uint32_t lastLedgerSeq_;
     std::uint32_t accountSqn_;
+    // accountSqn_ is a ticket sequence
+    bool ticket_ = false;
 
     std::uint32_t networkID_;
 
@@ -113,11 +156,22 @@ struct Submission
     virtual std::size_t
     numAttestations() const = 0;
 
-    virtual ripple::STTx
+    // Sign the transaction with the current sequence, last ledger and fee.
+    // The body is built by the first call, the next ones only patch these.
+    ripple::STTx
     getSignedTxn(
         config::TxnSubmit const& txn,
         ripple::XRPAmount const& fee,
-        beast::Journal j) const = 0;
+        beast::Journal j) const;
+
+    // The body holds the NetworkID, it is built again by the next
+    // getSignedTxn()
+    void
+    setNetworkID(std::uint32_t networkID);
+
+    // The transaction without the submit fields, see txn::getTxnBody()
+    virtual ripple::Buffer
+    getTxnBody(config::TxnSubmit const& txn, beast::Journal j) const = 0;
 
     virtual bool
     checkID(
@@ -139,6 +193,11 @@ protected:
         std::uint32_t accountSqn,
         std::uint32_t networkID,
         std::string_view const logName);
+
+private:
+    // Serialized transaction of getTxnBody(). A submission is signed by one
+    // job at a time.
+    mutable ripple::Buffer body_;
 };
 
 typedef std::unique_ptr<Submission> SubmissionPtr;
@@ -165,11 +224,8 @@ struct SubmissionBatch : public Submission
     virtual std::size_t
     numAttestations() const override;
 
-    virtual ripple::STTx
-    getSignedTxn(
-        config::TxnSubmit const& txn,
-        ripple::XRPAmount const& fee,
-        beast::Journal j) const override;
+    virtual ripple::Buffer
+    getTxnBody(config::TxnSubmit const& txn, beast::Journal j) const override;
 };
 
 #endif
@@ -197,11 +253,8 @@ struct SubmissionClaim : public Submission
     virtual std::size_t
     numAttestations() const override;
 
-    virtual ripple::STTx
-    getSignedTxn(
-        config::TxnSubmit const& txn,
-        ripple::XRPAmount const& fee,
-        beast::Journal j) const override;
+    virtual ripple::Buffer
+    getTxnBody(config::TxnSubmit const& txn, beast::Journal j) const override;
 
     virtual bool
     checkID(
@@ -235,11 +288,8 @@ struct SubmissionCreateAccount : public Submission
     virtual std::size_t
     numAttestations() const override;
 
-    virtual ripple::STTx
-    getSignedTxn(
-        config::TxnSubmit const& txn,
-        ripple::XRPAmount const& fee,
-        beast::Journal j) const override;
+    virtual ripple::Buffer
+    getTxnBody(config::TxnSubmit const& txn, beast::Journal j) const override;
 
     virtual bool
     checkID(
@@ -291,26 +341,240 @@ struct AttestedHistoryTx
 
     static std::optional<AttestedHistoryTx>
     fromEvent(FederatorEvent const& e);
+
+    // Stable across the restarts, saved in the DB
+    ripple::uint256
+    digest() const;
 };
 
 struct TransactionCache
 {
-    std::string id_;  // ClaimID or CreateID
-    std::string tx_;  // tx hash of XChainCommit /  XChainAccountCreateCommit
-                      // transaction
+    // Is create account, ClaimID or CreateCount
+    using ID = std::pair<bool, std::uint64_t>;
+
+    ID id_;
+    // tx hash of XChainCommit /  XChainAccountCreateCommit transaction
+    ripple::uint256 tx_;
 };
 
 typedef boost::multi_index::multi_index_container<
     TransactionCache,
     boost::multi_index::indexed_by<
         boost::multi_index::hashed_unique<
-            boost::multi_index::
-                member<TransactionCache, std::string, &TransactionCache::tx_>>,
+            boost::multi_index::member<
+                TransactionCache,
+                ripple::uint256,
+                &TransactionCache::tx_>,
+            ripple::hardened_hash<>>,
         boost::multi_index::hashed_non_unique<
-            boost::multi_index::
-                member<TransactionCache, std::string, &TransactionCache::id_>>>>
+            boost::multi_index::member<
+                TransactionCache,
+                TransactionCache::ID,
+                &TransactionCache::id_>,
+            ripple::hardened_hash<>>>>
     TransactionCacheContainer;
 
+// Numbers of the attestations in a collection of submissions. Updated with
+// the collection, under its lock, and read without the lock.
+class AttestCounters
+{
+    std::atomic_uint64_t commits_{0u};
+    std::atomic_uint64_t creates_{0u};
+
+public:
+    void
+    add(std::uint64_t commits, std::uint64_t creates);
+
+    void
+    add(Submission const& s);
+
+    void
+    remove(Submission const& s);
+
+    void
+    clear();
+
+    std::uint64_t
+    commits() const
+    {
+        return commits_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t
+    creates() const
+    {
+        return creates_.load(std::memory_order_relaxed);
+    }
+};
+
+// Submissions of a chain. Indexed by account sequence for the submit results,
+// by last ledger for the expiration and by attested ID for the attestation
+// results and the resubmission order. The keys of a stored submission must
+// only be changed through `modifyAll`.
+class SubmissionStore
+{
+    struct AccountSqnKey
+    {
+        using result_type = std::uint32_t;
+        result_type
+        operator()(SubmissionPtr const& s) const
+        {
+            return s->accountSqn_;
+        }
+    };
+
+    struct LastLedgerKey
+    {
+        using result_type = std::uint32_t;
+        result_type
+        operator()(SubmissionPtr const& s) const
+        {
+            return s->lastLedgerSeq_;
+        }
+    };
+
+    struct IDKey
+    {
+        using result_type = SubmissionSort;
+        result_type
+        operator()(SubmissionPtr const& s) const
+        {
+            return s->getSort();
+        }
+    };
+
+    struct by_sqn
+    {
+    };
+    struct by_ledger
+    {
+    };
+    struct by_id
+    {
+    };
+
+    using Container = boost::multi_index::multi_index_container<
+        SubmissionPtr,
+        boost::multi_index::indexed_by<
+            boost::multi_index::sequenced<>,
+            boost::multi_index::hashed_non_unique<
+                boost::multi_index::tag<by_sqn>,
+                AccountSqnKey>,
+            boost::multi_index::ordered_non_unique<
+                boost::multi_index::tag<by_ledger>,
+                LastLedgerKey>,
+            boost::multi_index::ordered_non_unique<
+                boost::multi_index::tag<by_id>,
+                IDKey>>>;
+
+    Container c_;
+    AttestCounters& counters_;
+
+public:
+    explicit SubmissionStore(AttestCounters& counters) : counters_(counters)
+    {
+    }
+
+    bool
+    empty() const
+    {
+        return c_.empty();
+    }
+
+    std::size_t
+    size() const
+    {
+        return c_.size();
+    }
+
+    // In insertion order
+    auto
+    begin() const
+    {
+        return c_.begin();
+    }
+
+    auto
+    end() const
+    {
+        return c_.end();
+    }
+
+    void
+    push_back(SubmissionPtr&& s);
+
+    // Remove the first submission with this account sequence
+    SubmissionPtr
+    extractBySqn(std::uint32_t accountSqn);
+
+    // Remove all the submissions of this claim ID and of this create count
+    std::vector<SubmissionPtr>
+    extractByID(
+        std::optional<std::uint64_t> const& claimID,
+        std::optional<std::uint64_t> const& createCount);
+
+    // Remove the submissions with the last ledger not after `ledger`, in the
+    // last ledger order
+    std::vector<SubmissionPtr>
+    extractExpired(std::uint32_t ledger);
+
+    // Update every submission, the keys may change
+    template <class F>
+    void
+    modifyAll(F&& f)
+    {
+        for (auto it = c_.begin(); it != c_.end(); ++it)
+            c_.modify(it, [&f](SubmissionPtr& s) { f(*s); });
+    }
+};
+
+// Submissions waiting to be submitted, or resubmitted, on a chain. The claims
+// on their last retry, the closest to give up, go first. Then the create
+// account attestations, in the createCount order they must land in, so a
+// flood of claims doesn't hold them. Then the other claims, in the arrival
+// order: the expiration order for the resubmits.
+class SubmissionQueue
+{
+public:
+    enum Class { sc_last_retry, sc_create, sc_claim, sc_last };
+
+private:
+    SubmitScheduler<SubmissionPtr> scheduler_{sc_last};
+    AttestCounters& counters_;
+
+public:
+    explicit SubmissionQueue(AttestCounters& counters) : counters_(counters)
+    {
+    }
+
+    bool
+    empty() const
+    {
+        return scheduler_.empty();
+    }
+
+    std::size_t
+    size() const
+    {
+        return scheduler_.size();
+    }
+
+    void
+    push_back(SubmissionPtr&& s);
+
+    // Remove at most `n` submissions, in the pick order
+    std::vector<SubmissionPtr>
+    extractFirst(std::size_t n);
+
+    // In the pick order
+    std::vector<Submission const*>
+    items() const;
+
+    // Depth and wait times by class
+    Json::Value
+    getInfo() const;
+};
+
 class Federator
 {
     enum LoopTypes {
@@ -327,6 +591,9 @@ class Federator
 
     App& app_;
     ripple::STXChainBridge const bridge_;
+    // Of the config, empty for the top level bridge. Suffix of the tables,
+    // statements and store of the bridge.
+    std::string const bridgeName_;
 
     struct Chain
     {
@@ -345,17 +612,90 @@ class Federator
     ChainArray<Chain> chains_;
     ChainArray<bool const> const autoSubmit_;  // event thread only
 
-    mutable std::mutex eventsMutex_;
-    ChainArray<std::vector<FederatorEvent>> GUARDED_BY(eventsMutex_) events_;
+    // One queue per event loop, pushed by the listeners
+    ChainArray<MPSCQueue<FederatorEvent>> events_{
+        EventQueueCapacity,
+        EventQueueCapacity};
 
     // Not divided by sidechains because attestation events need to be
     // processed after commit events(to delete them in the DB).
-    std::vector<FederatorDBEvent> GUARDED_BY(eventsMutex_) dbEvents_;
-
-    mutable std::mutex txnsMutex_;
-    ChainArray<std::vector<SubmissionPtr>> GUARDED_BY(txnsMutex_) txns_;
-    ChainArray<std::list<SubmissionPtr>> GUARDED_BY(txnsMutex_) submitted_;
-    ChainArray<std::vector<SubmissionPtr>> GUARDED_BY(txnsMutex_) errored_;
+    MPSCQueue<FederatorDBEvent> dbEvents_{EventQueueCapacity};
+
+    // The latest ledger progress of each chain, written once per DB batch.
+    // A newer one replaces the one not written yet.
+    ProfiledMutex<> dbLedgerMutex_{"db_ledger"};
+    ChainArray<std::optional<event::DBUpdateLedger>> GUARDED_BY(
+        dbLedgerMutex_) dbLedgerSlot_;
+
+    // The latest commit transaction written in the current DB batch, per
+    // chain. The sync table is updated once per batch. DB thread only.
+    ChainArray<std::optional<ripple::uint256>> dbBatchSyncTx_;
+
+    // Attestations written in the current DB batch, cached once committed.
+    // DB thread only.
+    std::vector<std::pair<AttestationCacheKey, CachedAttestation>>
+        dbBatchCache_;
+
+    // IDs deleted in the current DB batch, per chain, claims then create
+    // accounts. They are deleted by ranges at the end of the batch. DB thread
+    // only.
+    ChainArray<std::array<std::vector<std::uint64_t>, 2>> dbBatchDeletes_;
+
+    // DB batch statistics, written by the DB thread, reported by getInfo()
+    struct DBBatchStats
+    {
+        std::atomic_uint64_t batches_{0u};
+        std::atomic_uint64_t events_{0u};
+        std::atomic_uint32_t lastSize_{0u};
+        std::atomic_uint32_t maxSize_{0u};
+        std::atomic_uint64_t lastCommitUs_{0u};
+        std::atomic_uint64_t maxCommitUs_{0u};
+        std::atomic_uint64_t totalCommitUs_{0u};
+        // Ledger progress written, and replaced before it was
+        std::atomic_uint64_t ledgerUpdates_{0u};
+        std::atomic_uint64_t ledgerCoalesced_{0u};
+    };
+    DBBatchStats dbStats_;
+
+    // Reported by getMetrics()
+    enum AttestMetrics {
+        am_signed,
+        am_submitted,
+        am_validated,
+        am_expired,
+        am_resubmitted,
+        am_last
+    };
+    struct Metrics
+    {
+        ChainArray<std::array<
+            metrics::Counter,
+            std::variant_size_v<FederatorEvent>>>
+            events_;
+        ChainArray<std::array<metrics::Counter, am_last>> attests_;
+        metrics::Histogram dbCommit_;
+    };
+    Metrics metrics_;
+    AttestTracer tracer_{TraceActiveMax, TraceKeep};
+
+    // Attestation counts of the submissions, reported by getInfo() without
+    // the locks. pendingCounts_ counts txns_, batchCounts_ the in-progress
+    // batches.
+    ChainArray<AttestCounters> submittedCounts_;
+    ChainArray<AttestCounters> erroredCounts_;
+    ChainArray<AttestCounters> pendingCounts_;
+    ChainArray<AttestCounters> batchCounts_;
+
+    mutable ProfiledMutex<> txnsMutex_{"txns"};
+    ChainArray<SubmissionQueue> GUARDED_BY(txnsMutex_) txns_{
+        pendingCounts_[ChainType::locking],
+        pendingCounts_[ChainType::issuing]};
+    ChainArray<SubmissionStore> GUARDED_BY(txnsMutex_) submitted_{
+        submittedCounts_[ChainType::locking],
+        submittedCounts_[ChainType::issuing]};
+    ChainArray<SubmissionQueue> GUARDED_BY(txnsMutex_) errored_{
+        erroredCounts_[ChainType::locking],
+        erroredCounts_[ChainType::issuing]};
 
     // Cache of the events added to processing. It is added so as not to read
     // the DB. No need for mutex as event processing is synchronized. Insertion
@@ -363,9 +703,25 @@ class Federator
     // the same claimID
     ChainArray<TransactionCacheContainer> txnsInProcessing_;
 
-    // "Window" size for sending attestations
-    // 0 - no "window"
-    std::uint32_t const maxAttToSend_ = 0;
+    // "Window" size for sending attestations, fixed or adaptive
+    ChainArray<SubmitWindow> GUARDED_BY(txnsMutex_) submitWindow_;
+
+    // Tickets of the submitting account, when config::TxnSubmit::tickets is
+    // set. The owned tickets are read with account_objects, the ones used by
+    // the submissions are not free.
+    struct TicketPool
+    {
+        std::set<std::uint32_t> free_;
+        // Taken since the account_objects request
+        std::set<std::uint32_t> taken_;
+        bool refreshing_ = false;
+        std::uint32_t refreshLedger_ = 0;
+        // Tickets to create
+        std::uint32_t toCreate_ = 0;
+        // Last ledger of the TicketCreate in flight
+        std::uint32_t createLastLedger_ = 0;
+    };
+    ChainArray<TicketPool> GUARDED_BY(txnsMutex_) tickets_;
 
     std::optional<ripple::AccountID> signingAccount_;
     ripple::KeyType const keyType_;
@@ -374,19 +730,23 @@ class Federator
 
     ChainArray<SignerListInfo> signerListsInfo_;
 
-    // Use a condition variable to prevent busy waiting when the queue is
-    // empty
-    mutable std::array<std::mutex, lt_last> cvMutexes_;
-    mutable std::array<std::condition_variable, lt_last> cvs_;
+    // Wake the submit loop up when there may be something to submit: new
+    // attestations, a released submit window, a new ledger, the account
+    // sequence. The event and DB loops are woken up by their queues.
+    Wakeup submitWakeup_;
 
     // prevent the main loop from starting until explictly told to run.
     // This is used to allow bootstrap code to run before any events are
     // processed
-    mutable std::array<std::mutex, lt_last> loopMutexes_;
+    mutable std::array<ProfiledMutex<>, lt_last> loopMutexes_{
+        {{"loop_event_locking"},
+         {"loop_event_issuing"},
+         {"loop_txn_submit"},
+         {"loop_db"}}};
     std::array<bool, lt_last> loopLocked_;
-    std::array<std::condition_variable, lt_last> loopCvs_;
+    std::array<std::condition_variable_any, lt_last> loopCvs_;
 
-    mutable std::mutex batchMutex_;
+    mutable ProfiledMutex<> batchMutex_{"batch"};
     // in-progress batches (one collection for each attestation type). Will be
     // submitted when either all the transactions from that ledger are
     // collected, or the batch limit is reached
@@ -398,7 +758,12 @@ class Federator
         batchMutex_) curClaimAtts_;
     ChainArray<std::vector<ripple::Attestations::AttestationCreateAccount>>
         GUARDED_BY(batchMutex_) curCreateAtts_;
+    // When the in-progress batches are submitted, and the achieved sizes
+    ChainArray<AttestCoalescer> GUARDED_BY(batchMutex_) coalescers_;
     ChainArray<std::uint32_t> accountSqns_{0u, 0u};  // tx submit thread only
+    // The TTL of the submissions loaded from the DB is set on the first new
+    // ledger of the chain. Event thread of the chain only.
+    ChainArray<bool> ttlFixed_{false, false};
 
     struct InitSync
     {
@@ -418,23 +783,60 @@ class Federator
         // History index, used for the events order checks
         std::int32_t rpcOrder_{std::numeric_limits<std::int32_t>::min()};
 
-        // Set of historical attestation. Fill through playing
+        // Digests of the historical attestations. Fill through playing
         // historical transactions.
-        std::unordered_set<AttestedHistoryTx, ripple::hardened_hash<>>
-            attestedTx_;
+        FingerprintSet attestedTx_;
+
+        // Checkpoint of the previous session, the processed ledgers of the
+        // door and submit accounts.
+        std::uint32_t dbDoorLedgerSqn_{0u};
+        std::uint32_t dbSubmitLedgerSqn_{0u};
+
+        // Digests of the attestations landed in the previous sessions. Used
+        // with attestedTx_, the history scan stops at the checkpoint.
+        FingerprintSet dbAttestedTx_;
+
+        // The first history ledger seen and when, for the progress reported
+        // by getInfo(). Written by the event thread of the chain.
+        std::atomic_uint32_t historyStartLedger_{0u};
+        std::atomic<std::chrono::steady_clock::rep> historyStart_{0};
     };
 
+    // A chain leaves the sync once its own history is done: the attestations
+    // to it are expired and resubmitted from then on. The held events are
+    // replayed once both chains are done, in order and checked against the
+    // attestations of the other chain.
     ChainArray<InitSync> initSync_;
     // flag show that sync is finished AND all historical transactions are
     // already replayed
     std::atomic_bool syncFinished_{false};
-    ChainArray<std::deque<FederatorEvent>> replays_;
+    // The events held while syncing, spilled to DBDir past ReplayMemoryBytes
+    ChainArray<std::unique_ptr<ReplayBuffer>> replays_;
     beast::Journal j_;
 
     bool const useBatch_;
 
+    // Ledgers the claim and create account rows are kept for, 0 - forever
+    std::uint32_t const retainLedgers_;
+
+    // The witness RPCs read it through, the DB thread fills it once the
+    // attestations are committed and erases the deleted ones
+    AttestationCache attestationCache_;
+
     ChainArray<std::atomic_uint32_t> networkID_;
 
+    // Of historyPaused(), per chain
+    ChainArray<std::atomic_bool> historyPaused_;
+    ChainArray<metrics::Counter> historyPauses_;
+
+    // Signs the attestations and the submitted transactions. Declared last,
+    // so the pending jobs finish before the members they use are destroyed.
+    SigningPool signingPool_;
+
+    // Startup load of the DB attestations, see init(). Destroyed first: its
+    // destructor waits for readDBAttests().
+    std::future<void> dbLoad_;
+
 public:
     // Tag so make_Federator can call `std::make_shared`
     class PrivateTag
@@ -462,7 +864,7 @@ public:
     stop() EXCLUDES(m_);
 
     void
-    push(FederatorEvent&& e) EXCLUDES(m_, eventsMutex_);
+    push(FederatorEvent&& e) EXCLUDES(m_);
 
     // Don't process any events until the bootstrap has a chance to run
     void
@@ -471,22 +873,82 @@ public:
     Json::Value
     getInfo() const;
 
+    ripple::STXChainBridge const&
+    bridge() const
+    {
+        return bridge_;
+    }
+
+    std::string const&
+    bridgeName() const
+    {
+        return bridgeName_;
+    }
+
+    bool
+    useBatch() const
+    {
+        return useBatch_;
+    }
+
+    // The Prometheus text format, of all the federators of the process
+    static std::string
+    getMetrics(std::vector<std::unique_ptr<Federator>> const& federators);
+
+    // True while the history requests of the chain must wait, see
+    // QueueHighMark. Called by the listener of the chain.
+    bool
+    historyPaused(ChainType ct);
+
+    AttestationCache&
+    attestationCache()
+    {
+        return attestationCache_;
+    }
+
+    // The last confirmed attestations, with the time of each stage
+    Json::Value
+    getTraces(std::uint32_t limit) const;
+
+    enum class AttestList { submitted, errored, pending };
+
+    /**
+     * A page of the attestation IDs of the submitted, errored or pending
+     * submissions. The pending ones are followed by the attestations of the
+     * in-progress batch.
+     *
+     * @param ct the chain type
+     * @param list the submissions to list
+     * @param marker the position of the first entry, returned as "marker"
+     *        with the previous page. The entries may move between the pages.
+     * @param limit the maximum number of entries in the page
+     */
+    Json::Value
+    getAttestations(
+        ChainType ct,
+        AttestList list,
+        std::uint32_t marker,
+        std::uint32_t limit) const EXCLUDES(txnsMutex_, batchMutex_);
+
     /**
-     * Answering a RPC request for attesting an out of order transaction.
-     * The local witness node sends a tx RPC request to the connected
-     * rippled node to pull the details of a transaction. If the response
-     * has the right details, attest the transaction.
+     * Answering a RPC request for attesting out of order transactions.
+     * The local witness node sends the tx RPC requests to the connected
+     * rippled node all at once to pull the details of the transactions.
+     * Once all are answered, the transactions with the right details are
+     * attested together, so they are submitted in as few batches as
+     * possible.
      *
      * @param bridge the bridge spec
      * @param ct the chain type
-     * @param txHash the transaction hash
-     * @param result the response to the RPC request.
+     * @param txHashes the transaction hashes, the duplicates are ignored
+     * @param result the response to the RPC request, with the status of
+     * each transaction
      */
     void
     pullAndAttestTx(
         ripple::STXChainBridge const& bridge,
         ChainType ct,
-        ripple::uint256 const& txHash,
+        std::vector<ripple::uint256> const& txHashes,
         Json::Value& result);
 
     void
@@ -516,6 +978,21 @@ private:
     void
     dbLoop();
 
+    // Sign, in parallel, the attestations of the events of a batch. The
+    // signature is stored in the event, the future must be waited on before
+    // the event is used. The future is invalid for the events with nothing
+    // to sign, without the signing threads nothing is signed here.
+    std::vector<std::future<void>>
+    signAttestations(std::vector<FederatorEvent>& events);
+
+    // Attestation of a successful commit, std::nullopt otherwise. Reuse the
+    // signature of the event if it has one.
+    std::optional<ripple::Attestations::AttestationClaim>
+    makeAttestation(event::XChainCommitDetected const& e) const;
+
+    std::optional<ripple::Attestations::AttestationCreateAccount>
+    makeAttestation(event::XChainAccountCreateCommitDetected const& e) const;
+
     void
     onEvent(event::XChainCommitDetected const& e);
 
@@ -561,6 +1038,37 @@ private:
     void
     onDBEvent(event::DBUpdateLedger const& e);
 
+    void
+    onDBEvent(event::DBAttested const& e);
+
+    // Write the sync table updates collected in the current DB batch
+    void
+    updateDBSyncTx();
+
+    // Delete the IDs collected in the current DB batch
+    void
+    deleteDBBatch();
+
+    // Delete the claim and create account rows of the chain older than the
+    // retained ledgers
+    void
+    pruneDB(ChainType ct, std::uint32_t ledger);
+
+    // To the subscribers of the attestations stream, see rpc::Publisher.
+    // The attestation itself is only sent once signed.
+    void
+    publishAttestation(
+        AttestationCacheKey const& key,
+        char const* status,
+        CachedAttestation const* att = nullptr);
+
+    // Every attestation of a submission to the chain
+    void
+    publishAttestations(
+        ChainType ct,
+        Submission const& sub,
+        char const* status);
+
     void
     initSync(
         ChainType const ct,
@@ -571,9 +1079,14 @@ private:
     void
     tryFinishInitSync(ChainType const ct);
 
+    // Either chain still processes its history
     bool
     isSyncing() const;
 
+    // The sync progress of a chain, for getInfo()
+    Json::Value
+    getSyncInfo(ChainType ct) const;
+
     void
     pushAtt(
         ripple::STXChainBridge const& bridge,
@@ -592,25 +1105,36 @@ private:
     void
     pushAttOnSubmitTxn(
         ripple::STXChainBridge const& bridge,
-        ChainType chainType) REQUIRES(batchMutex_)
-        EXCLUDES(txnsMutex_, cvMutexes_);
+        ChainType chainType) REQUIRES(batchMutex_) EXCLUDES(txnsMutex_);
+
+    // std::nullopt if there is nothing to submit
+    std::optional<ripple::STTx>
+    signTxn(
+        Submission const& submission,
+        ChainType dstChain,
+        ripple::XRPAmount const& fee) const;
 
     void
-    submitTxn(SubmissionPtr&& submission, ChainType dstChain);
+    submitTxn(
+        SubmissionPtr&& submission,
+        ChainType dstChain,
+        ripple::STTx const& toSubmit);
 
     void
-    pushDB(FederatorDBEvent&& e) EXCLUDES(eventsMutex_);
+    pushDB(FederatorDBEvent&& e);
 
+    // Replace the ledger progress of the chain, and wake the DB thread
     void
-    deleteFromDB(
-        ChainType ct,
-        std::uint64_t claimID,
-        bool isCreateAccount);  // TODO add bridge
+    pushDBLedger(event::DBUpdateLedger const& e);
 
     // send the attestations for the events from this chain
     void
     readDBAttests(ChainType ct);
 
+    // digests of the attestations landed on this chain
+    void
+    readDBAttested(ChainType ct);
+
     friend std::unique_ptr<Federator>
     make_Federator(
         App& app,
@@ -624,6 +1148,21 @@ private:
     void
     checkExpired(ChainType ct, std::uint32_t ledger);
 
+    bool
+    useTickets(ChainType ct) const;
+
+    // Request the owned tickets, at most once per ledger
+    void
+    refreshTickets(ChainType ct) EXCLUDES(txnsMutex_);
+
+    // Submit TicketCreate with the account sequence. Submit thread only.
+    void
+    createTickets(ChainType ct, std::uint32_t count) EXCLUDES(txnsMutex_);
+
+    // Congestion on the chain, halve the adaptive submit window
+    void
+    shrinkWindow(ChainType ct, std::string_view reason) REQUIRES(txnsMutex_);
+
     void
     checkProcessedLedger(ChainType ct);
 };
@@ -216,6 +216,20 @@ DBUpdateLedger::toJson() const
     result["chainType"] = to_string(chainType_);
     result["eventType"] = "DBUpdateLedger";
     result["ledger"] = ledger_;
+    result["doorLedger"] = doorLedger_;
+    result["submitLedger"] = submitLedger_;
+
+    return result;
+}
+
+Json::Value
+DBAttested::toJson() const
+{
+    Json::Value result{Json::objectValue};
+    result["chainType"] = to_string(chainType_);
+    result["eventType"] = "DBAttested";
+    result["digest"] = to_string(digest_);
+    result["ledger"] = ledger_;
 
     return result;
 }
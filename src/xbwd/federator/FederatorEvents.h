@@ -22,12 +22,15 @@
 #include <xbwd/basics/ChainTypes.h>
 #include <xbwd/client/RpcResultParse.h>
 
+#include <ripple/basics/Buffer.h>
 #include <ripple/json/json_value.h>
 #include <ripple/protocol/AccountID.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/STXChainBridge.h>
 #include <ripple/protocol/TER.h>
 
+#include <array>
+#include <chrono>
 #include <optional>
 #include <variant>
 
@@ -52,6 +55,14 @@ struct XChainCommitDetected
     std::optional<std::int32_t> rpcOrder_;
     bool ledgerBoundary_;
 
+    // Attestation signature, set by the federator once signed so the DB
+    // thread and the replays don't sign again
+    std::optional<ripple::Buffer> signature_{};
+
+    // When the listener parsed the transaction, for the latency traces
+    std::chrono::steady_clock::time_point received_{
+        std::chrono::steady_clock::now()};
+
     Json::Value
     toJson() const;
 };
@@ -75,6 +86,14 @@ struct XChainAccountCreateCommitDetected
     std::optional<std::int32_t> rpcOrder_;
     bool ledgerBoundary_;
 
+    // Attestation signature, set by the federator once signed so the DB
+    // thread and the replays don't sign again
+    std::optional<ripple::Buffer> signature_{};
+
+    // When the listener parsed the transaction, for the latency traces
+    std::chrono::steady_clock::time_point received_{
+        std::chrono::steady_clock::now()};
+
     Json::Value
     toJson() const;
 };
@@ -179,10 +198,26 @@ struct DBDelete
     toJson() const;
 };
 
+// Not queued with the DB events, the latest one of a chain is written once per
+// DB batch
 struct DBUpdateLedger
 {
     ChainType chainType_ = ChainType::locking;
     std::uint32_t ledger_ = 0;
+    // checkpoint, the processed ledgers of the door and submit accounts
+    std::uint32_t doorLedger_ = 0;
+    std::uint32_t submitLedger_ = 0;
+
+    Json::Value
+    toJson() const;
+};
+
+// An attestation landed on the chain
+struct DBAttested
+{
+    ChainType chainType_ = ChainType::locking;
+    ripple::uint256 digest_;
+    std::uint32_t ledger_ = 0;
 
     Json::Value
     toJson() const;
@@ -202,6 +237,20 @@ using FederatorEvent = std::variant<
     event::XChainAccountSet,
     event::EndOfHistory>;
 
+// Names of the FederatorEvent alternatives, in the variant order
+inline constexpr std::array<char const*, std::variant_size_v<FederatorEvent>>
+    federatorEventNames{
+        "XChainCommitDetected",
+        "XChainAccountCreateCommitDetected",
+        "HeartbeatTimer",
+        "XChainTransferResult",
+        "XChainAttestsResult",
+        "NewLedger",
+        "XChainSignerListSet",
+        "XChainSetRegularKey",
+        "XChainAccountSet",
+        "EndOfHistory"};
+
 Json::Value
 toJson(FederatorEvent const& event);
 
@@ -209,6 +258,6 @@ using FederatorDBEvent = std::variant<
     event::XChainCommitDetected,
     event::XChainAccountCreateCommitDetected,
     event::DBDelete,
-    event::DBUpdateLedger>;
+    event::DBAttested>;
 
 }  // namespace xbwd
@@ -0,0 +1,68 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <algorithm>
+#include <cstdint>
+
+namespace xbwd {
+
+// What the chain reports about the fees
+struct FeeState
+{
+    // Base fee of the last closed ledger, from the ledger stream
+    std::uint32_t ledgerFee = 0;
+    // Fee to get into the open ledger, from the 'fee' command. 0 - unknown
+    std::uint32_t openLedgerFee = 0;
+    // Server load factor, from server_info, in 1/1000. 1000 - no load
+    std::uint32_t loadFactor = 1000;
+};
+
+struct FeeLimits
+{
+    // Added to the computed fee
+    std::uint32_t extraDrops = 0;
+    // Never pay more, unless the ledger base fee is higher. 0 - no cap
+    std::uint32_t maxFee = 0;
+};
+
+// Fee in drops for a transaction resubmitted `resubmits` times. The base is
+// the ledger fee scaled by the load, or the open ledger fee if higher. It
+// doubles on every resubmission, so an expired transaction does not wait in
+// the queue again at the same fee.
+inline std::uint64_t
+computeFee(
+    FeeState const& state,
+    std::uint32_t resubmits,
+    FeeLimits const& limits)
+{
+    std::uint64_t const loaded =
+        std::uint64_t(state.ledgerFee) * std::max(state.loadFactor, 1000u) /
+        1000;
+    std::uint64_t fee = std::max<std::uint64_t>(loaded, state.openLedgerFee);
+    fee += limits.extraDrops;
+    fee <<= std::min(resubmits, 16u);
+    if (limits.maxFee)
+        fee = std::max<std::uint64_t>(
+            std::min<std::uint64_t>(fee, limits.maxFee), state.ledgerFee);
+    return fee;
+}
+
+}  // namespace xbwd
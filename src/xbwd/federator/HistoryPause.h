@@ -0,0 +1,62 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <cstddef>
+
+namespace xbwd {
+
+// What the history of a chain feeds
+struct HistoryLoad
+{
+    // The event queue of the chain
+    std::size_t events = 0;
+    // The DB queue, shared by both chains
+    std::size_t dbEvents = 0;
+    // The pending submissions of the attestations of the chain, to the other
+    // chain
+    std::size_t txns = 0;
+};
+
+/**
+ *  When the history requests of a chain wait.
+ *
+ *  The history pauses once a load reaches its high mark and resumes once all
+ *  the loads are down to their low marks.
+ */
+struct HistoryMarks
+{
+    std::size_t queueHigh;
+    std::size_t queueLow;
+    std::size_t txnsHigh;
+    std::size_t txnsLow;
+
+    bool
+    paused(bool wasPaused, HistoryLoad const& load) const
+    {
+        if (!wasPaused)
+            return load.events >= queueHigh || load.dbEvents >= queueHigh ||
+                load.txns >= txnsHigh;
+        return load.events > queueLow || load.dbEvents > queueLow ||
+            load.txns > txnsLow;
+    }
+};
+
+}  // namespace xbwd
@@ -0,0 +1,530 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/federator/ReplayBuffer.h>
+
+#include <ripple/protocol/Serializer.h>
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace xbwd {
+
+namespace {
+
+// A record is its body size, the body and the size again. The body is the
+// type, the chain, the flags of the optional fields, then the fields.
+enum RecordType : std::uint8_t { rtCommit = 0, rtCreateAccount = 1 };
+
+enum RecordFlags : std::uint8_t {
+    rfBridge = 0x01,
+    rfDeliveredAmt = 0x02,
+    rfOtherChainDst = 0x04,
+    rfStatus = 0x08,
+    rfRpcOrder = 0x10,
+    rfLedgerBoundary = 0x20,
+    rfSignature = 0x40,
+};
+
+std::size_t constexpr SizeBytes = sizeof(std::uint32_t);
+
+[[noreturn]] void
+throwErrno(std::string const& what, std::string const& path)
+{
+    throw std::runtime_error(fmt::format(
+        "replay buffer: {} {}: {}", what, path, std::strerror(errno)));
+}
+
+class Encoder
+{
+    std::string& s_;
+
+public:
+    explicit Encoder(std::string& s) : s_(s)
+    {
+    }
+
+    template <class T>
+    void
+    put(T v)
+    {
+        s_.append(reinterpret_cast<char const*>(&v), sizeof(v));
+    }
+
+    template <std::size_t Bits, class Tag>
+    void
+    raw(ripple::base_uint<Bits, Tag> const& v)
+    {
+        s_.append(reinterpret_cast<char const*>(v.data()), v.size());
+    }
+
+    void
+    bytes(void const* data, std::size_t size)
+    {
+        put(static_cast<std::uint16_t>(size));
+        s_.append(static_cast<char const*>(data), size);
+    }
+
+    template <class T>
+    void
+    serialized(T const& v)
+    {
+        ripple::Serializer s;
+        v.add(s);
+        bytes(s.data(), s.size());
+    }
+};
+
+class Decoder
+{
+    char const* p_;
+    char const* const end_;
+
+    void
+    need(std::size_t size) const
+    {
+        if (end_ - p_ < static_cast<std::ptrdiff_t>(size))
+            throw std::runtime_error("replay buffer: short record");
+    }
+
+public:
+    Decoder(char const* p, std::size_t size) : p_(p), end_(p + size)
+    {
+    }
+
+    template <class T>
+    T
+    get()
+    {
+        T v;
+        need(sizeof(v));
+        std::memcpy(&v, p_, sizeof(v));
+        p_ += sizeof(v);
+        return v;
+    }
+
+    template <class T>
+    T
+    raw()
+    {
+        T v;
+        need(v.size());
+        std::memcpy(v.data(), p_, v.size());
+        p_ += v.size();
+        return v;
+    }
+
+    ripple::Buffer
+    bytes()
+    {
+        auto const size = get<std::uint16_t>();
+        need(size);
+        ripple::Buffer r(p_, size);
+        p_ += size;
+        return r;
+    }
+
+    ripple::STAmount
+    amount()
+    {
+        auto const b = bytes();
+        ripple::SerialIter s(b.data(), b.size());
+        return ripple::STAmount{s, ripple::sfAmount};
+    }
+
+    ripple::STXChainBridge
+    bridge()
+    {
+        auto const b = bytes();
+        ripple::SerialIter s(b.data(), b.size());
+        return ripple::STXChainBridge{s, ripple::sfXChainBridge};
+    }
+};
+
+// The fields both commit events have
+template <class E>
+std::uint8_t
+commonFlags(E const& e, ripple::STXChainBridge const& bridge)
+{
+    std::uint8_t flags = 0;
+    if (e.bridge_ != bridge)
+        flags |= rfBridge;
+    if (e.deliveredAmt_)
+        flags |= rfDeliveredAmt;
+    if (e.status_ != ripple::tesSUCCESS)
+        flags |= rfStatus;
+    if (e.rpcOrder_)
+        flags |= rfRpcOrder;
+    if (e.ledgerBoundary_)
+        flags |= rfLedgerBoundary;
+    if (e.signature_)
+        flags |= rfSignature;
+    return flags;
+}
+
+template <class E>
+void
+encodeHead(Encoder& enc, E const& e, std::uint8_t type, std::uint8_t flags)
+{
+    enc.put(type);
+    enc.put(static_cast<std::uint8_t>(e.chainType_));
+    enc.put(flags);
+    enc.raw(e.src_);
+    if (flags & rfBridge)
+        enc.serialized(e.bridge_);
+    if (e.deliveredAmt_)
+        enc.serialized(*e.deliveredAmt_);
+}
+
+template <class E>
+void
+encodeTail(Encoder& enc, E const& e)
+{
+    enc.put(e.ledgerSeq_);
+    enc.raw(e.txnHash_);
+    if (e.status_ != ripple::tesSUCCESS)
+        enc.put(static_cast<std::int32_t>(ripple::TERtoInt(e.status_)));
+    if (e.rpcOrder_)
+        enc.put(*e.rpcOrder_);
+    if (e.signature_)
+        enc.bytes(e.signature_->data(), e.signature_->size());
+}
+
+template <class E>
+void
+decodeHead(
+    Decoder& dec,
+    E& e,
+    std::uint8_t flags,
+    ripple::STXChainBridge const& bridge)
+{
+    e.src_ = dec.raw<ripple::AccountID>();
+    e.bridge_ = (flags & rfBridge) ? dec.bridge() : bridge;
+    if (flags & rfDeliveredAmt)
+        e.deliveredAmt_ = dec.amount();
+}
+
+template <class E>
+void
+decodeTail(Decoder& dec, E& e, std::uint8_t flags)
+{
+    e.ledgerSeq_ = dec.get<std::uint32_t>();
+    e.txnHash_ = dec.raw<ripple::uint256>();
+    e.status_ = (flags & rfStatus)
+        ? ripple::TER::fromInt(dec.get<std::int32_t>())
+        : ripple::TER{ripple::tesSUCCESS};
+    if (flags & rfRpcOrder)
+        e.rpcOrder_ = dec.get<std::int32_t>();
+    e.ledgerBoundary_ = flags & rfLedgerBoundary;
+    if (flags & rfSignature)
+        e.signature_ = dec.bytes();
+}
+
+void
+encode(
+    std::string& out,
+    FederatorEvent const& event,
+    ripple::STXChainBridge const& bridge)
+{
+    Encoder enc(out);
+    if (auto const e = std::get_if<event::XChainCommitDetected>(&event))
+    {
+        auto flags = commonFlags(*e, bridge);
+        if (e->otherChainDst_)
+            flags |= rfOtherChainDst;
+        encodeHead(enc, *e, rtCommit, flags);
+        enc.put(e->claimID_);
+        if (e->otherChainDst_)
+            enc.raw(*e->otherChainDst_);
+        encodeTail(enc, *e);
+    }
+    else if (
+        auto const e =
+            std::get_if<event::XChainAccountCreateCommitDetected>(&event))
+    {
+        encodeHead(enc, *e, rtCreateAccount, commonFlags(*e, bridge));
+        enc.serialized(e->rewardAmt_);
+        enc.put(e->createCount_);
+        enc.raw(e->otherChainDst_);
+        encodeTail(enc, *e);
+    }
+    else
+        throw std::logic_error("replay buffer: not a commit event");
+}
+
+FederatorEvent
+decode(char const* data, std::size_t size, ripple::STXChainBridge const& bridge)
+{
+    Decoder dec(data, size);
+    auto const type = dec.get<std::uint8_t>();
+    auto const ct = static_cast<ChainType>(dec.get<std::uint8_t>());
+    auto const flags = dec.get<std::uint8_t>();
+    if (type == rtCommit)
+    {
+        event::XChainCommitDetected e;
+        e.chainType_ = ct;
+        decodeHead(dec, e, flags, bridge);
+        e.claimID_ = dec.get<std::uint64_t>();
+        if (flags & rfOtherChainDst)
+            e.otherChainDst_ = dec.raw<ripple::AccountID>();
+        decodeTail(dec, e, flags);
+        return e;
+    }
+    if (type == rtCreateAccount)
+    {
+        event::XChainAccountCreateCommitDetected e;
+        e.chainType_ = ct;
+        decodeHead(dec, e, flags, bridge);
+        e.rewardAmt_ = dec.amount();
+        e.createCount_ = dec.get<std::uint64_t>();
+        e.otherChainDst_ = dec.raw<ripple::AccountID>();
+        decodeTail(dec, e, flags);
+        return e;
+    }
+    throw std::runtime_error("replay buffer: bad record type");
+}
+
+std::uint32_t
+sizeAt(char const* p)
+{
+    std::uint32_t size = 0;
+    std::memcpy(&size, p, sizeof(size));
+    return size;
+}
+
+// Call `f` with the records of `data`, in order or backward
+void
+readRecords(
+    char const* data,
+    std::uint64_t size,
+    bool backward,
+    std::function<void(char const*, std::uint32_t)> const& f)
+{
+    std::uint64_t pos = backward ? size : 0;
+    while (backward ? pos > 0 : pos < size)
+    {
+        if (backward)
+        {
+            auto const s = sizeAt(data + pos - SizeBytes);
+            pos -= s + 2 * SizeBytes;
+            f(data + pos + SizeBytes, s);
+        }
+        else
+        {
+            auto const s = sizeAt(data + pos);
+            f(data + pos + SizeBytes, s);
+            pos += s + 2 * SizeBytes;
+        }
+    }
+}
+
+// The file mapped for the reads
+class Mapping
+{
+    void* p_ = nullptr;
+    std::uint64_t size_ = 0;
+
+public:
+    Mapping(int fd, std::uint64_t size, std::string const& path) : size_(size)
+    {
+        if (!size_)
+            return;
+        p_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (p_ == MAP_FAILED)
+            throwErrno("mmap", path);
+    }
+
+    ~Mapping()
+    {
+        if (size_)
+            ::munmap(p_, size_);
+    }
+
+    Mapping(Mapping const&) = delete;
+    Mapping&
+    operator=(Mapping const&) = delete;
+
+    char const*
+    data() const
+    {
+        return static_cast<char const*>(p_);
+    }
+};
+
+}  // namespace
+
+ReplayBuffer::ReplayBuffer(
+    ripple::STXChainBridge const& bridge,
+    boost::filesystem::path const& path,
+    std::size_t memoryBytes)
+    : bridge_(bridge), path_(path), memoryBytes_(memoryBytes)
+{
+}
+
+ReplayBuffer::~ReplayBuffer()
+{
+    clear();
+}
+
+void
+ReplayBuffer::pushFront(FederatorEvent const& e)
+{
+    push(sides_[0], e);
+}
+
+void
+ReplayBuffer::pushBack(FederatorEvent const& e)
+{
+    push(sides_[1], e);
+}
+
+void
+ReplayBuffer::push(Side& side, FederatorEvent const& e)
+{
+    auto const start = side.mem.size();
+    side.mem.append(SizeBytes, '\0');
+    encode(side.mem, e, bridge_);
+    std::uint32_t const size = side.mem.size() - start - SizeBytes;
+    std::memcpy(side.mem.data() + start, &size, sizeof(size));
+    side.mem.append(reinterpret_cast<char const*>(&size), sizeof(size));
+    ++side.count;
+
+    if (side.mem.size() > memoryBytes_ / 2)
+        spill(side, &side - sides_.data());
+}
+
+void
+ReplayBuffer::spill(Side& side, std::size_t index)
+{
+    auto const path = fmt::format("{}.{}", path_.string(), index);
+    if (side.fd < 0)
+    {
+        side.fd = ::open(
+            path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (side.fd < 0)
+            throwErrno("open", path);
+        ::unlink(path.c_str());
+    }
+
+    char const* p = side.mem.data();
+    std::size_t left = side.mem.size();
+    while (left)
+    {
+        auto const written = ::write(side.fd, p, left);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throwErrno("write", path);
+        }
+        p += written;
+        left -= written;
+    }
+    side.fileSize += side.mem.size();
+    side.mem.clear();
+}
+
+void
+ReplayBuffer::forEach(std::function<void(FederatorEvent&&)> const& f) const
+{
+    auto const onRecord = [&](char const* data, std::uint32_t size) {
+        f(decode(data, size, bridge_));
+    };
+
+    // The history, from the last pushed: the memory then the file
+    auto const& history = sides_[0];
+    readRecords(history.mem.data(), history.mem.size(), true, onRecord);
+    {
+        Mapping const m(history.fd, history.fileSize, path_.string());
+        readRecords(m.data(), history.fileSize, true, onRecord);
+    }
+
+    // The new events, from the first pushed: the file then the memory
+    auto const& recent = sides_[1];
+    {
+        Mapping const m(recent.fd, recent.fileSize, path_.string());
+        readRecords(m.data(), recent.fileSize, false, onRecord);
+    }
+    readRecords(recent.mem.data(), recent.mem.size(), false, onRecord);
+}
+
+void
+ReplayBuffer::clear()
+{
+    for (auto& side : sides_)
+    {
+        if (side.fd >= 0)
+            ::close(side.fd);
+        side = Side{};
+    }
+}
+
+void
+FingerprintSet::insert(ripple::uint256 const& digest)
+{
+    std::uint64_t fp = 0;
+    std::memcpy(&fp, digest.data(), sizeof(fp));
+    v_.push_back(fp);
+    sorted_ = false;
+}
+
+bool
+FingerprintSet::contains(ripple::uint256 const& digest)
+{
+    std::uint64_t fp = 0;
+    std::memcpy(&fp, digest.data(), sizeof(fp));
+    sort();
+    return std::binary_search(v_.begin(), v_.end(), fp);
+}
+
+std::size_t
+FingerprintSet::size()
+{
+    sort();
+    return v_.size();
+}
+
+void
+FingerprintSet::sort()
+{
+    if (sorted_)
+        return;
+    std::sort(v_.begin(), v_.end());
+    v_.erase(std::unique(v_.begin(), v_.end()), v_.end());
+    sorted_ = true;
+}
+
+void
+FingerprintSet::clear()
+{
+    v_.clear();
+    v_.shrink_to_fit();
+    sorted_ = true;
+}
+
+}  // namespace xbwd
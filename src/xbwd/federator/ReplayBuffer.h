@@ -0,0 +1,156 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/federator/FederatorEvents.h>
+
+#include <ripple/basics/base_uint.h>
+#include <ripple/protocol/STXChainBridge.h>
+
+#include <boost/filesystem/path.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace xbwd {
+
+/**
+ *  The commit events held while the init sync runs, replayed once it is done.
+ *
+ *  The events are kept as compact records: the fields are written raw, the
+ *  bridge only if it is not the one of the federator. Past `memoryBytes`, the
+ *  records are appended to a file, memory mapped for the replay. The file is
+ *  unlinked once opened, so it never outlives the process.
+ *
+ *  The history events arrive from the newest to the oldest and the new ones
+ *  from the oldest to the newest: forEach() reads the first backward and the
+ *  second forward, every record has its size at both ends.
+ */
+class ReplayBuffer
+{
+    // The history and the new events
+    struct Side
+    {
+        std::string mem;
+        int fd = -1;
+        std::uint64_t fileSize = 0;
+        std::size_t count = 0;
+    };
+
+    ripple::STXChainBridge const bridge_;
+    boost::filesystem::path const path_;
+    std::size_t const memoryBytes_;
+    std::array<Side, 2> sides_;
+
+public:
+    ReplayBuffer(
+        ripple::STXChainBridge const& bridge,
+        boost::filesystem::path const& path,
+        std::size_t memoryBytes);
+    ~ReplayBuffer();
+
+    ReplayBuffer(ReplayBuffer const&) = delete;
+    ReplayBuffer&
+    operator=(ReplayBuffer const&) = delete;
+
+    // A history event, older than the ones pushed before. Only the commit
+    // and create account commit events are kept, others throw.
+    void
+    pushFront(FederatorEvent const& e);
+
+    // A new event, newer than the ones pushed before
+    void
+    pushBack(FederatorEvent const& e);
+
+    // Call `f` with the events from the oldest to the newest
+    void
+    forEach(std::function<void(FederatorEvent&&)> const& f) const;
+
+    // Drop the events and close the files
+    void
+    clear();
+
+    std::size_t
+    size() const
+    {
+        return sides_[0].count + sides_[1].count;
+    }
+
+    bool
+    empty() const
+    {
+        return !size();
+    }
+
+    std::uint64_t
+    memoryBytes() const
+    {
+        return sides_[0].mem.size() + sides_[1].mem.size();
+    }
+
+    std::uint64_t
+    fileBytes() const
+    {
+        return sides_[0].fileSize + sides_[1].fileSize;
+    }
+
+private:
+    void
+    push(Side& side, FederatorEvent const& e);
+
+    void
+    spill(Side& side, std::size_t index);
+};
+
+/**
+ *  Set of digests, kept as their first 64 bits.
+ *
+ *  8 bytes per digest in one sorted vector, instead of a hashed node per
+ *  element. Sorted on the first lookup after an insert, it is meant to be
+ *  filled first and queried later. Two digests of the same fingerprint
+ *  collide with a probability of 2^-64.
+ */
+class FingerprintSet
+{
+    std::vector<std::uint64_t> v_;
+    bool sorted_ = true;
+
+public:
+    void
+    insert(ripple::uint256 const& digest);
+
+    bool
+    contains(ripple::uint256 const& digest);
+
+    std::size_t
+    size();
+
+    void
+    clear();
+
+private:
+    void
+    sort();
+};
+
+}  // namespace xbwd
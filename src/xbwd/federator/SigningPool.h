@@ -0,0 +1,81 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace xbwd {
+
+// Threads for the signatures. The callers keep the order: they submit a
+// batch of jobs, then consume the futures in submission order. Without
+// threads the jobs run inline, on the calling thread.
+class SigningPool
+{
+    std::uint32_t const threads_;
+    std::optional<boost::asio::thread_pool> pool_;
+
+public:
+    explicit SigningPool(std::uint32_t threads) : threads_(threads)
+    {
+        if (threads_)
+            pool_.emplace(threads_);
+    }
+
+    ~SigningPool()
+    {
+        if (pool_)
+            pool_->join();
+    }
+
+    SigningPool(SigningPool const&) = delete;
+    SigningPool&
+    operator=(SigningPool const&) = delete;
+
+    std::uint32_t
+    threads() const
+    {
+        return threads_;
+    }
+
+    template <class F>
+    std::future<std::invoke_result_t<F>>
+    submit(F&& f)
+    {
+        using R = std::invoke_result_t<F>;
+        // The handler must be copyable
+        auto task = std::make_shared<std::packaged_task<R()>>(
+            std::forward<F>(f));
+        auto future = task->get_future();
+        if (pool_)
+            boost::asio::post(*pool_, [task] { (*task)(); });
+        else
+            (*task)();
+        return future;
+    }
+};
+
+}  // namespace xbwd
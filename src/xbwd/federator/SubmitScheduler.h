@@ -0,0 +1,188 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace xbwd {
+
+/**
+ *  Items waiting for the submission, by priority class and deadline.
+ *
+ *  The classes are picked in order, a lower class only when the higher ones
+ *  are empty. In a class the items are picked by key, the deadline or the
+ *  order they must land in, then in the arrival order. The depth and the
+ *  waiting time of each class are tracked.
+ *
+ *  Not thread safe, guarded by the owner.
+ */
+template <class T>
+class SubmitScheduler
+{
+public:
+    using clock = std::chrono::steady_clock;
+    using Key = std::pair<std::uint64_t, std::uint64_t>;
+
+    struct Stats
+    {
+        std::size_t depth = 0;
+        std::uint64_t pushed = 0;
+        std::uint64_t popped = 0;
+        // Of the popped items
+        std::uint64_t lastWaitUs = 0;
+        std::uint64_t maxWaitUs = 0;
+        std::uint64_t avgWaitUs = 0;
+        // Of the oldest waiting item
+        std::uint64_t oldestWaitUs = 0;
+    };
+
+private:
+    struct Entry
+    {
+        T value;
+        clock::time_point enqueued;
+    };
+
+    // Key, arrival
+    using Order = std::tuple<std::uint64_t, std::uint64_t, std::uint64_t>;
+
+    struct Class
+    {
+        std::map<Order, Entry> entries;
+        std::uint64_t pushed = 0;
+        std::uint64_t popped = 0;
+        std::uint64_t lastWaitUs = 0;
+        std::uint64_t maxWaitUs = 0;
+        std::uint64_t totalWaitUs = 0;
+    };
+
+    std::vector<Class> classes_;
+    std::uint64_t arrivals_ = 0;
+    std::size_t size_ = 0;
+
+public:
+    explicit SubmitScheduler(std::size_t classes) : classes_(classes)
+    {
+    }
+
+    std::size_t
+    classes() const
+    {
+        return classes_.size();
+    }
+
+    bool
+    empty() const
+    {
+        return !size_;
+    }
+
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+
+    void
+    push(
+        std::size_t cls,
+        Key const& key,
+        T&& v,
+        clock::time_point now = clock::now())
+    {
+        auto& c = classes_.at(cls);
+        c.entries.emplace(
+            std::make_tuple(key.first, key.second, arrivals_++),
+            Entry{std::move(v), now});
+        ++c.pushed;
+        ++size_;
+    }
+
+    // Remove at most `n` items, in the pick order
+    std::vector<T>
+    pop(std::size_t n, clock::time_point now = clock::now())
+    {
+        std::vector<T> r;
+        r.reserve(std::min(n, size_));
+        for (auto& c : classes_)
+        {
+            while (r.size() < n && !c.entries.empty())
+            {
+                auto node = c.entries.extract(c.entries.begin());
+                auto& e = node.mapped();
+                auto const us = waitUs(e, now);
+                c.lastWaitUs = us;
+                c.maxWaitUs = std::max(c.maxWaitUs, us);
+                c.totalWaitUs += us;
+                ++c.popped;
+                --size_;
+                r.push_back(std::move(e.value));
+            }
+        }
+        return r;
+    }
+
+    // The items in the pick order
+    template <class F>
+    void
+    forEach(F&& f) const
+    {
+        for (auto const& c : classes_)
+            for (auto const& kv : c.entries)
+                f(kv.second.value);
+    }
+
+    Stats
+    stats(std::size_t cls, clock::time_point now = clock::now()) const
+    {
+        auto const& c = classes_.at(cls);
+        Stats s;
+        s.depth = c.entries.size();
+        s.pushed = c.pushed;
+        s.popped = c.popped;
+        s.lastWaitUs = c.lastWaitUs;
+        s.maxWaitUs = c.maxWaitUs;
+        s.avgWaitUs = c.popped ? c.totalWaitUs / c.popped : 0;
+        // The oldest is not always the first by key
+        for (auto const& kv : c.entries)
+            s.oldestWaitUs = std::max(s.oldestWaitUs, waitUs(kv.second, now));
+        return s;
+    }
+
+private:
+    static std::uint64_t
+    waitUs(Entry const& e, clock::time_point now)
+    {
+        if (now <= e.enqueued)
+            return 0;
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   now - e.enqueued)
+            .count();
+    }
+};
+
+}  // namespace xbwd
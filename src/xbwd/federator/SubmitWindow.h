@@ -0,0 +1,119 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <algorithm>
+#include <cstdint>
+
+namespace xbwd {
+
+/**
+ *  The number of attestation transactions that can be in flight on a chain.
+ *
+ *  Fixed when min == max (max 0 - no window). Otherwise AIMD: the window grows
+ *  while the transactions land in the ledgers, by one per landed transaction
+ *  up to the threshold and by one per window of landed transactions above it.
+ *  It is halved when a transaction expires or rippled can't queue it, at most
+ *  once per ledger since one overload usually fails a whole burst.
+ */
+class SubmitWindow
+{
+    std::uint32_t const min_;
+    std::uint32_t const max_;
+    double size_;
+    double threshold_;
+    std::uint32_t lastDecreaseLedger_ = 0;
+
+    std::uint64_t landed_ = 0;
+    std::uint64_t decreases_ = 0;
+
+public:
+    SubmitWindow(std::uint32_t min, std::uint32_t max)
+        : min_(max ? std::clamp<std::uint32_t>(min, 1, max) : 0)
+        , max_(max)
+        , size_(min_)
+        , threshold_(max_)
+    {
+    }
+
+    bool
+    adaptive() const
+    {
+        return min_ != max_;
+    }
+
+    // 0 - no window
+    std::uint32_t
+    size() const
+    {
+        return static_cast<std::uint32_t>(size_);
+    }
+
+    std::uint32_t
+    min() const
+    {
+        return min_;
+    }
+
+    std::uint32_t
+    max() const
+    {
+        return max_;
+    }
+
+    std::uint64_t
+    landed() const
+    {
+        return landed_;
+    }
+
+    std::uint64_t
+    decreases() const
+    {
+        return decreases_;
+    }
+
+    // A submitted transaction was included in a ledger
+    void
+    onLanded()
+    {
+        ++landed_;
+        if (!adaptive())
+            return;
+        size_ += size_ < threshold_ ? 1. : 1. / size_;
+        size_ = std::min<double>(size_, max_);
+    }
+
+    // A submitted transaction expired or was not queued. Return true if the
+    // window shrank.
+    bool
+    onCongestion(std::uint32_t ledger)
+    {
+        if (!adaptive() || (decreases_ && ledger == lastDecreaseLedger_))
+            return false;
+        lastDecreaseLedger_ = ledger;
+        ++decreases_;
+        size_ = std::max<double>(size_ / 2, min_);
+        threshold_ = size_;
+        return true;
+    }
+};
+
+}  // namespace xbwd
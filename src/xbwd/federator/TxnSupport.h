@@ -20,6 +20,7 @@
 
 #include <xbwd/basics/StructuredLog.h>
 
+#include <ripple/basics/Buffer.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/json/json_value.h>
 #include <ripple/protocol/AccountID.h>
@@ -42,6 +43,7 @@ getTxn(
     Json::StaticString const& txType,
     Json::StaticString const& txFieldName,
     std::uint32_t seq,
+    bool ticket,
     std::uint32_t lastLedgerSeq,
     std::uint32_t networkID,
     ripple::XRPAmount const& fee)
@@ -56,7 +58,14 @@ getTxn(
 
     txnJson[jss::TransactionType] = txType;
     txnJson[jss::Account] = toBase58(acc);
-    txnJson[jss::Sequence] = seq;
+    // With a ticket the sequence is not used
+    if (ticket)
+    {
+        txnJson[jss::Sequence] = 0;
+        txnJson[sfTicketSequence.getJsonName()] = seq;
+    }
+    else
+        txnJson[jss::Sequence] = seq;
     txnJson[jss::Fee] = to_string(fee);
     txnJson[jss::LastLedgerSequence] = lastLedgerSeq;
     // networks with ID <= 1023 shouldn't send networkID
@@ -65,25 +74,14 @@ getTxn(
     return txnJson;
 }
 
-template <class T>
 [[nodiscard]] inline ripple::STTx
-getSignedTxn(
-    ripple::AccountID const& acc,
-    T const& batch,
-    Json::StaticString const& txType,
-    Json::StaticString const& txFieldName,
-    std::uint32_t seq,
-    std::uint32_t lastLedgerSeq,
-    std::uint32_t networkID,
-    ripple::XRPAmount const& fee,
+signTxn(
+    Json::Value const& txnJson,
     std::pair<ripple::PublicKey, ripple::SecretKey> const& keypair,
     beast::Journal j)
 {
     using namespace ripple;
 
-    auto const txnJson = getTxn(
-        acc, batch, txType, txFieldName, seq, lastLedgerSeq, networkID, fee);
-
     try
     {
         auto const& [pk, sk] = keypair;
@@ -108,4 +106,107 @@ getSignedTxn(
     }
 }
 
+// The transaction of getTxn() without the fields of a submit: the sequence,
+// the last ledger and the fee are placeholders. Serialized in the order of
+// the template, with the signing key.
+template <class T>
+[[nodiscard]] inline ripple::Buffer
+getTxnBody(
+    ripple::AccountID const& acc,
+    T const& batch,
+    Json::StaticString const& txType,
+    Json::StaticString const& txFieldName,
+    std::uint32_t networkID,
+    ripple::PublicKey const& pk,
+    beast::Journal j)
+{
+    using namespace ripple;
+
+    auto const txnJson = getTxn(
+        acc, batch, txType, txFieldName, 0, false, 0, networkID, XRPAmount{});
+    STParsedJSONObject parsed(std::string(jss::tx_json), txnJson);
+    if (parsed.object == std::nullopt)
+    {
+        JLOGV(
+            j.fatal(),
+            "invalid transaction body",
+            jv("txn", txnJson),
+            jv("error", parsed.error));
+        throw std::runtime_error("invalid transaction while signing");
+    }
+    parsed.object->setFieldVL(sfSigningPubKey, pk.slice());
+    STTx const txn(std::move(parsed.object.value()));
+    Serializer s;
+    txn.add(s);
+    return Buffer(s.data(), s.size());
+}
+
+// Sign the body of getTxnBody() with the fields of this submit
+[[nodiscard]] inline ripple::STTx
+signTxnBody(
+    ripple::Buffer const& body,
+    std::uint32_t seq,
+    bool ticket,
+    std::uint32_t lastLedgerSeq,
+    ripple::XRPAmount const& fee,
+    std::pair<ripple::PublicKey, ripple::SecretKey> const& keypair,
+    beast::Journal j)
+{
+    using namespace ripple;
+
+    try
+    {
+        SerialIter sit(body.data(), body.size());
+        STTx txn(sit);
+        // With a ticket the sequence is not used
+        if (ticket)
+        {
+            txn.setFieldU32(sfSequence, 0);
+            txn.setFieldU32(sfTicketSequence, seq);
+        }
+        else
+            txn.setFieldU32(sfSequence, seq);
+        txn.setFieldU32(sfLastLedgerSequence, lastLedgerSeq);
+        txn.setFieldAmount(sfFee, STAmount(fee));
+        auto const& [pk, sk] = keypair;
+        txn.sign(pk, sk);
+        return txn;
+    }
+    catch (std::exception const& e)
+    {
+        JLOGV(
+            j.fatal(),
+            "exception while signing transation",
+            jv("seq", seq),
+            jv("what", e.what()));
+        throw;
+    }
+}
+
+// TicketCreate for `count` tickets, they take the sequences after `seq`
+[[nodiscard]] inline ripple::STTx
+getSignedTicketCreate(
+    ripple::AccountID const& acc,
+    std::uint32_t count,
+    std::uint32_t seq,
+    std::uint32_t lastLedgerSeq,
+    std::uint32_t networkID,
+    ripple::XRPAmount const& fee,
+    std::pair<ripple::PublicKey, ripple::SecretKey> const& keypair,
+    beast::Journal j)
+{
+    using namespace ripple;
+
+    Json::Value txnJson;
+    txnJson[jss::TransactionType] = jss::TicketCreate;
+    txnJson[jss::Account] = toBase58(acc);
+    txnJson[sfTicketCount.getJsonName()] = count;
+    txnJson[jss::Sequence] = seq;
+    txnJson[jss::Fee] = to_string(fee);
+    txnJson[jss::LastLedgerSequence] = lastLedgerSeq;
+    if (networkID > 1023)
+        txnJson[jss::NetworkID] = networkID;
+    return signTxn(txnJson, keypair, j);
+}
+
 }  // namespace xbwd::txn
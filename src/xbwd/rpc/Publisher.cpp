@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/rpc/Publisher.h>
+
+#include <ripple/json/to_string.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace xbwd {
+namespace rpc {
+
+SharedWSMsg::SharedWSMsg(std::shared_ptr<std::string const> msg)
+    : msg_(std::move(msg))
+{
+}
+
+std::pair<boost::tribool, std::vector<boost::asio::const_buffer>>
+SharedWSMsg::prepare(std::size_t bytes, std::function<void(void)>)
+{
+    auto const n = std::min(bytes, msg_->size() - pos_);
+    boost::asio::const_buffer const b(msg_->data() + pos_, n);
+    pos_ += n;
+    return {pos_ == msg_->size(), {b}};
+}
+
+bool
+Publisher::subscribe(std::shared_ptr<ripple::WSSession> const& session)
+{
+    std::lock_guard l{m_};
+    std::erase_if(subs_, [](auto const& w) { return w.expired(); });
+    auto const found =
+        std::any_of(subs_.begin(), subs_.end(), [&session](auto const& w) {
+            return w.lock() == session;
+        });
+    if (!found)
+        subs_.push_back(session);
+    count_ = subs_.size();
+    return !found;
+}
+
+bool
+Publisher::unsubscribe(ripple::WSSession const& session)
+{
+    std::lock_guard l{m_};
+    bool found = false;
+    std::erase_if(subs_, [&](auto const& w) {
+        auto const s = w.lock();
+        if (s.get() != &session)
+            return !s;
+        found = true;
+        return true;
+    });
+    count_ = subs_.size();
+    return found;
+}
+
+std::size_t
+Publisher::size() const
+{
+    std::lock_guard l{m_};
+    return subs_.size();
+}
+
+void
+Publisher::publish(Json::Value const& jv)
+{
+    if (empty())
+        return;
+
+    std::vector<std::shared_ptr<ripple::WSSession>> sessions;
+    {
+        std::lock_guard l{m_};
+        sessions.reserve(subs_.size());
+        std::erase_if(subs_, [&sessions](auto const& w) {
+            auto s = w.lock();
+            if (!s)
+                return true;
+            sessions.push_back(std::move(s));
+            return false;
+        });
+        count_ = subs_.size();
+    }
+    if (sessions.empty())
+        return;
+
+    // Sent out of the lock, the sessions post to their strand
+    auto const msg = std::make_shared<std::string const>(to_string(jv));
+    for (auto const& s : sessions)
+        s->send(std::make_shared<SharedWSMsg>(msg));
+}
+
+}  // namespace rpc
+}  // namespace xbwd
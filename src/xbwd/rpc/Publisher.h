@@ -0,0 +1,90 @@
+#pragma once
+
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2024 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <xbwd/basics/ThreadSaftyAnalysis.h>
+
+#include <ripple/json/json_value.h>
+#include <ripple/server/WSSession.h>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xbwd {
+namespace rpc {
+
+// One serialized message, shared by the sessions it is sent to
+class SharedWSMsg : public ripple::WSMsg
+{
+    std::shared_ptr<std::string const> msg_;
+    std::size_t pos_ = 0;
+
+public:
+    explicit SharedWSMsg(std::shared_ptr<std::string const> msg);
+
+    std::pair<boost::tribool, std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes, std::function<void(void)>) override;
+};
+
+/**
+ *  The websocket sessions subscribed to the "attestations" stream.
+ *
+ *  A message is serialized once for all the subscribers. The session send
+ *  queue is bounded by the port ws_queue_limit: a subscriber that does not
+ *  keep up is closed by the session, and is then dropped from the stream.
+ */
+class Publisher
+{
+    mutable std::mutex m_;
+    std::vector<std::weak_ptr<ripple::WSSession>> GUARDED_BY(m_) subs_;
+    // Read without the lock, to skip building the messages when nobody
+    // listens
+    std::atomic<std::size_t> count_ = 0;
+
+public:
+    // Return false if already subscribed
+    bool
+    subscribe(std::shared_ptr<ripple::WSSession> const& session);
+
+    // Return false if not subscribed
+    bool
+    unsubscribe(ripple::WSSession const& session);
+
+    bool
+    empty() const
+    {
+        return count_.load(std::memory_order_relaxed) == 0;
+    }
+
+    std::size_t
+    size() const;
+
+    void
+    publish(Json::Value const& jv);
+};
+
+}  // namespace rpc
+}  // namespace xbwd
@@ -1,7 +1,9 @@
 #include <xbwd/rpc/RPCHandler.h>
 
 #include <xbwd/app/App.h>
-#include <xbwd/app/DBInit.h>
+#include <xbwd/app/AttestationStore.h>
+#include <xbwd/basics/LogLimiter.h>
+#include <xbwd/core/SociDB.h>
 #include <xbwd/federator/Federator.h>
 #include <xbwd/rpc/fromJSON.h>
 
@@ -16,16 +18,35 @@
 
 #include <fmt/core.h>
 #include <openssl/crypto.h>
-#include <soci/soci-backend.h>
 
+#include <algorithm>
 #include <functional>
+#include <optional>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace xbwd {
 namespace rpc {
 
 namespace {
 
+// The federator of the bridge, or nullptr and the error of the result set
+Federator*
+findFederator(
+    App& app,
+    ripple::STXChainBridge const& bridge,
+    Json::Value& result)
+{
+    auto* f = app.federator(bridge);
+    if (!f)
+    {
+        result[ripple::jss::error] = "invalidRequest";
+        result[ripple::jss::error_message] = "No such bridge";
+    }
+    return f;
+}
+
 void
 doStop(App& app, Json::Value const& in, Json::Value& result)
 {
@@ -41,8 +62,93 @@ doServerInfo(App& app, Json::Value const& in, Json::Value& result)
     result[ripple::jss::request] = in;
     auto const& f = app.federator();
     result["info"] = f.getInfo();
+    auto const& federators = app.federators();
+    if (federators.size() > 1)
+    {
+        auto& jb = (result["info"]["bridges"] = Json::arrayValue);
+        for (std::size_t i = 1; i < federators.size(); ++i)
+            jb.append(federators[i]->getInfo());
+    }
 }
 
+// A page of the attestation IDs of the submissions, the server_info only
+// reports their numbers
+void
+doAttestations(App& app, Json::Value const& in, Json::Value& result)
+{
+    std::uint32_t constexpr defaultLimit = 256;
+    std::uint32_t constexpr maxLimit = 1024;
+
+    result[ripple::jss::request] = in;
+    auto const& f = app.federator();
+
+    auto optChainType = optFromJson<ChainType>(in, "chain_type");
+    auto optList = [&]() -> std::optional<Federator::AttestList> {
+        auto const list = optFromJson<std::string>(in, "list");
+        if (list == "submitted")
+            return Federator::AttestList::submitted;
+        if (list == "errored")
+            return Federator::AttestList::errored;
+        if (list == "pending")
+            return Federator::AttestList::pending;
+        return {};
+    }();
+    auto optMarker = in.isMember("marker")
+        ? optFromJson<std::uint32_t>(in, "marker")
+        : std::optional<std::uint32_t>{0};
+    auto optLimit = in.isMember("limit")
+        ? optFromJson<std::uint32_t>(in, "limit")
+        : std::optional<std::uint32_t>{defaultLimit};
+    {
+        auto const missingOrInvalidField = [&]() -> std::string {
+            if (!optChainType)
+                return "chain_type";
+            if (!optList)
+                return "list";
+            if (!optMarker)
+                return "marker";
+            if (!optLimit || !*optLimit)
+                return "limit";
+            return {};
+        }();
+        if (!missingOrInvalidField.empty())
+        {
+            result[ripple::jss::error] = "invalidRequest";
+            result[ripple::jss::error_message] = fmt::format(
+                "Missing or invalid field: {}", missingOrInvalidField);
+            return;
+        }
+    }
+
+    result["attestations"] = f.getAttestations(
+        *optChainType, *optList, *optMarker, std::min(*optLimit, maxLimit));
+}
+
+// The latency traces of the last confirmed attestations
+void
+doAttestationTraces(App& app, Json::Value const& in, Json::Value& result)
+{
+    std::uint32_t constexpr defaultLimit = 32;
+
+    result[ripple::jss::request] = in;
+    auto const& f = app.federator();
+
+    auto optLimit = in.isMember("limit")
+        ? optFromJson<std::uint32_t>(in, "limit")
+        : std::optional<std::uint32_t>{defaultLimit};
+    if (!optLimit)
+    {
+        result[ripple::jss::error] = "invalidRequest";
+        result[ripple::jss::error_message] = "Missing or invalid field: limit";
+        return;
+    }
+
+    result["attestation_traces"] = f.getTraces(
+        std::min<std::uint32_t>(*optLimit, TraceKeep));
+}
+
+// A page of the claim table, in (LedgerSeq, TransID) order. The "marker" of
+// the result, if any, is passed back to read the next page.
 void
 doSelectAll(
     App& app,
@@ -53,72 +159,89 @@ doSelectAll(
 {
     // TODO: Remove me
     //
+    std::uint32_t constexpr defaultLimit = 256;
+    std::uint32_t constexpr maxLimit = 1024;
 
     result[ripple::jss::request] = in;
 
-    auto const& tblName = db_init::xChainTableName(chain);
+    // The top level bridge if none is given
+    auto const optBridge = in.isMember("bridge")
+        ? optFromJson<ripple::STXChainBridge>(in, "bridge")
+        : std::optional<ripple::STXChainBridge>{app.federator().bridge()};
 
+    std::optional<AttestationMarker> marker;
+    bool badMarker = false;
+    if (in.isMember("marker"))
+    {
+        auto const& jm = in["marker"];
+        auto const optSeq = jm.isObject()
+            ? optFromJson<std::uint32_t>(jm, "ledger_seq")
+            : std::nullopt;
+        auto const optTxnId = jm.isObject()
+            ? optFromJson<ripple::uint256>(jm, "trans_id")
+            : std::nullopt;
+        if (optSeq && optTxnId)
+            marker.emplace(*optSeq, *optTxnId);
+        else
+            badMarker = true;
+    }
+    auto optLimit = in.isMember("limit")
+        ? optFromJson<std::uint32_t>(in, "limit")
+        : std::optional<std::uint32_t>{defaultLimit};
     {
-        auto session = app.getXChainTxnDB().checkoutDb();
-        soci::blob amtBlob(*session);
-        soci::blob bridgeBlob(*session);
-        soci::blob sendingAccountBlob(*session);
-        soci::blob rewardAccountBlob(*session);
-        soci::blob otherChainDstBlob(*session);
-        soci::blob signingAccountBlob(*session);
-        soci::blob publicKeyBlob(*session);
-        soci::blob signatureBlob(*session);
-
-        std::string transID;
-        int ledgerSeq;
-        int claimID;
-        int success;
-
-        auto sql = fmt::format(
-            R"sql(SELECT TransID, LedgerSeq, ClaimID, Success, DeliveredAmt,
-                         Bridge, SendingAccount, RewardAccount, OtherChainDst,
-                         SigningAccount, PublicKey, Signature
-                  FROM {table_name};
-            )sql",
-            fmt::arg("table_name", tblName));
-
-        soci::indicator otherChainDstInd;
-        soci::statement st =
-            ((*session).prepare << sql,
-             soci::into(transID),
-             soci::into(ledgerSeq),
-             soci::into(claimID),
-             soci::into(success),
-             soci::into(amtBlob),
-             soci::into(bridgeBlob),
-             soci::into(sendingAccountBlob),
-             soci::into(rewardAccountBlob),
-             soci::into(otherChainDstBlob, otherChainDstInd),
-             soci::into(signingAccountBlob),
-             soci::into(publicKeyBlob),
-             soci::into(signatureBlob));
-        st.execute();
-
-        std::vector<ripple::Attestations::AttestationClaim> claims;
-        std::optional<ripple::STXChainBridge> firstBridge;
-        while (st.fetch())
+        auto const missingOrInvalidField = [&]() -> std::string {
+            if (!optBridge)
+                return "bridge";
+            if (badMarker)
+                return "marker";
+            if (!optLimit || !*optLimit)
+                return "limit";
+            return {};
+        }();
+        if (!missingOrInvalidField.empty())
         {
+            result[ripple::jss::error] = "invalidRequest";
+            result[ripple::jss::error_message] = fmt::format(
+                "Missing or invalid field: {}", missingOrInvalidField);
+            return;
+        }
+    }
+    auto const limit = std::min(*optLimit, maxLimit);
+    auto const* f = findFederator(app, *optBridge, result);
+    if (!f)
+        return;
+
+    std::vector<ripple::Attestations::AttestationClaim> claims;
+    std::optional<ripple::STXChainBridge> firstBridge;
+    std::optional<AttestationMarker> next;
+    {
+        // One more row than the page, to know if there is a next one
+        auto const rows = app.attestationStore(f->bridgeName())
+                              .page(chain, false, marker, limit + 1);
+
+        std::optional<AttestationMarker> last;
+        for (auto const& row : rows)
+        {
+            if (claims.size() == limit)
+            {
+                next = last;
+                break;
+            }
+            last.emplace(row.ledgerSeq, row.txnHash);
+
             auto signingAccount =
-                convert<ripple::AccountID>(signingAccountBlob);
-            auto signingPK = convert<ripple::PublicKey>(publicKeyBlob);
-            auto sigBuf = convert<ripple::Buffer>(signatureBlob);
-            auto sendingAmount = convert<ripple::STAmount>(amtBlob);
+                convert<ripple::AccountID>(row.signingAccount);
+            auto signingPK = convert<ripple::PublicKey>(row.publicKey);
+            auto sigBuf = convert<ripple::Buffer>(row.signature);
+            auto sendingAmount = convert<ripple::STAmount>(row.amt);
             auto sendingAccount =
-                convert<ripple::AccountID>(sendingAccountBlob);
-            auto rewardAccount = convert<ripple::AccountID>(rewardAccountBlob);
+                convert<ripple::AccountID>(row.sendingAccount);
+            auto rewardAccount = convert<ripple::AccountID>(row.rewardAccount);
             std::optional<ripple::AccountID> optDst;
-            if (otherChainDstInd == soci::i_ok)
-            {
-                optDst.emplace();
-                *optDst = convert<ripple::AccountID>(otherChainDstBlob);
-            }
+            if (!row.otherChainDst.empty())
+                optDst = convert<ripple::AccountID>(row.otherChainDst);
 
-            auto bridge = convert<ripple::STXChainBridge>(bridgeBlob);
+            auto bridge = convert<ripple::STXChainBridge>(row.bridge);
             if (!firstBridge)
             {
                 firstBridge = bridge;
@@ -136,32 +259,44 @@ doSelectAll(
                 sendingAmount,
                 rewardAccount,
                 chain == ChainType::locking,
-                claimID,
+                row.id,
                 optDst);
         }
+    }
 
-        auto const& config(app.config());
-        if (config.useBatch)
-        {
+    if (next)
+    {
+        auto& jm = (result["marker"] = Json::objectValue);
+        jm["ledger_seq"] = next->first;
+        jm["trans_id"] = to_string(next->second);
+    }
+
+    if (claims.empty())
+    {
+        result["claims"] = Json::arrayValue;
+        return;
+    }
+
+    if (f->useBatch())
+    {
 #ifdef USE_BATCH_ATTESTATION
-            ripple::STXChainAttestationBatch batch{
-                *firstBridge, claims.begin(), claims.end()};
-            result[ripple::sfXChainAttestationBatch.getJsonName()] =
-                batch.getJson(ripple::JsonOptions::none);
+        ripple::STXChainAttestationBatch batch{
+            *firstBridge, claims.begin(), claims.end()};
+        result[ripple::sfXChainAttestationBatch.getJsonName()] =
+            batch.getJson(ripple::JsonOptions::none);
 #else
-            throw std::runtime_error(
-                "Please compile with USE_BATCH_ATTESTATION to use Batch "
-                "Attestations");
+        throw std::runtime_error(
+            "Please compile with USE_BATCH_ATTESTATION to use Batch "
+            "Attestations");
 #endif
-        }
-        else
+    }
+    else
+    {
+        auto& jclaims = (result["claims"] = Json::arrayValue);
+        for (auto const& claim : claims)
         {
-            auto& jclaims = (result["claims"] = Json::arrayValue);
-            for (auto const& claim : claims)
-            {
-                SubmissionClaim sc(0, 0, 0, *firstBridge, claim);
-                jclaims.append(sc.getJson(ripple::JsonOptions::none));
-            }
+            SubmissionClaim sc(0, 0, 0, *firstBridge, claim);
+            jclaims.append(sc.getJson(ripple::JsonOptions::none));
         }
     }
 }
@@ -232,115 +367,92 @@ doWitness(App& app, Json::Value const& in, Json::Value& result)
         return;
     }
 
-    auto const& tblName = db_init::xChainTableName(ct);
+    auto* f = findFederator(app, bridge, result);
+    if (!f)
+        return;
+
+    auto& cache = f->attestationCache();
+    AttestationCacheKey const key{ct, false, claimID};
+    auto att = cache.get(key);
+    if (att &&
+        !att->matches(
+            bridge, sendingAmount, std::nullopt, sendingAccount, optDst))
+        att.reset();
 
+    if (!att)
     {
-        auto session = app.getXChainTxnDB().checkoutDb();
-        soci::blob amtBlob = convert(sendingAmount, *session);
-        soci::blob bridgeBlob = convert(bridge, *session);
-        soci::blob sendingAccountBlob = convert(sendingAccount, *session);
-        soci::blob rewardAccountBlob(*session);
-        soci::blob otherChainDstBlob(*session);
-        soci::blob signingAccountBlob(*session);
-        soci::blob publicKeyBlob(*session);
-        soci::blob signatureBlob(*session);
-
-        soci::indicator sigInd;
+        auto const generation = cache.generation(key);
+        AttestationQuery q;
+        q.id = claimID;
+        q.amt = serialize(sendingAmount);
+        q.bridge = serialize(bridge);
+        q.sendingAccount = serialize(sendingAccount);
         if (optDst)
-        {
-            otherChainDstBlob = convert(*optDst, *session);
-
-            auto sql = fmt::format(
-                R"sql(SELECT SigningAccount, Signature, PublicKey, RewardAccount FROM {table_name}
-                  WHERE ClaimID = :claimID and
-                        Success = 1 and
-                        DeliveredAmt = :amt and
-                        Bridge = :bridge and
-                        SendingAccount = :sendingAccount and
-                        OtherChainDst = :otherChainDst;
-            )sql",
-                fmt::arg("table_name", tblName));
-
-            *session << sql, soci::into(signingAccountBlob),
-                soci::into(signatureBlob, sigInd), soci::into(publicKeyBlob),
-                soci::into(rewardAccountBlob), soci::use(*optClaimID),
-                soci::use(amtBlob), soci::use(bridgeBlob),
-                soci::use(sendingAccountBlob), soci::use(otherChainDstBlob);
-        }
-        else
-        {
-            auto sql = fmt::format(
-                R"sql(SELECT SigningAccount, Signature, PublicKey, RewardAccount, OtherChainDst FROM {table_name}
-                  WHERE ClaimID = :claimID and
-                        Success = 1 and
-                        DeliveredAmt = :amt and
-                        Bridge = :bridge and
-                        SendingAccount = :sendingAccount;
-            )sql",
-                fmt::arg("table_name", tblName));
-
-            soci::indicator otherChainDstInd;
-            *session << sql, soci::into(signingAccountBlob),
-                soci::into(signatureBlob, sigInd), soci::into(publicKeyBlob),
-                soci::into(rewardAccountBlob),
-                soci::into(otherChainDstBlob, otherChainDstInd),
-                soci::use(*optClaimID), soci::use(amtBlob),
-                soci::use(bridgeBlob), soci::use(sendingAccountBlob);
-
-            if (otherChainDstInd == soci::i_ok)
-            {
-                optDst.emplace();
-                *optDst = convert<ripple::AccountID>(otherChainDstBlob);
-            }
-        }
+            q.otherChainDst = serialize(*optDst);
+
+        auto const row =
+            app.attestationStore(f->bridgeName()).find(ct, false, q);
+        auto dst = optDst;
+        if (row && !optDst && !row->otherChainDst.empty())
+            dst = convert<ripple::AccountID>(row->otherChainDst);
 
         // TODO: Check for multiple values
-        if (sigInd == soci::i_ok && publicKeyBlob.get_len() > 0 &&
-            rewardAccountBlob.get_len() > 0)
+        if (row && !row->signature.empty() && !row->publicKey.empty() &&
+            !row->rewardAccount.empty())
         {
-            auto rewardAccount = convert<ripple::AccountID>(rewardAccountBlob);
-            auto signingAccount =
-                convert<ripple::AccountID>(signingAccountBlob);
-            auto signingPK = convert<ripple::PublicKey>(publicKeyBlob);
-            auto sigBuf = convert<ripple::Buffer>(signatureBlob);
-
-            ripple::Attestations::AttestationClaim claim{
-                signingAccount,
-                signingPK,
-                sigBuf,
-                sendingAccount,
+            att.emplace(CachedAttestation{
+                bridge,
                 sendingAmount,
-                rewardAccount,
-                ct == ChainType::locking,
-                claimID,
-                optDst};
+                std::nullopt,
+                sendingAccount,
+                convert<ripple::AccountID>(row->rewardAccount),
+                dst,
+                convert<ripple::AccountID>(row->signingAccount),
+                convert<ripple::PublicKey>(row->publicKey),
+                convert<ripple::Buffer>(row->signature)});
+            cache.put(key, *att, generation);
+        }
+    }
 
-            auto const& config(app.config());
-            if (config.useBatch)
-            {
+    if (att)
+    {
+        if (!optDst)
+            optDst = att->otherChainDst;
+
+        ripple::Attestations::AttestationClaim claim{
+            att->signingAccount,
+            att->publicKey,
+            att->signature,
+            sendingAccount,
+            sendingAmount,
+            att->rewardAccount,
+            ct == ChainType::locking,
+            claimID,
+            optDst};
+
+        if (f->useBatch())
+        {
 #ifdef USE_BATCH_ATTESTATION
-                ripple::STXChainAttestationBatch batch{
-                    bridge, &claim, &claim + 1};
-                result[ripple::sfXChainAttestationBatch.getJsonName()] =
-                    batch.getJson(ripple::JsonOptions::none);
+            ripple::STXChainAttestationBatch batch{bridge, &claim, &claim + 1};
+            result[ripple::sfXChainAttestationBatch.getJsonName()] =
+                batch.getJson(ripple::JsonOptions::none);
 #else
-                throw std::runtime_error(
-                    "Please compile with USE_BATCH_ATTESTATION to use Batch "
-                    "Attestations");
+            throw std::runtime_error(
+                "Please compile with USE_BATCH_ATTESTATION to use Batch "
+                "Attestations");
 #endif
-            }
-            else
-            {
-                SubmissionClaim sc(0, 0, 0, bridge, claim);
-                result["claim"] = sc.getJson(ripple::JsonOptions::none);
-            }
         }
         else
         {
-            result[ripple::jss::error] = "invalidRequest";
-            result[ripple::jss::error_message] = "No such transaction";
+            SubmissionClaim sc(0, 0, 0, bridge, claim);
+            result["claim"] = sc.getJson(ripple::JsonOptions::none);
         }
     }
+    else
+    {
+        result[ripple::jss::error] = "invalidRequest";
+        result[ripple::jss::error_message] = "No such transaction";
+    }
 }
 
 void
@@ -407,112 +519,181 @@ doWitnessAccountCreate(App& app, Json::Value const& in, Json::Value& result)
         return;
     }
 
-    auto const& tblName = db_init::xChainCreateAccountTableName(ct);
+    auto* f = findFederator(app, bridge, result);
+    if (!f)
+        return;
 
+    auto& cache = f->attestationCache();
+    AttestationCacheKey const key{ct, true, createCount};
+    auto att = cache.get(key);
+    if (att &&
+        !att->matches(bridge, sendingAmount, rewardAmount, sendingAccount, dst))
+        att.reset();
+
+    if (!att)
     {
-        auto session = app.getXChainTxnDB().checkoutDb();
-
-        soci::blob amtBlob = convert(sendingAmount, *session);
-        soci::blob rewardAmtBlob = convert(rewardAmount, *session);
-        soci::blob bridgeBlob = convert(bridge, *session);
-        soci::blob sendingAccountBlob = convert(sendingAccount, *session);
-        soci::blob otherChainDstBlob = convert(dst, *session);
-
-        soci::blob rewardAccountBlob(*session);
-        soci::blob signingAccountBlob(*session);
-        soci::blob publicKeyBlob(*session);
-        soci::blob signatureBlob(*session);
-
-        auto sql = fmt::format(
-            R"sql(SELECT SigningAccount, Signature, PublicKey, RewardAccount FROM {table_name}
-                  WHERE CreateCount = :createCount and
-                        Success = 1 and
-                        DeliveredAmt = :amt and
-                        RewardAmt = :rewardAmt and
-                        Bridge = :bridge and
-                        SendingAccount = :sendingAccount and
-                        OtherChainDst = :otherChainDst;
-            )sql",
-            fmt::arg("table_name", tblName));
-
-        *session << sql, soci::into(signingAccountBlob),
-            soci::into(signatureBlob), soci::into(publicKeyBlob),
-            soci::into(rewardAccountBlob), soci::use(createCount),
-            soci::use(amtBlob), soci::use(rewardAmtBlob), soci::use(bridgeBlob),
-            soci::use(sendingAccountBlob), soci::use(otherChainDstBlob);
+        auto const generation = cache.generation(key);
+        AttestationQuery q;
+        q.id = createCount;
+        q.amt = serialize(sendingAmount);
+        q.rewardAmt = serialize(rewardAmount);
+        q.bridge = serialize(bridge);
+        q.sendingAccount = serialize(sendingAccount);
+        q.otherChainDst = serialize(dst);
+
+        auto const row =
+            app.attestationStore(f->bridgeName()).find(ct, true, q);
 
         // TODO: Check for multiple values
-        if (signatureBlob.get_len() > 0 && publicKeyBlob.get_len() > 0 &&
-            rewardAccountBlob.get_len() > 0)
+        if (row && !row->signature.empty() && !row->publicKey.empty() &&
+            !row->rewardAccount.empty())
         {
-            auto rewardAccount = convert<ripple::AccountID>(rewardAccountBlob);
-            auto signingAccount =
-                convert<ripple::AccountID>(signingAccountBlob);
-            auto signingPK = convert<ripple::PublicKey>(publicKeyBlob);
-            auto sigBuf = convert<ripple::Buffer>(signatureBlob);
-
-            ripple::Attestations::AttestationCreateAccount createAccount{
-                signingAccount,
-                signingPK,
-                sigBuf,
-                sendingAccount,
+            att.emplace(CachedAttestation{
+                bridge,
                 sendingAmount,
                 rewardAmount,
-                rewardAccount,
-                ct == ChainType::locking,
-                createCount,
-                dst};
+                sendingAccount,
+                convert<ripple::AccountID>(row->rewardAccount),
+                dst,
+                convert<ripple::AccountID>(row->signingAccount),
+                convert<ripple::PublicKey>(row->publicKey),
+                convert<ripple::Buffer>(row->signature)});
+            cache.put(key, *att, generation);
+        }
+    }
 
-            auto const& config(app.config());
-            if (config.useBatch)
-            {
+    if (att)
+    {
+        ripple::Attestations::AttestationCreateAccount createAccount{
+            att->signingAccount,
+            att->publicKey,
+            att->signature,
+            sendingAccount,
+            sendingAmount,
+            rewardAmount,
+            att->rewardAccount,
+            ct == ChainType::locking,
+            createCount,
+            dst};
+
+        if (f->useBatch())
+        {
 #ifdef USE_BATCH_ATTESTATION
-                ripple::AttestationBatch::AttestationClaim* nullClaim = nullptr;
-                ripple::STXChainAttestationBatch batch{
-                    bridge,
-                    nullClaim,
-                    nullClaim,
-                    &createAccount,
-                    &createAccount + 1};
-                result[ripple::sfXChainAttestationBatch.getJsonName()] =
-                    batch.getJson(ripple::JsonOptions::none);
+            ripple::AttestationBatch::AttestationClaim* nullClaim = nullptr;
+            ripple::STXChainAttestationBatch batch{
+                bridge,
+                nullClaim,
+                nullClaim,
+                &createAccount,
+                &createAccount + 1};
+            result[ripple::sfXChainAttestationBatch.getJsonName()] =
+                batch.getJson(ripple::JsonOptions::none);
 #else
-                throw std::runtime_error(
-                    "Please compile with USE_BATCH_ATTESTATION to use Batch "
-                    "Attestations");
+            throw std::runtime_error(
+                "Please compile with USE_BATCH_ATTESTATION to use Batch "
+                "Attestations");
 #endif
-            }
-            else
-            {
-                SubmissionCreateAccount ca(0, 0, 0, bridge, createAccount);
-                result["createAccount"] = ca.getJson(ripple::JsonOptions::none);
-            }
         }
         else
         {
-            result[ripple::jss::error] = "invalidRequest";
-            result[ripple::jss::error_message] = "No such transaction";
+            SubmissionCreateAccount ca(0, 0, 0, bridge, createAccount);
+            result["createAccount"] = ca.getJson(ripple::JsonOptions::none);
         }
     }
+    else
+    {
+        result[ripple::jss::error] = "invalidRequest";
+        result[ripple::jss::error_message] = "No such transaction";
+    }
 }
 
 void
 doAttestTx(App& app, Json::Value const& in, Json::Value& result)
 {
     result[ripple::jss::request] = in;
-    auto& f = app.federator();
+
+    std::uint32_t constexpr maxHashes = 256;
 
     auto optBridge = optFromJson<ripple::STXChainBridge>(in, "bridge");
     auto optChainType = optFromJson<ChainType>(in, "chain_type");
-    auto optTxHash = optFromJson<ripple::uint256>(in, "tx_hash");
+    // One "tx_hash", or up to maxHashes "tx_hashes" pulled together
+    auto optTxHashes = [&]() -> std::optional<std::vector<ripple::uint256>> {
+        if (!in.isMember("tx_hashes"))
+        {
+            auto const optTxHash = optFromJson<ripple::uint256>(in, "tx_hash");
+            if (!optTxHash)
+                return {};
+            return std::vector<ripple::uint256>{*optTxHash};
+        }
+        auto const& jhashes = in["tx_hashes"];
+        if (!jhashes.isArray() || !jhashes.size() ||
+            jhashes.size() > maxHashes)
+            return {};
+        std::vector<ripple::uint256> r;
+        r.reserve(jhashes.size());
+        for (auto const& jh : jhashes)
+            if (!jh.isString() || !r.emplace_back().parseHex(jh.asString()))
+                return {};
+        return r;
+    }();
     {
         auto const missingOrInvalidField = [&]() -> std::string {
             if (!optBridge)
                 return "bridge";
             if (!optChainType)
                 return "chain_type";
-            if (!optTxHash)
-                return "tx_hash";
+            if (!optTxHashes)
+                return in.isMember("tx_hashes") ? "tx_hashes" : "tx_hash";
+            return {};
+        }();
+        if (!missingOrInvalidField.empty())
+        {
+            result[ripple::jss::error] = "invalidRequest";
+            result[ripple::jss::error_message] = fmt::format(
+                "Missing or invalid field: {}", missingOrInvalidField);
+            return;
+        }
+    }
+
+    if (auto* f = findFederator(app, *optBridge, result))
+        f->pullAndAttestTx(*optBridge, *optChainType, *optTxHashes, result);
+}
+
+// Set or clear the LogLimiter limit of a jlogId, and list the limits
+void
+doLogLimits(App& app, Json::Value const& in, Json::Value& result)
+{
+    result[ripple::jss::request] = in;
+    auto& limiter = LogLimiter::instance();
+
+    if (in.isMember("jlog_id"))
+    {
+        auto const optId = optFromJson<std::uint32_t>(in, "jlog_id");
+        bool const clear = in.isMember("clear") && in["clear"].asBool();
+        LogLimit limit;
+        auto const missingOrInvalidField = [&]() -> std::string {
+            if (!optId)
+                return "jlog_id";
+            if (in.isMember("rate"))
+            {
+                if (!in["rate"].isNumeric() || in["rate"].asDouble() < 0)
+                    return "rate";
+                limit.rate = in["rate"].asDouble();
+            }
+            if (in.isMember("burst"))
+            {
+                auto const burst = optFromJson<std::uint32_t>(in, "burst");
+                if (!burst || !*burst)
+                    return "burst";
+                limit.burst = *burst;
+            }
+            if (in.isMember("sample"))
+            {
+                auto const sample = optFromJson<std::uint32_t>(in, "sample");
+                if (!sample || !*sample)
+                    return "sample";
+                limit.sample = *sample;
+            }
             return {};
         }();
         if (!missingOrInvalidField.empty())
@@ -522,9 +703,14 @@ doAttestTx(App& app, Json::Value const& in, Json::Value& result)
                 "Missing or invalid field: {}", missingOrInvalidField);
             return;
         }
+
+        if (clear)
+            limiter.clear(*optId);
+        else
+            limiter.set(*optId, limit);
     }
 
-    f.pullAndAttestTx(*optBridge, *optChainType, *optTxHash, result);
+    result["log_limits"] = limiter.getJson();
 }
 
 enum class Role { USER, ADMIN };
@@ -540,12 +726,16 @@ std::unordered_map<std::string, CmdFun> const handlers = [] {
     std::unordered_map<std::string, CmdFun> r;
     r.emplace("stop"s, CmdFun{doStop, Role::ADMIN});
     r.emplace("server_info"s, CmdFun{doServerInfo, Role::ADMIN});
+    r.emplace("attestations"s, CmdFun{doAttestations, Role::ADMIN});
+    r.emplace(
+        "attestation_traces"s, CmdFun{doAttestationTraces, Role::ADMIN});
     r.emplace("witness"s, CmdFun{doWitness, Role::ADMIN});
     r.emplace(
         "witness_account_create"s, CmdFun{doWitnessAccountCreate, Role::ADMIN});
     r.emplace("select_all_locking"s, CmdFun{doSelectAllLocking, Role::ADMIN});
     r.emplace("select_all_issuing"s, CmdFun{doSelectAllIssuing, Role::ADMIN});
     r.emplace("attest_tx"s, CmdFun{doAttestTx, Role::ADMIN});
+    r.emplace("log_limits"s, CmdFun{doLogLimits, Role::ADMIN});
     return r;
 }();
 }  // namespace
@@ -677,5 +867,20 @@ doCommand(
     it->second.func(app, in, result);
 }
 
+std::optional<std::string>
+getMetrics(App& app, beast::IP::Endpoint const& remoteIPAddress)
+{
+    auto const& adminConfig = app.config().adminConfig;
+    if (adminConfig && adminConfig->pass)
+        return {};
+    if (!isAdmin(
+            adminConfig,
+            Json::Value{Json::objectValue},
+            {},
+            remoteIPAddress.address()))
+        return {};
+    return Federator::getMetrics(app.federators());
+}
+
 }  // namespace rpc
 }  // namespace xbwd
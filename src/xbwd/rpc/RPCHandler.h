@@ -4,6 +4,9 @@
 #include <ripple/json/json_value.h>
 #include <ripple/server/Port.h>
 
+#include <optional>
+#include <string>
+
 namespace xbwd {
 class App;
 namespace rpc {
@@ -16,5 +19,11 @@ doCommand(
     std::optional<std::string> const& passwordOp,
     Json::Value& result);
 
+// The metrics in the Prometheus text format, if the remote address passes the
+// admin config. A password in the admin config can't be checked, the request
+// is refused.
+std::optional<std::string>
+getMetrics(App& app, beast::IP::Endpoint const& remoteIPAddress);
+
 }  // namespace rpc
 }  // namespace xbwd
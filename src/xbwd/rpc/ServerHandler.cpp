@@ -19,7 +19,9 @@
 
 #include <xbwd/rpc/ServerHandler.h>
 
+#include <xbwd/app/App.h>
 #include <xbwd/app/BuildInfo.h>
+#include <xbwd/rpc/Publisher.h>
 #include <xbwd/rpc/RPCHandler.h>
 
 #include <ripple/basics/Log.h>
@@ -46,6 +48,8 @@
 #include <boost/beast/http/string_body.hpp>
 #include <boost/type_traits.hpp>
 
+#include <fmt/format.h>
+
 #include <algorithm>
 #include <mutex>
 #include <sstream>
@@ -190,14 +194,17 @@ HTTPReply(
     beast::Journal j)
 {
     auto const content = to_string(jcontent) + '\n';
-    auto const level = jcontent.isMember(ripple::jss::error) &&
+    auto const level = jcontent.isObject() &&
+            jcontent.isMember(ripple::jss::error) &&
             jcontent[ripple::jss::error].isString() &&
             (jcontent[ripple::jss::error].asString() == "internalError")
         ? j.warn()
         : j.trace();
     JLOG(level) << "HTTP Reply " << nStatus << " " << content;
 
-    assert(!jcontent[ripple::jss::result].isMember(ripple::jss::result));
+    assert(
+        !jcontent.isObject() ||
+        !jcontent[ripple::jss::result].isMember(ripple::jss::result));
 
     if (nStatus == 401)
     {
@@ -290,6 +297,13 @@ isStatusRequest(ripple::http_request_type const& request)
         request.method() == boost::beast::http::verb::get;
 }
 
+bool
+isMetricsRequest(ripple::http_request_type const& request)
+{
+    return request.target() == "/metrics" &&
+        request.method() == boost::beast::http::verb::get;
+}
+
 ripple::Handoff
 statusRequestResponse(
     ripple::http_request_type const& request,
@@ -776,7 +790,23 @@ ServerHandler::onHandoff(
 
     if (websocket::is_upgrade(request))
     {
-        // TODO
+        if (!is_ws)
+            return statusRequestResponse(request, http::status::unauthorized);
+
+        std::shared_ptr<ripple::WSSession> ws;
+        try
+        {
+            ws = session.websocketUpgrade();
+        }
+        catch (std::exception const& e)
+        {
+            JLOG(j_.error())
+                << "Exception upgrading websocket: " << e.what() << "\n";
+            return statusRequestResponse(
+                request, http::status::internal_server_error);
+        }
+        ws->run();
+
         ripple::Handoff handoff;
         handoff.moved = true;
         return handoff;
@@ -785,6 +815,10 @@ ServerHandler::onHandoff(
     if (is_ws && isStatusRequest(request))
         return statusResponse(request);
 
+    if ((p.count("http") > 0 || p.count("https") > 0) &&
+        isMetricsRequest(request))
+        return metricsResponse(request, remote_address);
+
     // Otherwise pass to legacy onRequest or websocket
     return {};
 }
@@ -826,6 +860,9 @@ build_map(boost::beast::http::fields const& h)
     return c;
 }
 
+// The largest request, HTTP or websocket
+std::size_t constexpr maxRequestSize = 2048;
+
 template <class ConstBufferSequence>
 std::string
 buffers_to_string(ConstBufferSequence const& bs)
@@ -873,7 +910,29 @@ ServerHandler::onWSMessage(
     std::shared_ptr<ripple::WSSession> session,
     std::vector<boost::asio::const_buffer> const& buffers)
 {
-    // TODO
+    Json::Value jv;
+    auto const size = boost::asio::buffer_size(buffers);
+    if (size > maxRequestSize ||
+        !Json::Reader{}.parse(buffers_to_string(buffers), jv) ||
+        !jv.isObject())
+    {
+        Json::Value jvResult(Json::objectValue);
+        jvResult[ripple::jss::type] = ripple::jss::error;
+        jvResult[ripple::jss::error] = "jsonInvalid";
+        JLOG(j_.trace()) << "Websocket sending '" << jvResult << "'";
+        session->send(std::make_shared<SharedWSMsg>(
+            std::make_shared<std::string const>(to_string(jvResult))));
+        session->complete();
+        return;
+    }
+
+    boost::asio::post(
+        threadPool_, [this, session, jv = std::move(jv)]() mutable {
+            auto const jr = this->processSession(session, jv);
+            session->send(std::make_shared<SharedWSMsg>(
+                std::make_shared<std::string const>(to_string(jr))));
+            session->complete();
+        });
 }
 
 void
@@ -919,12 +978,17 @@ ServerHandler::processSession(
             return jr;
         }
 
-        rpc::doCommand(
-            app_,
-            beast::IP::from_asio(session->remote_endpoint().address()),
-            jv,
-            {},  // TODO password
-            jr[ripple::jss::result]);
+        auto const method = jv[ripple::jss::method].asString();
+        if (method == "subscribe" || method == "unsubscribe")
+            jr[ripple::jss::result] =
+                processSubscribe(session, jv, method == "subscribe");
+        else
+            rpc::doCommand(
+                app_,
+                beast::IP::from_asio(session->remote_endpoint().address()),
+                jv,
+                {},  // TODO password
+                jr[ripple::jss::result]);
     }
     catch (std::exception const& ex)
     {
@@ -972,6 +1036,38 @@ ServerHandler::processSession(
     return jr;
 }
 
+Json::Value
+ServerHandler::processSubscribe(
+    std::shared_ptr<ripple::WSSession> const& session,
+    Json::Value const& jv,
+    bool subscribe)
+{
+    Json::Value result(Json::objectValue);
+    result[ripple::jss::request] = jv;
+
+    // The attestations stream only, for now
+    auto const& streams = jv[ripple::jss::streams];
+    if (!streams.isArray() || streams.size() != 1 ||
+        streams[0u] != "attestations")
+    {
+        result[ripple::jss::error] = "invalidRequest";
+        result[ripple::jss::error_message] =
+            "Missing or invalid field: streams";
+        return result;
+    }
+
+    auto& publisher = app_.publisher();
+    if (subscribe)
+        publisher.subscribe(session);
+    else
+        publisher.unsubscribe(*session);
+    JLOG(j_.debug()) << (subscribe ? "Subscribed " : "Unsubscribed ")
+                     << session->remote_endpoint() << ", "
+                     << publisher.size() << " subscribers";
+    result[ripple::jss::status] = ripple::jss::success;
+    return result;
+}
+
 void
 ServerHandler::processSession(std::shared_ptr<ripple::Session> const& session)
 {
@@ -1004,13 +1100,16 @@ ServerHandler::processRequest(
     boost::string_view user)
 {
     Json::Value jsonOrig;
+    std::size_t const batchLimit = app_.config().rpcBatchLimit;
 
     {
-        std::size_t const maxRequestSize = 2048;
+        // A batch may be as large as that many requests
         Json::Reader reader;
-        if ((request.size() > maxRequestSize) ||
+        if ((request.size() >
+             maxRequestSize * std::max<std::size_t>(batchLimit, 1)) ||
             !reader.parse(request, jsonOrig) || !jsonOrig ||
-            !jsonOrig.isObject())
+            !(jsonOrig.isObject() ? request.size() <= maxRequestSize
+                                  : jsonOrig.isArray() && batchLimit))
         {
             Json::Value reply(Json::objectValue);
             reply[ripple::jss::result][ripple::jss::error] = "invalidRequest";
@@ -1021,10 +1120,44 @@ ServerHandler::processRequest(
         }
     }
 
-    auto const start(std::chrono::high_resolution_clock::now());
+    // Clear header-assigned values since not positively identified from a
+    // secure_gateway.
+    forwardedFor.clear();
+    user.clear();
 
-    Json::Value const& jsonRPC = jsonOrig;
+    if (jsonOrig.isObject())
+    {
+        auto [status, reply] = processRPC(jsonOrig, remoteIPAddress);
+        HTTPReply(status, std::move(reply), output, j_);
+        return;
+    }
 
+    if (jsonOrig.size() == 0 || jsonOrig.size() > batchLimit)
+    {
+        Json::Value reply(Json::objectValue);
+        reply[ripple::jss::result][ripple::jss::error] = "invalidRequest";
+        reply[ripple::jss::result][ripple::jss::error_message] = fmt::format(
+            "Batch of {} requests, 1 to {} expected",
+            jsonOrig.size(),
+            batchLimit);
+        HTTPReply(400, std::move(reply), output, j_);
+        return;
+    }
+
+    // The queries of the batch run on one read session, the replies are in
+    // the order of the requests
+    DatabaseCon::PinnedReadDb const pin(app_.getXChainTxnDB());
+    Json::Value replies(Json::arrayValue);
+    for (auto const& jsonRPC : jsonOrig)
+        replies.append(processRPC(jsonRPC, remoteIPAddress).second);
+    HTTPReply(200, std::move(replies), output, j_);
+}
+
+std::pair<int, Json::Value>
+ServerHandler::processRPC(
+    Json::Value const& jsonRPC,
+    beast::IP::Endpoint const& remoteIPAddress)
+{
     if (!jsonRPC.isMember(ripple::jss::method) ||
         !jsonRPC[ripple::jss::method].isString() ||
         !jsonRPC[ripple::jss::method])
@@ -1033,8 +1166,7 @@ ServerHandler::processRequest(
         reply[ripple::jss::result][ripple::jss::error] = "invalidRequest";
         reply[ripple::jss::result][ripple::jss::error_message] =
             "Invalid 'method' field";
-        HTTPReply(400, std::move(reply), output, j_);
-        return;
+        return {400, std::move(reply)};
     }
 
     // Extract request parameters from the request Json as `params`.
@@ -1055,8 +1187,7 @@ ServerHandler::processRequest(
         reply[ripple::jss::result][ripple::jss::error] = "invalidRequest";
         reply[ripple::jss::result][ripple::jss::error_message] =
             "params unparseable";
-        HTTPReply(400, std::move(reply), output, j_);
-        return;
+        return {400, std::move(reply)};
     }
     else
     {
@@ -1067,8 +1198,7 @@ ServerHandler::processRequest(
             reply[ripple::jss::result][ripple::jss::error] = "invalidRequest";
             reply[ripple::jss::result][ripple::jss::error_message] =
                 "params unparseable";
-            HTTPReply(400, std::move(reply), output, j_);
-            return;
+            return {400, std::move(reply)};
         }
     }
     // note: also mask the password
@@ -1082,11 +1212,6 @@ ServerHandler::processRequest(
         return {};
     }();
 
-    // Clear header-assigned values since not positively identified from a
-    // secure_gateway.
-    forwardedFor.clear();
-    user.clear();
-
     Json::Value const& method = jsonRPC[ripple::jss::method];
     std::string strMethod = method.asString();
     // Provide the JSON-RPC method as the field "command" in the request.
@@ -1118,7 +1243,7 @@ ServerHandler::processRequest(
     if (params.isMember(ripple::jss::id))
         reply[ripple::jss::id] = params[ripple::jss::id];
 
-    HTTPReply(200, std::move(reply), output, j_);
+    return {200, std::move(reply)};
 }
 
 //------------------------------------------------------------------------------
@@ -1151,6 +1276,36 @@ ServerHandler::statusResponse(ripple::http_request_type const& request) const
     return handoff;
 }
 
+// The metrics for Prometheus, in its text format
+ripple::Handoff
+ServerHandler::metricsResponse(
+    ripple::http_request_type const& request,
+    boost::asio::ip::tcp::endpoint const& remote_address) const
+{
+    using namespace boost::beast::http;
+    ripple::Handoff handoff;
+    response<string_body> msg;
+    auto metrics =
+        rpc::getMetrics(app_, beast::IP::from_asio(remote_address.address()));
+    if (metrics)
+    {
+        msg.result(boost::beast::http::status::ok);
+        msg.body() = std::move(*metrics);
+    }
+    else
+    {
+        msg.result(boost::beast::http::status::forbidden);
+        msg.body() = "Forbidden";
+    }
+    msg.version(request.version());
+    msg.insert("Server", build_info::getFullVersionString());
+    msg.insert("Content-Type", "text/plain; version=0.0.4");
+    msg.insert("Connection", "close");
+    msg.prepare_payload();
+    handoff.response = std::make_shared<ripple::SimpleWriter>(msg);
+    return handoff;
+}
+
 //------------------------------------------------------------------------------
 
 }  // namespace rpc
@@ -14,6 +14,7 @@
 #include <condition_variable>
 #include <map>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace xbwd {
@@ -102,6 +103,13 @@ private:
         std::shared_ptr<ripple::WSSession> const& session,
         Json::Value const& jv);
 
+    // Add or remove the session from the streams of the request
+    Json::Value
+    processSubscribe(
+        std::shared_ptr<ripple::WSSession> const& session,
+        Json::Value const& jv,
+        bool subscribe);
+
     void
     processSession(std::shared_ptr<ripple::Session> const&);
 
@@ -114,8 +122,19 @@ private:
         boost::string_view forwardedFor,
         boost::string_view user);
 
+    // Reply to one JSON-RPC request, with the HTTP status of a lone request
+    std::pair<int, Json::Value>
+    processRPC(
+        Json::Value const& jsonRPC,
+        beast::IP::Endpoint const& remoteIPAddress);
+
     ripple::Handoff
     statusResponse(ripple::http_request_type const& request) const;
+
+    ripple::Handoff
+    metricsResponse(
+        ripple::http_request_type const& request,
+        boost::asio::ip::tcp::endpoint const& remote_address) const;
 };
 
 }  // namespace rpc